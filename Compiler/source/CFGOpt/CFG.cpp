@@ -7,11 +7,77 @@
 
 #include "../compile/Functions.h"
 #include "CFG.h"
+#include "Layout.h"
 
 using namespace std;
 
+thread_local ControlFlowGraph::Fragment* ControlFlowGraph::building = nullptr;
+
+void ControlFlowGraph::beginFragment(Fragment& fragment)
+{
+    building = &fragment;
+}
+
+void ControlFlowGraph::endFragment()
+{
+    building = nullptr;
+}
+
+void ControlFlowGraph::merge(Fragment& fragment)
+{
+    for (auto& change : fragment.held) change();
+    fragment.held.clear();
+    fragment.nodes.clear();
+    fragment.nodeNames.clear();
+}
+
+void ControlFlowGraph::defer(function<void()> change)
+{
+    if (building != nullptr) building->held.push_back(move(change));
+    else change();
+}
+
+void ControlFlowGraph::addEdge(CFGNode* from, CFGNode* to)
+{
+    if (building != nullptr && building->nodeNames.find(to->getName()) == building->nodeNames.end())
+    {
+        building->held.push_back([from, to] () {to->addParent(from);});
+    }
+    else to->addParent(from);
+}
+
+CFGNode* ControlFlowGraph::addNode(unique_ptr<CFGNode> node)
+{
+    CFGNode* added = node.get();
+    if (building == nullptr)
+    {
+        added->id = nodesById.size();
+        nodesById.push_back(added);
+        currentNodes[added->getName()] = move(node);
+        return added;
+    }
+
+    size_t index = building->nodes.size();
+    Fragment* fragment = building;
+    building->nodes.push_back(move(node));
+    building->nodeNames[added->getName()] = added;
+    building->held.push_back([this, fragment, index] ()
+    {
+        unique_ptr<CFGNode>& node = fragment->nodes[index];
+        node->id = nodesById.size(); //given here so ids follow source order however parsing was split
+        nodesById.push_back(node.get());
+        currentNodes[node->getName()] = move(node);
+    });
+    return added;
+}
+
 CFGNode* ControlFlowGraph::getNode(const string& name)
 {
+    if (building != nullptr)
+    {
+        auto found = building->nodeNames.find(name);
+        if (found != building->nodeNames.end()) return found->second;
+    }
     unordered_map<string, unique_ptr<CFGNode>>::const_iterator it = currentNodes.find(name);
     if (it == currentNodes.cend()) return nullptr;
     return it->second.get();
@@ -23,12 +89,13 @@ NodeMapIterator ControlFlowGraph::removeNode(NodeMapIterator it)
     unique_ptr<CFGNode>& nodePointer = it->second;
     if (nodePointer->isLastNode())
     {
-        if (nodePointer->getPredecessorMap().size() != 1) throw runtime_error("Can't replace last node");
-        CFGNode* newLast = last->getPredecessorMap().cbegin()->second;
+        if (nodePointer->getPredecessors().size() != 1) throw runtime_error("Can't replace last node");
+        CFGNode* newLast = last->getPredecessors()[0];
         nodePointer->getParentFunction()->mergeInto(newLast->getParentFunction());
         nodePointer->getParentFunction()->setLastNode(newLast);
         if (last->getName() == nodePointer->getName()) last = newLast;
     }
+    nodesById[nodePointer->getId()] = nullptr;
     return currentNodes.erase(it);
 }
 
@@ -63,7 +130,7 @@ CFGNode* ControlFlowGraph::createNode(const string &name, bool overwrite, bool i
             parentFunc->setLastNode(introducing);
             introducing->setLast(true);
         }
-        currentNodes[introducing->getName()] = move(newPtr);
+        addNode(move(newPtr));
     }
     return introducing;
 }
@@ -81,7 +148,7 @@ CFGNode* ControlFlowGraph::createNode(const string &name, bool overwrite, bool i
         FunctionSymbol* parentFunc = functionTable.getParentFunc(name);
         unique_ptr<CFGNode> nodePointer = make_unique<CFGNode>(*this, parentFunc, name, isLast);
         introducing = nodePointer.get();
-        currentNodes[introducing->getName()] = move(nodePointer);
+        addNode(move(nodePointer));
     }
 
     return introducing;
@@ -92,19 +159,7 @@ string ControlFlowGraph::getStructuredSource()
     if (first == nullptr) return "";
 
     stringstream outs;
-    outs << first->getSource();
-    outs << '\n';
-
-    //order nodes
-    map<string, CFGNode*> ordered;
-    for (auto& node : currentNodes) ordered[node.first] = node.second.get();
-
-    for (auto& it : ordered)
-    {
-        if (it.first == first->getName()) continue;
-        outs << it.second->getSource() << '\n';
-    }
-
+    for (CFGNode* node : layoutNodes(*this)) outs << node->getSource() << '\n';
     return outs.str();
 }
 
@@ -243,9 +298,9 @@ string ControlFlowGraph::destroyStructureAndGetFinalSource()
     for (auto& pair : currentNodes)
     {
         unique_ptr<SourceNode>& sn = outputMap[pair.first];
-        for (auto& predpair : pair.second->getPredecessorMap())
+        for (CFGNode* predNode : pair.second->getPredecessors())
         {
-            unique_ptr<SourceNode>& pred = outputMap[predpair.first];
+            unique_ptr<SourceNode>& pred = outputMap[predNode->getName()];
             sn->addPredecessor(pred.get());
             pred->addSuccessor(sn.get());
         }
@@ -321,6 +376,7 @@ string ControlFlowGraph::destroyStructureAndGetFinalSource()
     //clear CFG
     first = last = nullptr;
     currentNodes.clear();
+    nodesById.clear();
     outputMap.clear();
 
     return out.str();
@@ -369,6 +425,42 @@ unordered_map<string, unique_ptr<CFGNode>>& ControlFlowGraph::getCurrentNodes()
     return currentNodes;
 }
 
+unsigned int ControlFlowGraph::getNodeIdBound() const
+{
+    return nodesById.size();
+}
+
+ControlFlowGraph::Adjacency::Adjacency(const ControlFlowGraph& cfg):
+        predecessorStart(cfg.nodesById.size() + 1),
+        successorStart(cfg.nodesById.size() + 1)
+{
+    for (unsigned int i = 0; i < cfg.nodesById.size(); ++i)
+    {
+        predecessorStart[i] = predecessorList.size();
+        successorStart[i] = successorList.size();
+        CFGNode* node = cfg.nodesById[i];
+        if (node == nullptr) continue;
+        NodeSpan preds = node->getPredecessors();
+        predecessorList.insert(predecessorList.end(), preds.begin(), preds.end());
+        vector<CFGNode*> succs = node->getSuccessorVector();
+        successorList.insert(successorList.end(), succs.begin(), succs.end());
+    }
+    predecessorStart.back() = predecessorList.size();
+    successorStart.back() = successorList.size();
+}
+
+NodeSpan ControlFlowGraph::Adjacency::predecessors(const CFGNode* node) const
+{
+    CFGNode* const* list = predecessorList.data();
+    return {list + predecessorStart[node->getId()], list + predecessorStart[node->getId() + 1]};
+}
+
+NodeSpan ControlFlowGraph::Adjacency::successors(const CFGNode* node) const
+{
+    CFGNode* const* list = successorList.data();
+    return {list + successorStart[node->getId()], list + successorStart[node->getId() + 1]};
+}
+
 CFGNode* ControlFlowGraph::getFirst() const
 {
     return first;
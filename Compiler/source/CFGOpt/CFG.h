@@ -3,29 +3,94 @@
 
 #include <unordered_map>
 #include <set>
+#include <vector>
+#include <memory>
+#include <functional>
 
 #include "../compile/SymbolTable.h"
 #include "../compile/Token.h"
 #include "../Command.h"
 #include "../compile/Reporter.h"
 #include "../compile/Functions.h"
+#include "../compile/Arena.h"
 
 class CFGNode;
 
+//a run of nodes in one of the graph's arrays, good until that array next changes
+class NodeSpan
+{
+private:
+    CFGNode* const* first;
+    CFGNode* const* past;
+
+public:
+    NodeSpan(CFGNode* const* b, CFGNode* const* e): first(b), past(e) {}
+    explicit NodeSpan(const std::vector<CFGNode*>& nodes): first(nodes.data()), past(nodes.data() + nodes.size()) {}
+    CFGNode* const* begin() const {return first;}
+    CFGNode* const* end() const {return past;}
+    size_t size() const {return past - first;}
+    bool empty() const {return first == past;}
+    CFGNode* operator[](size_t i) const {return first[i];}
+};
+
 //This class owns the nodes
 typedef std::unordered_map<std::string, std::unique_ptr<CFGNode>>::iterator NodeMapIterator;
 class ControlFlowGraph
 {
+public:
+    class Fragment;
+
 private:
     std::unordered_map<std::string, std::unique_ptr<CFGNode>> currentNodes;
+    std::vector<CFGNode*> nodesById; //nullptr where a node has been removed
     CFGNode* first;
     CFGNode* last;
     Reporter& reporter;
     FunctionTable& functionTable;
     SymbolTable& symbolTable;
+    static thread_local Fragment* building;
+    CFGNode* addNode(std::unique_ptr<CFGNode> node);
 
 public:
     ControlFlowGraph(Reporter& r, FunctionTable& fc, SymbolTable& st) : reporter(r), functionTable(fc), symbolTable(st) {};
+
+    /*While a thread has a fragment, nodes it creates go into the fragment rather than the graph, and changes it makes
+      to nodes outside the fragment are held back in order - so several functions can be parsed at once, each into a
+      fragment, and the fragments merged in source order as though the functions had been parsed one after another*/
+    class Fragment
+    {
+    private:
+        std::vector<std::unique_ptr<CFGNode>> nodes;
+        std::unordered_map<std::string, CFGNode*> nodeNames;
+        std::vector<std::function<void()>> held; //including moving each node into the graph
+        friend class ControlFlowGraph;
+    };
+    void beginFragment(Fragment& fragment);
+    void endFragment();
+    void merge(Fragment& fragment);
+    //done now, or when the fragment being built is merged
+    void defer(std::function<void()> change);
+    //from -> to, held back if to is outside the fragment being built
+    void addEdge(CFGNode* from, CFGNode* to);
+
+    /*Every node's predecessors and successors laid out in two flat arrays indexed by node id - built once by an
+      analysis that walks the graph without changing its edges, instead of asking each node on every visit*/
+    class Adjacency
+    {
+    private:
+        std::vector<unsigned int> predecessorStart;
+        std::vector<unsigned int> successorStart;
+        std::vector<CFGNode*> predecessorList;
+        std::vector<CFGNode*> successorList;
+
+    public:
+        explicit Adjacency(const ControlFlowGraph& cfg);
+        NodeSpan predecessors(const CFGNode* node) const;
+        NodeSpan successors(const CFGNode* node) const;
+    };
+    //node ids are below this, so it sizes anything indexed by them
+    unsigned int getNodeIdBound() const;
+
     const FunctionSymbol& getMain() const;
     CFGNode* createNode(const std::string& name, bool overwrite, bool last, FunctionSymbol* parentFunc);
     CFGNode* createNode(const std::string& name, bool overwrite, bool last);
@@ -50,8 +115,9 @@ class CFGNode: public std::enable_shared_from_this<CFGNode>
 {
 private:
     std::string name;
+    unsigned int id = 0; //dense, given when the node joins the graph and never reused
     std::unique_ptr<JumpOnComparisonCommand> comp;
-    std::unordered_map<std::string, CFGNode*> predecessors;
+    std::vector<CFGNode*> predecessors;
     CFGNode* compSuccess;
     CFGNode* compFail; //unconditional jump at the end of the node
     std::vector<std::unique_ptr<AbstractCommand>> instrs; //pointers to allow downcasting (avoid object slicing)
@@ -64,16 +130,18 @@ private:
 
 public:
     CFGNode(ControlFlowGraph& p, FunctionSymbol* pf, std::string n, bool last = false);
-    bool constProp(std::unordered_map<std::string, Atom> assignments = std::unordered_map<std::string, Atom>()); //returns true if it bypassed some return
+    //in the current compilation's arena
+    static void* operator new(size_t size) {return Arena::allocateObject(size);}
+    static void operator delete(void* node) {Arena::releaseObject(node);}
+    bool constProp(std::unordered_map<Symbols::Id, Atom> assignments = std::unordered_map<Symbols::Id, Atom>()); //returns true if it bypassed some return
     bool addParent(CFGNode*); //returns false if parent was already in
     void removeParent(CFGNode*);
-    void removeParent(const std::string&);
     void clearPredecessors(); //does not remove successor relationships
 
     void setInstructions(std::vector<std::unique_ptr<AbstractCommand>>& in);
     void setFunctionCall(FunctionSymbol* fc);
-    void appendDeclatation(std::string varName);
-    void appendArrayDeclaration(std::string varName, unsigned int size);
+    void appendDeclatation(Symbols::Id varName);
+    void appendArrayDeclaration(Symbols::Id varName, unsigned int size);
     void setCompSuccess(CFGNode* compSuccess);
     void setCompFail(CFGNode* compFail);
     void setComp(std::unique_ptr<JumpOnComparisonCommand> comp);
@@ -94,13 +162,14 @@ public:
     bool swallowNode(CFGNode* other);
 
     JumpOnComparisonCommand* getComp() const;
-    const std::unordered_map<std::string, CFGNode*>& getPredecessorMap();
-    std::vector<CFGNode*> getPredecessorVector() const;
+    NodeSpan getPredecessors() const;
+    bool hasPredecessor(const CFGNode* node) const;
     std::vector<CFGNode*> getSuccessorVector() const;
     CFGNode* getCompSuccess() const;
     CFGNode* getCompFail() const;
     int getJumpline() const;
     const std::string& getName() const;
+    unsigned int getId() const;
     std::vector<std::unique_ptr<AbstractCommand>>& getInstrs();
     ControlFlowGraph& getParentGraph() const;
     FunctionSymbol* getParentFunction() const;
@@ -109,6 +178,8 @@ public:
     std::string getDotEdges();
     bool isLastNode() const;
     bool isFirstNode() const;
+
+    friend class ControlFlowGraph;
 };
 
 #endif
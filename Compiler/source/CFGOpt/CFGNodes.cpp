@@ -26,6 +26,11 @@ const string &CFGNode::getName() const
     return name;
 }
 
+unsigned int CFGNode::getId() const
+{
+    return id;
+}
+
 string CFGNode::getSource(bool makeState, std::string delim, bool escape) const
 {
     stringstream outs;
@@ -98,7 +103,7 @@ string CFGNode::getDotEdges()
     return outs.str();
 }
 
-bool CFGNode::constProp(unordered_map<string,Atom> assignments)
+bool CFGNode::constProp(unordered_map<Symbols::Id, Atom> assignments)
 {
     stack<vector<unique_ptr<AbstractCommand>>::iterator> pushedThings;
 
@@ -114,25 +119,25 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
             case CommandType::NONDET:
             {
                 auto ndc = static_cast<NondetCommand *>(current.get());
-                if (ndc->holding) assignments.erase(current->getVarWrapper()->getBaseName());
+                if (ndc->holding) assignments.erase(current->getVarWrapper()->getBaseId());
                 newInstrs.push_back(move(current));
                 break;
             }
             case CommandType::INPUTVAR:
             {
-                assignments.erase(current->getVarWrapper()->getFullName());
+                assignments.erase(current->getVarWrapper()->getFullId());
                 newInstrs.push_back(move(current));
                 break;
             }
             case CommandType::ASSIGNVAR:
             {
                 auto avc = static_cast<AssignVarCommand*>(current.get());
-                const string& lhsname = avc->getVarWrapper()->getFullName();
+                Symbols::Id lhsname = avc->getVarWrapper()->getFullId();
                 if (!avc->getAtom().isHolding()) assignments.emplace(lhsname, Atom(avc->getAtom()));
                 else
                 {
-                    const string& vname = avc->getAtom().getVarWrapper()->getFullName();
-                    unordered_map<string, Atom>::const_iterator constit = assignments.find(vname);
+                    Symbols::Id vname = avc->getAtom().getVarWrapper()->getFullId();
+                    auto constit = assignments.find(vname);
                     if (constit != assignments.end())
                     {
                         Atom found = constit->second;
@@ -143,25 +148,28 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
                     else assignments.emplace(lhsname, Atom(avc->getAtom()));
                 }
 
-                if (lhsname != string(avc->getAtom())) newInstrs.push_back(move(current));
+                if (!avc->getAtom().isHolding() || lhsname != avc->getAtom().getVarWrapper()->getFullId())
+                {
+                    newInstrs.push_back(move(current));
+                }
                 break;
             }
             case CommandType::EXPR:
             {
                 EvaluateExprCommand* eec = static_cast<EvaluateExprCommand*>(current.get());
-                const string& intoVar = eec->getVarWrapper()->getFullName();
+                Symbols::Id intoVar = eec->getVarWrapper()->getFullId();
 
                 //literals will not be found
                 if (eec->term1.isHolding())
                 {
-                    unordered_map<string, Atom>::const_iterator t1it = assignments.find(eec->term1.getVarWrapper()->getFullName());
+                    auto t1it = assignments.find(eec->term1.getVarWrapper()->getFullId());
                     if (t1it != assignments.end()) eec->term1 = Atom(t1it->second);
 
                 }
     
                 if (eec->term2.isHolding())
                 {
-                    unordered_map<string, Atom>::const_iterator t2it = assignments.find(eec->term2.getVarWrapper()->getFullName());
+                    auto t2it = assignments.find(eec->term2.getVarWrapper()->getFullId());
                     if (t2it != assignments.end()) eec->term2 = Atom(t2it->second);
                 }
     
@@ -171,9 +179,9 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
                     {
                         case MINUS:
                         {
-                            assignments.emplace(intoVar, Atom(0));
-                            newInstrs.push_back(make_unique<AssignVarCommand>(eec->getVarWrapper()->clone(),
-                                                                              Atom(0), eec->getLineNum()));
+                            assignments.emplace(intoVar, Atom(0.0));
+                            newInstrs.push_back(make_unique<AssignVarCommand>(eec->getVarWrapper(),
+                                                                              Atom(0.0), eec->getLineNum()));
                             break;
                         }
                         case PLUS:
@@ -198,7 +206,7 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
                     double rhs = eec->term2.getLiteral();
                     double result = evaluateOp(lhs, eec->op, rhs);
                     assignments.emplace(intoVar, Atom(result));
-                    newInstrs.push_back(make_unique<AssignVarCommand>(eec->getVarWrapper()->clone(),
+                    newInstrs.push_back(make_unique<AssignVarCommand>(eec->getVarWrapper(),
                                                                       Atom(result), eec->getLineNum()));
                 }
                 else
@@ -210,8 +218,11 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
             }
             case CommandType::PRINT:
             {
-                unordered_map<string, Atom>::const_iterator t1it = assignments.find(string(current->getAtom()));
-                if (t1it != assignments.end()) current->getAtom().become(t1it->second);
+                if (current->getAtom().isHolding())
+                {
+                    auto t1it = assignments.find(current->getAtom().getVarWrapper()->getFullId());
+                    if (t1it != assignments.end()) current->getAtom().become(t1it->second);
+                }
                 newInstrs.push_back(move(current));
                 break;
             }
@@ -222,7 +233,7 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
                 {
                     if (pushc->getAtom().isHolding())
                     {
-                        auto pushedVarIt = assignments.find(pushc->getAtom().getVarWrapper()->getFullName());
+                        auto pushedVarIt = assignments.find(pushc->getAtom().getVarWrapper()->getFullId());
                         if (pushedVarIt != assignments.end()) current->setAtom(pushedVarIt->second);
                     }
                 }
@@ -256,11 +267,12 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
                         else
                         {
                             pushedThings.pop();
-                            const string& popInto = current->getVarWrapper()->getFullName();
-                            if (popInto != string(pushc->getAtom()))
+                            Symbols::Id popInto = current->getVarWrapper()->getFullId();
+                            const Atom& pushed = pushc->getAtom();
+                            if (!pushed.isHolding() || popInto != pushed.getVarWrapper()->getFullId())
                             {
                                 newInstrs.push_back(make_unique<AssignVarCommand>
-                                                            (current->getVarWrapper()->clone(),
+                                                            (current->getVarWrapper(),
                                                              pushc->getAtom(), current->getLineNum()));
                             }
                             newInstrs.erase(stackTop);
@@ -281,12 +293,12 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
     {
         if (comp->term1.isHolding())
         {
-            auto it = assignments.find(comp->term1.getVarWrapper()->getFullName());
+            auto it = assignments.find(comp->term1.getVarWrapper()->getFullId());
             if (it != assignments.end()) comp->term1.become(it->second);
         }
         if (comp->term2.getType() == StringType::ID)
         {
-            auto it = assignments.find(comp->term2.getVarWrapper()->getFullName());
+            auto it = assignments.find(comp->term2.getVarWrapper()->getFullId());
             if (it != assignments.end()) comp->term2.become(it->second);
         }
 
@@ -310,7 +322,7 @@ bool CFGNode::constProp(unordered_map<string,Atom> assignments)
                 //replace conditionals with true/false
                 if (Relations::evaluateRelop<double>(comp->term1.getLiteral(), comp->op, comp->term2.getLiteral()))
                 {
-                    if (getCompFail() != nullptr) getCompFail()->removeParent(getName());
+                    if (getCompFail() != nullptr) getCompFail()->removeParent(this);
                     else throw std::runtime_error("shouldnt happen at the end of a function call");
                     setCompFail(getCompSuccess());
                 }
@@ -329,9 +341,9 @@ bool CFGNode::swallowNode(CFGNode* other)
 {
     if (other->getName() == name) throw std::runtime_error("cant swallow self");
 
-    const set<unique_ptr<FunctionCall>>& returnTo = parentFunction->getFunctionCalls();
+    const FunctionCalls& returnTo = parentFunction->getFunctionCalls();
 
-    bool needlessFunctionCall = other->isFirstNode() && other->getPredecessorMap().size() == 1;
+    bool needlessFunctionCall = other->isFirstNode() && other->getPredecessors().size() == 1;
 
     bool needlessFunctionReturn = isLast && returnTo.size() == 1
                                 && (*returnTo.cbegin())->returnTo->getName() == other->getName()
@@ -432,14 +444,14 @@ bool CFGNode::swallowNode(CFGNode* other)
     return false;
 }
 
-void CFGNode::appendDeclatation(std::string varName)
+void CFGNode::appendDeclatation(Symbols::Id varName)
 {
-    instrs.push_back(make_unique<DeclareVarCommand>(move(varName), -1));
+    instrs.push_back(make_unique<DeclareVarCommand>(varName, -1));
 }
 
-void CFGNode::appendArrayDeclaration(std::string varName, unsigned int size)
+void CFGNode::appendArrayDeclaration(Symbols::Id varName, unsigned int size)
 {
-    instrs.push_back(make_unique<DeclareArrayCommand>(move(varName), size, -1));
+    instrs.push_back(make_unique<DeclareArrayCommand>(varName, size, -1));
 }
 
 
@@ -463,7 +475,7 @@ void CFGNode::setInstructions(vector<unique_ptr<AbstractCommand>>& in)
         {
             PopCommand* pc = static_cast<PopCommand*>(it->get());
             if (!pc->isEmpty()) instrs.emplace_back(make_unique<AssignVarCommand>
-                                                            (pc->getVarWrapper()->clone(),
+                                                            (pc->getVarWrapper(),
                                                              intraNodeStack.top()->getAtom(),
                                                              intraNodeStack.top()->getLineNum()));
             intraNodeStack.pop();
@@ -479,7 +491,7 @@ void CFGNode::setInstructions(vector<unique_ptr<AbstractCommand>>& in)
         JumpOnComparisonCommand* jocc = static_cast<JumpOnComparisonCommand*>(it->get());
         compSuccess = parentGraph.getNode(jocc->getString());
         if (compSuccess == nullptr) compSuccess = parentGraph.createNode(jocc->getString(), false, false);
-        compSuccess->addParent(this);
+        parentGraph.addEdge(this, compSuccess);
         setComp(make_unique<JumpOnComparisonCommand>(*jocc));
 
         if (++it == in.cend()) return;
@@ -494,7 +506,7 @@ void CFGNode::setInstructions(vector<unique_ptr<AbstractCommand>>& in)
         {
             compFail = parentGraph.getNode(jumpto);
             if (compFail == nullptr) compFail = parentGraph.createNode(jumpto, false, false);
-            compFail->addParent(this);
+            parentGraph.addEdge(this, compFail);
         }
         if (++it != in.cend()) throw std::runtime_error("Should end here");
     }
@@ -508,21 +520,16 @@ void CFGNode::setFunctionCall(FunctionSymbol* fc)
 
 bool CFGNode::addParent(CFGNode* parent)
 {
-    auto it = predecessors.find(parent->getName());
-
-    if (it != predecessors.end()) return false;
-    predecessors[parent->getName()] = parent;
+    if (hasPredecessor(parent)) return false;
+    predecessors.push_back(parent);
     return true;
 }
 
 void CFGNode::removeParent(CFGNode* leaving)
 {
-    removeParent(leaving->getName());
-}
-
-void CFGNode::removeParent(const string& s)
-{
-    if (predecessors.erase(s) == 0) runtime_error("Parent '" + s + "' not found in '" + getName() + "'");
+    auto it = find(predecessors.begin(), predecessors.end(), leaving);
+    if (it == predecessors.end()) runtime_error("Parent '" + leaving->getName() + "' not found in '" + getName() + "'");
+    else predecessors.erase(it);
 }
 
 JumpOnComparisonCommand* CFGNode::getComp() const
@@ -535,14 +542,24 @@ void CFGNode::clearPredecessors()
     predecessors.clear();
 }
 
-const unordered_map<string, CFGNode*>& CFGNode::getPredecessorMap()
+NodeSpan CFGNode::getPredecessors() const
+{
+    return NodeSpan(predecessors);
+}
+
+bool CFGNode::hasPredecessor(const CFGNode* node) const
 {
-    return predecessors;
+    return find(predecessors.begin(), predecessors.end(), node) != predecessors.end();
 }
 
 vector<CFGNode*> CFGNode::getSuccessorVector() const
 {
     std::vector<CFGNode*> successors;
+    for (const auto& ac : instrs)
+    {
+        if (ac->getType() != CommandType::SWITCH) continue;
+        for (const auto& c : static_cast<SwitchCommand*>(ac.get())->cases) successors.push_back(parentGraph.getNode(c.second));
+    }
     if (getCompSuccess() != nullptr) successors.push_back(getCompSuccess());
     if (getCompFail() != nullptr) successors.push_back(getCompFail());
     else
@@ -552,13 +569,6 @@ vector<CFGNode*> CFGNode::getSuccessorVector() const
     }
     return successors;
 }
-std::vector<CFGNode*> CFGNode::getPredecessorVector() const
-{
-    std::vector<CFGNode*> predecessorVec;
-    for (const auto& pair : predecessors) predecessorVec.push_back(pair.second);
-    return predecessorVec;
-}
-
 CFGNode* CFGNode::getCompSuccess() const
 {
     return compSuccess;
@@ -589,7 +599,7 @@ void CFGNode::setCompSuccess(CFGNode* compsucc)
 bool CFGNode::noPreds()
 {
     return (predecessors.empty() ||
-            (predecessors.size() == 1 && predecessors.begin()->first == name));
+            (predecessors.size() == 1 && predecessors.front() == this));
 }
 
 FunctionSymbol* CFGNode::calledFunction()
@@ -718,8 +728,8 @@ void CFGNode::removeFunctionCall(const string& bye, FunctionSymbol* fs)
 void CFGNode::prepareToDie()
 {
     if (isLastNode() || name == parentGraph.getLast()->getName()) throw std::runtime_error("cant delete last node");
-    if (getCompFail() != nullptr) getCompFail()->removeParent(name);
-    if (getCompSuccess() != nullptr) getCompSuccess()->removeParent(name);
+    if (getCompFail() != nullptr) getCompFail()->removeParent(this);
+    if (getCompSuccess() != nullptr) getCompSuccess()->removeParent(this);
 
     removePushes();
 
@@ -6,23 +6,23 @@
 using namespace std;
 using namespace DataFlow;
 
-std::vector<CFGNode*> DataFlow::getSuccessorNodes(CFGNode* node)
+NodeSpan DataFlow::getSuccessorNodes(const Adjacency& adjacency, CFGNode* node)
 {
-    return node->getSuccessorVector();
+    return adjacency.successors(node);
 }
-std::vector<CFGNode*> DataFlow::getPredecessorNodes(CFGNode* node)
+NodeSpan DataFlow::getPredecessorNodes(const Adjacency& adjacency, CFGNode* node)
 {
-    return node->getPredecessorVector();
+    return adjacency.predecessors(node);
 }
 
 //AssignmentPropogationDataFlow
 AssignmentPropogationDataFlow::AssignmentPropogationDataFlow(ControlFlowGraph& cfg, SymbolTable& st)
-        : AbstractDataFlow(cfg, st)
+        : AbstractDataFlow(cfg, st), genSets(cfg.getNodeIdBound()), killSets(cfg.getNodeIdBound())
 {
     for (CFGNode* node : nodes) //intra-propogation already done in Optimiser
     {
         set<Assignment> genSet;
-        set<string> killSet;
+        set<Symbols::Id> killSet;
 
         vector<unique_ptr<AbstractCommand>>& instrs = node->getInstrs();
 
@@ -39,7 +39,7 @@ AssignmentPropogationDataFlow::AssignmentPropogationDataFlow(ControlFlowGraph& c
                 case CommandType::EXPR:
                 case CommandType::POP:
                 {
-                    const std::string& data = instr->getVarWrapper()->getBaseName();
+                    Symbols::Id data = instr->getVarWrapper()->getBaseId();
                     auto it = find_if(genSet.begin(), genSet.end(),
                                       [&, data](const Assignment& ass)
                                       { return ass.lhs == data; });
@@ -50,7 +50,7 @@ AssignmentPropogationDataFlow::AssignmentPropogationDataFlow(ControlFlowGraph& c
                 }
                 case CommandType::ASSIGNVAR:
                 {
-                    const string& lhs = instr->getVarWrapper()->getFullName();
+                    Symbols::Id lhs = instr->getVarWrapper()->getFullId();
                     auto it = find_if(genSet.begin(), genSet.end(),
                                       [&, lhs](const Assignment& ass)
                                       { return ass.lhs == lhs; });
@@ -64,31 +64,31 @@ AssignmentPropogationDataFlow::AssignmentPropogationDataFlow(ControlFlowGraph& c
                     DeclareCommand* dvc = static_cast<DeclareCommand*>(instr.get());
                     if (dvc->dt == DeclareCommand::DeclareType::ARRAY) continue;
 
-                    const string& lhs = dvc->getBaseName();
+                    Symbols::Id lhs = dvc->getBaseId();
                     auto it = find_if(genSet.begin(), genSet.end(),
                                       [&, lhs](const Assignment& ass)
                                       { return ass.lhs == lhs; });
                     if (it != genSet.end()) genSet.erase(it);
-                    genSet.insert(Assignment(lhs, Atom(0)));
+                    genSet.insert(Assignment(lhs, Atom(0.0)));
                     killSet.erase(lhs);
                     break;
                 }
             }
         }
-        genSets[node->getName()] = move(genSet);
-        killSets[node->getName()] = move(killSet);
+        genSets[node->getId()] = move(genSet);
+        killSets[node->getId()] = move(killSet);
     }
 }
 
 void AssignmentPropogationDataFlow::transfer(set<Assignment>& in, CFGNode* node)
 {
-    for (auto& ass: genSets[node->getName()])
+    for (auto& ass: genSets[node->getId()])
     {
         auto it = find_if(in.begin(), in.end(), [&, ass](const Assignment& otherAss){return otherAss.lhs == ass.lhs;});
         if (it != in.end()) in.erase(it);
         in.insert(ass);
     }
-    for (auto& kill : killSets[node->getName()])
+    for (auto& kill : killSets[node->getId()])
     {
         auto it = find_if(in.begin(), in.end(), [&, kill] (const Assignment& ass) {return ass.lhs == kill;});
         if (it != in.end()) in.erase(it);
@@ -99,9 +99,9 @@ void AssignmentPropogationDataFlow::finish()
 {
     for (CFGNode* node : nodes)
     {
-        set<Assignment> inAss = intersectPredecessors(node, outSets);
+        set<Assignment> inAss = intersectPredecessors(node, adjacency, outSets);
 
-        unordered_map<string, Atom> mapToPass;
+        unordered_map<Symbols::Id, Atom> mapToPass;
         for (const Assignment& ass : inAss) mapToPass.emplace(ass.lhs, ass.rhs);
         //node->constProp(move(mapToPass));
     }
@@ -110,27 +110,28 @@ void AssignmentPropogationDataFlow::finish()
 //LiveVariableDataFlow
 
 LiveVariableDataFlow::LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& st)
-        : AbstractDataFlow(cfg, st)
+        : AbstractDataFlow(cfg, st), UEVars(cfg.getNodeIdBound()), genSets(cfg.getNodeIdBound()),
+          killSets(cfg.getNodeIdBound())
 {
     for (CFGNode* node : nodes) //intra-propogation already done in Optimiser
     {
-        set<string> thisUEVars;
-        set<string> genSet;
-        set<string> killSet;
+        set<Symbols::Id> thisUEVars;
+        set<Symbols::Id> genSet;
+        set<Symbols::Id> killSet;
 
         auto insertAndCheckUpwardExposed = [&genSet, &thisUEVars, &killSet, this](const VarWrapper* inserting) -> void
         {
             if (inserting->isCompound())
             {
-                for (const std::string* namePtr : inserting->getAllNames())
+                for (Symbols::Id id : inserting->getAllIds())
                 {
-                    const std::string& name = *namePtr;
+                    const std::string& name = Symbols::name(id);
                     if (!isdigit(name[0]) && name[0] != '"')
                     {
-                        auto it = killSet.find(name);
-                        if (it == killSet.end()) thisUEVars.insert(name);
-                        genSet.insert(name);
-                        usedVars.insert(name);
+                        auto it = killSet.find(id);
+                        if (it == killSet.end()) thisUEVars.insert(id);
+                        genSet.insert(id);
+                        usedVars.insert(id);
                     }
                 }
             }
@@ -140,10 +141,11 @@ LiveVariableDataFlow::LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& s
                 const std::string& name = inserting->getBaseName();
                 if (!isdigit(name[0]) && name[0] != '"')
                 {
-                    auto it = killSet.find(name);
-                    if (it == killSet.end()) thisUEVars.insert(name);
-                    genSet.insert(name);
-                    usedVars.insert(name);
+                    Symbols::Id id = inserting->getBaseId();
+                    auto it = killSet.find(id);
+                    if (it == killSet.end()) thisUEVars.insert(id);
+                    genSet.insert(id);
+                    usedVars.insert(id);
                 }
             }
         };
@@ -158,21 +160,21 @@ LiveVariableDataFlow::LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& s
                 case CommandType::DECLAREVAR:
                 {
                     DeclareCommand* dc = static_cast<DeclareCommand*>(instr.get());
-                    killSet.insert(dc->getBaseName());
+                    killSet.insert(dc->getBaseId());
                     break;
                 }
                 case CommandType::INPUTVAR:
                 case CommandType::POP:
                 {
-                    usedVars.insert(instr->getVarWrapper()->getBaseName());
-                    genSet.insert(instr->getVarWrapper()->getBaseName());
-                    killSet.insert(instr->getVarWrapper()->getBaseName());
+                    usedVars.insert(instr->getVarWrapper()->getBaseId());
+                    genSet.insert(instr->getVarWrapper()->getBaseId());
+                    killSet.insert(instr->getVarWrapper()->getBaseId());
                     break;
                 }
                 case CommandType::NONDET:
                 {
                     auto nc = static_cast<NondetCommand*>(instr.get());
-                    const string& bname = (nc->holding) ? nc->getVarWrapper()->getBaseName() : nc->getString();
+                    Symbols::Id bname = (nc->holding) ? nc->getVarWrapper()->getBaseId() : nc->getArray();
                     usedVars.insert(bname);
                     genSet.insert(bname);
                     killSet.insert(bname);
@@ -184,7 +186,7 @@ LiveVariableDataFlow::LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& s
                 {
                     PushCommand* pc = static_cast<PushCommand*>(instr.get());
                     if (pc->pushesState() || !pc->getAtom().isHolding()) continue;
-                    else killSet.insert(pc->getAtom().getVarWrapper()->getBaseName());
+                    else killSet.insert(pc->getAtom().getVarWrapper()->getBaseId());
 
                 }
                 case CommandType::PRINT:
@@ -195,7 +197,7 @@ LiveVariableDataFlow::LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& s
                 }
                 case CommandType::ASSIGNVAR:
                 {
-                    killSet.insert(instr->getVarWrapper()->getBaseName());
+                    killSet.insert(instr->getVarWrapper()->getBaseId());
                     const Atom& rhs = instr->getAtom();
                     if (rhs.getType() == StringType::ID) insertAndCheckUpwardExposed(rhs.getVarWrapper());
                     break;
@@ -203,7 +205,7 @@ LiveVariableDataFlow::LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& s
                 case CommandType::EXPR:
                 {
                     EvaluateExprCommand* eec = static_cast<EvaluateExprCommand*>(instr.get());
-                    killSet.insert(eec->getVarWrapper()->getBaseName());
+                    killSet.insert(eec->getVarWrapper()->getBaseId());
                     if (eec->term1.isHolding()) insertAndCheckUpwardExposed(eec->term1.getVarWrapper());
                     if (eec->term2.isHolding()) insertAndCheckUpwardExposed(eec->term2.getVarWrapper());
                 }
@@ -223,58 +225,58 @@ LiveVariableDataFlow::LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& s
             }
         }
 
-        outSets[node->getName()] = thisUEVars;//copies
-        UEVars[node->getName()] = move(thisUEVars);
-        genSets[node->getName()] = move(genSet);
-        killSets[node->getName()] = move(killSet);
+        outSets[node->getId()] = thisUEVars;//copies
+        UEVars[node->getId()] = move(thisUEVars);
+        genSets[node->getId()] = move(genSet);
+        killSets[node->getId()] = move(killSet);
     }
 }
 
-void LiveVariableDataFlow::transfer(set<string>& in, CFGNode* node)
+void LiveVariableDataFlow::transfer(set<Symbols::Id>& in, CFGNode* node)
 {
-    for (auto& exposed: UEVars[node->getName()]) in.insert(exposed);
+    for (auto& exposed: UEVars[node->getId()]) in.insert(exposed);
 }
 
 void LiveVariableDataFlow::finish()
 {
-    set<pair<VariableType,string>> toDeclare;
+    set<pair<VariableType, Symbols::Id>> toDeclare;
     for (CFGNode* node : nodes)
     {
-        set<string>& liveOut = outSets[node->getName()];
-        set<string>& genSet = genSets[node->getName()];
+        set<Symbols::Id>& liveOut = outSets[node->getId()];
+        set<Symbols::Id>& genSet = genSets[node->getId()];
         vector<unique_ptr<AbstractCommand>> newInstrs;
 
         //we remove commands that assign stuff or declare dead vars
-        auto isDead = [&, liveOut](const string& varN) -> bool
+        auto isDead = [&, liveOut](Symbols::Id varN) -> bool
         {
             return liveOut.find(varN) == liveOut.end() && genSet.find(varN) == genSet.end();
         };
 
         for (auto& ac : node->getInstrs())
         {
-            std::string name;
+            Symbols::Id name;
 
             switch (ac->getType())
             {
                 case CommandType::NONDET:
                 {
                     auto ndc = static_cast<NondetCommand*>(ac.get());
-                    if (ndc->holding) name = ac->getVarWrapper()->getBaseName();
-                    else name = ndc->getString();
+                    if (ndc->holding) name = ac->getVarWrapper()->getBaseId();
+                    else name = ndc->getArray();
                     break;
                 }
                 case CommandType::ASSIGNVAR:
                 case CommandType::EXPR:
                 case CommandType::INPUTVAR:
                 {
-                    name = ac->getVarWrapper()->getBaseName();
+                    name = ac->getVarWrapper()->getBaseId();
                     break;
                 }
 
                 case CommandType::DECLAREVAR:
                 {
                     DeclareCommand *dvc = static_cast<DeclareVarCommand *>(ac.get());
-                    name = dvc->getBaseName();
+                    name = dvc->getBaseId();
                     break;
                 }
                 default:
@@ -298,7 +300,7 @@ void LiveVariableDataFlow::finish()
 
             else
             {
-                if (ac->getType() == CommandType::POP && isDead(ac->getVarWrapper()->getBaseName()))
+                if (ac->getType() == CommandType::POP && isDead(ac->getVarWrapper()->getBaseId()))
                 {
                     PopCommand* pc = static_cast<PopCommand*>(ac.get());
                     pc->clear();
@@ -11,8 +11,10 @@
 
 namespace DataFlow
 {
-    std::vector<CFGNode*> getSuccessorNodes(CFGNode* node);
-    std::vector<CFGNode*> getPredecessorNodes(CFGNode* node);
+    typedef ControlFlowGraph::Adjacency Adjacency;
+
+    NodeSpan getSuccessorNodes(const Adjacency& adjacency, CFGNode* node);
+    NodeSpan getPredecessorNodes(const Adjacency& adjacency, CFGNode* node);
 
 
     //as Ts are put in ordered sets they must have comparison stuff
@@ -60,14 +62,15 @@ namespace DataFlow
         return intersect;
     }
 
+    //out sets are indexed by node id
     template<typename T>
-    std::set<T> intersectPredecessors(CFGNode* node, std::unordered_map<std::string, std::set<T>>& outSets)
+    std::set<T> intersectPredecessors(CFGNode* node, const Adjacency& adjacency, std::vector<std::set<T>>& outSets)
     {
         std::vector <std::set<T>*> predSets; //by reference!
 
-        for (const auto& pair : node->getPredecessorMap())
+        for (CFGNode* pred : adjacency.predecessors(node))
         {
-            std::set<T>& parentOut = outSets[pair.first];
+            std::set<T>& parentOut = outSets[pred->getId()];
             if (!parentOut.empty()) predSets.push_back(&parentOut);
             else return std::set<T>();
         }
@@ -77,40 +80,41 @@ namespace DataFlow
     }
 
     template<typename T>
-    std::set<T> unionPredecessors(CFGNode* node, std::unordered_map <std::string, std::set<T>>& outSets)
+    std::set<T> unionPredecessors(CFGNode* node, const Adjacency& adjacency, std::vector<std::set<T>>& outSets)
     {
         std::set<T> join;
-        for (const auto& pair : node->getPredecessorMap())
+        for (CFGNode* pred : adjacency.predecessors(node))
         {
-            for (const T& goingIn: outSets[pair.first]) join.insert(goingIn);
+            for (const T& goingIn: outSets[pred->getId()]) join.insert(goingIn);
         }
         return join;
     }
 
     template<typename T>
-    std::vector<std::set<T>*> getSuccessorOutSets(CFGNode* node, std::unordered_map<std::string, std::set<T>>& outSets)
+    std::vector<std::set<T>*> getSuccessorOutSets(CFGNode* node, const Adjacency& adjacency,
+                                                  std::vector<std::set<T>>& outSets)
     {
         std::vector <std::set<T>*> succSets;
-        for (const auto& successor : getSuccessorNodes(node))
+        for (CFGNode* successor : adjacency.successors(node))
         {
-            if (!outSets[successor->getName()].empty()) succSets.push_back(&outSets[successor->getName()]);
+            if (!outSets[successor->getId()].empty()) succSets.push_back(&outSets[successor->getId()]);
         }
         return succSets;
     }
 
     template<typename T>
-    std::set<T> intersectSuccessors(CFGNode* node, std::unordered_map <std::string, std::set<T>>& outSets)
+    std::set<T> intersectSuccessors(CFGNode* node, const Adjacency& adjacency, std::vector<std::set<T>>& outSets)
     {
-        std::vector <std::set<T>*> succSets = getSuccessorOutSets(node, outSets);
+        std::vector <std::set<T>*> succSets = getSuccessorOutSets(node, adjacency, outSets);
         if (succSets.empty()) return std::set<T>(); //return empty std::set
         else return intersectSets(succSets);
     }
 
     template<typename T>
-    std::set<T> unionSuccessors(CFGNode* node, std::unordered_map<std::string, std::set<T>>& outSets)
+    std::set<T> unionSuccessors(CFGNode* node, const Adjacency& adjacency, std::vector<std::set<T>>& outSets)
     {
         std::set<T> join;
-        for (const auto& outSet : getSuccessorOutSets(node, outSets))
+        for (const auto& outSet : getSuccessorOutSets(node, adjacency, outSets))
         {
             for (const T& goingIn: *outSet) join.insert(goingIn);
         }
@@ -118,25 +122,28 @@ namespace DataFlow
     }
 
     template<typename T,
-            std::set<T>(*in)(CFGNode* , std::unordered_map<std::string, std::set<T>>&),
-            std::vector<CFGNode*> (*nextNodes) (CFGNode*)>
+            std::set<T>(*in)(CFGNode* , const Adjacency&, std::vector<std::set<T>>&),
+            NodeSpan (*nextNodes) (const Adjacency&, CFGNode*)>
     class AbstractDataFlow
     {
     protected:
-        std::unordered_map<std::string, std::set<T>> outSets;
+        std::vector<std::set<T>> outSets; //by node id
         std::vector<CFGNode*> nodes;
         ControlFlowGraph& cfg;
+        Adjacency adjacency;
         SymbolTable& symbolTable;
         bool checkNodes; //used if we are only doing data flow on a part of the graph
     public:
         AbstractDataFlow(ControlFlowGraph& controlFlowGraph, SymbolTable& st)
-                :symbolTable(st), cfg(controlFlowGraph), checkNodes(false)
+                :symbolTable(st), cfg(controlFlowGraph), adjacency(controlFlowGraph), checkNodes(false),
+                 outSets(controlFlowGraph.getNodeIdBound())
         {
             for (const auto& pair : cfg.getCurrentNodes()) nodes.push_back(pair.second.get());
         };
 
         AbstractDataFlow(std::vector<CFGNode*> nodeList, ControlFlowGraph& controlFlowGraph, SymbolTable& st)
-                :symbolTable(st), checkNodes(true), nodes(move(nodeList)), cfg(controlFlowGraph) {};
+                :symbolTable(st), checkNodes(true), nodes(move(nodeList)), cfg(controlFlowGraph),
+                 adjacency(controlFlowGraph), outSets(controlFlowGraph.getNodeIdBound()) {};
 
         void worklist()
         {
@@ -146,12 +153,12 @@ namespace DataFlow
             {
                 CFGNode* top = list.top();
                 list.pop();
-                std::set<T> inSet = in(top, outSets);
+                std::set<T> inSet = in(top, adjacency, outSets);
                 transfer(inSet, top);
-                if (outSets[top->getName()] != inSet) //inSet has been transferred to new outset
+                if (outSets[top->getId()] != inSet) //inSet has been transferred to new outset
                 {
-                    outSets[top->getName()] = move(inSet);
-                    for (CFGNode* nextNode : nextNodes(top)) list.push(nextNode);
+                    outSets[top->getId()] = move(inSet);
+                    for (CFGNode* nextNode : nextNodes(adjacency, top)) list.push(nextNode);
                 }
             }
             finish();
@@ -163,10 +170,10 @@ namespace DataFlow
 
     struct Assignment
     {
-        std::string lhs;
+        Symbols::Id lhs;
         Atom rhs;
 
-        Assignment(std::string l, Atom r) : lhs(move(l)), rhs(std::move(r))
+        Assignment(Symbols::Id l, Atom r) : lhs(l), rhs(std::move(r))
         {}
 
         bool operator<(const Assignment& right) const
@@ -185,8 +192,8 @@ namespace DataFlow
                                                                   DataFlow::getSuccessorNodes>
     {
     private:
-        std::unordered_map<std::string, std::set<Assignment>> genSets;
-        std::unordered_map<std::string, std::set<std::string>> killSets;
+        std::vector<std::set<Assignment>> genSets;
+        std::vector<std::set<Symbols::Id>> killSets;
     public:
         AssignmentPropogationDataFlow(ControlFlowGraph& cfg, SymbolTable& st);
 
@@ -194,19 +201,19 @@ namespace DataFlow
         void finish() override;
     };
 
-    class LiveVariableDataFlow : public AbstractDataFlow<std::string,
-                                                         DataFlow::unionSuccessors<std::string>,
+    class LiveVariableDataFlow : public AbstractDataFlow<Symbols::Id,
+                                                         DataFlow::unionSuccessors<Symbols::Id>,
                                                          DataFlow::getPredecessorNodes>
     {
     private:
-        std::set<std::string> usedVars;
-        std::unordered_map<std::string, std::set<std::string>> UEVars;
-        std::unordered_map<std::string, std::set<std::string>> genSets;
-        std::unordered_map<std::string, std::set<std::string>> killSets;
+        std::set<Symbols::Id> usedVars;
+        std::vector<std::set<Symbols::Id>> UEVars;
+        std::vector<std::set<Symbols::Id>> genSets;
+        std::vector<std::set<Symbols::Id>> killSets;
     public:
         LiveVariableDataFlow(ControlFlowGraph& cfg, SymbolTable& st);
 
-        void transfer(std::set<std::string>& in, CFGNode* node) override;
+        void transfer(std::set<Symbols::Id>& in, CFGNode* node) override;
 
         void finish() override;
     };
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <unordered_map>
+
+#include "Layout.h"
+#include "../Command.h"
+
+using namespace std;
+
+namespace
+{
+    struct LayoutEdge
+    {
+        unsigned long to;
+        unsigned int weight;
+    };
+
+    const unsigned int fallThroughWeight = 4;
+    const unsigned int jumpWeight = 2;
+    const unsigned int loopWeight = 16;
+
+    //the jumps as the runtime will see them - in the order they're written, the closing jump counting most
+    vector<vector<LayoutEdge>> findEdges(const vector<CFGNode*>& nodes)
+    {
+        unordered_map<string, unsigned long> numbers;
+        for (unsigned long i = 0; i < nodes.size(); ++i) numbers[nodes[i]->getName()] = i;
+        auto number = [&] (const string& name)
+        {
+            auto it = numbers.find(name);
+            if (it == numbers.end()) throw runtime_error("Jump to unknown node '" + name + "'");
+            return it->second;
+        };
+
+        vector<vector<LayoutEdge>> successors(nodes.size());
+        for (unsigned long i = 0; i < nodes.size(); ++i)
+        {
+            for (auto& ac : nodes[i]->getInstrs())
+            {
+                if (ac->getType() == CommandType::SWITCH)
+                {
+                    for (auto& c : static_cast<SwitchCommand*>(ac.get())->cases)
+                    {
+                        successors[i].push_back({number(c.second), jumpWeight});
+                    }
+                }
+                else if (ac->getType() == CommandType::PUSH && static_cast<PushCommand*>(ac.get())->pushesState())
+                {
+                    successors[i].push_back({number(ac->getString()), jumpWeight});
+                }
+            }
+            if (nodes[i]->getCompSuccess() != nullptr)
+            {
+                successors[i].push_back({number(nodes[i]->getCompSuccess()->getName()), jumpWeight});
+            }
+            if (nodes[i]->getCompFail() != nullptr)
+            {
+                successors[i].push_back({number(nodes[i]->getCompFail()->getName()), fallThroughWeight});
+            }
+        }
+        return successors;
+    }
+
+    vector<long> findComponents(const vector<vector<LayoutEdge>>& successors)
+    {
+        unsigned long n = successors.size();
+        vector<long> component(n, -1), index(n, -1), low(n, 0);
+        vector<unsigned long> stack, path;
+        vector<unsigned long> nextEdge(n, 0);
+        long nextIndex = 0, components = 0;
+
+        for (unsigned long root = 0; root < n; ++root)
+        {
+            if (index[root] != -1) continue;
+            path.push_back(root);
+            while (!path.empty())
+            {
+                unsigned long v = path.back();
+                if (index[v] == -1)
+                {
+                    index[v] = low[v] = nextIndex++;
+                    stack.push_back(v);
+                }
+                if (nextEdge[v] < successors[v].size())
+                {
+                    unsigned long w = successors[v][nextEdge[v]++].to;
+                    if (index[w] == -1) path.push_back(w);
+                    else if (component[w] == -1) low[v] = min(low[v], index[w]);
+                    continue;
+                }
+
+                path.pop_back();
+                if (!path.empty()) low[path.back()] = min(low[path.back()], low[v]);
+                if (low[v] == index[v])
+                {
+                    unsigned long w;
+                    do
+                    {
+                        w = stack.back();
+                        stack.pop_back();
+                        component[w] = components;
+                    } while (w != v);
+                    components++;
+                }
+            }
+        }
+        return component;
+    }
+}
+
+vector<CFGNode*> layoutNodes(ControlFlowGraph& controlFlowGraph)
+{
+    vector<CFGNode*> nodes;
+    if (controlFlowGraph.getFirst() == nullptr) return nodes;
+    nodes.push_back(controlFlowGraph.getFirst());
+    for (auto& it : controlFlowGraph.getCurrentNodes())
+    {
+        if (it.second.get() != controlFlowGraph.getFirst()) nodes.push_back(it.second.get());
+    }
+    sort(nodes.begin() + 1, nodes.end(), [] (CFGNode* a, CFGNode* b) {return a->getName() < b->getName();});
+    auto name = [&] (unsigned long v) -> const string& {return nodes[v]->getName();};
+
+    unsigned long n = nodes.size();
+    vector<vector<LayoutEdge>> successors = findEdges(nodes);
+    vector<long> component = findComponents(successors);
+
+    struct WeightedEdge
+    {
+        unsigned long from, to;
+        unsigned int weight;
+    };
+    vector<WeightedEdge> edges;
+    for (unsigned long v = 0; v < n; ++v)
+    {
+        for (const LayoutEdge& e : successors[v])
+        {
+            if (e.to == v) continue;
+            edges.push_back({v, e.to, component[v] == component[e.to] ? e.weight * loopWeight : e.weight});
+        }
+    }
+    stable_sort(edges.begin(), edges.end(), [&] (const WeightedEdge& a, const WeightedEdge& b)
+    {
+        if (a.weight != b.weight) return a.weight > b.weight;
+        if (a.from != b.from) return name(a.from) < name(b.from);
+        return name(a.to) < name(b.to);
+    });
+
+    //chains of nodes joined by an edge from the end of one to the start of another, never in front of the first
+    vector<vector<unsigned long>> chains(n);
+    vector<unsigned long> chainOf(n);
+    for (unsigned long v = 0; v < n; ++v)
+    {
+        chains[v].push_back(v);
+        chainOf[v] = v;
+    }
+    for (const WeightedEdge& e : edges)
+    {
+        unsigned long from = chainOf[e.from], to = chainOf[e.to];
+        if (from == to || e.to == 0 || chains[from].back() != e.from || chains[to].front() != e.to) continue;
+        for (unsigned long v : chains[to]) chainOf[v] = from;
+        chains[from].insert(chains[from].end(), chains[to].begin(), chains[to].end());
+        chains[to].clear();
+    }
+
+    //nodes are numbered in name order past the first, so this is also the order of roots for the depth first search
+    vector<unsigned long> reached(n, n);
+    unsigned long order = 0;
+    vector<unsigned long> path;
+    for (unsigned long root = 0; root < n; ++root)
+    {
+        if (reached[root] != n) continue;
+        path.push_back(root);
+        while (!path.empty())
+        {
+            unsigned long v = path.back();
+            path.pop_back();
+            if (reached[v] != n) continue;
+            reached[v] = order++;
+            vector<LayoutEdge> next = successors[v];
+            stable_sort(next.begin(), next.end(), [] (const LayoutEdge& a, const LayoutEdge& b)
+            {
+                return a.weight < b.weight;
+            });
+            for (const LayoutEdge& e : next) if (reached[e.to] == n) path.push_back(e.to);
+        }
+    }
+
+    vector<unsigned long> chainIds;
+    vector<unsigned long> chainReached(n, n);
+    for (unsigned long v = 0; v < n; ++v)
+    {
+        chainReached[chainOf[v]] = min(chainReached[chainOf[v]], reached[v]);
+        if (chainOf[v] == v) chainIds.push_back(v);
+    }
+    stable_sort(chainIds.begin(), chainIds.end(), [&] (unsigned long a, unsigned long b)
+    {
+        return chainReached[a] < chainReached[b];
+    });
+
+    vector<CFGNode*> layout;
+    for (unsigned long id : chainIds) for (unsigned long v : chains[id]) layout.push_back(nodes[v]);
+    return layout;
+}
@@ -0,0 +1,14 @@
+#ifndef PROJECT_LAYOUT_H
+#define PROJECT_LAYOUT_H
+
+#include <vector>
+
+#include "CFG.h"
+
+/*The order nodes are written out in, so states that usually run one after another end up next to each other once
+  loaded. This is the layout the runtime makes with -layout (FSM/StateLayout.cpp) over the same jumps and with the
+  same ties, so it finds the output already laid out. Edges inside loops are weighted up, chains are built greedily from
+  the heaviest edges and placed depth first from the first node, which stays first*/
+std::vector<CFGNode*> layoutNodes(ControlFlowGraph& controlFlowGraph);
+
+#endif
@@ -33,17 +33,19 @@ LengTarj::~LengTarj()
 
 void LengTarj::labelNodes()
 {
+    ControlFlowGraph::Adjacency adjacency(controlFlowGraph);
+    labels.assign(controlFlowGraph.getNodeIdBound(), 0);
     unsigned long n = 0;
     function<void(CFGNode*, unsigned long)> DFS =
-    [this, &DFS, &n](CFGNode* node, unsigned long parent) -> void
+    [this, &DFS, &n, &adjacency](CFGNode* node, unsigned long parent) -> void
     {
         ++n;
-        labels[node] = n;
+        labels[node->getId()] = n;
         semiDomNums[n] = n;
         forestMinimums[n] = n;
         domNums[n] = n; //might cause problems
         verticies[n] = make_unique<NodeWrapper>(node, parent, n);
-        for (CFGNode* succ : node->getSuccessorVector()) if (labels.find(succ) == labels.end()) DFS(succ, labels[node]);
+        for (CFGNode* succ : adjacency.successors(node)) if (labels[succ->getId()] == 0) DFS(succ, labels[node->getId()]);
     };
     DFS(controlFlowGraph.getFirst(), 0);
     numNodes = n;
@@ -52,23 +54,23 @@ void LengTarj::labelNodes()
     for (unsigned long i = 1; i <= numNodes; ++i)
     {
         unique_ptr<NodeWrapper>& wrapperPointer = verticies[i];
-        vector<CFGNode*> predVec = wrapperPointer->node->getPredecessorVector();
-        wrapperPointer->predecessors.reserve(predVec.size());
-        for (auto pred : predVec) if (labels.find(pred) != labels.end())
+        NodeSpan predSpan = adjacency.predecessors(wrapperPointer->node);
+        wrapperPointer->predecessors.reserve(predSpan.size());
+        for (CFGNode* pred : predSpan) if (labels[pred->getId()] != 0)
         {
-            wrapperPointer->predecessors.push_back(labels[pred]);
+            wrapperPointer->predecessors.push_back(labels[pred->getId()]);
         }
 
-        vector<CFGNode*> succVec = wrapperPointer->node->getSuccessorVector();
-        wrapperPointer->successors.reserve(succVec.size());
-        for (auto succ : succVec) if (labels.find(succ) != labels.end())
+        NodeSpan succSpan = adjacency.successors(wrapperPointer->node);
+        wrapperPointer->successors.reserve(succSpan.size());
+        for (CFGNode* succ : succSpan) if (labels[succ->getId()] != 0)
         {
-            if (succ->getName() == wrapperPointer->node->getName())
+            if (succ == wrapperPointer->node)
             {
                 wrapperPointer->selfLoop = true;
                 domNums[i] = semiDomNums[i] = i;
             }
-            wrapperPointer->successors.push_back(labels[succ]);
+            wrapperPointer->successors.push_back(labels[succ->getId()]);
         }
     }
 }
@@ -126,7 +128,7 @@ vector<unique_ptr<Loop>> LengTarj::findNesting(std::vector<unique_ptr<Loop>>& lo
         for (auto pair : loops[i]->getNodes())
         {
             CFGNode* node = pair.first;
-            bitVectors[i][labels[node] - 1] = true;
+            bitVectors[i][labels[node->getId()] - 1] = true;
         }
     }
 
@@ -39,7 +39,7 @@ private:
     //forest stuff
     unsigned long* forestAncestors;
     unsigned long* forestMinimums;
-    std::map<CFGNode*, unsigned long> labels;
+    std::vector<unsigned long> labels; //by node id, zero if the node was not reached
     unsigned long compress(unsigned long node);
     unsigned long eval(unsigned long node);
     std::map<unsigned long, std::vector<unsigned long>> buckets;
@@ -15,7 +15,7 @@
 
 //implemented in LoopValidation.cpp
 
-typedef std::map<std::string, unsigned short int> NodeChangeMap;
+typedef std::map<Symbols::Id, unsigned short int> NodeChangeMap;
 typedef std::map<CFGNode*, NodeChangeMap> ChangeMap;
 typedef std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> SEFPointer;
 
@@ -32,7 +32,7 @@ private:
     const unsigned long domNum;
 
     //returns true if it was a node in the loop on a path to the loop exit
-    bool searchNode(CFGNode* node, ChangeMap& map, std::unordered_map<std::string, std::unique_ptr<SearchResult>>& tags,
+    bool searchNode(CFGNode* node, ChangeMap& map, std::vector<std::unique_ptr<SearchResult>>& tags,
                     SEFPointer sef, bool headerSeen = true);
 
 
@@ -42,7 +42,7 @@ public:
     std::string getInfo(bool nested = false, std::string indent = "|");
     void addChild(std::unique_ptr<Loop> child);
     void setNodeNesting(CFGNode* node, Loop* child);
-    void validate(std::unordered_map<std::string, std::unique_ptr<SearchResult>>& tags);
+    void validate(std::vector<std::unique_ptr<SearchResult>>& tags);
 };
 
 #endif //PROJECT_LOOP_H
@@ -1,8 +1,10 @@
 #include <algorithm>
+#include <set>
 
 #include "Optimiser.h"
 #include "DataFlow.h"
 #include "LengTarj.h"
+#include "../symbolic/VarWrappers.h"
 
 using namespace std;
 
@@ -13,17 +15,18 @@ void diagFunc(ControlFlowGraph& cfg)
     for (auto& node : cfg.getCurrentNodes())
     {
         const auto& nodeName = node.first;
-        for (auto& parent : node.second->getPredecessorMap())
+        for (CFGNode* parent : node.second->getPredecessors())
         {
-            if (find_if(succs[parent.first].begin(), succs[parent.first].end(), [&, nodeName] (const CFGNode* cfgn)
+            const vector<CFGNode*>& parentSuccs = succs[parent->getName()];
+            if (find_if(parentSuccs.begin(), parentSuccs.end(), [&, nodeName] (const CFGNode* cfgn)
             {
                 return cfgn->getName() == nodeName;
-            }) == succs[parent.first].end()) throw runtime_error(nodeName + " claims to be a child of " + parent.first);
+            }) == parentSuccs.end()) throw runtime_error(nodeName + " claims to be a child of " + parent->getName());
         }
 
         for (auto& succ : succs[node.first])
         {
-            if (succ->getPredecessorMap().find(node.first) == succ->getPredecessorMap().end())
+            if (!succ->hasPredecessor(node.second.get()))
             {
                 throw runtime_error(nodeName + " claims to be a parent of " + succ->getName());
             }
@@ -75,16 +78,17 @@ namespace Optimise
                     }
                     else
                     {
-                        for (const auto& parentit : current->getPredecessorMap())
+                        NodeSpan preds = current->getPredecessors();
+                        for (CFGNode* parent : vector<CFGNode*>(preds.begin(), preds.end()))
                         {
-                            if (parentit.first == current->getName())
+                            if (parent == current)
                             {
                                 throw runtime_error("Guaranteed crash around line " + current->getJumpline());
                             }
-                            if (!parentit.second->swallowNode(current)) throw std::runtime_error("should swallow");
+                            if (!parent->swallowNode(current)) throw std::runtime_error("should swallow");
                         }
                         current->prepareToDie();
-                        pair = nodes.erase(pair);
+                        pair = controlFlowGraph.removeNode(pair);
                         changes = true;
                     }
                 }
@@ -96,7 +100,7 @@ namespace Optimise
             {
                 CFGNode* current = pair->second.get();
                 vector<unique_ptr<AbstractCommand>>& instructionList = current->getInstrs();
-                const unordered_map<string, CFGNode*>& preds = current->getPredecessorMap();
+                NodeSpan preds = current->getPredecessors();
 
                 if (current->getName() == controlFlowGraph.getFirst()->getName())
                 {
@@ -109,7 +113,7 @@ namespace Optimise
                     if (preds.size() != 1) ++pair;
                     else
                     {
-                        CFGNode* pred = preds.cbegin()->second;
+                        CFGNode* pred = preds[0];
                         if (pred->getName() == current->getName()) ++pair;
                         else
                         {
@@ -123,7 +127,7 @@ namespace Optimise
                                 pred->getParentFunction()->setLastNode(pred);
                                 pred->setLast();
                                 current->prepareToDie();
-                                pair = nodes.erase(pair);
+                                pair = controlFlowGraph.removeNode(pair);
                                 changes = true;
                             }
                             else ++pair;
@@ -133,7 +137,7 @@ namespace Optimise
                 }
                 if (preds.size() == 1)
                 {
-                    CFGNode* parent = preds.cbegin()->second;
+                    CFGNode* parent = preds[0];
                     if (parent->swallowNode(current))
                     {
                         current->clearPredecessors();
@@ -143,11 +147,95 @@ namespace Optimise
                 if (current->noPreds())
                 {
                     current->prepareToDie();
-                    pair = nodes.erase(pair);
+                    pair = controlFlowGraph.removeNode(pair);
                     changes = true;
                 }
                 else ++pair;
             }
         }
     }
-}
\ No newline at end of file
+
+    //x = literal, with x a plain variable - returns nullptr if the comparison can't be a switch case
+    static const VarWrapper* switchVariable(const CFGNode* node)
+    {
+        const JumpOnComparisonCommand* jocc = node->getComp();
+        if (jocc == nullptr || node->getCompSuccess() == nullptr || jocc->op != Relations::EQ) return nullptr;
+        if (!jocc->term1.isHolding() || jocc->term2.isHolding()) return nullptr;
+        const VarWrapper* vw = jocc->term1.getVarWrapper();
+        return vw->isCompound() ? nullptr : vw;
+    }
+
+    //whether next only exists to carry on test's chain of comparisons on the same variable
+    static bool continuesChain(CFGNode* test, CFGNode* next)
+    {
+        const VarWrapper* testVar = switchVariable(test);
+        const VarWrapper* nextVar = switchVariable(next);
+        return testVar != nullptr && nextVar != nullptr && test->getCompFail() == next
+               && testVar->getFullId() == nextVar->getFullId()
+               && next->getInstrs().empty() && next->getCompFail() != nullptr
+               && next->getPredecessors().size() == 1 && next->getNumPushingStates() == 0
+               && !next->isLastNode() && !next->isFirstNode();
+    }
+
+    void formSwitches(ControlFlowGraph& controlFlowGraph)
+    {
+        const unsigned int minimumCases = 3; //two jumpifs are as quick as a lookup
+
+        vector<CFGNode*> heads;
+        for (auto& node : controlFlowGraph.getCurrentNodes())
+        {
+            CFGNode* current = node.second.get();
+            if (switchVariable(current) == nullptr) continue;
+            NodeSpan preds = current->getPredecessors();
+            if (preds.size() == 1 && continuesChain(preds[0], current)) continue; //middle of a chain
+            heads.push_back(current);
+        }
+
+        for (CFGNode* head : heads)
+        {
+            vector<CFGNode*> chain = {head};
+            set<string> inChain = {head->getName()};
+            while (continuesChain(chain.back(), chain.back()->getCompFail())
+                   && inChain.insert(chain.back()->getCompFail()->getName()).second)
+            {
+                chain.push_back(chain.back()->getCompFail());
+            }
+            //a case or the default jumping into a node that's about to go means it has to stay
+            while (chain.size() > 1)
+            {
+                auto removed = [&chain] (CFGNode* node)
+                {
+                    return find(chain.begin() + 1, chain.end(), node) != chain.end();
+                };
+                bool reentered = removed(chain.back()->getCompFail());
+                for (CFGNode* link : chain) reentered = reentered || removed(link->getCompSuccess());
+                if (!reentered) break;
+                chain.pop_back();
+            }
+            if (chain.size() < minimumCases) continue;
+
+            vector<pair<double, string>> cases;
+            set<double> seen;
+            for (CFGNode* link : chain)
+            {
+                double key = link->getComp()->term2.getLiteral();
+                if (!seen.insert(key).second) continue; //the first comparison wins
+                cases.emplace_back(key, link->getCompSuccess()->getName());
+                link->getCompSuccess()->addParent(head);
+            }
+
+            CFGNode* defaultNode = chain.back()->getCompFail();
+            const VarWrapper* switchOn = head->getComp()->term1.getVarWrapper();
+            int line = head->getComp()->getLineNum();
+
+            for (unsigned int i = 1; i < chain.size(); ++i)
+            {
+                chain[i]->prepareToDie();
+                controlFlowGraph.removeNode(chain[i]->getName());
+            }
+            head->setCompSuccess(nullptr);
+            head->getInstrs().push_back(make_unique<SwitchCommand>(move(switchOn), move(cases), line));
+            head->setCompFail(defaultNode);
+        }
+    }
+}
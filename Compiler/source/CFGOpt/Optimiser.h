@@ -9,6 +9,8 @@ namespace Optimise
 {
     void optimise(SymbolTable& symbolTable, FunctionTable& functionTable, ControlFlowGraph& controlFlowGraph);
     void collapseSmallStates(ControlFlowGraph& controlFlowGraph, FunctionTable& functionTable);
+    //replaces chains of "jumpif x = c" nodes with one switch - the runtime can't reason about these, so this is last
+    void formSwitches(ControlFlowGraph& controlFlowGraph);
 };
 
 
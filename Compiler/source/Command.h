@@ -2,45 +2,45 @@
 #define COMMAND_H
 
 #include <memory>
+#include <vector>
 
 #include "compile/Token.h"
+#include "compile/Symbols.h"
+#include "compile/Arena.h"
 
 class VarWrapper;
 namespace SymbolicExecution {class SymbolicExecutionFringe;}; //symbolic/SymbolicExecution.cpp
 
-enum class CommandType{JUMP, CONDJUMP, RETURN, DECLAREVAR, PUSH, POP, ASSIGNVAR, EXPR, PRINT, INPUTVAR, NONDET};
+enum class CommandType{JUMP, CONDJUMP, RETURN, DECLAREVAR, PUSH, POP, ASSIGNVAR, EXPR, PRINT, INPUTVAR, NONDET, SWITCH};
 
 enum class StringType{ID, DOUBLELIT};
 StringType getStringType(const std::string& str);
 
+//a literal or a variable - the variable's wrapper is shared (see VarWrappers.h), so atoms are cheap to copy
 class Atom
 {
 private:
     double d;
-    std::unique_ptr<VarWrapper> vptr;
+    const VarWrapper* vptr = nullptr;
     bool holding;
     StringType type;
 
 public:
     Atom();
-    ~Atom();
     explicit Atom(double d);
-    explicit Atom(std::unique_ptr<VarWrapper>);
-    Atom(const Atom& o);
-    Atom(Atom&& o);
-    Atom& operator=(const Atom& o);
-    Atom& operator=(Atom&& o);
+    explicit Atom(const VarWrapper*);
     bool isHolding() const;
     StringType getType() const; //todo replace this w/ isHolding
     double getLiteral() const;
-    VarWrapper* getVarWrapper() const;
+    const VarWrapper* getVarWrapper() const;
     void swap(Atom& a);
     void become(const Atom& a);
     void set(double sptr);
-    void set(std::unique_ptr<VarWrapper> sptr);
+    void set(const VarWrapper* sptr);
     operator std::string() const;
     //used to put assignments in maps in dataflow
     bool operator<(const Atom& right) const;
+    //the same variable is the same wrapper
     bool operator==(const Atom& right) const;
 };
 
@@ -63,6 +63,10 @@ public:
     virtual ~AbstractCommand() {}
     virtual std::unique_ptr<AbstractCommand> clone() = 0;
 
+    //in the current compilation's arena
+    static void* operator new(size_t size) {return Arena::allocateObject(size);}
+    static void operator delete(void* command) {Arena::releaseObject(command);}
+
     //returns true if the symbolic execution of this command went through
     virtual bool acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> sef, bool repeat = false);
 
@@ -70,8 +74,8 @@ public:
     virtual void setString(const std::string& data) {throw std::runtime_error("no state");}
     virtual Atom& getAtom() {throw std::runtime_error("no atom");}
     virtual void setAtom(Atom data) {throw std::runtime_error("no atom");}
-    virtual const std::unique_ptr<VarWrapper>& getVarWrapper() const {throw std::runtime_error("doesn't set var");}
-    virtual void setVarWrapper(std::unique_ptr<VarWrapper> sd) {throw std::runtime_error("doesn't set var");}
+    virtual const VarWrapper* getVarWrapper() const {throw std::runtime_error("doesn't set var");}
+    virtual void setVarWrapper(const VarWrapper* sd) {throw std::runtime_error("doesn't set var");}
 
     CommandType getType() const
     {
@@ -109,13 +113,13 @@ public:
 class WrapperHoldingCommand : public AbstractCommand
 {
 protected:
-    std::unique_ptr<VarWrapper> vs;
+    const VarWrapper* vs;
 public:
-    WrapperHoldingCommand(std::unique_ptr<VarWrapper> VarWrapper, int linenum);
+    WrapperHoldingCommand(const VarWrapper* VarWrapper, int linenum);
     virtual ~WrapperHoldingCommand();
 
-    const std::unique_ptr<VarWrapper>& getVarWrapper() const override {return vs;}
-    void setVarWrapper(std::unique_ptr<VarWrapper> nvs) override;
+    const VarWrapper* getVarWrapper() const override {return vs;}
+    void setVarWrapper(const VarWrapper* nvs) override;
 };
 
 class PrintAtomCommand: public AtomHoldingCommand
@@ -188,10 +192,10 @@ public:
 
     Relations::Relop op;
 
-    JumpOnComparisonCommand(const std::string& st, std::unique_ptr<VarWrapper> t1,
-                            std::unique_ptr<VarWrapper> t2, Relations::Relop o, int linenum);
+    JumpOnComparisonCommand(const std::string& st, const VarWrapper* t1,
+                            const VarWrapper* t2, Relations::Relop o, int linenum);
 
-    JumpOnComparisonCommand(const std::string& st, std::unique_ptr<VarWrapper> t1,
+    JumpOnComparisonCommand(const std::string& st, const VarWrapper* t1,
                             double t2, Relations::Relop o, int linenum);
 
     JumpOnComparisonCommand(const JumpOnComparisonCommand& jocc);
@@ -230,7 +234,7 @@ public:
 class InputVarCommand: public WrapperHoldingCommand
 {
 public:
-    InputVarCommand(std::unique_ptr<VarWrapper> into, int linenum);
+    InputVarCommand(const VarWrapper* into, int linenum);
     std::string translation(const std::string& delim) const override;
     std::unique_ptr<AbstractCommand> clone() override;
     bool acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> sef, bool repeat) override;
@@ -289,7 +293,7 @@ public:
 class PopCommand: public WrapperHoldingCommand
 {
 public:
-    PopCommand(std::unique_ptr<VarWrapper> into, int linenum);
+    PopCommand(const VarWrapper* into, int linenum);
     void clear();
     std::unique_ptr<AbstractCommand> clone() override;
     bool isEmpty() const {return vs == nullptr;}
@@ -301,15 +305,15 @@ class AssignVarCommand: public AbstractCommand
 {
 private:
     Atom atom;
-    std::unique_ptr<VarWrapper> vs;
+    const VarWrapper* vs;
 
 public:
-    AssignVarCommand(std::unique_ptr<VarWrapper> lh, Atom at, int linenum);
-    AssignVarCommand(std::unique_ptr<VarWrapper> lh, std::unique_ptr<VarWrapper> rh, int linenum);
+    AssignVarCommand(const VarWrapper* lh, Atom at, int linenum);
+    AssignVarCommand(const VarWrapper* lh, const VarWrapper* rh, int linenum);
     Atom& getAtom() override {return atom;}
     void setAtom(Atom data) override {atom = std::move(data);}
-    const std::unique_ptr<VarWrapper>& getVarWrapper() const override {return vs;}
-    void setVarWrapper(std::unique_ptr<VarWrapper> sd) override;
+    const VarWrapper* getVarWrapper() const override {return vs;}
+    void setVarWrapper(const VarWrapper* sd) override;
     std::unique_ptr<AbstractCommand> clone() override;
     std::string translation(const std::string& delim) const override;
     bool acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> sef, bool repeat) override;
@@ -323,7 +327,7 @@ public:
 
     ArithOp op;
 
-    EvaluateExprCommand(std::unique_ptr<VarWrapper> lh, Atom t1, ArithOp o, Atom t2, int linenum);
+    EvaluateExprCommand(const VarWrapper* lh, Atom t1, ArithOp o, Atom t2, int linenum);
     EvaluateExprCommand(const EvaluateExprCommand& o);
     EvaluateExprCommand(EvaluateExprCommand&& o) = delete;
     EvaluateExprCommand& operator=(EvaluateExprCommand& o) = delete;
@@ -343,16 +347,17 @@ public:
     {
         setType(CommandType::DECLAREVAR);
     }
-    virtual const std::string& getBaseName() const = 0;
+    virtual Symbols::Id getBaseId() const = 0;
+    const std::string& getBaseName() const {return Symbols::name(getBaseId());}
 };
 
 class DeclareVarCommand: public DeclareCommand
 {
 private:
-    std::string name;
+    Symbols::Id name;
 public:
-    DeclareVarCommand(std::string n, int linenum)
-            :DeclareCommand(DeclareType::VAR, linenum), name(move(n))
+    DeclareVarCommand(Symbols::Id n, int linenum)
+            :DeclareCommand(DeclareType::VAR, linenum), name(n)
     {}
 
     std::unique_ptr<AbstractCommand> clone() override
@@ -362,10 +367,10 @@ public:
 
     std::string translation(const std::string& delim) const override
     {
-        return "double " + name + ";" + delim;
+        return "double " + getBaseName() + ";" + delim;
     }
 
-    const std::string& getBaseName() const override {return name;}
+    Symbols::Id getBaseId() const override {return name;}
 
     bool acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> sef, bool repeat) override;
 };
@@ -373,12 +378,12 @@ public:
 class DeclareArrayCommand: public DeclareCommand
 {
 private:
-    std::string name;
+    Symbols::Id name;
 public:
     const unsigned long size;
 
-    DeclareArrayCommand(std::string n, const unsigned long& s, int linenum):
-            DeclareCommand(DeclareType::ARRAY, linenum), name(move(n)), size(s)
+    DeclareArrayCommand(Symbols::Id n, const unsigned long& s, int linenum):
+            DeclareCommand(DeclareType::ARRAY, linenum), name(n), size(s)
     {
         if (size == 0) throw std::runtime_error("arrays have size >0");
     }
@@ -390,10 +395,10 @@ public:
 
     std::string translation(const std::string& delim) const override
     {
-        return "double[" + std::to_string(size) + "] " + name + ";" + delim;
+        return "double[" + std::to_string(size) + "] " + getBaseName() + ";" + delim;
     }
 
-    const std::string& getBaseName() const override {return name;}
+    Symbols::Id getBaseId() const override {return name;}
 
     bool acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> sef, bool repeat) override;
 };
@@ -402,37 +407,52 @@ class NondetCommand : public AbstractCommand
 {
     union
     {
-        std::string s;
-        std::unique_ptr<VarWrapper> varWrapper;
+        Symbols::Id array;
+        const VarWrapper* varWrapper;
     };
 public:
     const bool holding;
 
-    NondetCommand(std::unique_ptr<VarWrapper> vw, int linenum);
+    NondetCommand(const VarWrapper* vw, int linenum);
 
-    NondetCommand(std::string stringie, int linenum):
-            AbstractCommand(linenum), s(move(stringie)), holding(false)
+    NondetCommand(Symbols::Id wholeArray, int linenum):
+            AbstractCommand(linenum), array(wholeArray), holding(false)
     {setType(CommandType::NONDET);}
 
-    ~NondetCommand();
-
     std::unique_ptr<AbstractCommand> clone() override;
     std::string translation(const std::string& delim) const override;
     bool acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> sef, bool repeat) override;
 
-    const std::unique_ptr<VarWrapper>& getVarWrapper() const override
+    const VarWrapper* getVarWrapper() const override
     {
         if (!holding) throw std::runtime_error("i fall ovre");
         return varWrapper;
     }
 
     const std::string& getString() const override
+    {
+        return Symbols::name(getArray());
+    }
+
+    Symbols::Id getArray() const
     {
         if (holding) throw std::runtime_error("nondet-ing var");
-        return s;
+        return array;
     }
 
-    void setVarWrapper(std::unique_ptr<VarWrapper> sd) override;
+    void setVarWrapper(const VarWrapper* sd) override;
+};
+
+
+//made from chains of equality jumps on one variable by Optimise::formSwitches, falls through if nothing matches
+class SwitchCommand: public WrapperHoldingCommand
+{
+public:
+    std::vector<std::pair<double, std::string>> cases;
+
+    SwitchCommand(const VarWrapper* on, std::vector<std::pair<double, std::string>> c, int linenum);
+    std::unique_ptr<AbstractCommand> clone() override;
+    std::string translation(const std::string& delim) const override;
 };
 
 
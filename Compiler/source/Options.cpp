@@ -0,0 +1,117 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "Options.h"
+#include "compile/CompileCache.h"
+
+using namespace std;
+
+void doHelp(ostream& out)
+{
+    out << "Required parameters:\n";
+    out << "-f : Source code filename\n";
+    out << "Optional parameters:\n";
+    out << "-w : Warning output\n";
+    out << "-o : Produced code output\n";
+    out << "-g b/a: CFG DOT output before/after symbolic execution\n";
+    out << "-nv : Don't attempt verification\n";
+    out << "-no : Don't perform dataflow/state collapsing\n";
+    out << "-nd : Don't remove unreachable code\n";
+    out << "-j <n> : Parse functions on n threads (default: one per core)\n";
+    out << "-a : Report allocation counts (with -t, heap allocations too)\n";
+    out << "-t, --time-report : Report the time, memory and allocations each phase took, and the program's size\n";
+    out << "--time-report-json <file> : The same, as JSON into file\n";
+    out << "--cache : Keep whole-program results on disk, reused when no function has changed\n"
+        << "          (in $XDG_CACHE_HOME/fsm-compiler)\n";
+    out << "--cache-dir <dir> : The same, in dir\n";
+    out << "--cache-size <MB> : Delete the least recently used results once they take more than this (default: "
+        << (CompileCache::defaultMaxBytes >> 20) << ")\n";
+    out << "--no-cache : Always compile from scratch, without reusing or storing a whole-program result\n";
+    out << "--serve : Stay up compiling for ProjectClient on the socket, n compilations at once for -j n\n";
+    out << "--socket <path> : Socket to serve on or connect to (default: $XDG_RUNTIME_DIR/fsm-compiler.sock)\n";
+    out << "ProjectClient takes the same parameters, and -f - for source on standard input - -j is then the threads\n";
+    out << "  one compilation parses on (default: one), with --serve's -j the compilations at once\n";
+}
+
+Options parseOptions(int argc, char* argv[])
+{
+    Options options;
+    int counter = 1;
+
+    while (counter < argc)
+    {
+        if (strcmp(argv[counter], "-h") == 0) options.help = true;
+        else if (strcmp(argv[counter], "-f") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected filename after -f (-h for help)");
+            options.inputfile = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-w") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected filename after -w (-h for help)");
+            options.warningfile = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-o") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected filename after -o (-h for help)");
+            options.outputfile = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-g") == 0)
+        {
+            if (counter >= argc - 2) throw runtime_error("Not enough parrameters given to -g (-h for help)");
+            ++counter;
+            options.graphbefore = strcmp(argv[counter], "b") == 0;
+            ++counter;
+            options.graphfile = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-no") == 0) options.opt = false;
+        else if (strcmp(argv[counter], "-nv") == 0) options.verify = false;
+        else if (strcmp(argv[counter], "-nd") == 0) options.deadcode = false;
+        else if (strcmp(argv[counter], "-a") == 0) options.allocations = true;
+        else if (strcmp(argv[counter], "-t") == 0 || strcmp(argv[counter], "--time-report") == 0)
+        {
+            options.timeReport = true;
+        }
+        else if (strcmp(argv[counter], "--time-report-json") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected filename after --time-report-json (-h for help)");
+            options.timeReportJson = argv[counter];
+        }
+        else if (strcmp(argv[counter], "--no-cache") == 0) options.cache = false;
+        else if (strcmp(argv[counter], "--cache") == 0) options.cacheOnDisk = true;
+        else if (strcmp(argv[counter], "--cache-dir") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected directory after --cache-dir (-h for help)");
+            options.cachedir = argv[counter];
+            options.cacheOnDisk = true;
+        }
+        else if (strcmp(argv[counter], "--cache-size") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected megabytes after --cache-size (-h for help)");
+            options.cacheSize = stoul(argv[counter]);
+            if (options.cacheSize == 0) throw runtime_error("--cache-size must be at least 1 (-h for help)");
+        }
+        else if (strcmp(argv[counter], "--serve") == 0) options.serve = true;
+        else if (strcmp(argv[counter], "--socket") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected path after --socket (-h for help)");
+            options.socket = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-j") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected number of threads after -j (-h for help)");
+            options.threads = stoul(argv[counter]);
+        }
+        ++counter;
+    }
+
+    return options;
+}
@@ -0,0 +1,35 @@
+#ifndef PROJECT_OPTIONS_H
+#define PROJECT_OPTIONS_H
+
+#include <string>
+#include <ostream>
+
+//the command line, shared by the compiler and its client so they take the same one
+struct Options
+{
+    bool help = false;
+    std::string inputfile = ""; //"-" for standard input, with the client
+    std::string warningfile = "";
+    std::string outputfile = "";
+    std::string graphfile = "";
+    bool graphbefore = false;
+    bool verify = true;
+    bool opt = true;
+    bool deadcode = true;
+    unsigned int threads = 0; //0 for one per core
+    bool allocations = false;
+    bool timeReport = false;
+    std::string timeReportJson = "";
+    bool cache = true; //whether results are reused at all - a server's memory of them too
+    bool cacheOnDisk = false;
+    std::string cachedir = "";
+    unsigned long cacheSize = 0; //megabytes, 0 for the default
+    bool serve = false;
+    std::string socket = "";
+};
+
+//throws if they don't make sense, but doesn't insist on an input file
+Options parseOptions(int argc, char* argv[]);
+void doHelp(std::ostream& out);
+
+#endif
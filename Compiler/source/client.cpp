@@ -0,0 +1,138 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Options.h"
+#include "serve/Protocol.h"
+
+using namespace std;
+
+/*Takes the compiler's parameters and gets a compiler running with --serve to do the compiling, writing what comes back
+  where the compiler would have*/
+
+namespace
+{
+    int connectTo(const string& path)
+    {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) throw runtime_error("Socket path '" + path + "' is too long");
+        strcpy(address.sun_path, path.c_str());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, (const sockaddr*) &address, sizeof(address)) != 0)
+        {
+            string reason = strerror(errno);
+            if (fd >= 0) close(fd);
+            throw runtime_error("Could not connect to a compiler on '" + path + "' (" + reason + ")"
+                                + " - start one with --serve");
+        }
+        return fd;
+    }
+
+    void writeFile(const string& filename, const string& contents, const string& what)
+    {
+        ofstream fout(filename);
+        if (!fout.good()) throw runtime_error("Unable to open " + what + " file '" + filename + "'");
+        fout << contents;
+        fout.close();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options = parseOptions(argc, argv);
+    if (argc == 1 || options.help)
+    {
+        doHelp(cout);
+        return 0;
+    }
+
+    if (options.inputfile.empty()) throw runtime_error("No input file (-h for help)");
+
+    Protocol::Request request;
+    request.optimise = options.opt;
+    request.deadcode = options.deadcode;
+    request.verify = options.verify;
+    request.graph = options.graphfile.empty() ? '-' : options.graphbefore ? 'b' : 'a';
+    request.cache = options.cache;
+    request.timeReport = options.timeReport;
+    request.timeReportJson = !options.timeReportJson.empty();
+    request.allocations = options.allocations;
+    request.threads = options.threads;
+    if (options.serve) throw runtime_error("--serve is for the compiler, not ProjectClient (-h for help)");
+    if (options.cacheOnDisk || options.cacheSize != 0)
+    {
+        throw runtime_error("--cache, --cache-dir and --cache-size are the server's - give them to the compiler with "
+                            "--serve (-h for help)");
+    }
+    if (options.inputfile == "-")
+    {
+        ostringstream text;
+        text << cin.rdbuf();
+        request.fromText = true;
+        request.source = text.str();
+    }
+    else
+    {
+        //the server has a working directory of its own
+        char resolved[PATH_MAX];
+        if (realpath(options.inputfile.c_str(), resolved) == nullptr)
+        {
+            throw runtime_error("Could not open filename '" + options.inputfile + "' for lexing.");
+        }
+        request.source = resolved;
+    }
+
+    ofstream fout;
+    if (!options.warningfile.empty())
+    {
+        fout.open(options.warningfile);
+        if (!fout.good())
+        {
+            throw runtime_error("Could not open filename '" + options.warningfile + "' for warning output.");
+        }
+    }
+
+    int connection = connectTo(options.socket.empty() ? Protocol::defaultSocket() : options.socket);
+    Protocol::Response response;
+    bool answered = Protocol::send(connection, request) && Protocol::receive(connection, response);
+    close(connection);
+    if (!answered) throw runtime_error("The compiler serving on the socket didn't answer");
+
+    fout << response.warnings;
+    fout.close();
+    if (!response.graph.empty()) writeFile(options.graphfile, response.graph, "DOT graph output");
+
+    cerr << response.report;
+    if (!response.reportJson.empty()) writeFile(options.timeReportJson, response.reportJson, "time report");
+
+    if (!response.ok)
+    {
+        cerr << response.error << "\n";
+        return 1;
+    }
+
+    if (!options.outputfile.empty())
+    {
+        fstream out(options.outputfile);
+        if (!out.good())
+        {
+            throw runtime_error("Could not open filename '" + options.outputfile + "' for produced output.");
+        }
+        out << response.source;
+        out.close();
+    }
+
+    cout << "Finished\n";
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+
+#include "Arena.h"
+
+using namespace std;
+
+namespace
+{
+    //every allocation is preceded by a header saying where it came from, which keeps the objects aligned
+    const size_t headerSize = alignof(max_align_t);
+    enum Origin : unsigned char {HEAP, ARENA};
+
+    size_t roundUp(size_t size)
+    {
+        return (size + headerSize - 1) & ~(headerSize - 1);
+    }
+
+    atomic<unsigned long> serials{0};
+
+    thread_local Arena* current = nullptr;
+
+    //the block this thread is bumping through, belonging to the arena with this serial
+    struct Cursor
+    {
+        unsigned long serial = 0;
+        char* next = nullptr;
+        char* end = nullptr;
+    };
+    thread_local Cursor cursor;
+}
+
+const size_t Arena::blockSize;
+
+Arena::Scope::Scope(Arena& arena): previous(current)
+{
+    current = &arena;
+}
+
+Arena::Scope::~Scope()
+{
+    current = previous;
+}
+
+Arena::Arena(): serial(++serials) {}
+
+Arena::~Arena() = default;
+
+void* Arena::allocate(size_t size)
+{
+    size_t needed = headerSize + roundUp(size);
+    if (cursor.serial != serial || (size_t) (cursor.end - cursor.next) < needed)
+    {
+        size_t length = max(blockSize, needed);
+        char* block = new char[length];
+        {
+            lock_guard<mutex> guard(blocksLock);
+            blocks.emplace_back(block);
+        }
+        cursor = {serial, block, block + length};
+    }
+
+    char* header = cursor.next;
+    cursor.next += needed;
+    *header = ARENA;
+    objects.fetch_add(1, memory_order_relaxed);
+    bytes.fetch_add(needed, memory_order_relaxed);
+    return header + headerSize;
+}
+
+Arena::Stats Arena::getStats() const
+{
+    Stats stats;
+    stats.objects = objects.load(memory_order_relaxed);
+    stats.bytes = bytes.load(memory_order_relaxed);
+    stats.countingHeap = countingHeap.load(memory_order_relaxed);
+    stats.heapAllocations = heapAllocations.load(memory_order_relaxed);
+    {
+        lock_guard<mutex> guard(blocksLock);
+        stats.blocks = blocks.size();
+    }
+    return stats;
+}
+
+void Arena::countHeap(bool on)
+{
+    countingHeap.store(on, memory_order_relaxed);
+}
+
+void* Arena::allocateObject(size_t size)
+{
+    if (current != nullptr) return current->allocate(size);
+
+    char* header = static_cast<char*>(::operator new(headerSize + size));
+    *header = HEAP;
+    return header + headerSize;
+}
+
+void Arena::releaseObject(void* object)
+{
+    if (object == nullptr) return;
+    char* header = static_cast<char*>(object) - headerSize;
+    if (*header == HEAP) ::operator delete(header);
+}
+
+void Arena::heapAllocated()
+{
+    Arena* arena = current;
+    if (arena != nullptr && arena->countingHeap.load(memory_order_relaxed))
+    {
+        arena->heapAllocations.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+void Arena::printStats(ostream& out, const Stats& stats)
+{
+    out << stats.objects << " objects (" << stats.bytes << " bytes) allocated in " << stats.blocks << " blocks";
+    if (stats.countingHeap) out << ", " << stats.heapAllocations << " heap allocations alongside";
+    out << "\n";
+}
+
+//counts for Arena::countHeap, otherwise what the standard library's does - the other forms all come through these
+void* operator new(size_t size)
+{
+    Arena::heapAllocated();
+    if (size == 0) size = 1;
+    while (true)
+    {
+        void* memory = malloc(size);
+        if (memory != nullptr) return memory;
+        new_handler handler = get_new_handler();
+        if (handler == nullptr) throw bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
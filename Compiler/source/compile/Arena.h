@@ -0,0 +1,73 @@
+#ifndef PROJECT_ARENA_H
+#define PROJECT_ARENA_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+/*A bump allocator owning the memory of one compilation. Commands and graph nodes get it through their
+  class operator new (allocateObject) from the arena current on the allocating thread - see Scope. Deleting one still
+  runs its destructor but the memory only goes back when the arena is destroyed, all at once, so cloning them is a
+  pointer bump and a copy rather than a trip to malloc. Every thread bumps through a block of its own, so the parse
+  threads only take the arena's lock to get a new block. Objects made with no arena current come from the heap as
+  before and go back to it when deleted. With countHeap on, every other heap allocation (through the global operator
+  new) made by a thread with the arena current is counted against it - off, the global operator new only checks*/
+class Arena
+{
+public:
+    struct Stats
+    {
+        uint64_t objects = 0;
+        uint64_t bytes = 0;
+        uint64_t blocks = 0; //the heap allocations actually made
+        bool countingHeap = false;
+        uint64_t heapAllocations = 0; //while countingHeap
+    };
+
+    //makes arena current on this thread until the scope ends
+    class Scope
+    {
+    private:
+        Arena* previous;
+    public:
+        explicit Scope(Arena& arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    Arena();
+    //everything allocated in the arena has to be gone (or never be touched again) by now
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size);
+    Stats getStats() const;
+    void countHeap(bool on);
+
+    //for class operator new/delete
+    static void* allocateObject(size_t size);
+    static void releaseObject(void* object);
+    //for the global operator new
+    static void heapAllocated();
+    //what -a reports
+    static void printStats(std::ostream& out, const Stats& stats);
+
+    static const size_t blockSize = 64 * 1024;
+
+private:
+    const unsigned long serial; //tells the blocks threads hold apart from those of a dead arena at the same address
+    mutable std::mutex blocksLock;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::atomic<uint64_t> objects{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<bool> countingHeap{false};
+    std::atomic<uint64_t> heapAllocations{0};
+};
+
+#endif
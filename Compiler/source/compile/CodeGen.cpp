@@ -2,10 +2,11 @@
 #include "../symbolic/VarWrappers.h"
 
 using namespace std;
-void Compiler::genFunctionCall(FunctionSymbol* fromFS, VariableType expectedType, unique_ptr<VarWrapper> uid)
+void Compiler::genFunctionCall(FunctionSymbol* fromFS, VariableType expectedType, const VarWrapper* uid)
 {
     match(Type::CALL);
     string fid = plainIdent();
+    if (!functionTable.containsFunction(fid)) error("Undefined function '" + fid + "'");
     FunctionSymbol *toFS = functionTable.getFunction(fid);
 
     if (expectedType != ANY && !toFS->isOfType(expectedType))
@@ -15,8 +16,8 @@ void Compiler::genFunctionCall(FunctionSymbol* fromFS, VariableType expectedType
     }
 
     //push all vars
-    const set<VarWrapper*>& fromVars = fromFS->getVars(); //sets are ordered
-    for (auto& s : fromVars) fromFS->genPush(Atom(s->clone()), lookahead.line);
+    const vector<const VarWrapper*>& fromVars = fromFS->getVars();
+    for (auto& s : fromVars) fromFS->genPush(Atom(s), lookahead.line);
 
     string nextState = fromFS->newStateName();
     fromFS->genPush(nextState, lookahead.line, toFS);
@@ -30,16 +31,16 @@ void Compiler::genFunctionCall(FunctionSymbol* fromFS, VariableType expectedType
             if (lookahead.type == Type::NUMBER)
             {
                 paramTypes.push_back(VariableType::DOUBLE);
-                fromFS->genPush(Atom(stod(lookahead.lexemeString)), lookahead.line);
+                fromFS->genPush(Atom(stod(lookahead.lexeme.str())), lookahead.line);
                 match(Type::NUMBER);
             }
             else
             {
                 Identifier* id;
-                unique_ptr<VarWrapper> vg = wrappedIdent(&id);
+                const VarWrapper* vg = wrappedIdent(&id);
                 VariableType type = id->getType();
                 paramTypes.push_back(type == ARRAY ? DOUBLE : type);
-                fromFS->genPush(Atom(move(vg)), lookahead.line);
+                fromFS->genPush(Atom(vg), lookahead.line);
             }
             if (lookahead.type == Type::COMMA)
             {
@@ -59,13 +60,17 @@ void Compiler::genFunctionCall(FunctionSymbol* fromFS, VariableType expectedType
     fromFS->genEndState();
     fromFS->genNewState(nextState);
     CFGNode* created = fromFS->getCurrentNode();
-    toFS->addFunctionCall(finishedState, created, fromVars.size());
+    unsigned long numPushed = fromVars.size();
+    cfg.defer([toFS, finishedState, created, numPushed] () //toFS may be being parsed on another thread
+    {
+        toFS->addFunctionCall(finishedState, created, numPushed);
+        created->addParent(toFS->getLastNode());
+    });
     finishedState->setFunctionCall(toFS);
     created->addFunctionCall(finishedState, toFS);
-    created->addParent(toFS->getLastNode());
 
     //pop all vars back
-    for (auto rit = fromVars.rbegin(); rit != fromVars.rend(); ++rit) fromFS->genPop((*rit)->clone(), lookahead.line);
+    for (auto rit = fromVars.rbegin(); rit != fromVars.rend(); ++rit) fromFS->genPop(*rit, lookahead.line);
 
     if (uid)
     {
@@ -74,7 +79,7 @@ void Compiler::genFunctionCall(FunctionSymbol* fromFS, VariableType expectedType
             throw runtime_error("Trying to assign output of void function '" + toFS->getIdent() + "' into var '"
                                   + uid->getFullName() + "'");
         }
-        fromFS->genAssignment(move(uid), make_unique<SDByName>("retD"), lookahead.line);
+        fromFS->genAssignment(uid, SDByName::get("retD"), lookahead.line);
     }
 }
 
@@ -218,11 +223,11 @@ void Compiler::ands(FunctionSymbol* fs, string success, string fail)
 
 void Compiler::condition(FunctionSymbol* fs, string success, string fail)
 {
-    expression(fs, make_unique<SDByName>("LHS"));
+    expression(fs, SDByName::get("LHS"));
     Relations::Relop r = relop();
-    expression(fs, make_unique<SDByName>("RHS"));
+    expression(fs, SDByName::get("RHS"));
 
-    fs->genConditionalJump(move(success), make_unique<SDByName>("LHS"), r, make_unique<SDByName>("RHS"), lookahead.line);
+    fs->genConditionalJump(move(success), SDByName::get("LHS"), r, SDByName::get("RHS"), lookahead.line);
     fs->genJump(move(fail), lookahead.line);
     fs->genEndState();
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <utime.h>
+#include <unistd.h>
+
+#include "CompileCache.h"
+
+using namespace std;
+
+namespace
+{
+    const char* const magic = "FSMCACHE 2\n";
+    atomic<unsigned long> temporaries{0};
+
+    //mkdir -p
+    bool makeDirectory(const string& directory)
+    {
+        for (size_t slash = directory.find('/', 1); ; slash = directory.find('/', slash + 1))
+        {
+            string prefix = directory.substr(0, slash);
+            if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+            if (slash == string::npos) return true;
+        }
+    }
+
+    //reads a "name length\n" line then length bytes and a newline from at, moving at past them
+    bool readBlob(const string& file, size_t& at, const string& name, string& into)
+    {
+        size_t lineEnd = file.find('\n', at);
+        if (lineEnd == string::npos || file.compare(at, name.size() + 1, name + " ") != 0) return false;
+        string digits = file.substr(at + name.size() + 1, lineEnd - at - name.size() - 1);
+        if (digits.empty() || digits.find_first_not_of("0123456789") != string::npos) return false;
+        unsigned long long length = stoull(digits);
+        at = lineEnd + 1;
+        if (length >= file.size() - at || file[at + length] != '\n') return false;
+        into.assign(file, at, length);
+        at += length + 1;
+        return true;
+    }
+
+    void writeBlob(ostream& out, const string& name, const string& blob)
+    {
+        out << name << " " << blob.size() << "\n" << blob << "\n";
+    }
+}
+
+uint64_t CompileCache::Manifest::key() const
+{
+    uint64_t key = CompileCache::hash(options.data(), options.size());
+    key = CompileCache::hashValue(globals, key);
+    for (const auto& function : functions)
+    {
+        key = CompileCache::hash(function.first.data(), function.first.size(), key);
+        key = CompileCache::hashValue(function.second, key);
+    }
+    return key;
+}
+
+CompileCache::CompileCache(string dir, size_t remember, uint64_t max):
+        directory(move(dir)), stamp(emptyHash), maxBytes(max), remembered(remember)
+{
+    struct stat self;
+    if (stat("/proc/self/exe", &self) == 0)
+    {
+        stamp = hashValue(self.st_ino, stamp);
+        stamp = hashValue(self.st_size, stamp);
+        stamp = hashValue(self.st_mtime, stamp);
+    }
+    if (!directory.empty() && !makeDirectory(directory)) directory.clear();
+}
+
+string CompileCache::defaultDirectory()
+{
+    const char* base = getenv("XDG_CACHE_HOME");
+    if (base != nullptr && *base != '\0') return string(base) + "/fsm-compiler";
+    base = getenv("HOME");
+    if (base != nullptr && *base != '\0') return string(base) + "/.cache/fsm-compiler";
+    return "";
+}
+
+uint64_t CompileCache::hash(const void* data, size_t length, uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i)
+    {
+        seed ^= bytes[i];
+        seed *= 1099511628211ull;
+    }
+    return seed;
+}
+
+string CompileCache::path(const Manifest& manifest) const
+{
+    ostringstream name;
+    name << directory << "/" << hex << manifest.key();
+    return name.str();
+}
+
+string CompileCache::header(const Manifest& manifest) const
+{
+    ostringstream out;
+    out << magic << "stamp " << hex << stamp << "\noptions " << manifest.options << "\nglobals " << manifest.globals
+        << "\nfunctions " << dec << manifest.functions.size() << "\n";
+    for (const auto& function : manifest.functions) out << hex << function.second << " " << function.first << "\n";
+    return out.str();
+}
+
+void CompileCache::remember(uint64_t key, string header, const Entry& entry) const
+{
+    if (remembered == 0) return;
+    lock_guard<mutex> guard(memoryLock);
+    auto it = memory.find(key);
+    if (it != memory.end())
+    {
+        it->second = {move(header), entry};
+        return;
+    }
+    if (memory.size() == remembered)
+    {
+        memory.erase(memoryOrder.front());
+        memoryOrder.pop_front();
+    }
+    memory.emplace(key, make_pair(move(header), entry));
+    memoryOrder.push_back(key);
+}
+
+bool CompileCache::load(const Manifest& manifest, Entry& entry) const
+{
+    string expected = header(manifest);
+    uint64_t key = manifest.key();
+    if (remembered != 0)
+    {
+        lock_guard<mutex> guard(memoryLock);
+        auto it = memory.find(key);
+        if (it != memory.end() && it->second.first == expected)
+        {
+            entry = it->second.second;
+            return true;
+        }
+    }
+
+    if (directory.empty()) return false;
+    const string filePath = path(manifest);
+    ifstream in(filePath, ios::binary);
+    if (!in.good()) return false;
+    ostringstream contents;
+    contents << in.rdbuf();
+    const string file = contents.str();
+
+    if (file.compare(0, expected.size(), expected) != 0) return false;
+    size_t at = expected.size();
+    Entry read;
+    if (!readBlob(file, at, "output", read.output) || !readBlob(file, at, "warnings", read.warnings)
+        || !readBlob(file, at, "graph", read.graph)) return false;
+
+    ostringstream check;
+    check << "check " << hex << hash(file.data(), at) << "\n";
+    if (file.compare(at, string::npos, check.str()) != 0) return false;
+
+    entry = move(read);
+    remember(key, move(expected), entry);
+    utime(filePath.c_str(), nullptr); //used now, so it's the last to be trimmed
+    return true;
+}
+
+void CompileCache::store(const Manifest& manifest, const Entry& entry) const
+{
+    remember(manifest.key(), header(manifest), entry);
+    if (directory.empty()) return;
+    ostringstream out;
+    out << header(manifest);
+    writeBlob(out, "output", entry.output);
+    writeBlob(out, "warnings", entry.warnings);
+    writeBlob(out, "graph", entry.graph);
+    string file = out.str();
+    ostringstream check;
+    check << "check " << hex << hash(file.data(), file.size()) << "\n";
+    file += check.str();
+
+    //written aside then renamed over, so a reader never sees half an entry
+    string target = path(manifest);
+    string temporary = target + ".tmp" + to_string(getpid()) + "." + to_string(temporaries++);
+    {
+        ofstream tmp(temporary, ios::binary | ios::trunc);
+        tmp << file;
+        if (!tmp.good())
+        {
+            tmp.close();
+            unlink(temporary.c_str());
+            return;
+        }
+    }
+    if (rename(temporary.c_str(), target.c_str()) != 0) unlink(temporary.c_str());
+    else trim();
+}
+
+void CompileCache::trim() const
+{
+    lock_guard<mutex> guard(trimLock);
+    DIR* entries = opendir(directory.c_str());
+    if (entries == nullptr) return;
+    struct Stored
+    {
+        string path;
+        uint64_t size;
+        timespec used;
+    };
+    vector<Stored> stored;
+    uint64_t total = 0;
+    while (dirent* entry = readdir(entries))
+    {
+        //only entries, which are named by their key - not temporaries, or anything else that's been put there
+        string name = entry->d_name;
+        if (name.empty() || name.find_first_not_of("0123456789abcdef") != string::npos) continue;
+        struct stat info;
+        string entryPath = directory + "/" + name;
+        if (stat(entryPath.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) continue;
+        stored.push_back({move(entryPath), (uint64_t) info.st_size, info.st_mtim});
+        total += info.st_size;
+    }
+    closedir(entries);
+    if (total <= maxBytes) return;
+
+    sort(stored.begin(), stored.end(), [] (const Stored& a, const Stored& b)
+    {
+        return a.used.tv_sec != b.used.tv_sec ? a.used.tv_sec < b.used.tv_sec : a.used.tv_nsec < b.used.tv_nsec;
+    });
+    for (const Stored& entry : stored)
+    {
+        if (total <= maxBytes) break;
+        if (unlink(entry.path.c_str()) == 0) total -= entry.size;
+    }
+}
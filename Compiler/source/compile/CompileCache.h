@@ -0,0 +1,83 @@
+#ifndef PROJECT_COMPILECACHE_H
+#define PROJECT_COMPILECACHE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+/*A whole-program result cache. Keeps what compiling a source produced - output, warnings and DOT graph - in a
+  directory, a file per compilation, named by a hash of everything that went into it: each function's tokens (their
+  source text, and so its signature and the lines it's on), the global declarations, the options, and the compiler
+  binary. Optimisation and verification work on the whole graph at once, so nothing is reused per function - a result
+  is only reused when every function matches, and a function changing means compiling all of them. An entry is only
+  used if it checks out completely - its checksum, and every hash and name it was stored under - anything else is a
+  miss and gets overwritten. The directory is kept under a size, the entries used least recently going first. A cache
+  that lives across compilations (the server's) can also keep its most recent entries in memory, in front of the
+  directory. Safe to share between threads*/
+class CompileCache
+{
+public:
+    //what a compilation depends on
+    struct Manifest
+    {
+        std::string options;
+        uint64_t globals = 0;
+        std::vector<std::pair<std::string, uint64_t>> functions; //in source order
+
+        uint64_t key() const;
+    };
+
+    struct Entry
+    {
+        std::string output;
+        std::string warnings;
+        std::string graph;
+    };
+
+    static const uint64_t defaultMaxBytes = 64ull << 20;
+
+    //directory is made if it isn't there, and can be empty for memory only
+    explicit CompileCache(std::string directory, size_t remembered = 0, uint64_t maxBytes = defaultMaxBytes);
+
+    //false if there's no valid entry for manifest
+    bool load(const Manifest& manifest, Entry& entry) const;
+    //failing to write the entry isn't an error, the next compile just misses
+    void store(const Manifest& manifest, const Entry& entry) const;
+
+    //$XDG_CACHE_HOME or ~/.cache, empty if neither is set
+    static std::string defaultDirectory();
+
+    //FNV-1a, continuing from seed
+    static const uint64_t emptyHash = 14695981039346656037ull;
+    static uint64_t hash(const void* data, size_t length, uint64_t seed = emptyHash);
+    template<typename T>
+    static uint64_t hashValue(const T& value, uint64_t seed)
+    {
+        return hash(&value, sizeof(T), seed);
+    }
+
+private:
+    std::string directory;
+    uint64_t stamp; //identifies the compiler binary
+    const uint64_t maxBytes; //of entries in the directory
+    mutable std::mutex trimLock;
+    //deletes the least recently used entries until the directory's back under maxBytes
+    void trim() const;
+
+    //the last remembered entries stored or loaded, by key, with the header they were stored under
+    const size_t remembered;
+    mutable std::mutex memoryLock;
+    mutable std::unordered_map<uint64_t, std::pair<std::string, Entry>> memory;
+    mutable std::deque<uint64_t> memoryOrder; //oldest first
+    void remember(uint64_t key, std::string header, const Entry& entry) const;
+
+    std::string path(const Manifest& manifest) const;
+    std::string header(const Manifest& manifest) const;
+};
+
+#endif
@@ -3,6 +3,9 @@
 //
 #include <iostream>
 #include <cstring>
+#include <thread>
+#include <atomic>
+#include <exception>
 
 #include "Compiler.h"
 #include "../CFGOpt/Optimiser.h"
@@ -11,9 +14,20 @@
 
 using namespace std;
 
-Compiler::Compiler(vector<Token>& st, Reporter& r):
-        stream(st), reporter(r), functionTable(*this),
-        cfg(r, functionTable, symbolTable) {}
+Compiler::Compiler(Lexer& l, Reporter& r):
+        ownArena(make_unique<Arena>()), arena(*ownArena), ownSymbols(make_unique<Symbols::Table>()), symbols(*ownSymbols),
+        ownWrappers(make_unique<VarWrapper::Table>()), wrappers(*ownWrappers), lexer(l), reporter(r),
+        ownFunctionTable(make_unique<FunctionTable>(*this)),
+        ownCfg(make_unique<ControlFlowGraph>(r, *ownFunctionTable, symbolTable)),
+        functionTable(*ownFunctionTable), cfg(*ownCfg) {}
+
+Compiler::Compiler(Compiler& owner, Lexer& l, Reporter& r, const FunctionSource& source):
+        arena(owner.arena), symbols(owner.symbols), wrappers(owner.wrappers), lexer(l), reporter(r), symbolTable(owner.symbolTable, source.scopesOpened),
+        functionTable(owner.functionTable), cfg(owner.cfg)
+{
+    lookahead = Token(FUNCTION);
+    lookahead.setLine(source.line);
+}
 
 void Compiler::error(string err)
 {
@@ -34,59 +48,186 @@ string Compiler::quoteString(string &s)
 
 Token Compiler::nextToken()
 {
-    return *(tp++);
+    ++tokensRead;
+    if (tokenHash != nullptr) //lookahead is being consumed, and was the last token lexed
+    {
+        //its text rather than its lexeme, which operators and types don't have
+        Lexeme text = lexer.lastText();
+        *tokenHash = CompileCache::hashValue(lookahead.type, *tokenHash);
+        *tokenHash = CompileCache::hashValue(lookahead.line, *tokenHash);
+        *tokenHash = CompileCache::hash(text.data(), text.size(), *tokenHash);
+    }
+    return lexer.next();
+}
+
+namespace
+{
+    void writeFile(const string& filename, const string& contents, const string& what)
+    {
+        ofstream fout(filename);
+        if (!fout.good()) throw runtime_error("Unable to open " + what + " file '" + filename + "'");
+        fout << contents;
+        fout.close();
+    }
+
+    //stops the reporter recording into something that's going out of scope, however that happens
+    struct Recording
+    {
+        Reporter& reporter;
+        Recording(Reporter& r, string* into): reporter(r) {reporter.record(into);}
+        ~Recording() {reporter.record(nullptr);}
+    };
 }
 
-void Compiler::compile(bool optimise, bool deadcode, bool verify, std::string graphOutput, bool gb, std::string outputfile)
+void Compiler::compile(bool optimise, bool deadcode, bool verify, std::string graphOutput, bool gb, std::string outputfile,
+                       unsigned int threads, const CompileCache* cache)
 {
-    tp = stream.cbegin();
+    Products products;
+    try
+    {
+        compile(optimise, deadcode, verify, !graphOutput.empty(), gb, !outputfile.empty(), products, threads, cache);
+    }
+    catch (...)
+    {
+        //the graph is there to see what went wrong
+        if (!products.graph.empty()) writeFile(graphOutput, products.graph, "DOT graph output");
+        throw;
+    }
+
+    if (!products.graph.empty()) writeFile(graphOutput, products.graph, "DOT graph output");
+    if (!outputfile.empty())
+    {
+        fstream fout(outputfile);
+        if (!fout.good()) throw runtime_error("Could not open filename '" + outputfile + "' for produced output.");
+        fout << products.source;
+        fout.close();
+    }
+}
+
+void Compiler::compile(bool optimise, bool deadcode, bool verify, bool graph, bool gb, bool source, Products& products,
+                       unsigned int threads, const CompileCache* cache)
+{
+    Scope inCompilation(*this);
+    TimeReport::Laps laps(timeReport, arena);
+    string reported;
+    Recording recording(reporter, cache ? &reported : nullptr);
+
+    laps.start("find globals");
+    lexer.rewind();
+    tokensRead = 0;
     findGlobalsAndMakeStates();
-    tp = stream.cbegin();
-    lookahead = nextToken();
-    while (lookahead.type != END) body();
+    if (timeReport) timeReport->count("tokens", tokensRead);
+
+    CompileCache::Manifest manifest;
+    if (cache)
+    {
+        laps.start("cache lookup");
+        manifest.options = string("optimise ") + (optimise ? "1" : "0") + " deadcode " + (deadcode ? "1" : "0")
+                           + " verify " + (verify ? "1" : "0") + " graph " + (!graph ? "-" : gb ? "b" : "a");
+        manifest.globals = globalsHash;
+        for (const FunctionSource& function : functionSources)
+        {
+            manifest.functions.emplace_back(function.name, function.hash);
+        }
+
+        //what the first pass just warned about has to be how the stored warnings start
+        CompileCache::Entry cached;
+        if (cache->load(manifest, cached) && cached.warnings.compare(0, reported.size(), reported) == 0)
+        {
+            reporter.record(nullptr);
+            reporter.addText(cached.warnings.substr(reported.size()));
+            if (verify && graph) products.graph = move(cached.graph);
+            if (source) products.source = move(cached.output);
+            if (timeReport) timeReport->count("cached", 1);
+            return;
+        }
+    }
+
+    laps.start("parse");
+    parseFunctions(threads);
 
     FunctionSymbol* mainFuncSym = functionTable.getFunction("main");
     cfg.setLast(mainFuncSym->getLastNode()->getName());
+    if (timeReport) countGraph("parsed");
 
-    if (optimise) Optimise::optimise(symbolTable, functionTable, cfg);
+    if (optimise)
+    {
+        laps.start("optimise");
+        Optimise::optimise(symbolTable, functionTable, cfg);
+    }
 
     if (verify)
     {
-        if (!graphOutput.empty() && gb)
+        if (graph && gb)
         {
-            ofstream fout(graphOutput);
-            if (!fout.good()) throw runtime_error("Unable to open DOT graph output file '" + graphOutput + "'");
-            fout << cfg.getDotGraph();
-            fout.close();
+            laps.start("DOT graph");
+            products.graph = cfg.getDotGraph();
         }
 
+        laps.start("symbolic execution");
         SymbolicExecution::SymbolicExecutionManager symbolicExecutionManager
                 = SymbolicExecution::SymbolicExecutionManager(cfg, symbolTable, reporter);
-        unordered_map<string, SRPointer>& tags
+        vector<SRPointer>& tags
                 = symbolicExecutionManager.search(deadcode);
+        if (timeReport)
+        {
+            timeReport->count("symbolic visits", symbolicExecutionManager.getStats().visits);
+            timeReport->count("symbolic paths", symbolicExecutionManager.getStats().paths);
+        }
 
-        if (!graphOutput.empty() && !gb)
+        if (graph && !gb)
         {
-            ofstream fout(graphOutput);
-            if (!fout.good()) throw runtime_error("Unable to open DOT graph output file '" + graphOutput + "'");
-            fout << cfg.getDotGraph();
-            fout.close();
+            laps.start("DOT graph");
+            products.graph = cfg.getDotGraph();
         }
 
+        laps.start("find loops");
         vector<unique_ptr<Loop>> loops = LengTarj(cfg).findLoops();
+        if (timeReport) timeReport->count("loops", loops.size());
+        laps.start("validate loops");
         for (auto& loop : loops) loop->validate(tags);
     }
 
-    if (!outputfile.empty())
+    if (optimise)
     {
-        fstream fout(outputfile);
-        if (!fout.good()) throw runtime_error("Could not open filename '" + outputfile + "' for produced output.");
-        fout << cfg.getStructuredSource() << "\n";
-        fout.close();
+        laps.start("form switches");
+        Optimise::formSwitches(cfg);
     }
+
+    laps.start("output");
+    if (timeReport) countGraph("output");
+    if (source || cache) products.source = cfg.getStructuredSource() + "\n";
+
+    if (cache)
+    {
+        reporter.record(nullptr);
+        cache->store(manifest, {products.source, move(reported), products.graph});
+    }
+}
+
+void Compiler::countGraph(const string& when)
+{
+    uint64_t commands = 0;
+    for (auto& pair : cfg.getCurrentNodes())
+    {
+        commands += pair.second->getInstrs().size();
+        if (pair.second->getComp() != nullptr) ++commands;
+    }
+    timeReport->count(when + " nodes", cfg.getCurrentNodes().size());
+    timeReport->count(when + " commands", commands);
+}
+
+void Compiler::setTimeReport(TimeReport* report)
+{
+    timeReport = report;
 }
 
-Identifier* Compiler::findVariable(VarWrapper* vg, VariableType* vtype)
+Arena::Stats Compiler::getArenaStats() const
+{
+    return arena.getStats();
+}
+
+Identifier* Compiler::findVariable(const VarWrapper* vg, VariableType* vtype)
 {
     Identifier* ret = symbolTable.findIdentifier(vg->getBaseName());
     if (ret == nullptr) error("Undeclared variable '" + vg->getBaseName() + "'");
@@ -102,17 +243,21 @@ void Compiler::findGlobalsAndMakeStates()
 
     for (int i = 0; i < NUM_INITIAL; ++i)
     {
-        initialState.push_back(make_unique<DeclareVarCommand>(initialNames[i], -1));
+        initialState.push_back(make_unique<DeclareVarCommand>(Symbols::intern(initialNames[i]), -1));
         symbolTable.declare(DOUBLE, initialNames[i], -1);
     }
 
+    vector<unsigned int> scopesOpened(1, 1);
     lookahead = nextToken();
+    globalsHash = CompileCache::emptyHash;
+    tokenHash = &globalsHash;
     int depth = 0;
     while (lookahead.type != END)
     {
         if (lookahead.type == LBRACE)
         {
             ++depth;
+            SymbolTable::countScope(scopesOpened, depth + 1); //under the function's parameters
             match(LBRACE);
         }
 
@@ -120,6 +265,7 @@ void Compiler::findGlobalsAndMakeStates()
         {
             if (depth-- <= 0) error("Unexpected RBRACE");
             match(RBRACE);
+            if (depth == 0) tokenHash = &globalsHash; //end of a function
         }
 
         else if (depth != 0) lookahead = nextToken();
@@ -127,8 +273,12 @@ void Compiler::findGlobalsAndMakeStates()
         {
             if (lookahead.type == FUNCTION)
             {
+                functionSources.push_back({lexer.tell(), lookahead.line, scopesOpened});
+                tokenHash = &functionSources.back().hash;
+                SymbolTable::countScope(scopesOpened, 1);
                 match(FUNCTION);
-                string id = lookahead.lexemeString;
+                string id = lookahead.lexeme.str();
+                functionSources.back().name = id;
                 match(IDENT);
                 match(LPAREN);
 
@@ -168,11 +318,11 @@ void Compiler::findGlobalsAndMakeStates()
                 Identifier* i = symbolTable.declare(t, id, lookahead.line);
                 if (t == DOUBLE)
                 {
-                    initialState.push_back(make_unique<DeclareVarCommand>(i->getUniqueID(), lookahead.line));
+                    initialState.push_back(make_unique<DeclareVarCommand>(i->getSymbol(), lookahead.line));
                 }
                 else if (t == ARRAY)
                 {
-                    initialState.push_back(make_unique<DeclareArrayCommand>(i->getUniqueID(), size, lookahead.line));
+                    initialState.push_back(make_unique<DeclareArrayCommand>(i->getSymbol(), size, lookahead.line));
                 }
                 else throw runtime_error("Only support DOUBLE and ARRAY");
 
@@ -180,11 +330,11 @@ void Compiler::findGlobalsAndMakeStates()
                 {
                     match(ASSIGN);
                     i->setDefined();
-                    auto iptr = make_unique<SDByName>(i->getUniqueID());
+                    auto iptr = SDByName::get(i->getSymbol());
                     if (t == DOUBLE && lookahead.type == NUMBER)
                     {
                         initialState.push_back(make_unique<AssignVarCommand>
-                                                       (move(iptr), Atom(stod(lookahead.lexemeString)), lookahead.line));
+                                                       (move(iptr), Atom(stod(lookahead.lexeme.str())), lookahead.line));
                         match(NUMBER);
                     }
                     else error("Can only assign double literals in global scope");
@@ -194,6 +344,7 @@ void Compiler::findGlobalsAndMakeStates()
         }
     }
 
+    tokenHash = nullptr;
     if (!functionTable.containsFunction("main")) error("Function 'main' must be defined");
     FunctionSymbol* mainSymbol = functionTable.getFunction("main");
     mainSymbol->addCommands(initialState);
@@ -203,6 +354,56 @@ void Compiler::findGlobalsAndMakeStates()
     mainSymbol->genNewState(nextState);
 }
 
+void Compiler::parseFunctions(unsigned int threads)
+{
+    struct Parsed
+    {
+        stringbuf warnings;
+        ControlFlowGraph::Fragment fragment;
+        exception_ptr failure;
+    };
+    vector<Parsed> parsed(functionSources.size());
+    atomic<size_t> next(0);
+
+    //the thread timing laps has its own CPU time measured, the pool's is added to the report
+    auto parseSome = [&] (bool helping)
+    {
+        double cpu = helping && timeReport != nullptr ? TimeReport::threadCpu() : 0;
+        Scope inCompilation(*this);
+        size_t i;
+        while ((i = next.fetch_add(1)) < functionSources.size())
+        {
+            Parsed& p = parsed[i];
+            cfg.beginFragment(p.fragment);
+            try
+            {
+                Lexer functionLexer(lexer, functionSources[i].start);
+                Reporter warnings(&p.warnings);
+                Compiler(*this, functionLexer, warnings, functionSources[i]).body();
+            }
+            catch (...)
+            {
+                p.failure = current_exception();
+            }
+            cfg.endFragment();
+        }
+        if (helping && timeReport != nullptr) timeReport->addHelperCpu(TimeReport::threadCpu() - cpu);
+    };
+
+    if (threads > functionSources.size()) threads = functionSources.size();
+    vector<thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) pool.emplace_back(parseSome, true);
+    parseSome(false);
+    for (thread& t : pool) t.join();
+
+    for (Parsed& p : parsed)
+    {
+        if (p.failure) rethrow_exception(p.failure);
+        reporter.addText(p.warnings.str());
+        cfg.merge(p.fragment);
+    }
+}
+
 void Compiler::match(Type t)
 {
     if (lookahead.type != t)
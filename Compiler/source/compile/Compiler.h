@@ -3,15 +3,21 @@
 
 #include <unordered_map>
 #include <vector>
+#include <memory>
 
+#include "Arena.h"
 #include "Token.h"
+#include "Lexer.h"
 #include "SymbolTable.h"
 #include "Reporter.h"
 #include "Functions.h"
+#include "CompileCache.h"
+#include "TimeReport.h"
+#include "Symbols.h"
 #include "../CFGOpt/CFG.h"
+#include "../symbolic/VarWrappers.h"
 
 enum class AccessType;
-class VarWrapper;
 
 //Implemented in Compiler.cpp, Parsing.cpp, CodeGen.cpp
 class Compiler
@@ -19,23 +25,84 @@ class Compiler
     friend class ExpressionCodeGenerator;
 
 public:
-    Compiler(std::vector<Token>& st, Reporter& r);
-    void compile(bool optimise, bool deadcode, bool verify, std::string graphOutput, bool gb, std::string sourceout);
+    //tokens are pulled from lexer as they're parsed, in two passes - lexer has to outlive the compiler
+    Compiler(Lexer& lexer, Reporter& r);
+    //what a compilation produced, besides the warnings given to the reporter
+    struct Products
+    {
+        std::string source; //the structured source
+        std::string graph; //DOT
+    };
+
+    /*functions are parsed on up to threads threads at once, with the same result however many. If there's a cache the
+      output, graph and warnings come from it when nothing they depend on has changed, and are stored in it when they
+      don't*/
+    void compile(bool optimise, bool deadcode, bool verify, std::string graphOutput, bool gb, std::string sourceout,
+                 unsigned int threads = 1, const CompileCache* cache = nullptr);
+    /*The same, into products rather than files - the graph (from before symbolic execution if gb) if graph, and the
+      source if source. products is filled in as the compilation goes, so if it throws what's there is what it got to*/
+    void compile(bool optimise, bool deadcode, bool verify, bool graph, bool gb, bool source, Products& products,
+                 unsigned int threads = 1, const CompileCache* cache = nullptr);
+    //what the compilation has allocated in its arena so far
+    Arena::Stats getArenaStats() const;
+    //phases of compilations from now on are timed into report, if it isn't null
+    void setTimeReport(TimeReport* report);
 
 private:
-    std::vector<Token> stream;
-    std::vector<Token>::const_iterator tp;
+    //where a function starts, found by the first pass
+    struct FunctionSource
+    {
+        Lexer::Position start; //just after 'function'
+        unsigned int line;
+        std::vector<unsigned int> scopesOpened; //before it, see SymbolTable
+        std::string name;
+        uint64_t hash = CompileCache::emptyHash; //of its tokens, with their lines
+    };
+
+    //parses the function at source, sharing owner's functions and graph
+    Compiler(Compiler& owner, Lexer& lexer, Reporter& r, const FunctionSource& source);
+
+    //first so they go last, after everything allocated in them or named by them
+    std::unique_ptr<Arena> ownArena; //null for a compiler parsing one function of another's
+    Arena& arena;
+    std::unique_ptr<Symbols::Table> ownSymbols; //likewise
+    Symbols::Table& symbols;
+    std::unique_ptr<VarWrapper::Table> ownWrappers; //likewise
+    VarWrapper::Table& wrappers;
+    //makes the compilation's arena and tables current on this thread
+    struct Scope
+    {
+        Arena::Scope arena;
+        Symbols::Scope symbols;
+        VarWrapper::Scope wrappers;
+        explicit Scope(Compiler& c): arena(c.arena), symbols(c.symbols), wrappers(c.wrappers) {}
+    };
+
+    Lexer& lexer;
     Token lookahead;
     SymbolTable symbolTable;
-    FunctionTable functionTable;
-    ControlFlowGraph cfg;
+    std::unique_ptr<FunctionTable> ownFunctionTable; //null for a compiler parsing one function of another's
+    std::unique_ptr<ControlFlowGraph> ownCfg;
+    FunctionTable& functionTable;
+    ControlFlowGraph& cfg;
     Reporter& reporter;
+    std::vector<FunctionSource> functionSources;
+    uint64_t globalsHash = CompileCache::emptyHash; //of the tokens outside functions
+    uint64_t* tokenHash = nullptr; //where tokens are hashed as they're consumed, if anywhere
+    unsigned long tokensRead = 0;
+    TimeReport* timeReport = nullptr;
 
     void error(std::string);
     void warning(std::string);
     Token nextToken();
+    //the first pass - declares globals and function signatures, skipping over function bodies
     void findGlobalsAndMakeStates();
-    Identifier* findVariable(VarWrapper* varGetter, VariableType* vtype = nullptr); //redundant
+    /*The second - each function is parsed into a fragment of the graph by its own compiler, on a pool of threads, then
+      the fragments are merged (along with warnings) in source order*/
+    void parseFunctions(unsigned int threads);
+    //counts the graph's nodes and commands into the time report, as they are when
+    void countGraph(const std::string& when);
+    Identifier* findVariable(const VarWrapper* varGetter, VariableType* vtype = nullptr); //redundant
     std::string quoteString(std::string& s);
 
     //parsing
@@ -43,13 +110,13 @@ private:
     void body();
     bool statement(FunctionSymbol* fs); //returns true if the state has been ended
     Relations::Relop relop();
-    void expression(FunctionSymbol* fs, std::unique_ptr<VarWrapper> to);
+    void expression(FunctionSymbol* fs, const VarWrapper* to);
     VariableType vtype(unsigned int* = nullptr);
-    std::unique_ptr<VarWrapper> wrappedIdent(Identifier** vt = nullptr);
+    const VarWrapper* wrappedIdent(Identifier** vt = nullptr);
     std::string plainIdent();
 
     //code generation
-    void genFunctionCall(FunctionSymbol*, VariableType expectedType, std::unique_ptr<VarWrapper> vs = nullptr);
+    void genFunctionCall(FunctionSymbol*, VariableType expectedType, const VarWrapper* vs = nullptr);
     void genIf(FunctionSymbol*);
     void genWhile(FunctionSymbol*);
     void ands(FunctionSymbol* fs, std::string success, std::string fail);
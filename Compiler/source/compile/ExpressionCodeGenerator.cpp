@@ -8,10 +8,10 @@
 
 using namespace std;
 
-ExpressionCodeGenerator::ExpressionCodeGenerator(Compiler &p, std::unique_ptr<VarWrapper> asignee):
+ExpressionCodeGenerator::ExpressionCodeGenerator(Compiler &p, const VarWrapper* asignee):
         parent(p),
         currentUnique(0),
-        goingto(move(asignee)){}
+        goingto(asignee){}
 
 void ExpressionCodeGenerator::compileExpression(FunctionSymbol *fs)
 {
@@ -90,7 +90,7 @@ AbstractExprNode* ExpressionCodeGenerator::factor(FunctionSymbol* fs)
     if (parent.lookahead.type == IDENT) return withNeg(new AtomNode(parent.wrappedIdent()));
     else if (parent.lookahead.type == NUMBER)
     {
-        double d = stod(parent.lookahead.lexemeString);
+        double d = stod(parent.lookahead.lexeme.str());
         if (toNegate) d *= -1;
         AbstractExprNode* ref = new AtomNode(d);
         parent.match(NUMBER);
@@ -106,41 +106,40 @@ AbstractExprNode* ExpressionCodeGenerator::factor(FunctionSymbol* fs)
     else if (parent.lookahead.type == CALL)
     {
         parent.genFunctionCall(fs, DOUBLE);
-        unique_ptr<VarWrapper> uni = genUnique(fs);
-        fs->genAssignment(uni->clone(), make_unique<SDByName>("retD"), parent.lookahead.line);
-        return withNeg(new AtomNode(move(uni)));
+        const VarWrapper* uni = genUnique(fs);
+        fs->genAssignment(uni, SDByName::get("retD"), parent.lookahead.line);
+        return withNeg(new AtomNode(uni));
     }
     else parent.error("Expected identifier or double in expression");
 }
 
-unsigned int ExpressionCodeGenerator::nextTemp = 0;
-std::unique_ptr<VarWrapper> ExpressionCodeGenerator::genTemp(FunctionSymbol* fs, unsigned int i)
+const VarWrapper* ExpressionCodeGenerator::genTemp(FunctionSymbol* fs, unsigned int i)
 {
-    if (i == 0) return goingto->clone();
+    if (i == 0) return goingto;
     i -= 1;
-    if (i == nextTemp)
+    if (i == fs->numTemps())
     {
-        string s = "temp" + to_string(nextTemp++);
+        Symbols::Id s = fs->newTemp();
         fs->genVariableDecl(s, parent.lookahead.line);
-        return make_unique<SDByName>(s);
+        return SDByName::get(s);
     }
-    if (i > nextTemp) throw std::runtime_error("Something went wrong somehow");
-    return make_unique<SDByName>("temp" + to_string(i));
+    if (i > fs->numTemps()) throw std::runtime_error("Something went wrong somehow");
+    return SDByName::get(fs->getTemp(i));
 }
 
-unsigned int ExpressionCodeGenerator::nextUnique = 0;
-std::unique_ptr<VarWrapper> ExpressionCodeGenerator::genUnique(FunctionSymbol* fs)
+const VarWrapper* ExpressionCodeGenerator::genUnique(FunctionSymbol* fs)
 {
-    if (currentUnique == nextUnique)
+    if (currentUnique == fs->numUniques())
     {
-        string s = "unique" + to_string(nextUnique++);
+        Symbols::Id s = fs->newUnique();
         ++currentUnique;
-        parent.cfg.getFirst()->getInstrs().push_back(make_unique<DeclareVarCommand>(s, -1));
+        CFGNode* first = parent.cfg.getFirst();
+        parent.cfg.defer([first, s] () {first->getInstrs().push_back(make_unique<DeclareVarCommand>(s, -1));});
 
-        return make_unique<SDByName>(s);
+        return SDByName::get(s);
     }
-    else if (currentUnique > nextUnique) throw std::runtime_error("Something went wrong somehow");
-    return make_unique<SDByName>("unique" + to_string(currentUnique++));
+    else if (currentUnique > fs->numUniques()) throw std::runtime_error("Something went wrong somehow");
+    return SDByName::get(fs->getUnique(currentUnique++));
 }
 
 bool ExpressionCodeGenerator::translateTree(AbstractExprNode* p, FunctionSymbol* fs, unsigned int reg, double& ret)
@@ -154,7 +153,7 @@ bool ExpressionCodeGenerator::translateTree(AbstractExprNode* p, FunctionSymbol*
         }
         else
         {
-            fs->genAssignment(genTemp(fs, reg), p->getVarWrapper()->clone(), parent.lookahead.line);
+            fs->genAssignment(genTemp(fs, reg), p->getVarWrapper(), parent.lookahead.line);
             return false;
         }
     }
@@ -162,7 +161,8 @@ bool ExpressionCodeGenerator::translateTree(AbstractExprNode* p, FunctionSymbol*
     AbstractExprNode* leftp = p->getLeft();
     AbstractExprNode* rightp = p->getRight();
     double dl, dr;
-    std::unique_ptr<VarWrapper> left, right;
+    const VarWrapper* left = nullptr;
+    const VarWrapper* right = nullptr;
     bool leftlit = leftp->getType() == LITERAL && !leftp->getVarWrapper();
     bool rightlit = rightp->getType() == LITERAL && !rightp->getVarWrapper();
 
@@ -171,7 +171,7 @@ bool ExpressionCodeGenerator::translateTree(AbstractExprNode* p, FunctionSymbol*
 
     if (!leftlit)
     {
-        if (leftp->isAtom()) left = leftp->getVarWrapper()->clone();
+        if (leftp->isAtom()) left = leftp->getVarWrapper();
         else
         {
             leftlit = translateTree(leftp, fs, reg, dl);
@@ -181,7 +181,7 @@ bool ExpressionCodeGenerator::translateTree(AbstractExprNode* p, FunctionSymbol*
 
     if (!rightlit)
     {
-        if (rightp->isAtom()) right = rightp->getVarWrapper()->clone();
+        if (rightp->isAtom()) right = rightp->getVarWrapper();
         else
         {
             rightlit = translateTree(rightp, fs, reg + 1, dr);
@@ -199,19 +199,19 @@ bool ExpressionCodeGenerator::translateTree(AbstractExprNode* p, FunctionSymbol*
         if (leftlit)
         {
             auto tl = Atom(dl);
-            auto tr = Atom(move(right));
+            auto tr = Atom(right);
             fs->genExpr(genTemp(fs, reg), tl, p->getOp(), tr, parent.lookahead.line);
         }
         else if (rightlit)
         {
-            auto tl = Atom(move(left));
+            auto tl = Atom(left);
             auto tr = Atom(dr);
             fs->genExpr(genTemp(fs, reg), tl, p->getOp(), tr, parent.lookahead.line);
         }
         else
         {
-            auto tl = Atom(move(left));
-            auto tr = Atom(move(right));
+            auto tl = Atom(left);
+            auto tr = Atom(right);
             fs->genExpr(genTemp(fs, reg), tl, p->getOp(), tr, parent.lookahead.line);
         }
         return false;
@@ -23,7 +23,7 @@ protected:
 public:
     virtual ~AbstractExprNode() = default;
     virtual void addNode(AbstractExprNode*) = 0;
-    virtual const std::unique_ptr<VarWrapper>& getVarWrapper() const {throw std::runtime_error("no var");}
+    virtual const VarWrapper* getVarWrapper() const {throw std::runtime_error("no var");}
     NodeType getType() const;
     bool isAtom();
     virtual AbstractExprNode* getLeft() = 0;
@@ -52,18 +52,18 @@ public:
 class AtomNode : public AbstractExprNode
 {
 private:
-    std::unique_ptr<VarWrapper> data;
+    const VarWrapper* data;
     double doub;
     int varsRequired;
 public:
     AbstractExprNode* getLeft() override;
     AbstractExprNode* getRight() override;
 
-    AtomNode(std::unique_ptr<VarWrapper>);
+    AtomNode(const VarWrapper*);
     AtomNode(double d);
     double getDouble() override {return doub;}
-    const std::unique_ptr<VarWrapper>& getVarWrapper() const override;
-    void setData(std::unique_ptr<VarWrapper> vw);
+    const VarWrapper* getVarWrapper() const override;
+    void setData(const VarWrapper* vw);
     void setData(double d);
     void addNode(AbstractExprNode*) override;
 };
@@ -71,20 +71,18 @@ public:
 class ExpressionCodeGenerator
 {
 private:
-    static unsigned int nextTemp;
-    static unsigned int nextUnique;
-    int currentUnique;
+    unsigned int currentUnique;
     Compiler& parent;
     AbstractExprNode* expression(FunctionSymbol*);
     AbstractExprNode* term(FunctionSymbol*);
     AbstractExprNode* factor(FunctionSymbol*);
-    std::unique_ptr<VarWrapper> genTemp(FunctionSymbol*, unsigned int i);
-    std::unique_ptr<VarWrapper> genUnique(FunctionSymbol*);
+    const VarWrapper* genTemp(FunctionSymbol*, unsigned int i);
+    const VarWrapper* genUnique(FunctionSymbol*);
     bool translateTree(AbstractExprNode*, FunctionSymbol*, unsigned int, double&);
-    std::unique_ptr<VarWrapper> goingto;
+    const VarWrapper* goingto;
     
 public:
-    ExpressionCodeGenerator(Compiler& parent, std::unique_ptr<VarWrapper> assignee);
+    ExpressionCodeGenerator(Compiler& parent, const VarWrapper* assignee);
     void compileExpression(FunctionSymbol *fs);
 };
 
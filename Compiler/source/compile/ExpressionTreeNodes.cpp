@@ -109,8 +109,8 @@ AbstractExprNode* OperatorNode::getRight()
     return right;
 }
 
-AtomNode::AtomNode(std::unique_ptr<VarWrapper> vw):
-        varsRequired(0), data(move(vw))
+AtomNode::AtomNode(const VarWrapper* vw):
+        varsRequired(0), data(vw)
 {
     setType(IDENTIFIER);
 }
@@ -136,14 +136,14 @@ void AtomNode::addNode(AbstractExprNode*)
     throw std::runtime_error("Atoms have no children");
 }
 
-const unique_ptr<VarWrapper>& AtomNode::getVarWrapper() const
+const VarWrapper* AtomNode::getVarWrapper() const
 {
     return data;
 }
 
-void AtomNode::setData(unique_ptr<VarWrapper> s)
+void AtomNode::setData(const VarWrapper* s)
 {
-    data = move(s);
+    data = s;
     setType(IDENTIFIER);
 }
 
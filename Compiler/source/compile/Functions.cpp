@@ -9,9 +9,9 @@ using namespace std;
 //FunctionVars
 FunctionSymbol::FunctionVars::FunctionVars(unique_ptr<FunctionVars> p): parent(move(p)) {}
 
-void FunctionSymbol::FunctionVars::addVar(VarWrapper* varN)
+void FunctionSymbol::FunctionVars::addVar(const VarWrapper* varN)
 {
-    vars.insert(varN);
+    vars.push_back(varN);
 }
 
 unique_ptr<FunctionSymbol::FunctionVars> FunctionSymbol::FunctionVars::moveScope()
@@ -20,18 +20,15 @@ unique_ptr<FunctionSymbol::FunctionVars> FunctionSymbol::FunctionVars::moveScope
     return move(parent);
 }
 
-FunctionSymbol::FunctionVars::~FunctionVars()
-{
-    for (VarWrapper* vw : vars) delete vw;
-}
+FunctionSymbol::FunctionVars::~FunctionVars() = default;
 
-const set<VarWrapper*> FunctionSymbol::FunctionVars::getVarSet()
+const vector<const VarWrapper*> FunctionSymbol::FunctionVars::getVarSet()
 {
     if (parent == nullptr) return vars;
     else
     {
-        set<VarWrapper*> pvars = parent->getVarSet();
-        pvars.insert(vars.begin(), vars.end());
+        vector<const VarWrapper*> pvars = parent->getVarSet();
+        pvars.insert(pvars.end(), vars.begin(), vars.end());
         return pvars;
     }
 }
@@ -76,7 +73,7 @@ bool FunctionSymbol::mergeInto(FunctionSymbol* to)
             ++firstIt; //will be optimised by assignment propogation later
             if ((*firstIt)->getType() != CommandType::POP) throw std::runtime_error("should declare and pop");
             else if ((*callingIt)->getType() != CommandType::PUSH) throw std::runtime_error("pushes and pops should match");
-            unique_ptr<AbstractCommand> ac(new AssignVarCommand((*firstIt)->getVarWrapper()->clone(), (*callingIt)->getAtom(), (*firstIt)->getLineNum()));
+            unique_ptr<AbstractCommand> ac(new AssignVarCommand((*firstIt)->getVarWrapper(), (*callingIt)->getAtom(), (*firstIt)->getLineNum()));
             (*firstIt) = move(ac);
             ++firstIt;
             callingIt = callingInstrs.erase(callingIt);
@@ -99,7 +96,7 @@ bool FunctionSymbol::mergeInto(FunctionSymbol* to)
 
             if (cinstr->getType() != CommandType::PUSH || rinstr->getType() != CommandType::POP
                 || (rinstr->getVarWrapper()
-                    && cinstr->getAtom().getVarWrapper()->getFullName() != rinstr->getVarWrapper()->getFullName())) throw std::runtime_error("should match");
+                    && cinstr->getAtom().getVarWrapper()->getFullId() != rinstr->getVarWrapper()->getFullId())) throw std::runtime_error("should match");
             callingInstrs.erase(callingIt);
             returnIt = retInstrs.erase(returnIt);
             --localVarPushes;
@@ -163,7 +160,7 @@ CFGNode* FunctionSymbol::getCurrentNode() const
     return currentNode;
 }
 
-const set<VarWrapper*> FunctionSymbol::getVars()
+const vector<const VarWrapper*> FunctionSymbol::getVars()
 {
     return currentVarScope->getVarSet();
 }
@@ -179,7 +176,7 @@ void FunctionSymbol::popScope()
     currentVarScope = move(currentVarScope->moveScope());
 }
 
-void FunctionSymbol::addVar(VarWrapper* s)
+void FunctionSymbol::addVar(const VarWrapper* s)
 {
     currentVarScope->addVar(s);
 }
@@ -199,6 +196,38 @@ string FunctionSymbol::newStateName()
     return prefix + to_string(currentStateNum++);
 }
 
+Symbols::Id FunctionSymbol::getTemp(unsigned int i) const
+{
+    return temps.at(i);
+}
+
+Symbols::Id FunctionSymbol::newTemp()
+{
+    temps.push_back(Symbols::intern(prefix + "temp" + to_string(temps.size())));
+    return temps.back();
+}
+
+unsigned int FunctionSymbol::numTemps() const
+{
+    return temps.size();
+}
+
+Symbols::Id FunctionSymbol::getUnique(unsigned int i) const
+{
+    return uniques.at(i);
+}
+
+Symbols::Id FunctionSymbol::newUnique()
+{
+    uniques.push_back(Symbols::intern(prefix + "unique" + to_string(uniques.size())));
+    return uniques.back();
+}
+
+unsigned int FunctionSymbol::numUniques() const
+{
+    return uniques.size();
+}
+
 const string& FunctionSymbol::getPrefix() const
 {
     return prefix;
@@ -228,13 +257,14 @@ unsigned int FunctionSymbol::numCalls()
 FunctionCall* FunctionSymbol::addFunctionCall(CFGNode* calling, CFGNode* returnTo, unsigned int numPushedVars)
 {
     unique_ptr<FunctionCall> fc = make_unique<FunctionCall>(calling, returnTo, numPushedVars, this);
+    fc->order = callsAdded++;
     FunctionCall* rawPointer = fc.get();
     if (!calls.insert(move(fc)).second) throw std::runtime_error("already know about this call");
     returnTo->addParent(getLastNode());
     return rawPointer;
 }
 
-const set<unique_ptr<FunctionCall>>& FunctionSymbol::getFunctionCalls() const
+const FunctionCalls& FunctionSymbol::getFunctionCalls() const
 {
     return calls;
 }
@@ -280,8 +310,8 @@ void FunctionSymbol::replaceReturnState(CFGNode* going, CFGNode* replaceWith)
 
 void FunctionSymbol::clearFunctionCalls()
 {
-    string lastName = getLastNode()->getName();
-    for (auto& cp : calls) cp->returnTo->removeParent(lastName);
+    CFGNode* last = getLastNode();
+    for (auto& cp : calls) cp->returnTo->removeParent(last);
     calls.clear();
 }
 
@@ -436,17 +466,17 @@ void FunctionSymbol::genPrintLiteral(string s, int linenum)
     currentInstrs.push_back(make_unique<PrintLiteralCommand>(move(s), linenum));
 }
 
-void FunctionSymbol::genConditionalJump(string state, unique_ptr<VarWrapper> lh, Relations::Relop r,
-                                        unique_ptr<VarWrapper> rh, int linenum)
+void FunctionSymbol::genConditionalJump(string state, const VarWrapper* lh, Relations::Relop r,
+                                        const VarWrapper* rh, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<JumpOnComparisonCommand>(state, move(lh), move(rh), r, linenum));
+    currentInstrs.push_back(make_unique<JumpOnComparisonCommand>(state, lh, rh, r, linenum));
 }
 
-void FunctionSymbol::genPop(unique_ptr<VarWrapper> s, int linenum)
+void FunctionSymbol::genPop(const VarWrapper* s, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<PopCommand>(move(s), linenum));
+    currentInstrs.push_back(make_unique<PopCommand>(s, linenum));
 }
 
 void FunctionSymbol::genReturn(int linenum)
@@ -468,32 +498,32 @@ void FunctionSymbol::genPush(Atom toPush, int linenum)
     currentInstrs.push_back(make_unique<PushCommand>(move(toPush), linenum));
 }
 
-void FunctionSymbol::genInput(unique_ptr<VarWrapper> s, int linenum)
+void FunctionSymbol::genInput(const VarWrapper* s, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<InputVarCommand>(move(s), linenum));
+    currentInstrs.push_back(make_unique<InputVarCommand>(s, linenum));
 }
 
-void FunctionSymbol::genExpr(unique_ptr<VarWrapper> lh, Atom& t1,
+void FunctionSymbol::genExpr(const VarWrapper* lh, Atom& t1,
                              ArithOp o, Atom& t2, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<EvaluateExprCommand>(move(lh), move(t1), o, move(t2), linenum));
+    currentInstrs.push_back(make_unique<EvaluateExprCommand>(lh, move(t1), o, move(t2), linenum));
 }
 
-void FunctionSymbol::genVariableDecl( string n, int linenum)
+void FunctionSymbol::genVariableDecl(Symbols::Id n, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
     currentInstrs.push_back(make_unique<DeclareVarCommand>(n, linenum));
 
     //find wont work for whatever reason
-    currentVarScope->addVar(new SDByName(n));
+    currentVarScope->addVar(SDByName::get(n));
 }
 
-void FunctionSymbol::genArrayDecl(string name, unsigned long int size, int linenum)
+void FunctionSymbol::genArrayDecl(Symbols::Id name, unsigned long int size, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<DeclareArrayCommand>(move(name), size, linenum));
+    currentInstrs.push_back(make_unique<DeclareArrayCommand>(name, size, linenum));
 }
 
 void FunctionSymbol::addCommand(unique_ptr<AbstractCommand> ac)
@@ -502,28 +532,28 @@ void FunctionSymbol::addCommand(unique_ptr<AbstractCommand> ac)
     currentInstrs.push_back(move(ac));
 }
 
-void FunctionSymbol::genAssignment(unique_ptr<VarWrapper> LHS, double RHS, int linenum)
+void FunctionSymbol::genAssignment(const VarWrapper* LHS, double RHS, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<AssignVarCommand>(move(LHS), Atom(RHS), linenum));
+    currentInstrs.push_back(make_unique<AssignVarCommand>(LHS, Atom(RHS), linenum));
 }
 
-void FunctionSymbol::genAssignment(unique_ptr<VarWrapper> LHS, unique_ptr<VarWrapper> RHS, int linenum)
+void FunctionSymbol::genAssignment(const VarWrapper* LHS, const VarWrapper* RHS, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<AssignVarCommand>(move(LHS), move(RHS), linenum));
+    currentInstrs.push_back(make_unique<AssignVarCommand>(LHS, RHS, linenum));
 }
 
-void FunctionSymbol::genNondet(std::unique_ptr<VarWrapper> vw, int linenum)
+void FunctionSymbol::genNondet(const VarWrapper* vw, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<NondetCommand>(move(vw), linenum));
+    currentInstrs.push_back(make_unique<NondetCommand>(vw, linenum));
 }
 
-void FunctionSymbol::genNondet(std::string s, int linenum)
+void FunctionSymbol::genNondet(Symbols::Id array, int linenum)
 {
     if (endedState) throw std::runtime_error("No state to add to");
-    currentInstrs.push_back(make_unique<NondetCommand>(move(s), linenum));
+    currentInstrs.push_back(make_unique<NondetCommand>(array, linenum));
 }
 
 void FunctionSymbol::addCommands(vector<unique_ptr<AbstractCommand>>& acs)
@@ -533,6 +563,11 @@ void FunctionSymbol::addCommands(vector<unique_ptr<AbstractCommand>>& acs)
     currentInstrs.insert(currentInstrs.end(), make_move_iterator(acs.begin()), make_move_iterator(acs.end()));
 }
 
+bool CallOrder::operator()(const unique_ptr<FunctionCall>& l, const unique_ptr<FunctionCall>& r) const
+{
+    return l->order < r->order;
+}
+
 bool FunctionCall::operator< (const FunctionCall& r) const
 {
     return caller->getName() < r.caller->getName() || returnTo->getName() < r.returnTo->getName();
@@ -16,6 +16,13 @@ class ControlFlowGraph;
 class VarWrapper;
 
 struct FunctionCall;
+//orders calls by when they were added, so going through them doesn't depend on where they were allocated
+struct CallOrder
+{
+    bool operator()(const std::unique_ptr<FunctionCall>& l, const std::unique_ptr<FunctionCall>& r) const;
+};
+typedef std::set<std::unique_ptr<FunctionCall>, CallOrder> FunctionCalls;
+
 class FunctionSymbol : public std::enable_shared_from_this<FunctionSymbol>
 {
 private:
@@ -23,19 +30,21 @@ private:
     {
     private:
         std::unique_ptr<FunctionVars> parent;
-        std::set<VarWrapper*> vars;
+        std::vector<const VarWrapper*> vars; //in the order declared, so pushes around calls don't depend on addresses
 
     public:
         explicit FunctionVars(std::unique_ptr<FunctionVars> p = nullptr);
         ~FunctionVars();
-        const std::set<VarWrapper*> getVarSet();
+        const std::vector<const VarWrapper*> getVarSet();
         std::unique_ptr<FunctionVars> moveScope();
-        void addVar(VarWrapper* varN);
+        void addVar(const VarWrapper* varN);
     };
 
     VariableType returnType;
     std::vector<VariableType> paramTypes;
     int currentStateNum;
+    std::vector<Symbols::Id> temps;
+    std::vector<Symbols::Id> uniques;
     std::string prefix;
     std::string ident;
     bool endedState;
@@ -45,11 +54,19 @@ private:
     std::vector<std::unique_ptr<AbstractCommand>> currentInstrs;
     std::unique_ptr<FunctionVars> currentVarScope;
     ControlFlowGraph& cfg;
-    std::set<std::unique_ptr<FunctionCall>> calls;
+    FunctionCalls calls;
+    unsigned long callsAdded = 0;
 
 public:
     FunctionSymbol(VariableType returnType, std::vector<VariableType> types, std::string ident, std::string prefix, ControlFlowGraph& cfg);
     std::string newStateName();
+    //ExpressionCodeGenerator's temporaries and call results, named per function so functions compile independently
+    Symbols::Id getTemp(unsigned int i) const;
+    Symbols::Id newTemp();
+    unsigned int numTemps() const;
+    Symbols::Id getUnique(unsigned int i) const;
+    Symbols::Id newUnique();
+    unsigned int numUniques() const;
     const std::string& getPrefix() const;
     const std::string& getIdent() const;
     bool checkTypes(std::vector<VariableType>& potential);
@@ -60,8 +77,8 @@ public:
     CFGNode* getFirstNode();
     void setFirstNode(CFGNode* firstNode);
     CFGNode* getCurrentNode() const;
-    const std::set<VarWrapper*> getVars();
-    void addVar(VarWrapper* id);
+    const std::vector<const VarWrapper*> getVars();
+    void addVar(const VarWrapper* id);
     unsigned int numParams();
     unsigned int numCalls();
 
@@ -74,7 +91,7 @@ public:
     //return stuff
     FunctionCall* addFunctionCall(CFGNode* calling, CFGNode* returnTo, unsigned int numPushedVars);
     void replaceReturnState(CFGNode* going, CFGNode* replaceWith);
-    const std::set<std::unique_ptr<FunctionCall>>& getFunctionCalls() const;
+    const FunctionCalls& getFunctionCalls() const;
     void clearFunctionCalls();
     void removeFunctionCall(const std::string& calling, const std::string& ret, bool fixCalling = true);
     void forgetFunctionCall(const std::string& calling, const std::string& ret);
@@ -87,20 +104,20 @@ public:
     void genPrintAtom(Atom a, int linenum);
     void genPrintLiteral(std::string s, int linenum);
     void genJump(std::string, int linenum);
-    void genConditionalJump(std::string state, std::unique_ptr<VarWrapper> lh,
-                            Relations::Relop r, std::unique_ptr<VarWrapper> rh, int linenum);
+    void genConditionalJump(std::string state, const VarWrapper* lh,
+                            Relations::Relop r, const VarWrapper* rh, int linenum);
     void genPush(std::string toPush, int, FunctionSymbol* calledFuntion = nullptr);
     void genPush(Atom toPush, int linenum);
-    void genPop(std::unique_ptr<VarWrapper> vs, int linenum);
+    void genPop(const VarWrapper* vs, int linenum);
     void genReturn(int linenum);
-    void genInput(std::unique_ptr<VarWrapper>, int linenum);
-    void genExpr(std::unique_ptr<VarWrapper> lh, Atom& t1, ArithOp o, Atom& t2, int linenum);
-    void genVariableDecl(std::string n, int linenum);
-    void genArrayDecl(std::string name, unsigned long int size, int linenum);
-    void genAssignment(std::unique_ptr<VarWrapper> LHS, double RHS, int linenum);
-    void genAssignment(std::unique_ptr<VarWrapper> LHS, std::unique_ptr<VarWrapper> RHS, int linenum);
-    void genNondet(std::unique_ptr<VarWrapper> vw, int linenum);
-    void genNondet(std::string s, int linenum);
+    void genInput(const VarWrapper*, int linenum);
+    void genExpr(const VarWrapper* lh, Atom& t1, ArithOp o, Atom& t2, int linenum);
+    void genVariableDecl(Symbols::Id n, int linenum);
+    void genArrayDecl(Symbols::Id name, unsigned long int size, int linenum);
+    void genAssignment(const VarWrapper* LHS, double RHS, int linenum);
+    void genAssignment(const VarWrapper* LHS, const VarWrapper* RHS, int linenum);
+    void genNondet(const VarWrapper* vw, int linenum);
+    void genNondet(Symbols::Id array, int linenum);
     void addCommand(std::unique_ptr<AbstractCommand> ac);
     void addCommands(std::vector<std::unique_ptr<AbstractCommand>>& acs);
 };
@@ -127,6 +144,7 @@ struct FunctionCall
     CFGNode* returnTo;
     FunctionSymbol* calledFunction;
     unsigned int numPushedVars;
+    unsigned long order = 0; //see CallOrder
 
     FunctionCall(CFGNode* callerNode, CFGNode* returnToNode, unsigned int numLocalVars, FunctionSymbol* cf):
             caller(callerNode), returnTo(returnToNode), numPushedVars(numLocalVars), calledFunction(cf) {}
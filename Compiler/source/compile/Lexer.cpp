@@ -1,74 +1,239 @@
 #include "Lexer.h"
 #include <iostream>
+#include <cstring>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
-Lexer::Lexer()
+namespace
 {
-    currentLine = 1;
-    lastChar = 0;
-
-    resWords["if"] = Token(IF);
-    resWords["while"] = Token(WHILE);
-    resWords["function"] = Token(FUNCTION);
-    resWords["double"] = Token(DOUBLE);
-    resWords["call"] = Token(CALL);
-    resWords["input"] = Token(INPUT);
-    resWords["print"] = Token(PRINT);
-    resWords["endif"] = Token(ENDIF);
-    resWords["return"] = Token(RETURN);
-    resWords["void"] = Token(VOID);
-    resWords["else"] = Token(ELSE);
-    resWords["nondet"] = Token(NONDET);
-}
+    struct Keyword
+    {
+        const char* word;
+        size_t length;
+        Type type;
+        VariableType variableType; //for DTYPE
+    };
 
-vector<Token> Lexer::tokenize(string str)
-{
-    infile.open(str);
-    if (!infile.good()) throw runtime_error("Could not open filename '" + str + "' for lexing.");
+    constexpr Keyword keywords[] = {{"if", 2, IF, ANY}, {"while", 5, WHILE, ANY}, {"function", 8, FUNCTION, ANY},
+                                    {"double", 6, DTYPE, DOUBLE}, {"call", 4, CALL, ANY}, {"input", 5, INPUT, ANY},
+                                    {"print", 5, PRINT, ANY}, {"endif", 5, ENDIF, ANY}, {"return", 6, RETURN, ANY},
+                                    {"void", 4, DTYPE, VOID}, {"else", 4, ELSE, ANY}, {"nondet", 6, NONDET, ANY}};
+    constexpr size_t keywordCount = sizeof(keywords) / sizeof(keywords[0]);
+    constexpr unsigned int hashSlots = 32;
+
+    //perfect over the keywords - checked below
+    constexpr unsigned int keywordHash(const char* word, size_t length)
+    {
+        return (length + (unsigned char) word[0] + (unsigned char) word[length - 1]) % hashSlots;
+    }
+
+    struct KeywordTable
+    {
+        int slots[hashSlots];
+    };
+
+    constexpr KeywordTable makeKeywordTable()
+    {
+        KeywordTable table{};
+        for (unsigned int i = 0; i < hashSlots; ++i) table.slots[i] = -1;
+        for (size_t i = 0; i < keywordCount; ++i) table.slots[keywordHash(keywords[i].word, keywords[i].length)] = i;
+        return table;
+    }
+
+    constexpr KeywordTable keywordTable = makeKeywordTable();
+
+    constexpr bool keywordsHashApart()
+    {
+        for (size_t i = 0; i < keywordCount; ++i)
+        {
+            if (keywordTable.slots[keywordHash(keywords[i].word, keywords[i].length)] != (int) i) return false;
+        }
+        return true;
+    }
+    static_assert(keywordsHashApart(), "Two keywords share a hash slot - change keywordHash");
+
+    const Keyword* findKeyword(const char* word, size_t length)
+    {
+        int slot = keywordTable.slots[keywordHash(word, length)];
+        if (slot < 0) return nullptr;
+        const Keyword& candidate = keywords[slot];
+        if (candidate.length != length || memcmp(candidate.word, word, length) != 0) return nullptr;
+        return &candidate;
+    }
 
-    vector<Token> stream;
+    //isspace and isalnum in the C locale
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
 
-    while(infile)
+    inline bool isAlnum(char c)
     {
-        Token t = parseToken();
-        t.setLine(currentLine);
-        stream.push_back(t);
-        if (t.type == END) break;
+        char lower = c | 0x20;
+        return (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z');
+    }
+
+    //the end of the whitespace starting at p, adding the newlines skipped to lines
+    const char* skipSpace(const char* p, const char* end, int& lines)
+    {
+#ifdef __SSE2__
+        const __m128i space = _mm_set1_epi8(' '), beforeTab = _mm_set1_epi8('\t' - 1);
+        const __m128i afterReturn = _mm_set1_epi8('\r' + 1), newline = _mm_set1_epi8('\n');
+        while (end - p >= 16)
+        {
+            __m128i chars = _mm_loadu_si128((const __m128i*) p);
+            __m128i control = _mm_and_si128(_mm_cmpgt_epi8(chars, beforeTab), _mm_cmplt_epi8(chars, afterReturn));
+            unsigned int spaces = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars, space), control));
+            unsigned int newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, newline));
+            if (spaces != 0xFFFF)
+            {
+                unsigned int run = __builtin_ctz(~spaces);
+                lines += __builtin_popcount(newlines & ((1u << run) - 1));
+                return p + run;
+            }
+            lines += __builtin_popcount(newlines);
+            p += 16;
+        }
+#endif
+        for (; p != end && isSpace(*p); ++p) if (*p == '\n') lines++;
+        return p;
     }
 
-    infile.close();
-    return stream;
+    //the end of the letters and digits starting at p
+    const char* skipAlnum(const char* p, const char* end)
+    {
+#ifdef __SSE2__
+        const __m128i beforeZero = _mm_set1_epi8('0' - 1), afterNine = _mm_set1_epi8('9' + 1);
+        const __m128i beforeA = _mm_set1_epi8('a' - 1), afterZ = _mm_set1_epi8('z' + 1), lowerBit = _mm_set1_epi8(0x20);
+        while (end - p >= 16)
+        {
+            __m128i chars = _mm_loadu_si128((const __m128i*) p);
+            __m128i lower = _mm_or_si128(chars, lowerBit);
+            __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chars, beforeZero), _mm_cmplt_epi8(chars, afterNine));
+            __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(lower, beforeA), _mm_cmplt_epi8(lower, afterZ));
+            unsigned int alnum = _mm_movemask_epi8(_mm_or_si128(digits, letters));
+            if (alnum != 0xFFFF) return p + __builtin_ctz(~alnum);
+            p += 16;
+        }
+#endif
+        while (p != end && isAlnum(*p)) ++p;
+        return p;
+    }
+
+    //whether strtod would read a number from the start of the lexeme
+    bool startsNumber(const char* word, size_t length)
+    {
+        if (isdigit((unsigned char) word[0])) return true;
+        if (word[0] == '.') return length > 1 && isdigit((unsigned char) word[1]);
+        return length >= 3 && (strncasecmp(word, "inf", 3) == 0 || strncasecmp(word, "nan", 3) == 0);
+    }
+}
+
+Lexer::Lexer():
+        mapping(nullptr),
+        mappingSize(0),
+        source(nullptr),
+        position(nullptr),
+        sourceEnd(nullptr),
+        tokenStart(nullptr),
+        currentLine(1) {}
+
+Lexer::Lexer(const Lexer& other, Position start):
+        mapping(nullptr),
+        mappingSize(0),
+        source(other.source),
+        position(start.at),
+        sourceEnd(other.sourceEnd),
+        tokenStart(start.at),
+        currentLine(start.line) {}
+
+Lexer::~Lexer()
+{
+    unmap();
+}
+
+void Lexer::unmap()
+{
+    if (mapping != nullptr) munmap((void*) mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
 }
 
-char Lexer::getChar()
+void Lexer::open(string str)
 {
-    char c;
-    if(infile.get(c))
+    unmap();
+    int fd = ::open(str.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
     {
-        if (c == '\n') currentLine++;
-        lastChar = c;
-        return c;
+        if (fd >= 0) close(fd);
+        throw runtime_error("Could not open filename '" + str + "' for lexing.");
     }
-    else return 0;
+    if (info.st_size > 0)
+    {
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            close(fd);
+            throw runtime_error("Could not map filename '" + str + "' for lexing.");
+        }
+        madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+        mapping = (const char*) mapped;
+        mappingSize = info.st_size;
+    }
+    close(fd);
+
+    source = mapping;
+    sourceEnd = mapping + mappingSize;
+    rewind();
 }
 
-void Lexer::unget()
+void Lexer::read(const char* text, size_t length)
 {
-    if (lastChar == 0) throw runtime_error("Cannot unget twice");
-    if (lastChar == '\n') currentLine--;
-    lastChar = 0;
-    infile.unget();
+    unmap();
+    source = text;
+    sourceEnd = text + length;
+    rewind();
+}
+
+void Lexer::rewind()
+{
+    position = source;
+    tokenStart = source;
+    currentLine = 1;
+}
+
+Token Lexer::next()
+{
+    Token t = parseToken();
+    t.setLine(currentLine);
+    return t;
 }
 
 Token Lexer::parseToken()
 {
-    char c;
-    if (!(c = getChar())) return Token(END);
-    while (isspace(c) && (c = getChar()));
-    if (c == 0) return Token(END);
+    position = skipSpace(position, sourceEnd, currentLine);
+    tokenStart = position;
+    if (position == sourceEnd) return Token(END);
+
+    const char* start = position++;
+    //the second character of a two character operator
+    auto followedBy = [this] (char second)
+    {
+        if (position == sourceEnd || *position != second) return false;
+        ++position;
+        return true;
+    };
 
-    switch(c)
+    switch(*start)
     {
         case '{': return Token(LBRACE);
         case '}': return Token(RBRACE);
@@ -83,65 +248,21 @@ Token Lexer::parseToken()
         case ',': return Token(COMMA);
         case '[': return Token(LSQPAREN);
         case ']': return Token(RSQPAREN);
-        case '|':
-            if ((c = getChar()) && c == '|') return Token(COMPOR);
-            else
-            {
-                unget();
-                return Token(OR);
-            }
-        case '&':
-            if ((c = getChar()) && c == '&') return Token(COMPAND);
-            else
-            {
-                unget();
-                return Token(AND);
-            }
-        case '=':
-            if ((c = getChar()) && c == '=') return Token(Relations::EQ);
-            else
-            {
-                unget();
-                return Token(ASSIGN);
-            }
-        case '<':
-            if ((c = getChar()) && c == '=') return Token(Relations::LE);
-            else
-            {
-                unget();
-                return Token(Relations::LT);
-            }
-        case '>':
-            if ((c = getChar()) && c == '=') return Token(Relations::GE);
-            else
-            {
-                unget();
-                return Token(Relations::GT);
-            }
-        case '!':
-            if ((c = getChar()) && c == '=') return Token(Relations::NEQ);
-            else
-            {
-                unget();
-                return Token(NOT);
-            }
+        case '|': return followedBy('|') ? Token(COMPOR) : Token(OR);
+        case '&': return followedBy('&') ? Token(COMPAND) : Token(AND);
+        case '=': return followedBy('=') ? Token(Relations::EQ) : Token(ASSIGN);
+        case '<': return followedBy('=') ? Token(Relations::LE) : Token(Relations::LT);
+        case '>': return followedBy('=') ? Token(Relations::GE) : Token(Relations::GT);
+        case '!': return followedBy('=') ? Token(Relations::NEQ) : Token(NOT);
         default:
-            string str(1, c);
-            while ((c = getChar()) && isalnum(c)) str += c;
-            if (!infile.eof()) unget();
+            position = skipAlnum(position, sourceEnd);
+            size_t length = position - start;
 
-            if (str.empty()) return parseToken();
+            if (startsNumber(start, length)) return Token(NUMBER, Lexeme(start, length));
 
-            try //number
-            {
-                stod(str);
-                return Token(NUMBER, str);
-            }
-            catch(invalid_argument&)
-            {
-                unordered_map<string, Token>::const_iterator found = resWords.find(str);
-                if (found == resWords.end()) return Token(IDENT, str);
-                else return found->second;
-            }
+            const Keyword* keyword = findKeyword(start, length);
+            if (keyword == nullptr) return Token(IDENT, Lexeme(start, length));
+            else if (keyword->type == DTYPE) return Token(keyword->variableType);
+            else return Token(keyword->type);
     }
-}
\ No newline at end of file
+}
@@ -1,29 +1,52 @@
 #ifndef PROJECT_LEXER_H
 #define PROJECT_LEXER_H
 
-#include <fstream>
 #include <string>
-#include <unordered_map>
-#include <vector>
+#include <cstddef>
 
 #include "Token.h"
 
+/*Maps the source file into memory and scans it in place, a token at a time as the compiler asks for them - tokens'
+  lexemes point into the mapping rather than being copied, so the Lexer has to outlive the tokens it made. Nothing
+  else is kept, so a second pass over the source is a rewind and lexing it again*/
 class Lexer
 {
 private:
-    std::ifstream infile;
-    std::unordered_map<std::string, Token> resWords;
-
-    char lastChar;
+    const char* mapping; //null if borrowed from another Lexer
+    size_t mappingSize;
+    const char* source;
+    const char* position;
+    const char* sourceEnd;
+    const char* tokenStart; //of the last token returned
     int currentLine;
 
-    char getChar();
-    void unget();
+    void unmap();
     Token parseToken();
 
 public:
+    struct Position
+    {
+        const char* at;
+        int line;
+    };
+
     Lexer();
-    std::vector<Token> tokenize(std::string);
+    //reads on from start in what source mapped - source has to outlive this
+    Lexer(const Lexer& source, Position start);
+    ~Lexer();
+    Lexer(const Lexer&) = delete;
+    Lexer& operator=(const Lexer&) = delete;
+
+    void open(std::string);
+    //scans text in place rather than a file - text has to outlive this, or the next open
+    void read(const char* text, size_t length);
+    //END once the source runs out, and from then on
+    Token next();
+    void rewind();
+    //where the next token starts (or the whitespace before it)
+    Position tell() const {return {position, currentLine};}
+    //the source text of the last token returned, which its lexeme doesn't always have (operators, types)
+    Lexeme lastText() const {return Lexeme(tokenStart, position - tokenStart);}
 };
 
 
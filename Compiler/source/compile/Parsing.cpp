@@ -36,10 +36,10 @@ void Compiler::body()
             if (lookahead.type != COMMA && lookahead.type != RPAREN) error("'" + s + "' is not a valid function parameter");
             Identifier* vid = symbolTable.declare(t, s, line);
             vid->setDefined();
-            const string& vidName = vid->getUniqueID();
-            argumentStack.push(make_unique<PopCommand>(make_unique<SDByName>(vidName), lookahead.line));
+            Symbols::Id vidName = vid->getSymbol();
+            argumentStack.push(make_unique<PopCommand>(SDByName::get(vidName), lookahead.line));
             argumentStack.push(make_unique<DeclareVarCommand>(vidName, lookahead.line));
-            fs->addVar(new SDByName(vid->getUniqueID()));
+            fs->addVar(SDByName::get(vidName));
             if (lookahead.type == COMMA)
             {
                 match(COMMA);
@@ -86,10 +86,10 @@ bool Compiler::statement(FunctionSymbol* fs)
     {
         match(NONDET);
         Identifier* id;
-        unique_ptr<VarWrapper> vw = wrappedIdent(&id);
+        const VarWrapper* vw = wrappedIdent(&id);
         id->setDefined();
-        if (id->getType() == VariableType::ARRAY) fs->genNondet(id->getUniqueID(), lookahead.line);
-        else fs->genNondet(move(vw), lookahead.line);
+        if (id->getType() == VariableType::ARRAY) fs->genNondet(id->getSymbol(), lookahead.line);
+        else fs->genNondet(vw, lookahead.line);
         match(SEMIC);
     }
     else if (lookahead.type == PRINT)
@@ -100,7 +100,7 @@ bool Compiler::statement(FunctionSymbol* fs)
         {
             if (lookahead.type == NUMBER)
             {
-                fs->genPrintLiteral(lookahead.lexemeString, lookahead.line);
+                fs->genPrintLiteral(lookahead.lexeme.str(), lookahead.line);
                 match(NUMBER);
             }
             else
@@ -124,7 +124,7 @@ bool Compiler::statement(FunctionSymbol* fs)
         Identifier* id;
         auto vw = wrappedIdent(&id);
         if (id->getType() != ARRAY) id->setDefined();
-        fs->genInput(move(vw), lookahead.line);
+        fs->genInput(vw, lookahead.line);
         match(SEMIC);
     }
     else if (lookahead.type == DTYPE)
@@ -136,15 +136,15 @@ bool Compiler::statement(FunctionSymbol* fs)
         else
         {
             Identifier* idPtr = symbolTable.declare(t, id, lookahead.line);
-            if (t == ARRAY) fs->genArrayDecl(idPtr->getUniqueID(), size, lookahead.line);
-            else fs->genVariableDecl(idPtr->getUniqueID(), lookahead.line);
+            if (t == ARRAY) fs->genArrayDecl(idPtr->getSymbol(), size, lookahead.line);
+            else fs->genVariableDecl(idPtr->getSymbol(), lookahead.line);
 
             if (lookahead.type == ASSIGN)
             {
                 if (t == ARRAY) error("Cannot assign into entire array");
                 match(ASSIGN);
-                unique_ptr<VarWrapper> vs = make_unique<SDByName>(idPtr->getUniqueID());
-                expression(fs, move(vs));
+                const VarWrapper* vs = SDByName::get(idPtr->getSymbol());
+                expression(fs, vs);
                 idPtr->setDefined();
             }
         }
@@ -158,9 +158,9 @@ bool Compiler::statement(FunctionSymbol* fs)
     else if (lookahead.type == IDENT)
     {
         Identifier* idPtr;
-        std::unique_ptr<VarWrapper> setter = wrappedIdent(&idPtr);
+        const VarWrapper* setter = wrappedIdent(&idPtr);
         match(ASSIGN);
-        expression(fs, move(setter));
+        expression(fs, setter);
         idPtr->setDefined();
         match(SEMIC);
     }
@@ -175,7 +175,7 @@ bool Compiler::statement(FunctionSymbol* fs)
     {
         finishedState = true;
         match(RETURN);
-        if (lookahead.type != SEMIC) ExpressionCodeGenerator(*this, make_unique<SDByName>("retD")).compileExpression(fs);
+        if (lookahead.type != SEMIC) ExpressionCodeGenerator(*this, SDByName::get("retD")).compileExpression(fs);
         else if (fs->getReturnType() != VOID) error("Void function '" + fs->getIdent() + "' returns some value");
         match(SEMIC);
         fs->genReturn(lookahead.line);
@@ -191,9 +191,9 @@ Relations::Relop Compiler::relop()
     return r;
 }
 
-void Compiler::expression(FunctionSymbol* fs, unique_ptr<VarWrapper> to)
+void Compiler::expression(FunctionSymbol* fs, const VarWrapper* to)
 {
-    ExpressionCodeGenerator gen(*this, move(to));
+    ExpressionCodeGenerator gen(*this, to);
     gen.compileExpression(fs);
 }
 
@@ -205,7 +205,7 @@ VariableType Compiler::vtype(unsigned int* size)
     {
         match(LSQPAREN);
         if (lookahead.type != NUMBER) error("Expected number for array size");
-        if (size != nullptr) *size = stoi(lookahead.lexemeString);
+        if (size != nullptr) *size = stoi(lookahead.lexeme.str());
         match(NUMBER);
         match(RSQPAREN);
         t = ARRAY;
@@ -213,38 +213,38 @@ VariableType Compiler::vtype(unsigned int* size)
     return t;
 }
 
-unique_ptr<VarWrapper> Compiler::wrappedIdent(Identifier** idp)
+const VarWrapper* Compiler::wrappedIdent(Identifier** idp)
 {
-    string s = lookahead.lexemeString;
+    string s = lookahead.lexeme.str();
     Compiler::match(IDENT);
     Identifier* id = symbolTable.findIdentifier(s);
     if (!id) throw runtime_error("Could not find identifier '" + s + "'");
     if (idp) *idp = id;
-    s = id->getUniqueID();
+    Symbols::Id symbol = id->getSymbol();
     if (lookahead.type == LSQPAREN)
     {
         match(LSQPAREN);
 
         if (lookahead.type == NUMBER)
         {
-            int index = stoi(lookahead.lexemeString);
+            int index = stoi(lookahead.lexeme.str());
             match(NUMBER);
             match(RSQPAREN);
-            return make_unique<SDByArrayIndex>(s, index);
+            return SDByArrayIndex::get(symbol, index);
         }
         else
         {
-            unique_ptr<VarWrapper> indexVar = wrappedIdent();
+            const VarWrapper* indexVar = wrappedIdent();
             match(RSQPAREN);
-            return make_unique<SDByIndexVar>(s, move(indexVar));
+            return SDByIndexVar::get(symbol, indexVar);
         }
     }
-    else return make_unique<SDByName>(s);
+    else return SDByName::get(symbol);
 }
 
 std::string Compiler::plainIdent()
 {
-    string s = lookahead.lexemeString;
+    string s = lookahead.lexeme.str();
     Compiler::match(IDENT);
     return s;
 }
\ No newline at end of file
@@ -7,7 +7,7 @@ const std::string Reporter::enumNames[NUM_ALERTS] =
         {"", "OVERFLOW", "UNINITIALISED USE", "UNDECLARED USE",
          "TYPE", "ZERO DIVISION", "USELESS OP", "STACK USE", "ARRAY BOUNDS", "COMPILER", "DEAD CODE"};
 
-Reporter::Reporter(std::streambuf* sbuf) : output(sbuf)
+Reporter::Reporter(std::streambuf* sbuf) : tee(sbuf), output(&tee)
 {
     for (int i = 0; i < NUM_ALERTS; ++i) toWarn[i] = true;
 }
@@ -63,4 +63,29 @@ void Reporter::info(const std::string& details, int linenum)
 void Reporter::addText(const std::string& text)
 {
     output << text;
-}
\ No newline at end of file
+}
+
+void Reporter::record(std::string* into)
+{
+    tee.recording = into;
+}
+
+int Reporter::Tee::overflow(int c)
+{
+    if (c == traits_type::eof()) return traits_type::not_eof(c);
+    if (recording != nullptr) recording->push_back((char) c);
+    if (target != nullptr) target->sputc((char) c);
+    return c;
+}
+
+std::streamsize Reporter::Tee::xsputn(const char* s, std::streamsize n)
+{
+    if (recording != nullptr) recording->append(s, n);
+    if (target != nullptr) target->sputn(s, n);
+    return n;
+}
+
+int Reporter::Tee::sync()
+{
+    return target != nullptr ? target->pubsync() : 0;
+}
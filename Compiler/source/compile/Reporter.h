@@ -2,6 +2,7 @@
 #define PROJECT_REPORTER_H
 
 #include <fstream>
+#include <string>
 
 #define NUM_ALERTS 11
 
@@ -10,6 +11,20 @@ class Loop;
 class Reporter
 {
 private:
+    //passes everything on to the streambuf given, and copies it into recording if that's set
+    class Tee: public std::streambuf
+    {
+    public:
+        std::streambuf* target;
+        std::string* recording = nullptr;
+        explicit Tee(std::streambuf* t): target(t) {}
+    protected:
+        int overflow(int c) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+        int sync() override;
+    };
+
+    Tee tee;
     std::ostream output;
 
     const static std::string enumNames[NUM_ALERTS];
@@ -26,6 +41,8 @@ public:
     void optimising(AlertType type, const std::string& details, int linenum = -1);
     void info(const std::string& details, int linenum = -1);
     void addText(const std::string& text);
+    //copies everything reported from now on into into, until called with null
+    void record(std::string* into);
 };
 
 
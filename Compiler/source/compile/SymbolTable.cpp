@@ -7,8 +7,21 @@ using namespace std;
 SymbolTable::SymbolTable()
 {
     currentMap = make_unique<SymbolTableMap>();
-    scopeDepths.push_back(0);
+    scopesOpened.push_back(1);
     depth = 0;
+    enclosing = nullptr;
+}
+
+SymbolTable::SymbolTable(SymbolTable& globals, vector<unsigned int> opened):
+        currentMap(make_unique<SymbolTableMap>()),
+        scopesOpened(move(opened)),
+        depth(0),
+        enclosing(&globals) {}
+
+void SymbolTable::countScope(vector<unsigned int>& scopesOpened, unsigned int depth)
+{
+    if (depth >= scopesOpened.size()) scopesOpened.resize(depth + 1, 0);
+    ++scopesOpened[depth];
 }
 
 void SymbolTable::pushScope()
@@ -16,8 +29,7 @@ void SymbolTable::pushScope()
     sTable.push_front(move(currentMap));
     currentMap = make_unique<SymbolTableMap>();
     depth += 1;
-    if (depth == scopeDepths.size()) scopeDepths.push_back(0);
-    else ++scopeDepths[depth];
+    countScope(scopesOpened, depth);
 }
 
 void SymbolTable::popScope()
@@ -30,7 +42,7 @@ void SymbolTable::popScope()
 
 Identifier* SymbolTable::declare(VariableType type, std::string name, int lineNum)
 {
-    unique_ptr<Identifier> up = make_unique<Identifier>(name, type, lineNum, depth, scopeDepths[depth]);
+    unique_ptr<Identifier> up = make_unique<Identifier>(name, type, lineNum, depth, scopesOpened[depth] - 1);
     Identifier* idptr = up.get();
     currentMap->operator[](name) = move(up);
     return idptr;
@@ -71,5 +83,6 @@ Identifier* SymbolTable::findIdentifier(const string& name)
             if (it != currentMap->cend()) return it->second.get();
         }
     }
+    if (enclosing != nullptr) return enclosing->findIdentifier(name);
     return nullptr;
 }
\ No newline at end of file
@@ -7,17 +7,20 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <atomic>
 
 #include "Token.h"
+#include "Symbols.h"
 
 class Identifier
 {
 private:
     std::string lexeme;
     std::string uniqueID;
+    Symbols::Id symbol;
     unsigned int lineNum;
     VariableType type;
-    bool defined;
+    std::atomic<bool> defined; //globals are defined from functions parsed at once
 
 public:
     Identifier(std::string identifier, VariableType datatype, unsigned int line, unsigned int depth, unsigned int scopenum) :
@@ -25,7 +28,8 @@ public:
             lineNum(line),
             type(datatype),
             defined(false),
-            uniqueID("_" + std::to_string(depth) + "_" + std::to_string(scopenum) + "_" + lexeme){}
+            uniqueID("_" + std::to_string(depth) + "_" + std::to_string(scopenum) + "_" + lexeme),
+            symbol(Symbols::intern(uniqueID)){}
 
     const std::string &getLexeme() const
     {
@@ -37,6 +41,11 @@ public:
         return uniqueID;
     }
 
+    Symbols::Id getSymbol() const
+    {
+        return symbol;
+    }
+
     int getLineNum() const
     {
         return lineNum;
@@ -64,11 +73,16 @@ class SymbolTable
 private:
     std::unique_ptr<SymbolTableMap> currentMap;
     std::forward_list<std::unique_ptr<SymbolTableMap>> sTable;
-    //used for generating identifiers
-    std::vector<unsigned int> scopeDepths;
+    //used for generating identifiers - how many scopes have been opened at each depth, the current one being the last
+    std::vector<unsigned int> scopesOpened;
     unsigned int depth;
+    SymbolTable* enclosing;
 public:
     SymbolTable();
+    /*For parsing one function apart from the others: what it doesn't declare is looked for in globals, and its scopes
+      are numbered on from scopesOpened (the counts the functions before it leave) to give the same identifiers*/
+    SymbolTable(SymbolTable& globals, std::vector<unsigned int> scopesOpened);
+    static void countScope(std::vector<unsigned int>& scopesOpened, unsigned int depth);
     Identifier* findIdentifier(const std::string& name);
     void pushScope();
     void popScope();
@@ -0,0 +1,80 @@
+#include <stdexcept>
+
+#include "Symbols.h"
+
+using namespace std;
+
+namespace
+{
+    thread_local Symbols::Table* current = nullptr;
+
+    Symbols::Table& currentTable()
+    {
+        if (current != nullptr) return *current;
+        static Symbols::Table process;
+        return process;
+    }
+}
+
+Symbols::Table::Table(): chunks(new atomic<string*>[maxChunks]()) {}
+
+Symbols::Table::~Table()
+{
+    for (unsigned int i = 0; i < maxChunks; ++i) delete[] chunks[i].load(memory_order_relaxed);
+}
+
+Symbols::Id Symbols::Table::intern(const string& name)
+{
+    lock_guard<mutex> guard(internLock);
+    auto it = ids.find(name);
+    if (it != ids.end()) return it->second;
+
+    Id id = interned.load(memory_order_relaxed);
+    unsigned int chunk = id >> chunkBits;
+    if (chunk == maxChunks) throw runtime_error("Too many names to intern");
+    string* names = chunks[chunk].load(memory_order_relaxed);
+    if (names == nullptr)
+    {
+        names = new string[chunkSize];
+        chunks[chunk].store(names, memory_order_release);
+    }
+    names[id & (chunkSize - 1)] = name;
+    ids.emplace(name, id);
+    interned.store(id + 1, memory_order_release);
+    return id;
+}
+
+const string& Symbols::Table::name(Id id) const
+{
+    return chunks[id >> chunkBits].load(memory_order_acquire)[id & (chunkSize - 1)];
+}
+
+unsigned int Symbols::Table::count() const
+{
+    return interned.load(memory_order_acquire);
+}
+
+Symbols::Scope::Scope(Table& table): previous(current)
+{
+    current = &table;
+}
+
+Symbols::Scope::~Scope()
+{
+    current = previous;
+}
+
+Symbols::Id Symbols::intern(const string& name)
+{
+    return currentTable().intern(name);
+}
+
+const string& Symbols::name(Id id)
+{
+    return currentTable().name(id);
+}
+
+unsigned int Symbols::count()
+{
+    return currentTable().count();
+}
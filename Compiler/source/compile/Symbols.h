@@ -0,0 +1,64 @@
+#ifndef PROJECT_SYMBOLS_H
+#define PROJECT_SYMBOLS_H
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+/*Every variable name the compiler handles (unique IDs like _2_0_x, temps, array accesses like _1_0_a[3]) is interned
+  here once and passed around as a dense integer from then on - the optimiser and symbolic execution key their maps
+  and sets by it, and the name is only looked up to write source or a message. Names go into the Table current on the
+  thread (see Scope) - a compilation owns one, so its names go when it does and a server doesn't collect every name it
+  ever compiled - or one for the whole process outside any. Ids are only meaningful to the table that gave them, and
+  names are never freed before it is, so the reference name returns stays good that long. Interning takes a lock since
+  functions are parsed on several threads at once; looking a name up doesn't*/
+namespace Symbols
+{
+    typedef unsigned int Id;
+
+    class Table
+    {
+    public:
+        Table();
+        ~Table();
+        Table(const Table&) = delete;
+        Table& operator=(const Table&) = delete;
+
+        Id intern(const std::string& name);
+        const std::string& name(Id id) const;
+        unsigned int count() const;
+
+    private:
+        //names live in fixed size chunks that never move, so a reader only needs the chunk pointer
+        static const unsigned int chunkBits = 10;
+        static const unsigned int chunkSize = 1u << chunkBits;
+        static const unsigned int maxChunks = 1u << 13; //8M names, in a 64KB array
+
+        std::mutex internLock;
+        std::unordered_map<std::string, Id> ids;
+        std::unique_ptr<std::atomic<std::string*>[]> chunks;
+        std::atomic<unsigned int> interned{0};
+    };
+
+    //makes table current on this thread until the scope ends
+    class Scope
+    {
+    private:
+        Table* previous;
+    public:
+        explicit Scope(Table& table);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    //in the current table
+    Id intern(const std::string& name);
+    const std::string& name(Id id);
+    //number of names interned so far, ids are below this
+    unsigned int count();
+}
+
+#endif
@@ -0,0 +1,163 @@
+#include <chrono>
+#include <iomanip>
+#include <ctime>
+#include <sys/resource.h>
+
+#include "TimeReport.h"
+#include "Arena.h"
+
+using namespace std;
+
+namespace
+{
+    double milliseconds(const timeval& t)
+    {
+        return t.tv_sec * 1000.0 + t.tv_usec / 1000.0;
+    }
+
+    //names are ours, so only need quotes and backslashes escaping
+    string quoted(const string& s)
+    {
+        string out = "\"";
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+}
+
+TimeReport::TimeReport(bool shared): sharedProcess(shared), helperCpu(0)
+{
+}
+
+TimeReport::Laps::Laps(TimeReport* r, Arena& a): report(r), arena(a)
+{
+    if (report != nullptr) arena.countHeap(true);
+}
+
+TimeReport::Laps::~Laps()
+{
+    finish();
+}
+
+TimeReport::Laps::Sample TimeReport::Laps::sample() const
+{
+    Sample s;
+    s.wall = chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    s.cpu = milliseconds(usage.ru_utime) + milliseconds(usage.ru_stime) + report->helperCpu / 1e6;
+    s.peakRss = 0;
+    if (!report->sharedProcess)
+    {
+        getrusage(RUSAGE_SELF, &usage);
+        s.peakRss = usage.ru_maxrss;
+    }
+    Arena::Stats stats = arena.getStats();
+    s.arenaObjects = stats.objects;
+    s.heapAllocations = stats.heapAllocations;
+    return s;
+}
+
+void TimeReport::Laps::start(const string& next)
+{
+    if (report == nullptr) return;
+    finish();
+    phase = next;
+    started = sample();
+}
+
+void TimeReport::Laps::finish()
+{
+    if (report == nullptr || phase.empty()) return;
+    Sample finished = sample();
+    Phase p;
+    p.name = move(phase);
+    p.wall = finished.wall - started.wall;
+    p.cpu = finished.cpu - started.cpu;
+    p.peakRss = finished.peakRss - started.peakRss;
+    p.arenaObjects = finished.arenaObjects - started.arenaObjects;
+    p.heapAllocations = finished.heapAllocations - started.heapAllocations;
+    report->phases.push_back(move(p));
+    phase.clear();
+}
+
+void TimeReport::count(const string& metric, uint64_t value)
+{
+    metrics.emplace_back(metric, value);
+}
+
+void TimeReport::addHelperCpu(double ms)
+{
+    helperCpu += static_cast<uint64_t>(ms * 1e6);
+}
+
+double TimeReport::threadCpu()
+{
+    timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1e6;
+}
+
+TimeReport::Phase TimeReport::total() const
+{
+    Phase sum;
+    sum.name = "total";
+    for (const Phase& p : phases)
+    {
+        sum.wall += p.wall;
+        sum.cpu += p.cpu;
+        sum.peakRss += p.peakRss;
+        sum.arenaObjects += p.arenaObjects;
+        sum.heapAllocations += p.heapAllocations;
+    }
+    return sum;
+}
+
+void TimeReport::print(ostream& out) const
+{
+    out << left << setw(20) << "phase" << right << setw(12) << "wall ms" << setw(12) << "cpu ms"
+        << setw(14) << "peak RSS +KB" << setw(15) << "arena objects" << setw(18) << "heap allocations" << "\n";
+    auto row = [this, &out] (const Phase& p)
+    {
+        out << left << setw(20) << p.name << right << fixed << setprecision(3) << setw(12) << p.wall
+            << setw(12) << p.cpu << setw(14);
+        if (sharedProcess) out << "-";
+        else out << p.peakRss;
+        out << setw(15) << p.arenaObjects << setw(18) << p.heapAllocations << "\n";
+    };
+    for (const Phase& p : phases) row(p);
+    row(total());
+    if (sharedProcess) out << "(peak RSS is the server process's, shared with other compilations, so isn't reported)\n";
+
+    for (const auto& metric : metrics) out << left << setw(20) << metric.first << right << metric.second << "\n";
+}
+
+void TimeReport::printJson(ostream& out) const
+{
+    auto object = [this, &out] (const Phase& p)
+    {
+        out << "{\"name\": " << quoted(p.name) << fixed << setprecision(3) << ", \"wall_ms\": " << p.wall
+            << ", \"cpu_ms\": " << p.cpu << ", \"peak_rss_kb\": ";
+        if (sharedProcess) out << "null"; //see print
+        else out << p.peakRss;
+        out << ", \"arena_objects\": " << p.arenaObjects << ", \"heap_allocations\": " << p.heapAllocations << "}";
+    };
+
+    out << "{\n  \"phases\": [";
+    for (size_t i = 0; i < phases.size(); ++i)
+    {
+        out << (i == 0 ? "\n    " : ",\n    ");
+        object(phases[i]);
+    }
+    out << "\n  ],\n  \"total\": ";
+    object(total());
+    out << ",\n  \"metrics\": {";
+    for (size_t i = 0; i < metrics.size(); ++i)
+    {
+        out << (i == 0 ? "\n    " : ",\n    ") << quoted(metrics[i].first) << ": " << metrics[i].second;
+    }
+    out << "\n  }\n}\n";
+}
@@ -0,0 +1,80 @@
+#ifndef PROJECT_TIMEREPORT_H
+#define PROJECT_TIMEREPORT_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include <cstdint>
+#include <atomic>
+
+class Arena;
+
+/*What each phase of a compilation cost - wall and CPU time (of the compiling thread and the threads helping it), how
+  much the peak resident size grew, how many objects were allocated in the compilation's arena and how many heap
+  allocations its threads made besides (see Arena::countHeap, switched on by timing laps) - along with how big the
+  things it worked on were. The peak resident size is the whole process's, so a report for a compilation sharing its
+  process with others (the server's) leaves it out rather than charge it whatever the others grew*/
+class TimeReport
+{
+public:
+    explicit TimeReport(bool sharedProcess = false);
+
+    //times consecutive phases, each lasting until the next starts or the laps go - does nothing for a null report
+    class Laps
+    {
+    public:
+        Laps(TimeReport* report, Arena& arena);
+        ~Laps();
+        Laps(const Laps&) = delete;
+        Laps& operator=(const Laps&) = delete;
+
+        void start(const std::string& phase);
+
+    private:
+        struct Sample
+        {
+            double wall; //ms
+            double cpu; //ms
+            long peakRss; //KB
+            uint64_t arenaObjects;
+            uint64_t heapAllocations;
+        };
+
+        TimeReport* report;
+        Arena& arena;
+        std::string phase; //empty between phases
+        Sample started;
+
+        Sample sample() const;
+        void finish();
+    };
+
+    void count(const std::string& metric, uint64_t value);
+    //CPU time a thread spent helping the compilation - any thread but the one timing laps, whose own is measured
+    void addHelperCpu(double ms);
+    static double threadCpu(); //ms the calling thread has used
+
+    void print(std::ostream& out) const;
+    void printJson(std::ostream& out) const;
+
+private:
+    struct Phase
+    {
+        std::string name;
+        double wall = 0;
+        double cpu = 0;
+        long peakRss = 0; //growth
+        uint64_t arenaObjects = 0;
+        uint64_t heapAllocations = 0;
+    };
+
+    bool sharedProcess;
+    std::atomic<uint64_t> helperCpu; //ns
+    std::vector<Phase> phases;
+    std::vector<std::pair<std::string, uint64_t>> metrics; //in the order counted
+
+    Phase total() const;
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <string>
 #include <stdexcept>
 #include <cmath>
+#include <cstring>
 
 enum Type {IDENT, OP, RELOP, LBRACE, RBRACE,
             LPAREN, RPAREN, IF, WHILE,
@@ -34,6 +35,24 @@ enum ArithOp {PLUS, MULT, MINUS, DIV, MOD, AND, OR};
 double evaluateOp(double lhs, ArithOp op, double rhs);
 extern char opEnumChars[];
 
+//characters in place in the source mapped by the Lexer, so only valid while it is
+class Lexeme
+{
+public:
+    Lexeme(): start(""), length(0) {}
+    Lexeme(const char* s): start(s), length(strlen(s)) {}
+    Lexeme(const char* s, size_t len): start(s), length(len) {}
+
+    const char* data() const {return start;}
+    size_t size() const {return length;}
+    bool empty() const {return length == 0;}
+    std::string str() const {return std::string(start, length);}
+
+private:
+    const char* start;
+    size_t length;
+};
+
 class Token
 {
 public:
@@ -56,17 +75,17 @@ public:
     Type type;
     AuxTypeUnion auxType;
     unsigned int line;
-    std::string lexemeString;
+    Lexeme lexeme;
 
-    Token(Type t, std::string s = ""):
+    Token(Type t, Lexeme l = Lexeme()):
             type(t),
             auxType{},
-            lexemeString(move(s)){}
+            lexeme(l){}
 
-    Token(VariableType t, std::string s = ""):
+    Token(VariableType t, Lexeme l = Lexeme()):
             type(DTYPE),
             auxType(t),
-            lexemeString(move(s)){}
+            lexeme(l){}
 
     Token(Relations::Relop rel):
             type(RELOP),
@@ -75,22 +94,22 @@ public:
         switch((Relations::Relop)auxType)
         {
             case Relations::EQ:
-                lexemeString = "==";
+                lexeme = "==";
                 break;
             case Relations::NEQ:
-                lexemeString = "!=";
+                lexeme = "!=";
                 break;
             case Relations::LT:
-                lexemeString = "<";
+                lexeme = "<";
                 break;
             case Relations::LE:
-                lexemeString = "<=";
+                lexeme = "<=";
                 break;
             case Relations::GT:
-                lexemeString = ">";
+                lexeme = ">";
                 break;
             case Relations::GE:
-                lexemeString = ">=";
+                lexeme = ">=";
                 break;
         }
     }
@@ -1,27 +1,16 @@
 #include <iostream>
 #include <limits>
-#include <cstring>
+#include <thread>
 
+#include "Options.h"
 #include "compile/Compiler.h"
 #include "compile/Lexer.h"
 #include "symbolic/SymbolicArray.h"
 #include "CFGOpt/Optimiser.h"
+#include "serve/Server.h"
 
 using namespace std;
 
-void doHelp()
-{
-    cout << "Required parameters:\n";
-    cout << "-f : Source code filename\n";
-    cout << "Optional parameters:\n";
-    cout << "-w : Warning output\n";
-    cout << "-o : Produced code output\n";
-    cout << "-g b/a: CFG DOT output before/after symbolic execution\n";
-    cout << "-nv : Don't attempt verification\n";
-    cout << "-no : Don't perform dataflow/state collapsing\n";
-    cout << "-nd : Don't remove unreachable code\n";
-}
-
 int main(int argc, char* argv[])
 {
     /*Lexer lexer2;
@@ -34,73 +23,74 @@ int main(int argc, char* argv[])
     cout << pleaseWork2.str();
     return 0;*/
 
-    if (argc == 1 || argv[1] == "-h")
+    Options options = parseOptions(argc, argv);
+    if (argc == 1 || options.help)
     {
-        doHelp();
+        doHelp(cout);
         return 0;
     }
 
-    string inputfile = "";
-    string warningfile = "";
-    string outputfile = "";
-    string graphfile = "";
-    bool graphbefore = false;
-    bool verify = true;
-    bool opt = true;
-    bool deadcode = true;
-
-    int counter = 1;
-
-    while (counter < argc)
+    unique_ptr<CompileCache> cache;
+    if (options.cache)
     {
-        if (strcmp(argv[counter], "-f") == 0)
-        {
-            ++counter;
-            if (counter == argc) throw runtime_error("Expected filename after -f (-h for help)");
-            inputfile = argv[counter];
-        }
-        else if (strcmp(argv[counter], "-w") == 0)
-        {
-            ++counter;
-            if (counter == argc) throw runtime_error("Expected filename after -w (-h for help)");
-            warningfile = argv[counter];
-        }
-        else if (strcmp(argv[counter], "-o") == 0)
+        string cachedir;
+        if (options.cacheOnDisk)
         {
-            ++counter;
-            if (counter == argc) throw runtime_error("Expected filename after -o (-h for help)");
-            outputfile = argv[counter];
+            cachedir = options.cachedir.empty() ? CompileCache::defaultDirectory() : options.cachedir;
+            if (cachedir.empty()) throw runtime_error("Nowhere to cache - neither $XDG_CACHE_HOME nor $HOME is set, "
+                                                      "give a directory with --cache-dir (-h for help)");
         }
-        else if (strcmp(argv[counter], "-g") == 0)
+        uint64_t maxBytes = options.cacheSize == 0 ? CompileCache::defaultMaxBytes : (uint64_t) options.cacheSize << 20;
+        //a server remembers its recent compilations as well
+        if (!cachedir.empty() || options.serve)
         {
-            if (counter >= argc - 2) throw runtime_error("Not enough parrameters given to -g (-h for help)");
-            ++counter;
-            graphbefore = strcmp(argv[counter], "b") == 0;
-            ++counter;
-            graphfile = argv[counter];
+            cache = make_unique<CompileCache>(cachedir, options.serve ? 256 : 0, maxBytes);
         }
-        else if (strcmp(argv[counter], "-no") == 0) opt = false;
-        else if (strcmp(argv[counter], "-nv") == 0) verify = false;
-        else if (strcmp(argv[counter], "-nd") == 0) deadcode = false;
-        ++counter;
     }
 
-    if (inputfile.empty()) throw runtime_error("No input file (-h for help)");
+    if (options.serve)
+    {
+        string socket = options.socket.empty() ? Protocol::defaultSocket() : options.socket;
+        Server server(socket, options.threads == 0 ? thread::hardware_concurrency() : options.threads, cache.get());
+        server.run();
+        return 0;
+    }
+
+    if (options.inputfile.empty()) throw runtime_error("No input file (-h for help)");
 
     ofstream fout;
-    if (!warningfile.empty())
+    if (!options.warningfile.empty())
     {
-        fout.open(warningfile);
-        if (!fout.good()) throw runtime_error("Could not open filename '" + warningfile + "' for warning output.");
+        fout.open(options.warningfile);
+        if (!fout.good())
+        {
+            throw runtime_error("Could not open filename '" + options.warningfile + "' for warning output.");
+        }
     }
     else fout.setstate(std::ios::badbit); //disables output
 
     Reporter r(fout.rdbuf());
 
     Lexer lexer;
-    vector<Token> st = lexer.tokenize(inputfile);
-    Compiler c(st, r);
-    c.compile(opt, deadcode, verify, graphfile, graphbefore, outputfile);
+    lexer.open(options.inputfile);
+    Compiler c(lexer, r);
+    TimeReport times;
+    if (options.timeReport || !options.timeReportJson.empty()) c.setTimeReport(&times);
+    c.compile(options.opt, options.deadcode, options.verify, options.graphfile, options.graphbefore, options.outputfile,
+              options.threads == 0 ? thread::hardware_concurrency() : options.threads, cache.get());
+
+    if (options.allocations) Arena::printStats(cerr, c.getArenaStats());
+
+    if (options.timeReport) times.print(cerr);
+    if (!options.timeReportJson.empty())
+    {
+        ofstream json(options.timeReportJson);
+        if (!json.good())
+        {
+            throw runtime_error("Could not open filename '" + options.timeReportJson + "' for the time report.");
+        }
+        times.printJson(json);
+    }
 
     fout.close();
 
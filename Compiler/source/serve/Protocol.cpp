@@ -0,0 +1,147 @@
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Protocol.h"
+
+using namespace std;
+
+namespace
+{
+    const char* const magic = "FSM 2";
+    const uint32_t maxFields = 8;
+    const uint32_t maxFieldSize = 1u << 30;
+
+    bool writeAll(int fd, const void* data, size_t length)
+    {
+        const char* at = static_cast<const char*>(data);
+        while (length > 0)
+        {
+            ssize_t written = ::send(fd, at, length, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            at += written;
+            length -= written;
+        }
+        return true;
+    }
+
+    bool readAll(int fd, void* data, size_t length)
+    {
+        char* at = static_cast<char*>(data);
+        while (length > 0)
+        {
+            ssize_t got = ::recv(fd, at, length, 0);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            at += got;
+            length -= got;
+        }
+        return true;
+    }
+
+    bool sendFields(int fd, const vector<const string*>& fields)
+    {
+        uint32_t count = fields.size();
+        if (!writeAll(fd, &count, sizeof(count))) return false;
+        for (const string* field : fields)
+        {
+            uint32_t length = field->size();
+            if (!writeAll(fd, &length, sizeof(length)) || !writeAll(fd, field->data(), length)) return false;
+        }
+        return true;
+    }
+
+    //expects exactly count fields, the first of them magic
+    bool receiveFields(int fd, vector<string>& fields, uint32_t count)
+    {
+        uint32_t sent;
+        if (!readAll(fd, &sent, sizeof(sent)) || sent != count || count > maxFields) return false;
+        fields.assign(count, "");
+        for (string& field : fields)
+        {
+            uint32_t length;
+            if (!readAll(fd, &length, sizeof(length)) || length > maxFieldSize) return false;
+            field.resize(length);
+            if (length > 0 && !readAll(fd, &field[0], length)) return false;
+        }
+        return fields[0] == magic;
+    }
+
+    bool isFlag(char c)
+    {
+        return c == '0' || c == '1';
+    }
+}
+
+string Protocol::defaultSocket()
+{
+    const char* runtime = getenv("XDG_RUNTIME_DIR");
+    if (runtime != nullptr && *runtime != '\0') return string(runtime) + "/fsm-compiler.sock";
+    return "/tmp/fsm-compiler-" + to_string(getuid()) + ".sock";
+}
+
+bool Protocol::send(int fd, const Request& request)
+{
+    const string header = magic;
+    //optimise, deadcode, verify, graph, p for a path or t for text, cache, time report, JSON time report, allocations
+    const string flags = {request.optimise ? '1' : '0', request.deadcode ? '1' : '0', request.verify ? '1' : '0',
+                          request.graph, request.fromText ? 't' : 'p', request.cache ? '1' : '0',
+                          request.timeReport ? '1' : '0', request.timeReportJson ? '1' : '0',
+                          request.allocations ? '1' : '0'};
+    const string threads = to_string(request.threads);
+    return sendFields(fd, {&header, &flags, &threads, &request.source});
+}
+
+bool Protocol::receive(int fd, Request& request)
+{
+    vector<string> fields;
+    if (!receiveFields(fd, fields, 4)) return false;
+    const string& flags = fields[1];
+    if (flags.size() != 9 || !isFlag(flags[0]) || !isFlag(flags[1]) || !isFlag(flags[2])
+        || (flags[3] != '-' && flags[3] != 'b' && flags[3] != 'a') || (flags[4] != 'p' && flags[4] != 't')
+        || !isFlag(flags[5]) || !isFlag(flags[6]) || !isFlag(flags[7]) || !isFlag(flags[8]))
+    {
+        return false;
+    }
+    const string& threads = fields[2];
+    if (threads.empty() || threads.size() > 4 || threads.find_first_not_of("0123456789") != string::npos) return false;
+
+    request.optimise = flags[0] == '1';
+    request.deadcode = flags[1] == '1';
+    request.verify = flags[2] == '1';
+    request.graph = flags[3];
+    request.fromText = flags[4] == 't';
+    request.cache = flags[5] == '1';
+    request.timeReport = flags[6] == '1';
+    request.timeReportJson = flags[7] == '1';
+    request.allocations = flags[8] == '1';
+    request.threads = stoul(threads);
+    request.source = move(fields[3]);
+    return true;
+}
+
+bool Protocol::send(int fd, const Response& response)
+{
+    const string header = magic;
+    const string status = response.ok ? "ok" : "error";
+    return sendFields(fd, {&header, &status, &response.error, &response.warnings, &response.source, &response.graph,
+                           &response.report, &response.reportJson});
+}
+
+bool Protocol::receive(int fd, Response& response)
+{
+    vector<string> fields;
+    if (!receiveFields(fd, fields, 8) || (fields[1] != "ok" && fields[1] != "error")) return false;
+    response.ok = fields[1] == "ok";
+    response.error = move(fields[2]);
+    response.warnings = move(fields[3]);
+    response.source = move(fields[4]);
+    response.graph = move(fields[5]);
+    response.report = move(fields[6]);
+    response.reportJson = move(fields[7]);
+    return true;
+}
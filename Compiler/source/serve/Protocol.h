@@ -0,0 +1,47 @@
+#ifndef PROJECT_PROTOCOL_H
+#define PROJECT_PROTOCOL_H
+
+#include <string>
+
+/*What the client and a serving compiler say to each other over a Unix socket. A message is a count of fields then
+  the fields, each a 32 bit length and that many bytes, and starts with a field naming the protocol. A connection
+  carries requests and their responses in turn until the client closes it*/
+namespace Protocol
+{
+    struct Request
+    {
+        bool optimise = true;
+        bool deadcode = true;
+        bool verify = true;
+        char graph = '-'; //'b' or 'a' for the DOT graph before or after symbolic execution
+        bool fromText = false;
+        std::string source; //a path the server can open, or the source itself if fromText
+        bool cache = true; //whether the server's cache can be used
+        bool timeReport = false;
+        bool timeReportJson = false;
+        bool allocations = false;
+        unsigned int threads = 0; //to parse on, 0 for the server's choice
+    };
+
+    struct Response
+    {
+        bool ok = false;
+        std::string error; //why not
+        std::string warnings;
+        std::string source;
+        std::string graph; //empty if none was asked for, or the compilation didn't get that far
+        std::string report; //what the compiler would print to standard error for -t and -a
+        std::string reportJson; //for --time-report-json
+    };
+
+    //$XDG_RUNTIME_DIR/fsm-compiler.sock, or one per user in /tmp
+    std::string defaultSocket();
+
+    //false if the connection went, or what came wasn't a message of the right kind
+    bool send(int fd, const Request& request);
+    bool receive(int fd, Request& request);
+    bool send(int fd, const Response& response);
+    bool receive(int fd, Response& response);
+}
+
+#endif
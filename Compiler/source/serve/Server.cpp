@@ -0,0 +1,262 @@
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <algorithm>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Server.h"
+#include "../compile/Compiler.h"
+#include "../compile/Lexer.h"
+
+using namespace std;
+
+namespace
+{
+    sockaddr_un makeAddress(const string& path)
+    {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) throw runtime_error("Socket path '" + path + "' is too long");
+        strcpy(address.sun_path, path.c_str());
+        return address;
+    }
+
+    //whether something is accepting connections on path
+    bool inUse(const sockaddr_un& address)
+    {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0) return false;
+        bool connected = connect(probe, (const sockaddr*) &address, sizeof(address)) == 0;
+        close(probe);
+        return connected;
+    }
+}
+
+Server::Server(string path, unsigned int w, const CompileCache* c): Server(move(path), w, c, Timeouts()) {}
+
+Server::Server(string path, unsigned int w, const CompileCache* c, Timeouts t):
+        socketPath(move(path)), workers(w == 0 ? 1 : w), cache(c), timeouts(t) {}
+
+Server::~Server()
+{
+    if (listener >= 0)
+    {
+        close(listener);
+        unlink(socketPath.c_str());
+    }
+    if (poller >= 0) close(poller);
+    for (auto& connection : connections) close(connection.first);
+}
+
+void Server::run()
+{
+    sockaddr_un address = makeAddress(socketPath);
+    if (inUse(address)) throw runtime_error("Already serving on '" + socketPath + "'");
+    unlink(socketPath.c_str()); //left behind by a server that was killed
+
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listener < 0 || bind(listener, (const sockaddr*) &address, sizeof(address)) != 0
+        || listen(listener, SOMAXCONN) != 0)
+    {
+        throw runtime_error("Could not serve on '" + socketPath + "': " + strerror(errno));
+    }
+    poller = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    if (poller < 0 || epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event) != 0)
+    {
+        throw runtime_error(string("Could not watch the socket: ") + strerror(errno));
+    }
+
+    vector<thread> pool;
+    for (unsigned int i = 0; i < workers; ++i) pool.emplace_back(&Server::work, this);
+    watch();
+}
+
+//connections are watched one shot, so each readiness goes to one worker, which arms the connection again when done
+void Server::watch()
+{
+    const int maxEvents = 64;
+    epoll_event events[maxEvents];
+    int tick = (int) min<long long>(timeouts.idle.count(), 1000);
+    while (true)
+    {
+        int count = epoll_wait(poller, events, maxEvents, tick);
+        if (count < 0 && errno != EINTR) throw runtime_error(string("Could not wait on connections: ") + strerror(errno));
+        for (int i = 0; i < count; ++i)
+        {
+            if (events[i].data.fd == listener)
+            {
+                accept();
+                continue;
+            }
+            lock_guard<mutex> guard(connectionsLock);
+            connections[events[i].data.fd].busy = true;
+            ready.push_back(events[i].data.fd);
+            readyChanged.notify_one();
+        }
+        closeIdle();
+    }
+}
+
+void Server::accept()
+{
+    while (true)
+    {
+        int connection = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            //out of descriptors, say - the ones open will still be served, and idle ones closed
+            cerr << "Could not accept a connection: " << strerror(errno) << "\n";
+            return;
+        }
+
+        //a worker reading a request waits this long for each part of it
+        timeval wait{(time_t) (timeouts.request.count() / 1000), (suseconds_t) (timeouts.request.count() % 1000 * 1000)};
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+        setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &wait, sizeof(wait));
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.fd = connection;
+        lock_guard<mutex> guard(connectionsLock);
+        if (epoll_ctl(poller, EPOLL_CTL_ADD, connection, &event) != 0)
+        {
+            close(connection);
+            continue;
+        }
+        connections[connection].lastActive = chrono::steady_clock::now();
+    }
+}
+
+void Server::closeIdle()
+{
+    auto now = chrono::steady_clock::now();
+    lock_guard<mutex> guard(connectionsLock);
+    for (auto it = connections.begin(); it != connections.end(); )
+    {
+        if (!it->second.busy && now - it->second.lastActive > timeouts.idle)
+        {
+            epoll_ctl(poller, EPOLL_CTL_DEL, it->first, nullptr);
+            close(it->first);
+            it = connections.erase(it);
+        }
+        else ++it;
+    }
+}
+
+void Server::work()
+{
+    while (true)
+    {
+        int connection;
+        {
+            unique_lock<mutex> guard(connectionsLock);
+            readyChanged.wait(guard, [this] () {return !ready.empty();});
+            connection = ready.front();
+            ready.pop_front();
+        }
+
+        //nothing that goes wrong with one connection can be allowed out of the thread, or it takes the server down
+        bool keep = false;
+        try
+        {
+            keep = serve(connection);
+        }
+        catch (exception& e)
+        {
+            cerr << "Dropped a connection: " << e.what() << "\n";
+        }
+        catch (...)
+        {
+            cerr << "Dropped a connection\n";
+        }
+        finished(connection, keep);
+    }
+}
+
+bool Server::serve(int connection)
+{
+    //readiness with nothing to read is the client hanging up
+    char peek;
+    if (recv(connection, &peek, 1, MSG_PEEK | MSG_DONTWAIT) <= 0) return false;
+    Protocol::Request request;
+    if (!Protocol::receive(connection, request)) return false;
+    return Protocol::send(connection, compile(request));
+}
+
+void Server::finished(int connection, bool keep)
+{
+    lock_guard<mutex> guard(connectionsLock);
+    if (keep)
+    {
+        Connection& c = connections[connection];
+        c.busy = false;
+        c.lastActive = chrono::steady_clock::now();
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.fd = connection;
+        if (epoll_ctl(poller, EPOLL_CTL_MOD, connection, &event) == 0) return;
+    }
+    epoll_ctl(poller, EPOLL_CTL_DEL, connection, nullptr);
+    close(connection);
+    connections.erase(connection);
+}
+
+Protocol::Response Server::compile(const Protocol::Request& request) const
+{
+    Protocol::Response response;
+    ostringstream warnings;
+    Reporter r(warnings.rdbuf());
+    Compiler::Products products;
+    TimeReport times(true);
+
+    try
+    {
+        Lexer lexer;
+        if (request.fromText) lexer.read(request.source.data(), request.source.size());
+        else lexer.open(request.source);
+        Compiler c(lexer, r);
+        if (request.timeReport || request.timeReportJson) c.setTimeReport(&times);
+        //the workers are what run in parallel, so a compilation keeps to its own thread unless the client asked
+        c.compile(request.optimise, request.deadcode, request.verify, request.graph != '-', request.graph == 'b', true,
+                  products, request.threads == 0 ? 1 : request.threads, request.cache ? cache : nullptr);
+        response.ok = true;
+
+        ostringstream report;
+        if (request.allocations) Arena::printStats(report, c.getArenaStats());
+        if (request.timeReport) times.print(report);
+        response.report = report.str();
+        if (request.timeReportJson)
+        {
+            ostringstream json;
+            times.printJson(json);
+            response.reportJson = json.str();
+        }
+    }
+    catch (exception& e)
+    {
+        response.error = e.what();
+    }
+    catch (...)
+    {
+        response.error = "Compilation failed";
+    }
+
+    response.warnings = warnings.str();
+    response.source = move(products.source);
+    response.graph = move(products.graph);
+    return response;
+}
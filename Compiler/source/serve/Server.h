@@ -0,0 +1,68 @@
+#ifndef PROJECT_SERVER_H
+#define PROJECT_SERVER_H
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "Protocol.h"
+
+class CompileCache;
+
+/*Compiles for clients on a Unix socket (see Protocol) until the process is killed. One thread accepts connections and
+  watches them with epoll, and a connection only goes to the pool of workers once a request starts arriving on it - so
+  a client holding a connection open between requests (or never sending one) costs a file descriptor, not a worker.
+  A worker gives up on a request that stops arriving part way, and connections left idle are closed. Staying up is the
+  point - the allocator and the cache are warm from the compilations before, so a request only pays for what's new*/
+class Server
+{
+public:
+    struct Timeouts
+    {
+        std::chrono::milliseconds request{10000}; //for the rest of a request to arrive once it's started
+        std::chrono::milliseconds idle{60000}; //between requests, before the connection is closed
+    };
+
+    //cache can be null, and has to outlive the server otherwise
+    Server(std::string socketPath, unsigned int workers, const CompileCache* cache);
+    Server(std::string socketPath, unsigned int workers, const CompileCache* cache, Timeouts timeouts);
+    ~Server();
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    //binds the socket (taking it over if whatever made it has gone) then serves, never returning
+    void run();
+
+private:
+    const std::string socketPath;
+    const unsigned int workers;
+    const CompileCache* cache;
+    const Timeouts timeouts;
+    int listener = -1;
+    int poller = -1;
+
+    //the connections open, and whether a worker has each one
+    struct Connection
+    {
+        std::chrono::steady_clock::time_point lastActive;
+        bool busy = false;
+    };
+    std::mutex connectionsLock;
+    std::unordered_map<int, Connection> connections;
+    std::condition_variable readyChanged;
+    std::deque<int> ready; //connections with a request arriving, for the workers
+
+    void watch();
+    void accept();
+    void closeIdle();
+    void work();
+    //answers one request, false if the connection should be closed
+    bool serve(int connection);
+    void finished(int connection, bool keep);
+    Protocol::Response compile(const Protocol::Request& request) const;
+};
+
+#endif
@@ -131,7 +131,7 @@ bool EvaluateExprCommand::acceptSymbolicExecution(shared_ptr<SymbolicExecution::
                 || !term2.getVarWrapper()->check(sef.get(), getLineNum())) return false;
 
             unique_ptr<SymbolicDouble> result = term1.getVarWrapper()->getSymbolicDouble(sef.get(), getLineNum())->clone();
-            result->setName(vs->getFullName());
+            result->setId(vs->getFullId());
             GottenVarPtr<SymbolicDouble> t2 = term2.getVarWrapper()->getSymbolicDouble(sef.get(), getLineNum());
 
             if (result->isDetermined())
@@ -155,8 +155,8 @@ bool EvaluateExprCommand::acceptSymbolicExecution(shared_ptr<SymbolicExecution::
                 {
                     if (op == PLUS)
                     {
-                        std::string vsName = vs->getFullName();
-                        bool increment = vsName == term1.getVarWrapper()->getFullName() || vsName == term2.getVarWrapper()->getFullName();
+                        Symbols::Id vsName = vs->getFullId();
+                        bool increment = vsName == term1.getVarWrapper()->getFullId() || vsName == term2.getVarWrapper()->getFullId();
                         result->addSymbolicDouble(*t2, getLineNum(), increment);
                     }
                     else result->multSymbolicDouble(*t2, getLineNum());
@@ -168,7 +168,7 @@ bool EvaluateExprCommand::acceptSymbolicExecution(shared_ptr<SymbolicExecution::
         }
         else
         {
-            double constTerm; VarWrapper* varWrapper;
+            double constTerm; const VarWrapper* varWrapper;
             if (term1.isHolding())
             {
                 if (!term1.getVarWrapper()->check(sef.get(), getLineNum())) return false;
@@ -209,7 +209,7 @@ bool EvaluateExprCommand::acceptSymbolicExecution(shared_ptr<SymbolicExecution::
         if (term1.isHolding())
         {
             unique_ptr<SymbolicDouble> result = term1.getVarWrapper()->getSymbolicDouble(sef.get(), getLineNum())->clone();
-            result->setName(vs->getFullName());
+            result->setId(vs->getFullId());
             if (repeat)
             {
                 double t2c;
@@ -320,7 +320,7 @@ bool EvaluateExprCommand::acceptSymbolicExecution(shared_ptr<SymbolicExecution::
                 if (!term2.getVarWrapper()->check(sef.get(), getLineNum())) return false;
                 GottenVarPtr<SymbolicDouble> t2 = term2.getVarWrapper()->getSymbolicDouble(sef.get(), getLineNum());
 
-                if (op == MINUS) result->minusSymbolicDouble(*t2, getLineNum(), vs->getFullName() == term1.getVarWrapper()->getFullName());
+                if (op == MINUS) result->minusSymbolicDouble(*t2, getLineNum(), vs->getFullId() == term1.getVarWrapper()->getFullId());
                 else if (op == MOD) result->modSymbolicDouble(*t2, getLineNum());
                 else if (op == DIV) result->divSymbolicDouble(*t2, getLineNum());
                 else throw runtime_error("Strange op encountered");
@@ -441,7 +441,7 @@ bool DeclareVarCommand::acceptSymbolicExecution(shared_ptr<SymbolicExecution::Sy
 bool DeclareArrayCommand::acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::SymbolicExecutionFringe> sef,
                                                   bool repeat)
 {
-    sef->symbolicVarSet->addArray(name, make_unique<SymbolicArray>(name, size, sef->reporter));
+    sef->symbolicVarSet->addArray(name, make_unique<SymbolicArray>(getBaseName(), size, sef->reporter));
     return true;
 }
 
@@ -450,8 +450,8 @@ bool NondetCommand::acceptSymbolicExecution(std::shared_ptr<SymbolicExecution::S
     if (holding) getVarWrapper()->nondet(sef.get(), getLineNum());
     else
     {
-        SymbolicArray* sa = sef->symbolicVarSet->findArray(s);
-        if (!sa) throw runtime_error("Unknown array '" + s + "'");
+        SymbolicArray* sa = sef->symbolicVarSet->findArray(array);
+        if (!sa) throw runtime_error("Unknown array '" + getString() + "'");
         sa->nondet();
     }
     return true;
@@ -8,7 +8,7 @@
 
 using namespace std;
 
-unique_ptr<VarWrapper> parseAccess(const string& toParse, StringType* st = nullptr)
+const VarWrapper* parseAccess(const string& toParse, StringType* st = nullptr)
 {
     if (toParse.empty()) throw std::runtime_error("Can't parse an empty string");
     else try
@@ -21,160 +21,48 @@ unique_ptr<VarWrapper> parseAccess(const string& toParse, StringType* st = nullp
     {
         if (st) *st = StringType::ID;
         size_t first = toParse.find('[');
-        if (first == -1) return make_unique<SDByName>(toParse);
+        if (first == -1) return SDByName::get(toParse);
         string index = toParse.substr(first + 1, toParse.size() - first - 2);
         try
         {
             double dAttempt = stod(index);
-            return make_unique<SDByArrayIndex>(toParse.substr(0, first), dAttempt);
+            return SDByArrayIndex::get(Symbols::intern(toParse.substr(0, first)), dAttempt);
         }
         catch (invalid_argument&)
         {
-            unique_ptr<VarWrapper> indexWrapper = parseAccess(index);
+            const VarWrapper* indexWrapper = parseAccess(index);
             if (!indexWrapper) throw std::runtime_error("went wrong");
-            return make_unique<SDByIndexVar>(toParse.substr(0, first), move(indexWrapper));
+            return SDByIndexVar::get(Symbols::intern(toParse.substr(0, first)), indexWrapper);
         }
     }
 }
 
 //VarSetting superclasses
-WrapperHoldingCommand::WrapperHoldingCommand(std::unique_ptr<VarWrapper> vw, int linenum):
-        AbstractCommand(linenum), vs(std::move(vw)) {}
+WrapperHoldingCommand::WrapperHoldingCommand(const VarWrapper* vw, int linenum):
+        AbstractCommand(linenum), vs(vw) {}
 
 StringHoldingCommand::~StringHoldingCommand() = default;
 AtomHoldingCommand::~AtomHoldingCommand() = default;
 WrapperHoldingCommand::~WrapperHoldingCommand() = default;
 
-void WrapperHoldingCommand::setVarWrapper(std::unique_ptr<VarWrapper> nvs) {vs = move(nvs);}
+void WrapperHoldingCommand::setVarWrapper(const VarWrapper* nvs) {vs = nvs;}
 
 //Atom
 Atom::Atom(double nd):
     holding(false), type(StringType::DOUBLELIT), d(nd) {}
 
 Atom::Atom() = default;
-Atom::~Atom() = default;
 
-Atom::Atom(unique_ptr<VarWrapper> vg): holding(true)
-{
-    type = StringType::ID;
-    vptr = move(vg);
-}
-
-Atom::Atom(const Atom& o): type(o.type)
-{
-    if (o.holding)
-    {
-        vptr = o.vptr->clone();
-        holding = true;
-    }
-    else
-    {
-        d = o.d;
-        holding = false;
-    }
-}
-
-Atom::Atom(Atom&& o): type(o.type)
-{
-    if (o.holding)
-    {
-        vptr = move(o.vptr);
-        holding = true;
-        type = StringType::ID;
-    }
-    else
-    {
-        d = o.d;
-        holding = false;
-        type = StringType::DOUBLELIT;
-    }
-    o.vptr = nullptr;
-}
-
-Atom& Atom::operator=(const Atom& o)
-{
-    type = o.type;
-    if (o.holding)
-    {
-        vptr = o.vptr->clone();
-        holding = true;
-    }
-    else
-    {
-        d = o.d;
-        holding = false;
-    }
-    return *this;
-}
-
-Atom& Atom::operator=(Atom&& o)
-{
-    if (o.holding)
-    {
-        vptr = move(o.vptr);
-        o.vptr = nullptr;
-        holding = true;
-        type = StringType::ID;
-    }
-    else
-    {
-        d = o.d;
-        holding = false;
-        type = StringType::DOUBLELIT;
-    }
-    o.vptr = nullptr;
-    return *this;
-}
+Atom::Atom(const VarWrapper* vg): holding(true), type(StringType::ID), vptr(vg) {}
 
 void Atom::swap(Atom& a)
 {
-    if (holding)
-    {
-        unique_ptr<VarWrapper> vw = move(vptr);
-        if (a.holding)
-        {
-            vptr = move(a.vptr);
-            a.vptr = move(vw);
-        }
-        else
-        {
-            type = a.type;
-            d = a.d;
-            holding = false;
-            a.type = StringType::ID;
-            a.vptr = move(vw);
-            a.holding = true;
-        }
-    }
-    else
-    {
-        double t = d;
-        if (a.holding)
-        {
-            a.type = type;
-            type = StringType::ID;
-            holding = true;
-            a.holding = false;
-            vptr = move(a.vptr);
-            a.d = t;
-        }
-        else
-        {
-            StringType ttype = type;
-            type = a.type;
-            a.type = ttype;
-            d = a.d;
-            a.d = t;
-        }
-    }
+    std::swap(*this, a);
 }
 
 void Atom::become(const Atom& other)
 {
-    type = other.type;
-    holding = other.holding;
-    if (holding) vptr = other.vptr->clone();
-    else d = other.d;
+    *this = other;
 }
 
 void Atom::set(double nd)
@@ -184,27 +72,24 @@ void Atom::set(double nd)
     holding = false;
 }
 
-void Atom::set(unique_ptr<VarWrapper> vg)
+void Atom::set(const VarWrapper* vg)
 {
     type = StringType::ID;
-    vptr = move(vg);
+    vptr = vg;
     holding = true;
 }
 
 bool Atom::operator<(const Atom& right) const
 {
-    //if (holding != right.holding) return holding;
-    //else if (holding) return vptr->getFullName() < right.vptr->getFullName();
-    //else return d < right.d;
-
-    return (!holding? to_string(d) : vptr->getFullName())
-           < (!right.holding? to_string(right.d) : right.vptr->getFullName());
+    if (holding != right.holding) return holding;
+    else if (holding) return vptr->getFullId() < right.vptr->getFullId();
+    else return d < right.d;
 }
 
 bool Atom::operator==(const Atom& right) const
 {
     if (holding != right.holding) return false;
-    else if (holding) return vptr->getFullName() == right.vptr->getFullName();
+    else if (holding) return vptr == right.vptr;
     else return d == right.d;
 }
 
@@ -214,9 +99,9 @@ double Atom::getLiteral() const
 {
     return d;
 }
-VarWrapper* Atom::getVarWrapper() const
+const VarWrapper* Atom::getVarWrapper() const
 {
-    return vptr.get();
+    return vptr;
 }
 
 StringType Atom::getType() const {return type;}
@@ -228,17 +113,17 @@ Atom::operator std::string() const
 }
 
 //JumpOnComparisonCommand
-JumpOnComparisonCommand::JumpOnComparisonCommand(const string& st, unique_ptr<VarWrapper> t1,
-                                                 unique_ptr<VarWrapper> t2, Relations::Relop o, int linenum)
-    :StringHoldingCommand(st, linenum), term1(move(t1)), term2(move(t2))
+JumpOnComparisonCommand::JumpOnComparisonCommand(const string& st, const VarWrapper* t1,
+                                                 const VarWrapper* t2, Relations::Relop o, int linenum)
+    :StringHoldingCommand(st, linenum), term1(t1), term2(t2)
 {
     op = o;
     setType(CommandType::CONDJUMP);
 }
 
-JumpOnComparisonCommand::JumpOnComparisonCommand(const string& st, unique_ptr<VarWrapper> t1,
+JumpOnComparisonCommand::JumpOnComparisonCommand(const string& st, const VarWrapper* t1,
                                                  double t2, Relations::Relop o, int linenum)
-    :StringHoldingCommand(st, linenum), term1(move(t1)), term2(t2)
+    :StringHoldingCommand(st, linenum), term1(t1), term2(t2)
 {
     op = o;
     setType(CommandType::CONDJUMP);
@@ -251,15 +136,18 @@ JumpOnComparisonCommand::JumpOnComparisonCommand(const JumpOnComparisonCommand&
     setType(CommandType::CONDJUMP);
 }
 
-EvaluateExprCommand::EvaluateExprCommand(unique_ptr<VarWrapper> lh, Atom t1,
+EvaluateExprCommand::EvaluateExprCommand(const VarWrapper* lh, Atom t1,
                                          ArithOp o, Atom t2, int linenum):
-        WrapperHoldingCommand(move(lh), linenum),  op(o), term1(move(t1)), term2(move(t2))
+        WrapperHoldingCommand(lh, linenum),  op(o), term1(move(t1)), term2(move(t2))
 {
     setType(CommandType::EXPR);
 }
 
 EvaluateExprCommand::EvaluateExprCommand(const EvaluateExprCommand& o):
-        WrapperHoldingCommand(o.vs->clone(), o.getLineNum()), term1(o.term1), term2(o.term2), op(o.op) {}
+        WrapperHoldingCommand(o.vs, o.getLineNum()), term1(o.term1), term2(o.term2), op(o.op)
+{
+    setType(CommandType::EXPR);
+}
 
 unique_ptr<AbstractCommand> EvaluateExprCommand::clone()
 {
@@ -272,7 +160,7 @@ string EvaluateExprCommand::translation(const string& delim) const
 }
 
 //InputVarCommand
-InputVarCommand::InputVarCommand(unique_ptr<VarWrapper> into, int linenum) : WrapperHoldingCommand(move(into), linenum)
+InputVarCommand::InputVarCommand(const VarWrapper* into, int linenum) : WrapperHoldingCommand(into, linenum)
 {
     setType(CommandType::INPUTVAR);
 }
@@ -284,25 +172,25 @@ string InputVarCommand::translation(const string& delim) const
 
 unique_ptr<AbstractCommand> InputVarCommand::clone()
 {
-    return make_unique<InputVarCommand>(vs->clone(), getLineNum());
+    return make_unique<InputVarCommand>(vs, getLineNum());
 }
 
 //AssignVarCommand
-AssignVarCommand::AssignVarCommand(unique_ptr<VarWrapper> lh, unique_ptr<VarWrapper> rh, int linenum):
-        AbstractCommand(linenum), vs(move(lh)), atom(move(rh))
+AssignVarCommand::AssignVarCommand(const VarWrapper* lh, const VarWrapper* rh, int linenum):
+        AbstractCommand(linenum), vs(lh), atom(rh)
 {
     setType(CommandType::ASSIGNVAR);
 }
 
-AssignVarCommand::AssignVarCommand(unique_ptr<VarWrapper> lh, Atom rh, int linenum):
-        AbstractCommand(linenum), vs(move(lh)), atom(move(rh))
+AssignVarCommand::AssignVarCommand(const VarWrapper* lh, Atom rh, int linenum):
+        AbstractCommand(linenum), vs(lh), atom(rh)
 {
     setType(CommandType::ASSIGNVAR);
 }
 
-void AssignVarCommand::setVarWrapper(std::unique_ptr<VarWrapper> sd)
+void AssignVarCommand::setVarWrapper(const VarWrapper* sd)
 {
-    vs = move(sd);
+    vs = sd;
 }
 
 string AssignVarCommand::translation(const string& delim) const
@@ -312,18 +200,17 @@ string AssignVarCommand::translation(const string& delim) const
 
 unique_ptr<AbstractCommand> AssignVarCommand::clone()
 {
-    return make_unique<AssignVarCommand>(vs->clone(), atom, getLineNum());
+    return make_unique<AssignVarCommand>(vs, atom, getLineNum());
 }
 
 //PopCommand
-PopCommand::PopCommand(unique_ptr<VarWrapper> into, int linenum): WrapperHoldingCommand(move(into), linenum)
+PopCommand::PopCommand(const VarWrapper* into, int linenum): WrapperHoldingCommand(into, linenum)
 {
     setType(CommandType::POP);
 }
 
 void PopCommand::clear()
 {
-    vs.reset();
     vs = nullptr;
 }
 
@@ -334,7 +221,7 @@ string PopCommand::translation(const string& delim) const
 
 unique_ptr<AbstractCommand> PopCommand::clone()
 {
-    return make_unique<PopCommand>(vs->clone(), getLineNum());
+    return make_unique<PopCommand>(vs, getLineNum());
 }
 
 //PushCommand
@@ -359,31 +246,49 @@ std::unique_ptr<AbstractCommand> PushCommand::clone()
 }
 
 //Nondet command
-NondetCommand::NondetCommand(std::unique_ptr<VarWrapper> vw, int linenum):
-        AbstractCommand(linenum), varWrapper(move(vw)), holding(true)
+NondetCommand::NondetCommand(const VarWrapper* vw, int linenum):
+        AbstractCommand(linenum), varWrapper(vw), holding(true)
 {
     setType(CommandType::NONDET);
 }
 
 std::unique_ptr<AbstractCommand> NondetCommand::clone()
 {
-    if (holding) return std::make_unique<NondetCommand>(getVarWrapper()->clone(), AbstractCommand::getLineNum());
-    else return std::make_unique<NondetCommand>(s, AbstractCommand::getLineNum());
+    if (holding) return std::make_unique<NondetCommand>(getVarWrapper(), AbstractCommand::getLineNum());
+    else return std::make_unique<NondetCommand>(array, AbstractCommand::getLineNum());
 }
 
 std::string NondetCommand::translation(const std::string& delim) const
 {
     if (holding) return "nondet " + getVarWrapper()->getFullName() + ";" + delim;
-    else return "nondet " + s + ";" + delim;
+    else return "nondet " + getString() + ";" + delim;
 }
 
-NondetCommand::~NondetCommand()
+void NondetCommand::setVarWrapper(const VarWrapper* sd)
 {
-    if (holding) varWrapper.reset();
+    if (!holding) throw std::runtime_error("holding array");
+    varWrapper = sd;
 }
 
-void NondetCommand::setVarWrapper(std::unique_ptr<VarWrapper> sd)
+//Switch command
+SwitchCommand::SwitchCommand(const VarWrapper* on, std::vector<std::pair<double, std::string>> c, int linenum):
+        WrapperHoldingCommand(on, linenum), cases(move(c))
 {
-    if (!holding) throw std::runtime_error("holding array");
-    varWrapper = move(sd);
+    setType(CommandType::SWITCH);
+}
+
+std::unique_ptr<AbstractCommand> SwitchCommand::clone()
+{
+    return std::make_unique<SwitchCommand>(getVarWrapper(), cases, AbstractCommand::getLineNum());
+}
+
+std::string SwitchCommand::translation(const std::string& delim) const
+{
+    std::string out = "switch " + getVarWrapper()->getFullName() + " {";
+    for (unsigned int i = 0; i < cases.size(); ++i)
+    {
+        if (i != 0) out += "; ";
+        out += to_string(cases[i].first) + ": " + cases[i].second;
+    }
+    return out + "};" + delim;
 }
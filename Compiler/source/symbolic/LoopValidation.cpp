@@ -53,13 +53,13 @@ void Loop::setNodeNesting(CFGNode* node, Loop* child)
     nodes[node] = child;
 }
 
-void Loop::validate(unordered_map<string, unique_ptr<SearchResult>>& tags)
+void Loop::validate(vector<unique_ptr<SearchResult>>& tags)
 {
     for (auto& child : children) child->validate(tags);
 
     ChangeMap varChanges; //node->varname->known path through that node where the specified change happens
     SEFPointer sef = make_shared<SymbolicExecution::SymbolicExecutionFringe>(cfg.getReporter());
-    unique_ptr<SearchResult>& headerSR = tags[headerNode->getName()];
+    unique_ptr<SearchResult>& headerSR = tags[headerNode->getId()];
     sef->symbolicVarSet = headerSR->getInitSVS();
     sef->setLoopInit();
 
@@ -96,13 +96,13 @@ inline void mergeMaps(NodeChangeMap& intoMap, NodeChangeMap& fromMap)
     }
 }
 
-bool Loop::searchNode(CFGNode* node, ChangeMap& varChanges, unordered_map<string, unique_ptr<SearchResult>>& tags,
+bool Loop::searchNode(CFGNode* node, ChangeMap& varChanges, vector<unique_ptr<SearchResult>>& tags,
                       SEFPointer sef,  bool headerSeen)
 {
     auto it = nodes.find(node);
     if (it == nodes.end()) throw std::runtime_error("asked to search outside of loop");
 
-    unique_ptr<SearchResult>& thisNodeSR = tags[node->getName()];
+    unique_ptr<SearchResult>& thisNodeSR = tags[node->getId()];
 
     thisNodeSR->resetPoppedCounter();
 
@@ -134,7 +134,7 @@ bool Loop::searchNode(CFGNode* node, ChangeMap& varChanges, unordered_map<string
 
     auto generateNodeChanges = [&varChanges, &sef, node] () -> void
     {
-        map<string, unsigned short int> thisNodeChange;
+        NodeChangeMap thisNodeChange;
         for (const auto& symvar : sef->symbolicVarSet->getAllVars()) //todo make this more efficient in the style of (broken) SVSIterator
         {
             if (thisNodeChange.find(symvar.first) != thisNodeChange.end()) continue;
@@ -361,7 +361,7 @@ bool Loop::searchNode(CFGNode* node, ChangeMap& varChanges, unordered_map<string
                                     mergeMaps(varChanges.at(node), varChanges.at(succNode));
 
                                     //check if we can move out of must 'MUST'
-                                    unsigned short int termChange = varChanges.at(node)[string(jocc->term1)];
+                                    unsigned short int termChange = varChanges.at(node)[jocc->term1.getVarWrapper()->getFullId()];
                                     bool goingAway = (jocc->op == Relations::GT || jocc->op == Relations::GE) &&
                                                      termChange & FDECREASING != 0 ||
                                                      (jocc->op == Relations::LT || jocc->op == Relations::LE) &&
@@ -412,7 +412,7 @@ bool Loop::searchNode(CFGNode* node, ChangeMap& varChanges, unordered_map<string
                                 if (searchNode(failNode, varChanges, tags, sefFailure))
                                 {
                                     mergeMaps(varChanges.at(node), varChanges.at(failNode));
-                                    unsigned short int termChange = varChanges.at(node)[string(jocc->term1)];
+                                    unsigned short int termChange = varChanges.at(node)[jocc->term1.getVarWrapper()->getFullId()];
                                     bool goingAway = (jocc->op == Relations::GT || jocc->op == Relations::GE) &&
                                                      termChange & FINCREASING != 0 ||
                                                      (jocc->op == Relations::LT || jocc->op == Relations::LE) &&
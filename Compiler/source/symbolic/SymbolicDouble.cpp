@@ -12,10 +12,12 @@
 using namespace std;
 using namespace SymbolicExecution;
 
-SymbolicDouble::SymbolicDouble(string name, Reporter& r):
-    varN(move(name)), reporter(r), upperBound(0), lowerBound(0), repeatLower(numeric_limits<double>::lowest()),
+SymbolicDouble::SymbolicDouble(Symbols::Id name, Reporter& r):
+    varN(name), reporter(r), upperBound(0), lowerBound(0), repeatLower(numeric_limits<double>::lowest()),
     repeatUpper(numeric_limits<double>::max()) {}
 
+SymbolicDouble::SymbolicDouble(const string& name, Reporter& r): SymbolicDouble(Symbols::intern(name), r) {}
+
 SymbolicDouble::SymbolicDouble(const SymbolicDouble& o):
     varN(o.varN), reporter(o.reporter), upperBound(o.upperBound), lowerBound(o.lowerBound), repeatLower(o.repeatLower),
     repeatUpper(o.repeatUpper), minChange(o.minChange), maxChange(o.maxChange), defined(o.defined)
@@ -30,11 +32,16 @@ SymbolicDouble& SymbolicDouble::operator=(const SymbolicDouble& o)
 }
 
 const string& SymbolicDouble::getName() const
+{
+    return Symbols::name(varN);
+}
+
+Symbols::Id SymbolicDouble::getId() const
 {
     return varN;
 }
 
-void SymbolicDouble::setName(const string& newName)
+void SymbolicDouble::setId(Symbols::Id newName)
 {
     varN = newName;
 }
@@ -248,7 +255,7 @@ bool SymbolicDouble::guaranteedLT(SymbolicDouble* searchFor, SymbolicDouble* sea
     }
     for (SymbolicDouble* optr : lt)
     {
-        if (optr->getName() == searchFor->getName() || optr->guaranteedLE(searchFor, searchInit, seen))
+        if (optr->getId() == searchFor->getId() || optr->guaranteedLE(searchFor, searchInit, seen))
         {
             addLT();
             return true;
@@ -289,7 +296,7 @@ bool SymbolicDouble::guaranteedLE(SymbolicDouble* searchFor, SymbolicDouble* sea
     }
     for (SymbolicDouble* optr : lt)
     {
-        if (optr->getName() == searchFor->getName() || optr->guaranteedLE(searchFor, searchInit, seen))
+        if (optr->getId() == searchFor->getId() || optr->guaranteedLE(searchFor, searchInit, seen))
         {
             addLE();
             return true;
@@ -779,26 +786,26 @@ void SymbolicDouble::addConstToLower(const double diff, int linenum)
 {
     if (!defined)
     {
-        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised", linenum);
+        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised", linenum);
     }
 
     if (!isBoundedBelow())
     {
-        if (diff < 0) reporter.warn(Reporter::AlertType::RANGE, varN + " could possibly drop below limit", linenum);
+        if (diff < 0) reporter.warn(Reporter::AlertType::RANGE, getName() + " could possibly drop below limit", linenum);
         else lowerBound = numeric_limits<double>::lowest() + diff; //kind of assuming diff is not too big
     }
     else
     {
         if (diff > 0)
         {
-            if (lowerBound > numeric_limits<double>::max() - diff) reportError(Reporter::AlertType::RANGE, varN + " will overflow", linenum);
+            if (lowerBound > numeric_limits<double>::max() - diff) reportError(Reporter::AlertType::RANGE, getName() + " will overflow", linenum);
             else lowerBound += diff;
         }
         else
         {
             if (lowerBound < numeric_limits<double>::lowest() - diff)
             {
-                reporter.warn(Reporter::AlertType::RANGE, varN + " could possibly exceed double limits", linenum);
+                reporter.warn(Reporter::AlertType::RANGE, getName() + " could possibly exceed double limits", linenum);
             }
             else lowerBound += diff;
         }
@@ -809,11 +816,11 @@ void SymbolicDouble::addConstToLower(const double diff, int linenum)
 
 void SymbolicDouble::addConstToUpper(const double diff, int linenum)
 {
-    if (!defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised", linenum);
+    if (!defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised", linenum);
 
     if (!isBoundedAbove())
     {
-        if (diff > 0) reporter.warn(Reporter::AlertType::RANGE, varN + " could possibly exceed double limits", linenum);
+        if (diff > 0) reporter.warn(Reporter::AlertType::RANGE, getName() + " could possibly exceed double limits", linenum);
         else upperBound = numeric_limits<double>::max() + diff;
     }
     else
@@ -822,14 +829,14 @@ void SymbolicDouble::addConstToUpper(const double diff, int linenum)
         {
             if (upperBound > numeric_limits<double>::max() - diff)
             {
-                reporter.warn(Reporter::AlertType::RANGE, varN + " could possibly exceed double limits", linenum);
+                reporter.warn(Reporter::AlertType::RANGE, getName() + " could possibly exceed double limits", linenum);
                 upperBound = numeric_limits<double>::max();
             }
             else upperBound += diff;
         }
         else
         {
-            if (upperBound < numeric_limits<double>::lowest() - diff) reportError(Reporter::AlertType::RANGE, varN + " will overflow", linenum);
+            if (upperBound < numeric_limits<double>::lowest() - diff) reportError(Reporter::AlertType::RANGE, getName() + " will overflow", linenum);
             else upperBound += diff;
         }
     }
@@ -841,12 +848,12 @@ void SymbolicDouble::addConst(double diff, int linenum)
 {
     if (!defined)
     {
-        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised", linenum);
+        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised", linenum);
     }
 
     if (diff == 0)
     {
-        reporter.warn(Reporter::AlertType::USELESS_OP, "Zero added to " + varN, linenum);
+        reporter.warn(Reporter::AlertType::USELESS_OP, "Zero added to " + getName(), linenum);
         return;
     }
 
@@ -861,11 +868,11 @@ void SymbolicDouble::addConst(double diff, int linenum)
         double oldT = lowerBound;
         if (diff > 0 && oldT > numeric_limits<double>::max() - diff)
         {
-            reportError(Reporter::AlertType::RANGE, varN + " will overflow", linenum);
+            reportError(Reporter::AlertType::RANGE, getName() + " will overflow", linenum);
         }
         else if (diff < 0 && oldT < numeric_limits<double>::lowest() - diff)
         {
-            reportError(Reporter::AlertType::RANGE, varN + " will overflow", linenum);
+            reportError(Reporter::AlertType::RANGE, getName() + " will overflow", linenum);
         }
         upperBound = lowerBound = oldT + diff;
     }
@@ -878,7 +885,7 @@ void SymbolicDouble::addSymbolicDouble(SymbolicDouble& other, int linenum, bool
 {
     if (!other.defined)
     {
-        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, other.varN + " used before explicitly initialised", linenum);
+        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, other.getName() + " used before explicitly initialised", linenum);
     }
 
     if (other.isDetermined())
@@ -889,7 +896,7 @@ void SymbolicDouble::addSymbolicDouble(SymbolicDouble& other, int linenum, bool
 
     if (!defined)
     {
-        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised", linenum);
+        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised", linenum);
     }
 
     double otherLowerBound = other.getLowerBound();
@@ -912,7 +919,7 @@ void SymbolicDouble::addSymbolicDouble(SymbolicDouble& other, int linenum, bool
 
 void SymbolicDouble::minusSymbolicDouble(SymbolicDouble& other, int linenum, bool increment)
 {
-    if (!other.defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, other.varN + " used before explicitly initialised");
+    if (!other.defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, other.getName() + " used before explicitly initialised");
 
     if (other.isDetermined())
     {
@@ -920,7 +927,7 @@ void SymbolicDouble::minusSymbolicDouble(SymbolicDouble& other, int linenum, boo
         return;
     }
 
-    if (!defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised");
+    if (!defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised");
 
     double otherLowerBound = other.getLowerBound();
     double otherUpperBound = other.getUpperBound();
@@ -985,12 +992,12 @@ void SymbolicDouble::multConst(double mul, int linenum)
 
     if (!defined)
     {
-        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised", linenum);
+        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised", linenum);
     }
     if (mul == 0) setConstValue(0);
     else if (mul == 1)
     {
-        reporter.warn(Reporter::AlertType::USELESS_OP, varN + "multiplied by 1", linenum);
+        reporter.warn(Reporter::AlertType::USELESS_OP, getName() + "multiplied by 1", linenum);
     }
     else
     {
@@ -1034,12 +1041,12 @@ void SymbolicDouble::multConst(double mul, int linenum)
             if (alwaysabove || alwaysbelow)
             {
                 reportError(Reporter::AlertType::RANGE,
-                            varN + " guaranteed to overflow when multiplied by " + to_string(mul), linenum);
+                            getName() + " guaranteed to overflow when multiplied by " + to_string(mul), linenum);
             }
             else if (bad)
             {
                 reporter.warn(Reporter::AlertType::RANGE,
-                              varN + " might overflow when multiplied by " + to_string(mul), linenum);
+                              getName() + " might overflow when multiplied by " + to_string(mul), linenum);
             }
 
             if (lowerResult <= upperResult)
@@ -1061,7 +1068,7 @@ void SymbolicDouble::multSymbolicDouble(SymbolicDouble& other, int linenum)
     if (!other.defined)
     {
         reporter.warn(Reporter::AlertType::UNINITIALISED_USE,
-                      other.varN + " used before explicitly initialised", linenum);
+                      other.getName() + " used before explicitly initialised", linenum);
     }
     if (other.isDetermined())
     {
@@ -1070,7 +1077,7 @@ void SymbolicDouble::multSymbolicDouble(SymbolicDouble& other, int linenum)
     }
     if (!defined)
     {
-        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised", linenum);
+        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised", linenum);
     }
 
     double otherLowerBound = other.getLowerBound();
@@ -1136,12 +1143,12 @@ void SymbolicDouble::multSymbolicDouble(SymbolicDouble& other, int linenum)
     if (alwaysabove || alwaysbelow)
     {
         reportError(Reporter::AlertType::RANGE,
-                    varN + " guaranteed to overflow when multiplied by " + other.varN, linenum);
+                    getName() + " guaranteed to overflow when multiplied by " + other.getName(), linenum);
     }
     else if (bad)
     {
         reporter.warn(Reporter::AlertType::RANGE,
-                      varN + " might overflow when multiplied by " + other.varN, linenum);
+                      getName() + " might overflow when multiplied by " + other.getName(), linenum);
     }
 
 
@@ -1160,7 +1167,7 @@ void SymbolicDouble::modConst(double modulus, int linenum)
 {
     if (modulus == 0)
     {
-        reportError(Reporter::AlertType::ZERODIVISION, varN + " divided by zero", linenum);
+        reportError(Reporter::AlertType::ZERODIVISION, getName() + " divided by zero", linenum);
         return;
     }
 
@@ -1186,7 +1193,7 @@ void SymbolicDouble::modSymbolicDouble(SymbolicDouble& other, int linenum)
         double otherVal = other.getConstValue();
         if (otherVal == 0)
         {
-            reportError(Reporter::ZERODIVISION, varN + " divided by " + other.varN + " ( = 0)", linenum);
+            reportError(Reporter::ZERODIVISION, getName() + " divided by " + other.getName() + " ( = 0)", linenum);
             return;
         }
         else modConst(otherVal, linenum);
@@ -1199,7 +1206,7 @@ void SymbolicDouble::modSymbolicDouble(SymbolicDouble& other, int linenum)
         if (other.lowerBound <= 0 && other.upperBound >= 0)
         {
             reporter.warn(Reporter::ZERODIVISION,
-                          varN + " divided by " + other.varN + " which could possibly be zero", linenum);
+                          getName() + " divided by " + other.getName() + " which could possibly be zero", linenum);
         }
         setUpperBound(max(upperBound, max(abs(other.lowerBound), abs(other.upperBound))));
     }
@@ -1230,7 +1237,7 @@ void SymbolicDouble::divConst(double denom, int linenum)
 {
     if (!defined)
     {
-        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised", linenum);
+        reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised", linenum);
     }
 
     double change1 = upperBound * (1/denom - 1);
@@ -1248,12 +1255,12 @@ void SymbolicDouble::divConst(double denom, int linenum)
 
     if (denom == 0)
     {
-        reportError(Reporter::AlertType::ZERODIVISION, varN + "divided by 0", linenum);
+        reportError(Reporter::AlertType::ZERODIVISION, getName() + "divided by 0", linenum);
         return;
     }
     else if (denom == 1)
     {
-        reporter.warn(Reporter::AlertType::USELESS_OP, varN + "divided by 1", linenum);
+        reporter.warn(Reporter::AlertType::USELESS_OP, getName() + "divided by 1", linenum);
         return;
     }
     else if (isDetermined())
@@ -1297,11 +1304,11 @@ void SymbolicDouble::divConst(double denom, int linenum)
 
         if (alwaysabove || alwaysbelow)
         {
-            reportError(Reporter::AlertType::RANGE, varN + " guaranteed to overflow when divided by " + to_string(denom), linenum);
+            reportError(Reporter::AlertType::RANGE, getName() + " guaranteed to overflow when divided by " + to_string(denom), linenum);
         }
         else if (bad)
         {
-            reporter.warn(Reporter::AlertType::RANGE, varN + " might overflow when divided by " + to_string(denom), linenum);
+            reporter.warn(Reporter::AlertType::RANGE, getName() + " might overflow when divided by " + to_string(denom), linenum);
         }
 
         if (lowerResult <= upperResult)
@@ -1320,13 +1327,13 @@ void SymbolicDouble::divConst(double denom, int linenum)
 
 void SymbolicDouble::divSymbolicDouble(SymbolicDouble& other, int linenum)
 {
-    if (!other.defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, other.varN + " used before explicitly initialised");
+    if (!other.defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, other.getName() + " used before explicitly initialised");
     if (other.isDetermined())
     {
         divConst(other.getConstValue(), linenum);
         return;
     }
-    if (!defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, varN + " used before explicitly initialised");
+    if (!defined) reporter.warn(Reporter::AlertType::UNINITIALISED_USE, getName() + " used before explicitly initialised");
 
     double otherLowerBound = other.getLowerBound();
     double otherUpperBound = other.getUpperBound();
@@ -1377,11 +1384,11 @@ void SymbolicDouble::divSymbolicDouble(SymbolicDouble& other, int linenum)
 
     if (alwaysabove || alwaysbelow)
     {
-        reportError(Reporter::AlertType::RANGE, varN + " guaranteed to overflow when divided by " + other.varN, linenum);
+        reportError(Reporter::AlertType::RANGE, getName() + " guaranteed to overflow when divided by " + other.getName(), linenum);
     }
     else if (bad)
     {
-        reporter.warn(Reporter::AlertType::RANGE, varN + " might overflow when divided by " + other.varN, linenum);
+        reporter.warn(Reporter::AlertType::RANGE, getName() + " might overflow when divided by " + other.getName(), linenum);
     }
 
     setLowerBound(min(lowerlower, min(lowerupper, min(upperlower, upperupper))));
@@ -8,6 +8,7 @@
 #include "../compile/Reporter.h"
 #include "../compile/Token.h"
 #include "../Command.h"
+#include "../compile/Symbols.h"
 //SymbolicDouble.cpp
 
 class VarWrapper;
@@ -19,7 +20,7 @@ private:
     bool defined = false;
     bool feasable = true;
     bool userAffected = false;
-    std::string varN;
+    Symbols::Id varN;
     Reporter& reporter;
 
     /*std::set<SymbolicDouble*> lt;
@@ -45,14 +46,16 @@ public:
     enum MonotoneEnum{INCREASING, DECREASING, FRESH, NONE, UNKNOWN};
     enum MeetEnum {CANT, MAY, MUST};
 
-    SymbolicDouble(std::string name, Reporter& reporter);
+    SymbolicDouble(Symbols::Id name, Reporter& reporter);
+    SymbolicDouble(const std::string& name, Reporter& reporter);
     SymbolicDouble(const SymbolicDouble& o);
     SymbolicDouble(SymbolicDouble* o);
     SymbolicDouble(const SymbolicDouble&& other) = delete;
     SymbolicDouble& operator=(const SymbolicDouble& o);
 
     const std::string& getName() const;
-    void setName(const std::string& newName);
+    Symbols::Id getId() const;
+    void setId(Symbols::Id newName);
     bool isDefined() const;
     virtual bool getRelativeVelocity(SymbolicDouble* o,long double& slowest, long double& fastest) const;
     void define();
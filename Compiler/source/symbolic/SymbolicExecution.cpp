@@ -147,17 +147,19 @@ void SymbolicExecutionFringe::setLoopInit()
 }
 
 //SymbolicExecutionManager
-unordered_map<string, unique_ptr<SymbolicExecutionManager::SearchResult>>& SymbolicExecutionManager::search(bool optimising)
+vector<unique_ptr<SymbolicExecutionManager::SearchResult>>& SymbolicExecutionManager::search(bool optimising)
 {
-    visitedNodes.clear();
+    stats = Stats();
+    visitedNodes.assign(cfg.getNodeIdBound(), false);
     tags.clear();
-    for (auto& pair : cfg.getCurrentNodes()) tags[pair.first] = make_unique<SearchResult>(reporter);
+    tags.resize(cfg.getNodeIdBound());
+    for (auto& pair : cfg.getCurrentNodes()) tags[pair.second->getId()] = make_unique<SearchResult>(reporter);
     shared_ptr<SymbolicExecutionFringe> sef = make_shared<SymbolicExecutionFringe>(reporter);
     visitNode(sef, cfg.getFirst());
     auto it = cfg.getCurrentNodes().begin();
     while (it != cfg.getCurrentNodes().end())
     {
-        if (!it->second->isLastNode() && visitedNodes.find(it->first) == visitedNodes.end()) //no feasable visits - remove
+        if (!it->second->isLastNode() && !visitedNodes[it->second->getId()]) //no feasable visits - remove
         {
             string s =  "State '" + it->first + "' is unreachable";
             if (optimising)
@@ -166,9 +168,8 @@ unordered_map<string, unique_ptr<SymbolicExecutionManager::SearchResult>>& Symbo
                 CFGNode *lonelyNode = it->second.get();
                 if (lonelyNode->getCompSuccess() != nullptr) lonelyNode->getCompSuccess()->removeParent(lonelyNode);
                 if (lonelyNode->getCompFail() != nullptr) lonelyNode->getCompFail()->removeParent(lonelyNode);
-                for (auto& parentPair : lonelyNode->getPredecessorMap())
+                for (CFGNode* parent : lonelyNode->getPredecessors())
                 {
-                    CFGNode *parent = parentPair.second;
                     if (parent->getCompFail() != nullptr && parent->getCompFail()->getName() == lonelyNode->getName())
                     {
                         parent->setCompFail(parent->getCompSuccess());
@@ -182,7 +183,7 @@ unordered_map<string, unique_ptr<SymbolicExecutionManager::SearchResult>>& Symbo
                     parent->setComp(nullptr);
                 }
                 lonelyNode->prepareToDie();
-                it = cfg.removeNode(it->first);
+                it = cfg.removeNode(it);
             }
             else
             {
@@ -274,6 +275,7 @@ CFGNode* SymbolicExecutionManager::getFailNode(shared_ptr<SymbolicExecutionFring
         if (returningSEF->symbolicStack->isEmpty())
         {
             if (!n->isLastNode()) throw std::runtime_error("returns too early");
+            ++stats.paths;
             return nullptr;
         }
 
@@ -281,8 +283,8 @@ CFGNode* SymbolicExecutionManager::getFailNode(shared_ptr<SymbolicExecutionFring
 
         failNode = n->getParentGraph().getNode(returningSEF->symbolicStack->popState());
         if (failNode == nullptr) throw std::runtime_error("tried to jump to a nonexisting state");
-        else //check its in successors of n
-        if (find(n->getSuccessorVector().begin(), n->getSuccessorVector().end(), failNode) == n->getSuccessorVector().end())
+        vector<CFGNode*> successors = n->getSuccessorVector(); //check its in successors of n
+        if (find(successors.begin(), successors.end(), failNode) == successors.end())
         {
             throw std::runtime_error("should be successor");
         }
@@ -294,11 +296,14 @@ void SymbolicExecutionManager::visitNode(shared_ptr<SymbolicExecutionFringe> ose
 {
     if (!osef->isFeasable()) return;
 
-    unique_ptr<SearchResult>& thisNodeSR = tags[n->getName()];
+    unique_ptr<SearchResult>& thisNodeSR = tags[n->getId()];
 
     bool change = thisNodeSR->unionSVS(osef->symbolicVarSet.get());
     if (thisNodeSR->unionStack(osef->symbolicStack.get())) change = true;
-    if (!visitedNodes.insert(n->getName()).second && !change) return; //seen before
+    bool seen = visitedNodes[n->getId()];
+    visitedNodes[n->getId()] = true;
+    if (seen && !change) return; //seen before
+    ++stats.visits;
 
     shared_ptr<SymbolicExecutionFringe> sef = make_shared<SymbolicExecutionFringe>(osef);
 
@@ -420,7 +425,7 @@ void SymbolicExecutionManager::visitNode(shared_ptr<SymbolicExecutionFringe> ose
 
 //these things below will usually be called when we already have
 //a ptr to the vars but we want to copy that var into the 'new scope'
-void SymbolicExecutionManager::branch(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n, VarWrapper* lhsvar,
+void SymbolicExecutionManager::branch(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n, const VarWrapper* lhsvar,
                                       Relations::Relop op, double rhsconst, int linenum, bool reverse)
 {
     switch(op)
@@ -449,7 +454,7 @@ void SymbolicExecutionManager::branch(shared_ptr<SymbolicExecutionFringe> sef, C
 }
 
 void SymbolicExecutionManager::branchEQ(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                        VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
+                                        const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
 {
     shared_ptr<SymbolicExecutionFringe> seflt = make_shared<SymbolicExecutionFringe>(sef);
     GottenVarPtr<SymbolicDouble> gvpLT = lhsvar->getSymbolicDouble(seflt.get(), linenum);
@@ -508,7 +513,7 @@ void SymbolicExecutionManager::branchEQ(shared_ptr<SymbolicExecutionFringe> sef,
 
 
 void SymbolicExecutionManager::branchNE(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                        VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
+                                        const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
 {
     shared_ptr<SymbolicExecutionFringe> seflt = make_shared<SymbolicExecutionFringe>(sef);
     GottenVarPtr<SymbolicDouble> gvpLT = lhsvar->getSymbolicDouble(seflt.get(), linenum);
@@ -563,7 +568,7 @@ void SymbolicExecutionManager::branchNE(shared_ptr<SymbolicExecutionFringe> sef,
 }
 
 void SymbolicExecutionManager::branchLT(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                        VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
+                                        const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
 {
     shared_ptr<SymbolicExecutionFringe> seflt = make_shared<SymbolicExecutionFringe>(sef);
     GottenVarPtr<SymbolicDouble> gvpLT = lhsvar->getSymbolicDouble(seflt.get(), linenum);
@@ -604,7 +609,7 @@ void SymbolicExecutionManager::branchLT(shared_ptr<SymbolicExecutionFringe> sef,
 
 
 void SymbolicExecutionManager::branchLE(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                        VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
+                                        const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
 {
     shared_ptr<SymbolicExecutionFringe> sefle = make_shared<SymbolicExecutionFringe>(sef);
     GottenVarPtr<SymbolicDouble> gvpLE = lhsvar->getSymbolicDouble(sefle.get(), linenum);
@@ -645,7 +650,7 @@ void SymbolicExecutionManager::branchLE(shared_ptr<SymbolicExecutionFringe> sef,
 
 
 void SymbolicExecutionManager::branchGT(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                        VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
+                                        const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
 {
     shared_ptr<SymbolicExecutionFringe> sefgt = make_shared<SymbolicExecutionFringe>(sef);
     GottenVarPtr<SymbolicDouble> gvpGT = lhsvar->getSymbolicDouble(sefgt.get(), linenum);
@@ -684,7 +689,7 @@ void SymbolicExecutionManager::branchGT(shared_ptr<SymbolicExecutionFringe> sef,
 }
 
 void SymbolicExecutionManager::branchGE(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                        VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
+                                        const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse)
 {
     shared_ptr<SymbolicExecutionFringe> sefge = make_shared<SymbolicExecutionFringe>(sef);
     GottenVarPtr<SymbolicDouble> gvpGE = lhsvar->getSymbolicDouble(sefge.get(), linenum);
@@ -725,7 +730,7 @@ void SymbolicExecutionManager::branchGE(shared_ptr<SymbolicExecutionFringe> sef,
 
 //branching on var comparison
 void SymbolicExecutionManager::varBranch(shared_ptr<SymbolicExecutionFringe>& sef, CFGNode* n,
-                                         VarWrapper* LHS, Relations::Relop op, VarWrapper* RHS, int linenum)
+                                         const VarWrapper* LHS, Relations::Relop op, const VarWrapper* RHS, int linenum)
 {
     switch(op)
     {
@@ -753,7 +758,7 @@ void SymbolicExecutionManager::varBranch(shared_ptr<SymbolicExecutionFringe>& se
 }
 
 void SymbolicExecutionManager::varBranchGE(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                           VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum)
+                                           const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum)
 {
     if (!(n->isLastNode() && sef->symbolicStack->isEmpty())) 
     {
@@ -773,7 +778,7 @@ void SymbolicExecutionManager::varBranchGE(shared_ptr<SymbolicExecutionFringe> s
 }
 
 void SymbolicExecutionManager::varBranchGT(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                              VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum)
+                                              const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum)
 {
     if (!(n->isLastNode() && sef->symbolicStack->isEmpty()))
     {
@@ -790,7 +795,7 @@ void SymbolicExecutionManager::varBranchGT(shared_ptr<SymbolicExecutionFringe> s
 }
 
 void SymbolicExecutionManager::varBranchLT(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                              VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum)
+                                              const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum)
 {
     if (!(n->isLastNode() && sef->symbolicStack->isEmpty()))
     {
@@ -807,7 +812,7 @@ void SymbolicExecutionManager::varBranchLT(shared_ptr<SymbolicExecutionFringe> s
 
 
 void SymbolicExecutionManager::varBranchLE(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                              VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum)
+                                              const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum)
 {
     if (!(n->isLastNode() && sef->symbolicStack->isEmpty()))
     {
@@ -824,7 +829,7 @@ void SymbolicExecutionManager::varBranchLE(shared_ptr<SymbolicExecutionFringe> s
 
 
 void SymbolicExecutionManager::varBranchNE(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                           VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum)
+                                           const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum)
 {
     if (!(n->isLastNode() && sef->symbolicStack->isEmpty()))
     {
@@ -847,7 +852,7 @@ void SymbolicExecutionManager::varBranchNE(shared_ptr<SymbolicExecutionFringe> s
 
 
 void SymbolicExecutionManager::varBranchEQ(shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                                           VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum)
+                                           const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum)
 {
     shared_ptr<SymbolicExecutionFringe> sefeq = make_shared<SymbolicExecutionFringe>(sef);
     CFGNode* failNode = getFailNode(sefeq, n);
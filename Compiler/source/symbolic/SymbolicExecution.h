@@ -135,11 +135,21 @@ namespace SymbolicExecution
         SymbolicExecutionManager(ControlFlowGraph& cfg, SymbolTable& sTable, Reporter& reporter):
                 cfg(cfg), sTable(sTable), reporter(reporter)
         {};
-        std::unordered_map<std::string, std::unique_ptr<SearchResult>>& search(bool deadcode);
+        //indexed by node id
+        std::vector<std::unique_ptr<SearchResult>>& search(bool deadcode);
+
+        //how much searching the last search did
+        struct Stats
+        {
+            uint64_t visits = 0; //of a node, with something new to explore there
+            uint64_t paths = 0; //that reached the end of the program
+        };
+        const Stats& getStats() const {return stats;}
 
     private:
-        std::set<std::string> visitedNodes;
-        std::unordered_map<std::string, std::unique_ptr<SearchResult>> tags;
+        Stats stats;
+        std::vector<bool> visitedNodes;
+        std::vector<std::unique_ptr<SearchResult>> tags;
         //std::unordered_map<std::string, std::set<std::string>> seenReturnStates;
 
         ControlFlowGraph& cfg;
@@ -150,49 +160,50 @@ namespace SymbolicExecution
         //a path is feasable if it visits itself or reaches the last state
         void visitNode(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n);
         //the below don't check if the ranges are disjoint - this is done in visitNode
-        void branch(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n, VarWrapper* lhsvar,
+        void branch(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n, const VarWrapper* lhsvar,
                     Relations::Relop op, double rhsconst, int linenum, bool reverse = false);
         
         void branchEQ(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
+                      const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
         
         void branchNE(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
+                      const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
         
         void branchLE(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
+                      const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
         
         void branchLT(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
+                      const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
         
         void branchGE(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                           VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
+                           const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
         
         void branchGT(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
+                      const VarWrapper* lhsvar, double rhsconst, int linenum, bool reverse = false);
         
         void varBranch(std::shared_ptr<SymbolicExecutionFringe>& sef, CFGNode* n,
-                       VarWrapper* lhsvar, Relations::Relop op, VarWrapper* rhsvar, int linenum);
+                       const VarWrapper* lhsvar, Relations::Relop op, const VarWrapper* rhsvar, int linenum);
         
         void varBranchEQ(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum);
+                      const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum);
         
         void varBranchNE(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum);
+                      const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum);
         
         void varBranchLE(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum);
+                      const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum);
         
         void varBranchLT(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum);
+                      const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum);
         
         void varBranchGE(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum);
+                      const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum);
         
         void varBranchGT(std::shared_ptr<SymbolicExecutionFringe> sef, CFGNode* n,
-                      VarWrapper* lhsvar, VarWrapper* rhsvar, int linenum);
+                      const VarWrapper* lhsvar, const VarWrapper* rhsvar, int linenum);
 
-        static CFGNode* getFailNode(std::shared_ptr<SymbolicExecutionFringe> returningSEF, CFGNode* n);
+        //null if the path ends at n
+        CFGNode* getFailNode(std::shared_ptr<SymbolicExecutionFringe> returningSEF, CFGNode* n);
     };
 }
 
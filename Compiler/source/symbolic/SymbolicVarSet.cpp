@@ -2,9 +2,9 @@
 
 using namespace std;
 
-SymbolicDouble* SymbolicVarSet::findVar(string name)
+SymbolicDouble* SymbolicVarSet::findVar(Symbols::Id name)
 {
-    unordered_map<string, SymbolicDoublePointer>::const_iterator it = variables.find(name);
+    VarMap::const_iterator it = variables.find(name);
     if (it != variables.cend()) return it->second.get();
 
     else //must copy symbolic variable into this 'scope'
@@ -17,9 +17,9 @@ SymbolicDouble* SymbolicVarSet::findVar(string name)
     }
 }
 
-SymbolicArray* SymbolicVarSet::findArray(string name)
+SymbolicArray* SymbolicVarSet::findArray(Symbols::Id name)
 {
-    unordered_map<string, SymbolicArrayPointer>::const_iterator it = arrays.find(name);
+    ArrayMap::const_iterator it = arrays.find(name);
     if (it != arrays.cend()) return it->second.get();
     else
     {
@@ -49,10 +49,10 @@ void SymbolicVarSet::setLoopInit()
 
 void SymbolicVarSet::addVar(SymbolicDoublePointer newvar)
 {
-    variables[newvar->getName()] = move(newvar);
+    variables[newvar->getId()] = move(newvar);
 }
 
-void SymbolicVarSet::addArray(const std::string& name, SymbolicArrayPointer p)
+void SymbolicVarSet::addArray(Symbols::Id name, SymbolicArrayPointer p)
 {
     arrays[name] = move(p);
 }
@@ -91,9 +91,9 @@ bool SymbolicVarSet::unionSVS(SymbolicVarSet* other)
     return change;
 }
 
-std::unordered_map<std::string, SymbolicDouble*> SymbolicVarSet::getAllVars()
+std::unordered_map<Symbols::Id, SymbolicDouble*> SymbolicVarSet::getAllVars()
 {
-    std::unordered_map<std::string, SymbolicDouble*> toReturn = {};
+    std::unordered_map<Symbols::Id, SymbolicDouble*> toReturn = {};
     if (parent != nullptr) toReturn = parent->getAllVars();
 
     for (const auto& v : variables)
@@ -104,9 +104,9 @@ std::unordered_map<std::string, SymbolicDouble*> SymbolicVarSet::getAllVars()
     return toReturn;
 }
 
-std::unordered_map<std::string, SymbolicArray*> SymbolicVarSet::getAllArrays()
+std::unordered_map<Symbols::Id, SymbolicArray*> SymbolicVarSet::getAllArrays()
 {
-    std::unordered_map<std::string, SymbolicArray*> toReturn = {};
+    std::unordered_map<Symbols::Id, SymbolicArray*> toReturn = {};
     if (parent != nullptr) toReturn = parent->getAllArrays();
 
     for (const auto& v : arrays)
@@ -118,7 +118,7 @@ std::unordered_map<std::string, SymbolicArray*> SymbolicVarSet::getAllArrays()
 }
 
 //iterator
-const pair<const string, SymbolicDoublePointer>& SVSIterator::operator*()
+const pair<const Symbols::Id, SymbolicDoublePointer>& SVSIterator::operator*()
 {
     return *currentIt;
 }
@@ -10,9 +10,9 @@
 
 
 typedef std::unique_ptr<SymbolicDouble> SymbolicDoublePointer;
-typedef std::unordered_map<std::string, SymbolicDoublePointer> VarMap;
+typedef std::unordered_map<Symbols::Id, SymbolicDoublePointer> VarMap;
 typedef std::unique_ptr<SymbolicArray> SymbolicArrayPointer;
-typedef std::unordered_map<std::string, SymbolicArrayPointer> ArrayMap;
+typedef std::unordered_map<Symbols::Id, SymbolicArrayPointer> ArrayMap;
 
 class SymbolicVarSet;
 
@@ -27,7 +27,7 @@ public:
             : currentSVS(start), currentIt(cit) {}
 
     bool operator!=(const SVSIterator& other);
-    const std::pair<const std::string, SymbolicDoublePointer>& operator*();
+    const std::pair<const Symbols::Id, SymbolicDoublePointer>& operator*();
     SVSIterator& operator++();
 };
 
@@ -47,18 +47,18 @@ public:
         parent = move(p);
     }
     SymbolicVarSet(const SymbolicVarSet&) = delete;
-    SymbolicDouble* findVar(std::string name);
-    SymbolicArray* findArray(std::string name);
-    //const std::unordered_map<std::string, SymbolicDoublePointer>& getVars() const {return variables;}
+    SymbolicDouble* findVar(Symbols::Id name);
+    SymbolicArray* findArray(Symbols::Id name);
+    //const VarMap& getVars() const {return variables;}
     void addVar(SymbolicDoublePointer newvar);
-    void addArray(const std::string& name, SymbolicArrayPointer sap);
+    void addArray(Symbols::Id name, SymbolicArrayPointer sap);
     bool unionSVS(SymbolicVarSet* other);
     bool isFeasable();
 
     void setLoopInit();
 
-    std::unordered_map<std::string, SymbolicDouble*> getAllVars();
-    std::unordered_map<std::string, SymbolicArray*> getAllArrays();
+    std::unordered_map<Symbols::Id, SymbolicDouble*> getAllVars();
+    std::unordered_map<Symbols::Id, SymbolicArray*> getAllArrays();
 
     SVSIterator begin() const {throw std::runtime_error("not working");}// return {this, variables.cbegin()};} (todo)
     SVSIterator end() const {return parent == nullptr ? SVSIterator(this, variables.cend()) : parent->end();} //end only called once when iterating
@@ -3,115 +3,193 @@
 //
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "VarWrappers.h"
 #include "SymbolicExecution.h"
 
+namespace
+{
+    enum Kind : unsigned char {BY_NAME, BY_ARRAY_INDEX, BY_INDEX_VAR};
+
+    //what a wrapper is made of - an array index, or the address of an index variable's (also unique) wrapper
+    struct Key
+    {
+        unsigned char kind;
+        Symbols::Id base;
+        uintptr_t index;
+
+        bool operator==(const Key& other) const
+        {
+            return kind == other.kind && base == other.base && index == other.index;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return std::hash<uintptr_t>()(key.index * 31 + key.base) ^ key.kind;
+        }
+    };
+
+    thread_local VarWrapper::Table* current = nullptr;
+
+    VarWrapper::Table& currentTable()
+    {
+        if (current != nullptr) return *current;
+        static VarWrapper::Table process;
+        return process;
+    }
+}
+
+struct VarWrapper::Table::Wrappers
+{
+    std::mutex lock;
+    std::unordered_map<Key, std::unique_ptr<VarWrapper>, KeyHash> made;
+};
+
+VarWrapper::Table::Table(): wrappers(std::make_unique<Wrappers>()) {}
+
+VarWrapper::Table::~Table() = default;
+
+VarWrapper::Scope::Scope(Table& table): previous(current)
+{
+    current = &table;
+}
+
+VarWrapper::Scope::~Scope()
+{
+    current = previous;
+}
+
+template<typename Make>
+const VarWrapper* VarWrapper::find(unsigned char kind, Symbols::Id base, uintptr_t index, Make make)
+{
+    Table::Wrappers& wrappers = *currentTable().wrappers;
+    std::lock_guard<std::mutex> guard(wrappers.lock);
+    std::unique_ptr<VarWrapper>& found = wrappers.made[{kind, base, index}];
+    if (!found) found.reset(make());
+    return found.get();
+}
+
 //SDByName
+const VarWrapper* SDByName::get(Symbols::Id symbol)
+{
+    return find(BY_NAME, symbol, 0, [symbol] () {return new SDByName(symbol);});
+}
+
+const VarWrapper* SDByName::get(const std::string& name)
+{
+    return get(Symbols::intern(name));
+}
+
 GottenVarPtr<SymbolicDouble> SDByName::getSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    SymbolicDouble* foundsv = sef->symbolicVarSet->findVar(name);
+    SymbolicDouble* foundsv = sef->symbolicVarSet->findVar(id);
     return GottenVarPtr<SymbolicDouble>(foundsv);
 }
 
-void SDByName::setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum)
+void SDByName::setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) const
 {
     std::unique_ptr<SymbolicDouble> sd2 = sd->clone();
-    sd2->setName(name);
+    sd2->setId(id);
     sd2->define();
     sef->symbolicVarSet->addVar(move(sd2));
 }
 
-void SDByName::setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum)
+void SDByName::setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) const
 {
-    auto var = sef->symbolicVarSet->findVar(name);
-    if (!var) throw std::runtime_error("Undefined variable '" + name + "'");
+    auto var = sef->symbolicVarSet->findVar(id);
+    if (!var) throw std::runtime_error("Undefined variable '" + getBaseName() + "'");
     var->setConstValue(d);
 }
 
-void SDByName::nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum)
+void SDByName::nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    auto var = sef->symbolicVarSet->findVar(name);
-    if (!var) throw std::runtime_error("Undefined variable '" + name + "'");
+    auto var = sef->symbolicVarSet->findVar(id);
+    if (!var) throw std::runtime_error("Undefined variable '" + getBaseName() + "'");
     var->nondet();
 }
 
 bool SDByName::check(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    auto var = sef->symbolicVarSet->findVar(name);
+    auto var = sef->symbolicVarSet->findVar(id);
     return var != nullptr;
 }
 
-std::string SDByName::getFullName() const
-{
-    return name;
-}
+//SDByArrayIndex
+SDByArrayIndex::SDByArrayIndex(Symbols::Id array, unsigned int i):
+        VarWrapper(array, Symbols::intern(Symbols::name(array) + "[" + std::to_string(i) + "]"), false), index(i) {}
 
-std::unique_ptr<VarWrapper> SDByName::clone() const
+const VarWrapper* SDByArrayIndex::get(Symbols::Id array, unsigned int index)
 {
-    return std::make_unique<SDByName>(name);
+    return find(BY_ARRAY_INDEX, array, index, [array, index] () {return new SDByArrayIndex(array, index);});
 }
 
-//SDByArrayIndex
 GottenVarPtr<SymbolicDouble> SDByArrayIndex::getSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     return GottenVarPtr<SymbolicDouble>(move(sa->get(index, linenum)));
 }
 
 bool SDByArrayIndex::check(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
     if (sa == nullptr)
     {
-        sef->error(Reporter::UNDECLARED_USE, "Array '" + name + "' undeclared");
+        sef->error(Reporter::UNDECLARED_USE, "Array '" + getBaseName() + "' undeclared");
         return false;
     }
     sa->checkIndex(index, linenum);
 }
 
-void SDByArrayIndex::setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum)
+void SDByArrayIndex::setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     sa->set(index, sd, linenum);
 }
 
-void SDByArrayIndex::setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum)
+void SDByArrayIndex::setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     sa->set(index, d, linenum);
 }
 
-void SDByArrayIndex::nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum)
+void SDByArrayIndex::nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     sa->nondet(index, linenum);
 }
 
-std::unique_ptr<VarWrapper> SDByArrayIndex::clone() const
+//SDByIndexVar
+SDByIndexVar::SDByIndexVar(Symbols::Id array, const VarWrapper* var):
+        VarWrapper(array, Symbols::intern(Symbols::name(array) + "[" + var->getFullName() + "]"), true), index(var) {}
+
+const VarWrapper* SDByIndexVar::get(Symbols::Id array, const VarWrapper* index)
 {
-    return std::make_unique<SDByArrayIndex>(name, index);
+    return find(BY_INDEX_VAR, array, (uintptr_t) index, [array, index] () {return new SDByIndexVar(array, index);});
 }
 
-//SDByIndexVar
 GottenVarPtr<SymbolicDouble> SDByIndexVar::getSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     auto sd = index->getSymbolicDouble(sef, linenum);
     return GottenVarPtr<SymbolicDouble>(sa->get(sd.get(), linenum));
 }
 
 bool SDByIndexVar::check(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
     if (sa == nullptr)
     {
-        sef->error(Reporter::UNDECLARED_USE, "Array '" + name + "' undeclared");
+        sef->error(Reporter::UNDECLARED_USE, "Array '" + getBaseName() + "' undeclared");
         return false;
     }
 
@@ -120,32 +198,27 @@ bool SDByIndexVar::check(SymbolicExecution::SymbolicExecutionFringe* sef, int li
     else return sa->checkBounds(sd->getLowerBound(), sd->getUpperBound(), linenum);
 }
 
-void SDByIndexVar::setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum)
+void SDByIndexVar::setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     SymbolicDouble* ind = index->getSymbolicDouble(sef, linenum).get();
     sa->set(ind, sd, linenum);
 }
 
-void SDByIndexVar::setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum)
+void SDByIndexVar::setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) const
 {
 
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     SymbolicDouble val("val", sef->reporter);
     val.setConstValue(d);
     sa->set(index->getSymbolicDouble(sef, linenum).get(), &val, linenum);
 }
 
-void SDByIndexVar::nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum)
+void SDByIndexVar::nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const
 {
-    SymbolicArray* sa = sef->symbolicVarSet->findArray(name);
-    if (sa == nullptr) throw std::runtime_error("Array '" + name + "' undeclared");
+    SymbolicArray* sa = sef->symbolicVarSet->findArray(id);
+    if (sa == nullptr) throw std::runtime_error("Array '" + getBaseName() + "' undeclared");
     sa->nondet(index->getSymbolicDouble(sef, linenum).get(), linenum);
-}
-
-std::unique_ptr<VarWrapper> SDByIndexVar::clone() const
-{
-    return std::make_unique<SDByIndexVar>(name, index->clone());
 }
\ No newline at end of file
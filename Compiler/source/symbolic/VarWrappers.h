@@ -7,7 +7,9 @@
 
 #include <memory>
 #include <vector>
+#include <cstdint>
 #include "../compile/Token.h"
+#include "../compile/Symbols.h"
 
 class SymbolicDouble;
 class SymbolicArray;
@@ -94,110 +96,134 @@ public:
     }
 };
 
+/*Var wrappers are immutable and hash-consed: there's one of each access (x, a[3], a[i]) in the Table current on the
+  thread, got from the get functions below. A compilation owns a table alongside its Symbols::Table, so the wrappers
+  go with the names they're made of - outside any there's one for the whole process, never freed. They're passed
+  around as plain const pointers - copying an Atom copies the pointer, and two accesses are the same exactly when
+  their wrappers are*/
 class VarWrapper
 {
+public:
+    class Table
+    {
+    public:
+        Table();
+        ~Table();
+        Table(const Table&) = delete;
+        Table& operator=(const Table&) = delete;
+
+    private:
+        struct Wrappers;
+        std::unique_ptr<Wrappers> wrappers;
+        friend class VarWrapper;
+    };
+
+    //makes table current on this thread until the scope ends
+    class Scope
+    {
+    private:
+        Table* previous;
+    public:
+        explicit Scope(Table& table);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
 protected:
-    std::string name;
-    void setName(std::string n) {name = move(n);}
-    bool compound = false;
-    void setCompound(bool c) {compound = c;}
+    Symbols::Id id;
+    Symbols::Id fullId;
+    bool compound;
+
+    VarWrapper(Symbols::Id base, Symbols::Id full, bool isCompound): id(base), fullId(full), compound(isCompound) {}
+    //returns the wrapper already made for key, or makes one with make
+    template<typename Make>
+    static const VarWrapper* find(unsigned char kind, Symbols::Id base, uintptr_t index, Make make);
 
 public:
+    VarWrapper(const VarWrapper&) = delete;
+    VarWrapper& operator=(const VarWrapper&) = delete;
     virtual ~VarWrapper() {};
-    virtual std::string getFullName() const {return name;}
-    virtual const std::string& getBaseName() const {return name;}
+    const std::string& getFullName() const {return Symbols::name(fullId);}
+    const std::string& getBaseName() const {return Symbols::name(id);}
+    //the variable (or array) this names
+    Symbols::Id getBaseId() const {return id;}
+    //the whole access, what constant propagation and symbolic execution key on
+    Symbols::Id getFullId() const {return fullId;}
     bool isCompound() const {return compound;}
     virtual GottenVarPtr<SymbolicDouble> getSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const  = 0; //todo clone symbolic double
     virtual bool check(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const = 0;
-    virtual std::unique_ptr<VarWrapper> clone() const  = 0;
-    virtual void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) = 0;
-    virtual void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) = 0; //todo test
-    virtual std::vector<const std::string*> getAllNames() const = 0;
+    virtual void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) const = 0;
+    virtual void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) const = 0; //todo test
+    virtual std::vector<Symbols::Id> getAllIds() const = 0;
 
-    virtual void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) = 0;
+    virtual void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const = 0;
 };
 
 
 class SDByName: public VarWrapper
 {
+private:
+    explicit SDByName(Symbols::Id symbol): VarWrapper(symbol, symbol, false) {}
+
 public:
-    SDByName(std::string n)
-    {
-        setName(move(n));
-    }
-    std::vector<const std::string*> getAllNames() const override
+    static const VarWrapper* get(Symbols::Id symbol);
+    static const VarWrapper* get(const std::string& name);
+
+    std::vector<Symbols::Id> getAllIds() const override
     {
-        std::vector<const std::string*> toRet;
-        toRet.push_back(&name);
-        return toRet;
+        return {id};
     }
     GottenVarPtr<SymbolicDouble> getSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
-    void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) override;
-    void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) override;
-    void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) override;
+    void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) const override;
+    void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) const override;
+    void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
     bool check(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
-    std::string getFullName() const override;
-    std::unique_ptr<VarWrapper> clone() const override;
 };
 
 class SDByArrayIndex: public VarWrapper
 {
+private:
+    SDByArrayIndex(Symbols::Id array, unsigned int i);
+
 public:
-    unsigned int index;
+    const unsigned int index;
 
-    SDByArrayIndex(std::string n, unsigned int i): index(i)
-    {
-        setName(move(n));
-    };
+    static const VarWrapper* get(Symbols::Id array, unsigned int index);
 
-    std::string getFullName() const override
+    std::vector<Symbols::Id> getAllIds() const override
     {
-        return name + "[" + std::to_string(index) + "]";
-    }
-    std::vector<const std::string*> getAllNames() const override
-    {
-        std::vector<const std::string*> toRet;
-        toRet.push_back(&name);
-        return toRet;
+        return {id};
     }
     GottenVarPtr<SymbolicDouble> getSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
     bool check(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
-    void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) override;
-    void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) override;
-    void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) override;
-    std::unique_ptr<VarWrapper> clone() const override;
+    void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) const override;
+    void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) const override;
+    void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
 };
 
 class SDByIndexVar: public VarWrapper
 {
-public:
-    std::unique_ptr<VarWrapper> index;
+private:
+    SDByIndexVar(Symbols::Id array, const VarWrapper* var);
 
-    SDByIndexVar(std::string arrN, std::unique_ptr<VarWrapper> var):
-            index(move(var))
-    {
-        setName(move(arrN));
-        setCompound(true);
-    }
+public:
+    const VarWrapper* const index;
 
-    std::string getFullName() const override
-    {
-        return name + "[" + index->getFullName() + "]";
-    }
+    static const VarWrapper* get(Symbols::Id array, const VarWrapper* index);
 
-    std::vector<const std::string*> getAllNames() const override
+    std::vector<Symbols::Id> getAllIds() const override
     {
-        std::vector<const std::string*> names = index->getAllNames();
-        names.push_back(&name);
-        return names;
+        std::vector<Symbols::Id> ids = index->getAllIds();
+        ids.push_back(id);
+        return ids;
     }
 
     GottenVarPtr<SymbolicDouble> getSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
     bool check(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
-    void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) override;
-    void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) override;
-    void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) override;
-    std::unique_ptr<VarWrapper> clone() const override;
+    void setSymbolicDouble(SymbolicExecution::SymbolicExecutionFringe* sef, SymbolicDouble* sd, int linenum) const override;
+    void setConstValue(SymbolicExecution::SymbolicExecutionFringe* sef, double d, int linenum) const override;
+    void nondet(SymbolicExecution::SymbolicExecutionFringe* sef, int linenum) const override;
 };
 
 #endif
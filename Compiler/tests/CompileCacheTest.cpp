@@ -0,0 +1,228 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../source/compile/Compiler.h"
+#include "../source/compile/CompileCache.h"
+
+using namespace std;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool ok, const string& what)
+    {
+        if (!ok)
+        {
+            cerr << "FAILED: " << what << "\n";
+            ++failures;
+        }
+    }
+
+    string makeDirectory()
+    {
+        char name[] = "/tmp/compilecachetestXXXXXX";
+        if (mkdtemp(name) == nullptr) throw runtime_error("Could not make a temporary directory");
+        return name;
+    }
+
+    string readFile(const string& path)
+    {
+        ifstream in(path, ios::binary);
+        ostringstream contents;
+        contents << in.rdbuf();
+        return contents.str();
+    }
+
+    void writeFile(const string& path, const string& contents)
+    {
+        ofstream out(path, ios::binary | ios::trunc);
+        out << contents;
+    }
+
+    string entryPath(const string& directory, const CompileCache::Manifest& manifest)
+    {
+        ostringstream name;
+        name << directory << "/" << hex << manifest.key();
+        return name.str();
+    }
+
+    CompileCache::Manifest manifest()
+    {
+        CompileCache::Manifest m;
+        m.options = "optimise 1";
+        m.globals = 1;
+        m.functions = {{"main", 2}, {"f", 3}};
+        return m;
+    }
+
+    void entries()
+    {
+        string directory = makeDirectory();
+        CompileCache cache(directory);
+        CompileCache::Manifest m = manifest();
+        CompileCache::Entry stored{"output\nwith lines", "", "digraph {}"}, loaded;
+
+        check(!cache.load(m, loaded), "an empty cache misses");
+        cache.store(m, stored);
+        check(cache.load(m, loaded) && loaded.output == stored.output && loaded.warnings == stored.warnings
+              && loaded.graph == stored.graph, "a stored entry loads back");
+
+        //the same key with anything else stored under it in the header
+        const string path = entryPath(directory, m);
+        const string good = readFile(path);
+        CompileCache::Manifest renamed = m;
+        renamed.functions[1].first = "g";
+        writeFile(entryPath(directory, renamed), good);
+        check(!cache.load(renamed, loaded), "an entry stored under other names is rejected");
+
+        string file = good;
+        file.replace(0, 10, "FSMCACHE 0");
+        writeFile(path, file);
+        check(!cache.load(m, loaded), "an entry with another format's header is rejected");
+
+        file = good;
+        file[file.find("output\nwith") + 1] ^= 1;
+        writeFile(path, file);
+        check(!cache.load(m, loaded), "an entry that fails its checksum is rejected");
+
+        for (size_t length : {good.size() - 1, good.size() / 2, (size_t) 5, (size_t) 0})
+        {
+            writeFile(path, good.substr(0, length));
+            check(!cache.load(m, loaded), "an entry truncated to " + to_string(length) + " bytes is rejected");
+        }
+
+        writeFile(path, good.substr(0, good.find("output ")) + "output 99999999999\nx\n");
+        check(!cache.load(m, loaded), "an entry with a length past its end is rejected");
+
+        //a miss is overwritten by the next store
+        cache.store(m, stored);
+        check(cache.load(m, loaded) && loaded.output == stored.output, "a rejected entry is rewritten");
+        check(system(("rm -rf " + directory).c_str()) == 0, "removing " + directory);
+    }
+
+    //a directory kept to three entries' worth - the least recently used, stored or loaded, go
+    void eviction()
+    {
+        string directory = makeDirectory();
+        CompileCache::Entry stored{"output", "", ""}, loaded;
+        vector<CompileCache::Manifest> manifests(5, manifest());
+        for (size_t i = 0; i < manifests.size(); ++i) manifests[i].options += " " + to_string(i);
+
+        struct stat info;
+        CompileCache(directory).store(manifests[0], stored);
+        check(stat(entryPath(directory, manifests[0]).c_str(), &info) == 0, "an entry is stored");
+        CompileCache cache(directory, 0, info.st_size * 3 + info.st_size / 2);
+
+        //apart, so each is used later than the one before by the clock the file system keeps
+        auto pause = [] () {this_thread::sleep_for(chrono::milliseconds(20));};
+        pause();
+        cache.store(manifests[1], stored);
+        pause();
+        cache.store(manifests[2], stored);
+        pause();
+        check(cache.load(manifests[0], loaded), "the cache isn't trimmed while it's under its size");
+        pause();
+        cache.store(manifests[3], stored);
+        check(!cache.load(manifests[1], loaded), "the least recently used entry goes");
+        for (size_t i : {0, 2, 3})
+        {
+            check(cache.load(manifests[i], loaded), "entry " + to_string(i) + " stays, loading one counting as a use");
+            pause();
+        }
+        cache.store(manifests[4], stored);
+        check(!cache.load(manifests[0], loaded) && cache.load(manifests[4], loaded), "the cache stays at its size");
+        check(system(("rm -rf " + directory).c_str()) == 0, "removing " + directory);
+    }
+
+    //the compiled source, or the error, and whether it came from the cache - json gets the time report
+    string compile(const string& text, const CompileCache* cache, bool* cached = nullptr, string* json = nullptr)
+    {
+        Lexer lexer;
+        lexer.read(text.data(), text.size());
+        stringbuf warnings;
+        Reporter reporter(&warnings);
+        Compiler compiler(lexer, reporter);
+        TimeReport times;
+        compiler.setTimeReport(&times);
+        Compiler::Products products;
+        try
+        {
+            compiler.compile(true, true, true, false, false, true, products, 1, cache);
+        }
+        catch (runtime_error& e)
+        {
+            products.source = string("error: ") + e.what();
+        }
+        ostringstream report;
+        times.printJson(report);
+        if (cached) *cached = report.str().find("\"cached\": 1") != string::npos;
+        if (json) *json = report.str();
+        return products.source;
+    }
+
+    //an edit touching nothing but tokens with no lexeme has to miss, and give what compiling it afresh does
+    void edits()
+    {
+        string directory = makeDirectory();
+        CompileCache cache(directory);
+        const string program = "function gcd(double m, double n) double\n{\n    if (m == n) return m;\n"
+                               "    else if (m > n)\n    {\n        m = m - n;\n        return call gcd(m, n);\n    }\n"
+                               "    else\n    {\n        n = n - m;\n        return call gcd(m, n);\n    }\n}\n\n"
+                               "function main() void\n{\n    double m, double n;\n    input m; input n;\n"
+                               "    double y = m + 2;\n    print(y);\n    double result = call gcd(m, n);\n"
+                               "    print(result);\n}\n";
+
+        bool cached;
+        string json;
+        const string first = compile(program, &cache, &cached, &json);
+        check(!cached && first.find("error") != 0, "the first compilation compiles");
+        size_t total = json.find("\"heap_allocations\": ", json.find("\"total\""));
+        check(total != string::npos && json.compare(total + 20, 2, "0}") != 0,
+              "a compilation's heap allocations are counted: " + json.substr(total == string::npos ? 0 : total, 40));
+        check(compile(program, &cache, &cached) == first && cached, "compiling it again is a hit");
+
+        for (const string& op : {"-", "*", "/", "%"})
+        {
+            string edited = program;
+            edited.replace(edited.find("m + 2"), 5, "m " + op + " 2");
+            string result = compile(edited, &cache, &cached);
+            check(!cached, "changing + to " + op + " misses");
+            check(result == compile(edited, nullptr), "changing + to " + op + " compiles it afresh");
+        }
+
+        for (const string& from : {"gcd(double m, double n) double", "main() void"})
+        {
+            string edited = program;
+            size_t at = edited.find(from);
+            size_t type = edited.find(')', at) + 2;
+            edited.replace(type, from.size() - (type - at), from.back() == 'e' ? "void" : "double");
+            string result = compile(edited, &cache, &cached);
+            check(!cached, "changing the return type of " + from + " misses");
+            check(result == compile(edited, nullptr), "changing the return type of " + from + " compiles afresh");
+        }
+
+        check(system(("rm -rf " + directory).c_str()) == 0, "removing " + directory);
+    }
+}
+
+int main()
+{
+    entries();
+    eviction();
+    edits();
+    if (failures != 0)
+    {
+        cerr << failures << " checks failed\n";
+        return 1;
+    }
+    cout << "All passed\n";
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../source/serve/Server.h"
+#include "../source/serve/Protocol.h"
+#include "../source/compile/Symbols.h"
+
+using namespace std;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool ok, const string& what)
+    {
+        if (!ok)
+        {
+            cerr << "FAILED: " << what << "\n";
+            ++failures;
+        }
+    }
+
+    const string socketPath = "/tmp/servertest" + to_string(getpid()) + ".sock";
+    const string program = "function main() void\n{\n    double m;\n    input m;\n    double y = m + 2;\n"
+                           "    print(y);\n}\n";
+
+    //-1 if nothing is serving, with a receive timeout so a test that goes wrong fails rather than hangs
+    int connectToServer()
+    {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, socketPath.c_str());
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (connect(fd, (const sockaddr*) &address, sizeof(address)) != 0)
+        {
+            close(fd);
+            return -1;
+        }
+        timeval wait{5, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+        return fd;
+    }
+
+    bool compile(int fd, Protocol::Response& response, bool timeReport = false)
+    {
+        Protocol::Request request;
+        request.fromText = true;
+        request.source = program;
+        request.timeReport = timeReport;
+        request.allocations = timeReport;
+        return Protocol::send(fd, request) && Protocol::receive(fd, response) && response.ok;
+    }
+
+    //whether the server has closed fd (resetting it, if what was sent wasn't all read) rather than it timing out
+    bool closedByServer(int fd)
+    {
+        char c;
+        ssize_t got = recv(fd, &c, 1, 0);
+        return got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+    }
+
+    double secondsSince(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    Server::Timeouts timeouts;
+    timeouts.request = chrono::milliseconds(300);
+    timeouts.idle = chrono::milliseconds(1500);
+    //serves until the test exits
+    thread([timeouts] ()
+    {
+        Server server(socketPath, 2, nullptr, timeouts);
+        server.run();
+    }).detach();
+
+    int probe = -1;
+    for (int tries = 0; tries < 100 && (probe = connectToServer()) < 0; ++tries) this_thread::sleep_for(50ms);
+    if (probe < 0)
+    {
+        cerr << "FAILED: the server never came up\n";
+        return 1;
+    }
+    close(probe);
+
+    //more idle connections than workers, and one that stops part way through a request
+    vector<int> idle;
+    for (int i = 0; i < 4; ++i) idle.push_back(connectToServer());
+    int stalled = connectToServer();
+    uint32_t fieldCount = 4;
+    check(send(stalled, &fieldCount, sizeof(fieldCount), MSG_NOSIGNAL) == sizeof(fieldCount), "starting a request");
+
+    auto start = chrono::steady_clock::now();
+    int fd = connectToServer();
+    Protocol::Response response;
+    check(compile(fd, response), "a compile with idle connections open is answered: " + response.error);
+    check(secondsSince(start) < 2, "a compile isn't held up by idle connections");
+    check(response.source.find("print") != string::npos, "the compiled source comes back");
+    check(compile(fd, response, true), "a second request on the same connection is answered");
+    check(response.report.find("phase") != string::npos && response.report.find("objects") != string::npos,
+          "-t and -a are forwarded: " + response.report);
+    check(response.report.find("peak RSS is the server process's") != string::npos,
+          "a server's time report leaves out the shared peak RSS: " + response.report);
+    close(fd);
+
+    check(closedByServer(stalled), "a request that stops arriving is dropped");
+
+    int garbage = connectToServer();
+    const char junk[] = "\xff\xff\xff\xff not a message";
+    send(garbage, junk, sizeof(junk), MSG_NOSIGNAL);
+    check(closedByServer(garbage), "a malformed request is dropped");
+
+    //compiles at once from more clients than there are workers
+    atomic<int> answered{0};
+    vector<thread> clients;
+    for (int c = 0; c < 6; ++c)
+    {
+        clients.emplace_back([&answered] ()
+        {
+            int client = connectToServer();
+            Protocol::Response r;
+            for (int i = 0; i < 3; ++i) if (compile(client, r)) ++answered;
+            close(client);
+        });
+    }
+    for (thread& client : clients) client.join();
+    check(answered == 18, "concurrent clients are all answered (" + to_string(answered) + " of 18)");
+
+    this_thread::sleep_for(timeouts.idle + 1s);
+    for (int i : idle) check(closedByServer(i), "an idle connection is closed");
+
+    fd = connectToServer();
+    check(compile(fd, response), "the server still answers afterwards");
+    close(fd);
+    //each compilation interns into a table of its own, freed with it, so nothing builds up in the process's
+    check(Symbols::count() == 0, "compilations leave no names behind (" + to_string(Symbols::count()) + ")");
+    for (int i : idle) close(i);
+    close(stalled);
+    close(garbage);
+    unlink(socketPath.c_str());
+
+    if (failures != 0)
+    {
+        cerr << failures << " checks failed\n";
+        return 1;
+    }
+    cout << "All passed\n";
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <thread>
+#include <stdexcept>
+
+#include "Channel.h"
+
+using namespace std;
+
+namespace
+{
+    //tries that yield before a blocked sender or receiver sleeps
+    const unsigned int spinTries = 64;
+}
+
+Channel::Channel(string cname, size_t capacity, unsigned int producers):
+        name(move(cname)),
+        liveProducers(producers),
+        consumerAlive(true),
+        sleeping(0)
+{
+    if (producers == 0) throw runtime_error("Channel '" + name + "' has no producers");
+    if (producers == 1) spsc = make_unique<SPSCRingBuffer<Variable::TaggedDataUnion>>(capacity);
+    else mpsc = make_unique<MPSCRingBuffer<Variable::TaggedDataUnion>>(capacity);
+}
+
+bool Channel::tryPush(Variable::TaggedDataUnion& tdu)
+{
+    return spsc ? spsc->tryPush(tdu) : mpsc->tryPush(tdu);
+}
+
+bool Channel::tryPop(Variable::TaggedDataUnion& out)
+{
+    return spsc ? spsc->tryPop(out) : mpsc->tryPop(out);
+}
+
+template <typename Attempt>
+void Channel::retry(Attempt attempt)
+{
+    for (unsigned int tries = 0; tries < spinTries; ++tries)
+    {
+        if (attempt()) return;
+        this_thread::yield();
+    }
+
+    //counted as sleeping before the last try, so an end that moves after it sees this one and wakes it (see wake)
+    unique_lock<mutex> lock(sleepLock);
+    sleeping.fetch_add(1);
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!attempt()) moved.wait(lock);
+    sleeping.fetch_sub(1);
+}
+
+void Channel::wake()
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (sleeping.load(memory_order_relaxed) == 0) return;
+    //taking the lock means a sleeper is either waiting already or hasn't made its last try yet
+    lock_guard<mutex> guard(sleepLock);
+    moved.notify_all();
+}
+
+bool Channel::send(const Variable::TaggedDataUnion& tdu)
+{
+    Variable::TaggedDataUnion owned(tdu); //moved into the buffer once there's room
+    bool sent = false;
+    retry([&] () {return (sent = tryPush(owned)) || !consumerAlive.load(memory_order_acquire);});
+    if (sent) wake();
+    return sent;
+}
+
+bool Channel::receive(Variable::TaggedDataUnion& out)
+{
+    bool received = false;
+    retry([&] ()
+    {
+        if ((received = tryPop(out))) return true;
+        if (liveProducers.load(memory_order_acquire) != 0) return false;
+        received = tryPop(out); //one last look after the final send
+        return true;
+    });
+    if (received) wake();
+    return received;
+}
+
+void Channel::producerFinished()
+{
+    liveProducers.fetch_sub(1, memory_order_release);
+    wake();
+}
+
+void Channel::consumerFinished()
+{
+    consumerAlive.store(false, memory_order_release);
+    wake();
+}
+
+const string& Channel::getName() const
+{
+    return name;
+}
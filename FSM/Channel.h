@@ -0,0 +1,180 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <unordered_map>
+
+#include "Variable.h"
+
+//single producer, single consumer - the producer only touches tail, the consumer only touches head. Items are moved in
+//(only when there's room) and moved out again, so a value owning memory is never in two slots
+template <typename T>
+class SPSCRingBuffer
+{
+public:
+    explicit SPSCRingBuffer(size_t capacity);
+    bool tryPush(T& item);
+    bool tryPop(T& out);
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+};
+
+//multiple producer, single consumer - each slot carries a sequence number (Vyukov's bounded queue)
+template <typename T>
+class MPSCRingBuffer
+{
+public:
+    explicit MPSCRingBuffer(size_t capacity);
+    bool tryPush(T& item);
+    bool tryPop(T& out);
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T item;
+        Slot(): sequence(0), item(0.0) {}
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+};
+
+inline size_t roundUpToPowerOfTwo(size_t n)
+{
+    size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+template <typename T>
+SPSCRingBuffer<T>::SPSCRingBuffer(size_t capacity):
+        slots(roundUpToPowerOfTwo(capacity), T(0.0)),
+        mask(slots.size() - 1),
+        head(0),
+        tail(0) {}
+
+template <typename T>
+bool SPSCRingBuffer<T>::tryPush(T& item)
+{
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == slots.size()) return false;
+    slots[t & mask] = std::move(item);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SPSCRingBuffer<T>::tryPop(T& out)
+{
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return false;
+    out = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+MPSCRingBuffer<T>::MPSCRingBuffer(size_t capacity):
+        slots(new Slot[roundUpToPowerOfTwo(capacity)]),
+        mask(roundUpToPowerOfTwo(capacity) - 1),
+        head(0),
+        tail(0)
+{
+    for (size_t i = 0; i <= mask; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool MPSCRingBuffer<T>::tryPush(T& item)
+{
+    size_t pos = tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = slots[pos & mask];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        long diff = (long) seq - (long) pos;
+        if (diff == 0)
+        {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot.item = std::move(item);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0) return false; //full
+        else pos = tail.load(std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool MPSCRingBuffer<T>::tryPop(T& out)
+{
+    size_t pos = head.load(std::memory_order_relaxed);
+    Slot& slot = slots[pos & mask];
+    size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if ((long) seq - (long) (pos + 1) < 0) return false; //empty, or a producer hasn't finished writing
+    out = std::move(slot.item);
+    slot.sequence.store(pos + mask + 1, std::memory_order_release);
+    head.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+/*Named connection between machines running on separate threads. A sent value is copied once into the buffer and
+  moved out to the receiver, and whatever is still buffered when the channel goes is freed with it. A blocked sender
+  or receiver yields for a few tries, then sleeps until the other end moves - so a machine waiting on a quiet
+  neighbour doesn't hold a core*/
+class Channel
+{
+public:
+    Channel(std::string name, size_t capacity, unsigned int producers);
+
+    //blocks while full, returns false if the consumer has finished
+    bool send(const Variable::TaggedDataUnion& tdu);
+    //blocks while empty, returns false once every producer has finished and the buffer is drained
+    bool receive(Variable::TaggedDataUnion& out);
+
+    void producerFinished();
+    void consumerFinished();
+    const std::string& getName() const;
+
+private:
+    bool tryPush(Variable::TaggedDataUnion& tdu);
+    bool tryPop(Variable::TaggedDataUnion& out);
+    //retries attempt until it returns true, yielding then sleeping between tries
+    template <typename Attempt>
+    void retry(Attempt attempt);
+    //after pushing, popping or finishing - wakes the other end if it's asleep
+    void wake();
+
+    std::string name;
+    std::unique_ptr<SPSCRingBuffer<Variable::TaggedDataUnion>> spsc;
+    std::unique_ptr<MPSCRingBuffer<Variable::TaggedDataUnion>> mpsc;
+    std::atomic<unsigned int> liveProducers;
+    std::atomic<bool> consumerAlive;
+
+    std::mutex sleepLock;
+    std::condition_variable moved;
+    std::atomic<unsigned int> sleeping;
+};
+
+//the channels a single machine is allowed to use, by name
+struct ChannelBindings
+{
+    std::unordered_map<std::string, Channel*> sendsTo;
+    std::unordered_map<std::string, Channel*> receivesFrom;
+};
+
+#endif
@@ -1,4 +1,8 @@
 #include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
 #include <math.h>
 
 #include "Command.h"
@@ -6,6 +10,12 @@
 
 using namespace std;
 
+//doubles that integer variables can hold exactly
+static bool isIntegral(double d)
+{
+    return d == trunc(d) && fabs(d) <= 9007199254740992.0; //2^53
+}
+
 int AbstractCommand::getNextState() const
 {
     return nextState;
@@ -21,6 +31,11 @@ void AbstractCommand::setState(int i)
     nextState = i;
 }
 
+void AbstractCommand::renumberStates(const vector<int>& newNumber)
+{
+    if (nextState != -1) nextState = newNumber.at(nextState);
+}
+
 void AbstractCommand::setChangeState(bool b)
 {
     changeState = b;
@@ -48,17 +63,29 @@ std::string PrintCommand<T>::unescape(const string& in)
 }
 
 template<>
-PrintCommand<string>::PrintCommand(string s)
+PrintCommand<string>::PrintCommand(string s, FSM& ioOwner):
+    io(&ioOwner.io),
+    metrics(&ioOwner.metrics)
 {
     this->toPrint = move(s);//unescape(s);
 }
 
 template <typename T>
-PrintCommand<T>::PrintCommand(T toPrint)
+PrintCommand<T>::PrintCommand(T toPrint, FSM& ioOwner):
+    io(&ioOwner.io),
+    metrics(&ioOwner.metrics)
 {
     this->toPrint = toPrint;
 }
 
+template <typename T>
+void PrintCommand<T>::print(const string& text)
+{
+    if (io->print) io->print(text);
+    else cout << text;
+    if (metrics->isEnabled()) metrics->output(text.length());
+}
+
 template<>
 void PrintCommand<Variable*>::execute()
 {
@@ -67,12 +94,19 @@ void PrintCommand<Variable*>::execute()
         case Type::STRING:
         {
             string *ref = toPrint->getData();
-            cout << *ref;
+            print(*ref);
             break;
         }
         case Type::DOUBLE:
+        case Type::INT:
         {
-            cout << (double) toPrint->getData();
+            if (io->print || metrics->isEnabled())
+            {
+                ostringstream formatted;
+                formatted << toPrint->getNumber();
+                print(formatted.str());
+            }
+            else cout << toPrint->getNumber();
             break;
         }
     }
@@ -81,7 +115,7 @@ void PrintCommand<Variable*>::execute()
 template <typename T>
 void PrintCommand<T>::execute()
 {
-    cout << toPrint;
+    print(toPrint);
 }
 
 /*JumpCommand*/
@@ -95,76 +129,139 @@ void JumpCommand::execute(){}
 
 /*ReturnCommand - jumps to the number on top of the stack if it is not empty*/
 ReturnCommand::ReturnCommand(FSM &stackOwner):
-        popFrom(&stackOwner.sharedStack) {}
+        popFrom(&stackOwner.sharedStack),
+        trace(&stackOwner.trace) {}
 
 void ReturnCommand::execute()
 {
     if (popFrom->empty()) setChangeState(false);
     else
     {
-        setState((int)popFrom->top().contents);
+        setState((int) popFrom->top().asNumber());
         popFrom->pop();
         setChangeState(true);
+        if (trace->isEnabled()) trace->record(RETURN, popFrom->size());
     }
 }
 
 /*InputVarCommand*/
-InputVarCommand::InputVarCommand(Variable* varPtr):
-        var(varPtr) {}
+InputVarCommand::InputVarCommand(Variable* varPtr, FSM& ioOwner):
+        var(varPtr),
+        io(&ioOwner.io),
+        metrics(&ioOwner.metrics) {}
 
 void InputVarCommand::execute()
+{
+    if (!metrics->isEnabled()) return read();
+    auto start = chrono::steady_clock::now();
+    read();
+    metrics->blockedOnInput(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+}
+
+void InputVarCommand::read()
 {
     switch(var->getType())
     {
         case Type::STRING:
         {
             string str;
-            cin >> str;
+            if (io->input) io->input(str);
+            else cin >> str;
             var->setData(str);
             break;
         }
         case Type::DOUBLE:
         {
-            int d;
-            cin >> d;
-            var->setData(d);
+            int d = 0;
+            if (io->input)
+            {
+                string word;
+                if (io->input(word)) d = strtol(word.c_str(), nullptr, 10);
+            }
+            else cin >> d;
+            var->setData((double) d);
+            break;
+        }
+        case Type::INT:
+        {
+            long long i = 0;
+            if (io->input)
+            {
+                string word;
+                if (io->input(word)) i = strtoll(word.c_str(), nullptr, 10);
+            }
+            else cin >> i;
+            var->setData(i);
             break;
         }
         default:
-            throw runtime_error("Strange type");
+            throw FSMException(FSMError::INTERNAL, "Strange type");
     }
 }
 
+NondetCommand::NondetCommand(Variable* varPtr, FSM& owner):
+        var(varPtr),
+        random(&owner.random) {}
+
+void NondetCommand::execute()
+{
+    if (var->getType() == Type::INT) var->setData(random->nextInteger());
+    else var->setData(random->nextDouble());
+}
+
 /*PushCommand*/
 template <typename T>
 PushCommand<T>::PushCommand(T in, FSM &stackOwner):
     var(in),
-    pushTo(&stackOwner.sharedStack)
+    pushTo(&stackOwner.sharedStack),
+    trace(&stackOwner.trace)
 {}
 
 template<>
 void PushCommand<Variable*>::execute()
 {
     pushTo->push(var->getTaggedDataUnion());
+    if (trace->isEnabled()) trace->record(PUSH, pushTo->size());
 }
 
 template<class T>
 void PushCommand<T>::execute()
 {
     pushTo->push(Variable::TaggedDataUnion(var));
+    if (trace->isEnabled()) trace->record(PUSH, pushTo->size());
+}
+
+/*PushStateCommand*/
+PushStateCommand::PushStateCommand(int pushed, FSM& stackOwner):
+        state(pushed),
+        pushTo(&stackOwner.sharedStack),
+        trace(&stackOwner.trace)
+{}
+
+void PushStateCommand::renumberStates(const vector<int>& newNumber)
+{
+    state = newNumber.at(state);
+}
+
+void PushStateCommand::execute()
+{
+    pushTo->pushState(state);
+    if (trace->isEnabled()) trace->record(PUSH, pushTo->size());
 }
 
 /*PopCommand*/
 PopCommand::PopCommand(Variable* varPtr, FSM &stackOwner):
         var(move(varPtr)),
-        popFrom(&stackOwner.sharedStack)
+        popFrom(&stackOwner.sharedStack),
+        trace(&stackOwner.trace)
 {}
 
 void PopCommand::execute()
 {
-    if (popFrom->empty()) throw "tried to pop empty stack";
+    if (popFrom->empty()) throw FSMException(FSMError::EMPTY_STACK, "tried to pop empty stack");
     if (var != nullptr) var->setData(popFrom->top());
     popFrom->pop();
+    if (trace->isEnabled()) trace->record(POP, popFrom->size());
 }
 
 /*AssignVarCommand*/
@@ -179,6 +276,24 @@ void AssignVarCommand<T>::execute()
     var->setData(val);
 }
 
+template <>
+bool AssignVarCommand<double>::writesIntegral(const unordered_set<Variable*>&) const
+{
+    return isIntegral(val);
+}
+
+template <>
+bool AssignVarCommand<Variable*>::writesIntegral(const unordered_set<Variable*>& integral) const
+{
+    return integral.find(val) != integral.end();
+}
+
+template <>
+bool AssignVarCommand<string>::writesIntegral(const unordered_set<Variable*>&) const
+{
+    return false;
+}
+
 /*EvaluateExprCommand*/
 template <typename T>
 EvaluateExprCommand<T>::EvaluateExprCommand(Variable* varPtr, Variable* LHSVar, T b, ExpressionType t):
@@ -187,57 +302,93 @@ EvaluateExprCommand<T>::EvaluateExprCommand(Variable* varPtr, Variable* LHSVar,
     term2(b),
     type(t)
 {
-    if (varPtr->getType() != LHSVar->getType()) throw runtime_error("Incompatible types in evaluation");
+    if (varPtr->getType() == STRING || LHSVar->getType() == STRING)
+    {
+        throw FSMException(FSMError::TYPE_MISMATCH, "Incompatible types in evaluation");
+    }
 }
 
-template <typename T>
-void EvaluateExprCommand<T>::evaluate(double one, double two)
+//the bits AND and OR work on - the whole part, of anything an int64 can hold
+static long long bitsOf(double d)
+{
+    return d > -9223372036854775808.0 && d < 9223372036854775808.0 ? (long long) d : 0;
+}
+
+static double evaluateDouble(double one, ExpressionType type, double two)
 {
     switch(type)
     {
         case MUL:
-            var->setData(one * two);
-            break;
+            return one * two;
         case DIV:
-            var->setData(one / two);
-            break;
+            return one / two;
         case PLUS:
-            var->setData(one + two);
-            break;
+            return one + two;
         case MINUS:
-            var->setData(one - two);
-            break;
+            return one - two;
         case MOD:
-            var->setData(fmod(one, two));
-            break;
+            return fmod(one, two);
         case POW:
-            var->setData(pow(one, two));
-            break;
+            return pow(one, two);
         case AND:
-            var->setData((int)one & (int)two);
-            break;
+            return (double) (bitsOf(one) & bitsOf(two));
         case OR:
-            var->setData((int)one | (int)two);
-            break;
+            return (double) (bitsOf(one) | bitsOf(two));
         default:
-            throw runtime_error("Weird comparison");
+            throw FSMException(FSMError::INTERNAL, "Weird comparison");
     }
 }
 
-/*EvaluateExprCommand*/
+template <typename T>
+void EvaluateExprCommand<T>::evaluate(double one, double two)
+{
+    var->setData(evaluateDouble(one, type, two));
+}
+
 template <>
 void EvaluateExprCommand<Variable*>::execute()
 {
-    double d1 = (double) term1->getData();
-    double d2 = (double) term2->getData();
-    evaluate(d1, d2);
+    evaluate(term1->getNumber(), term2->getNumber());
 }
 
 template <>
 void EvaluateExprCommand<double>::execute()
 {
-    double d1 = (double) term1->getData();
-    evaluate(d1, term2);
+    evaluate(term1->getNumber(), term2);
+}
+
+//the ops that keep integers integral (DIV and POW don't), as long as nothing is taken mod zero
+static bool integralOp(ExpressionType type)
+{
+    return type == PLUS || type == MINUS || type == MUL || type == MOD || type == AND || type == OR;
+}
+
+template <>
+bool EvaluateExprCommand<Variable*>::writesIntegral(const unordered_set<Variable*>& integral) const
+{
+    return integralOp(type) && integral.find(term1) != integral.end() && integral.find(term2) != integral.end();
+}
+
+template <>
+bool EvaluateExprCommand<double>::writesIntegral(const unordered_set<Variable*>& integral) const
+{
+    return integralOp(type) && integral.find(term1) != integral.end() && isIntegral(term2)
+           && !(type == MOD && term2 == 0);
+}
+
+template <>
+unique_ptr<AbstractCommand> EvaluateExprCommand<Variable*>::integerVersion() const
+{
+    if (!integralOp(type) || var->getType() != INT || term1->getType() != INT || term2->getType() != INT) return nullptr;
+    return make_unique<IntEvaluateExprCommand<Variable*>>(var, term1, term2, type);
+}
+
+template <>
+unique_ptr<AbstractCommand> EvaluateExprCommand<double>::integerVersion() const
+{
+    if (!integralOp(type) || var->getType() != INT || term1->getType() != INT || !isIntegral(term2)
+        || (type == MOD && term2 == 0)) return nullptr;
+    return make_unique<IntEvaluateExprCommand<long long>>(var, term1, (long long) term2, type);
 }
 
 /*JumpOnComparisonCommand*/
@@ -245,7 +396,9 @@ template <typename T>
 JumpOnComparisonCommand<T>::JumpOnComparisonCommand(Variable* varPtr, T compare, int jstate, ComparisonOp type):
         compareTo(compare),
         cop(type),
-        var(varPtr)
+        var(varPtr),
+        popFrom(nullptr),
+        trace(nullptr)
         {setState(jstate);}
 
 template <typename T>
@@ -253,34 +406,362 @@ JumpOnComparisonCommand<T>::JumpOnComparisonCommand(Variable* varPtr, T compare,
         compareTo(compare),
         cop(type),
         var(varPtr),
-        popFrom(&stackOwner.sharedStack){}
+        popFrom(&stackOwner.sharedStack),
+        trace(&stackOwner.trace){}
 
 template <>
 void JumpOnComparisonCommand<Variable*>::execute()
 {
     if (var->getType() == STRING) setChangeState(evaluateComparisonOp<string>
                                                          (*(var->getData().str), cop, *(compareTo->getData().str)));
-    else setChangeState(evaluateComparisonOp<double>(var->getData().d, cop, compareTo->getData().d));
+    else setChangeState(evaluateComparisonOp<double>(var->getNumber(), cop, compareTo->getNumber()));
+
+    if (changesState() && getNextState() == -1)
+    {
+        setState((int) popFrom->top().asNumber());
+        popFrom->pop();
+        if (trace->isEnabled()) trace->record(RETURN, popFrom->size());
+    }
+}
+template <>
+void JumpOnComparisonCommand<double>::execute()
+{
+    setChangeState(evaluateComparisonOp<double>(var->getNumber(), cop, compareTo));
 
     if (changesState() && getNextState() == -1)
     {
-        setState((int)popFrom->top().contents);
+        setState((int) popFrom->top().asNumber());
         popFrom->pop();
+        if (trace->isEnabled()) trace->record(RETURN, popFrom->size());
+    }
+}
+
+template <>
+void JumpOnComparisonCommand<string>::execute()
+{
+    setChangeState(evaluateComparisonOp<string>(*(var->getData().str), cop, compareTo));
+
+    if (changesState() && getNextState() == -1)
+    {
+        setState((int) popFrom->top().asNumber());
+        popFrom->pop();
+        if (trace->isEnabled()) trace->record(RETURN, popFrom->size());
+    }
+}
+
+template <>
+unique_ptr<AbstractCommand> JumpOnComparisonCommand<Variable*>::integerVersion() const
+{
+    if (var->getType() != INT || compareTo->getType() != INT) return nullptr;
+    return make_unique<IntJumpOnComparisonCommand<Variable*>>(var, compareTo, getNextState(), cop, popFrom, trace);
+}
+
+template <>
+unique_ptr<AbstractCommand> JumpOnComparisonCommand<double>::integerVersion() const
+{
+    if (var->getType() != INT || !isIntegral(compareTo)) return nullptr;
+    return make_unique<IntJumpOnComparisonCommand<long long>>(var, (long long) compareTo, getNextState(), cop,
+                                                              popFrom, trace);
+}
+
+template <>
+unique_ptr<AbstractCommand> JumpOnComparisonCommand<string>::integerVersion() const
+{
+    return nullptr;
+}
+
+/*SwitchCommand*/
+SwitchCommand::SwitchCommand(Variable* varPtr, vector<pair<double, int>> cases, int defState):
+        var(varPtr),
+        defaultState(defState),
+        lookup(SEARCH)
+{
+    if (var->getType() == STRING) throw FSMException(FSMError::TYPE_MISMATCH, "Can't switch on string '"
+                                                                             + var->getName() + "'");
+    sort(cases.begin(), cases.end());
+    for (size_t i = 1; i < cases.size(); ++i)
+    {
+        if (cases[i].first == cases[i - 1].first) throw FSMException(FSMError::SYNTAX, "Duplicate switch case");
+    }
+
+    bool integral = !cases.empty();
+    for (auto& c : cases) integral = integral && isIntegral(c.first);
+
+    if (integral)
+    {
+        long long low = (long long) cases.front().first, high = (long long) cases.back().first;
+        if ((unsigned long long) (high - low) < 2 * cases.size())
+        {
+            lookup = DENSE;
+            base = low;
+            table.assign(high - low + 1, -1);
+            for (auto& c : cases) table[(long long) c.first - low] = c.second;
+            return;
+        }
+        if (findPerfectHash(cases)) return;
+    }
+    sorted = move(cases);
+}
+
+//tries multipliers until every key lands in its own slot, growing the table a few times before giving up
+bool SwitchCommand::findPerfectHash(const vector<pair<double, int>>& cases)
+{
+    unsigned int bits = 1;
+    while (((size_t) 1 << bits) < 2 * cases.size()) bits++;
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (unsigned int grow = 0; grow < 3; ++grow, ++bits)
+    {
+        size_t size = (size_t) 1 << bits;
+        for (int attempt = 0; attempt < 256; ++attempt)
+        {
+            //splitmix64 - any odd multiplier will do, these are just well spread
+            uint64_t m = (seed += 0x9E3779B97F4A7C15ULL);
+            m = (m ^ (m >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            m = (m ^ (m >> 27)) * 0x94D049BB133111EBULL;
+            m = (m ^ (m >> 31)) | 1;
+
+            table.assign(size, -1);
+            slotKeys.assign(size, 0);
+            bool collision = false;
+            for (auto& c : cases)
+            {
+                long long key = (long long) c.first;
+                size_t slot = (size_t) (((uint64_t) key * m) >> (64 - bits));
+                if (table[slot] != -1)
+                {
+                    collision = true;
+                    break;
+                }
+                table[slot] = c.second;
+                slotKeys[slot] = key;
+            }
+            if (!collision)
+            {
+                lookup = HASH;
+                multiplier = m;
+                shift = 64 - bits;
+                return true;
+            }
+        }
+    }
+    table.clear();
+    slotKeys.clear();
+    return false;
+}
+
+int SwitchCommand::find(double d) const
+{
+    switch (lookup)
+    {
+        case DENSE:
+        {
+            if (!isIntegral(d)) return -1;
+            unsigned long long offset = (unsigned long long) ((long long) d - base);
+            return offset < table.size() ? table[offset] : -1;
+        }
+
+        case HASH:
+        {
+            if (!isIntegral(d)) return -1;
+            long long key = (long long) d;
+            size_t slot = (size_t) (((uint64_t) key * multiplier) >> shift);
+            return slotKeys[slot] == key ? table[slot] : -1;
+        }
+
+        case SEARCH:
+        {
+            auto it = lower_bound(sorted.begin(), sorted.end(), d, [] (const pair<double, int>& c, double key)
+            {
+                return c.first < key;
+            });
+            return it != sorted.end() && it->first == d ? it->second : -1;
+        }
+    }
+    return -1;
+}
+
+void SwitchCommand::execute()
+{
+    int state = find(var->getNumber());
+    if (state == -1) state = defaultState;
+    setChangeState(state != -1);
+    if (state != -1) setState(state);
+}
+
+void SwitchCommand::jumpTargets(vector<int>& targets) const
+{
+    if (lookup == SEARCH) for (auto& c : sorted) targets.push_back(c.second);
+    else for (int state : table) if (state != -1) targets.push_back(state);
+    if (defaultState != -1) targets.push_back(defaultState);
+}
+
+void SwitchCommand::renumberStates(const vector<int>& newNumber)
+{
+    for (auto& c : sorted) c.second = newNumber.at(c.second);
+    for (int& state : table) if (state != -1) state = newNumber.at(state);
+    if (defaultState != -1) defaultState = newNumber.at(defaultState);
+}
+
+/*SendCommand - ends the machine if nobody is listening any more*/
+template <typename T>
+SendCommand<T>::SendCommand(Channel* sendTo, T value):
+        channel(sendTo),
+        val(value) {}
+
+template <>
+void SendCommand<Variable*>::execute()
+{
+    if (!channel->send(val->getTaggedDataUnion()))
+    {
+        setState(-1);
+        setChangeState(true);
+    }
+}
+
+template <typename T>
+void SendCommand<T>::execute()
+{
+    if (!channel->send(Variable::TaggedDataUnion(val)))
+    {
+        setState(-1);
+        setChangeState(true);
+    }
+}
+
+/*ReceiveCommand - ends the machine once the channel is closed and drained*/
+ReceiveCommand::ReceiveCommand(Channel* receiveFrom, Variable* varPtr, FSM& metricsOwner):
+        channel(receiveFrom),
+        var(varPtr),
+        metrics(&metricsOwner.metrics) {}
+
+void ReceiveCommand::execute()
+{
+    Variable::TaggedDataUnion received(0.0);
+    bool open;
+    if (!metrics->isEnabled()) open = channel->receive(received);
+    else
+    {
+        auto start = chrono::steady_clock::now();
+        open = channel->receive(received);
+        metrics->blockedOnInput(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    }
+    if (!open)
+    {
+        setState(-1);
+        setChangeState(true);
+        return;
     }
+    var->setData(move(received));
 }
 
+/*IntEvaluateExprCommand*/
+template <typename T>
+IntEvaluateExprCommand<T>::IntEvaluateExprCommand(Variable* varPtr, Variable* LHSVar, T b, ExpressionType t):
+        var(varPtr),
+        type(t),
+        term1(LHSVar),
+        term2(b) {}
 
+static inline bool holdsInt(Variable* var)
+{
+    return var->getType() == INT;
+}
+
+static inline bool holdsInt(long long)
+{
+    return true;
+}
+
+static inline long long intValue(Variable* var)
+{
+    return var->getData().i;
+}
+
+static inline long long intValue(long long i)
+{
+    return i;
+}
+
+static inline double numberValue(Variable* var)
+{
+    return var->getNumber();
+}
+
+static inline double numberValue(long long i)
+{
+    return (double) i;
+}
+
+/*An operand that has gone back to being a double, a result that overflows or a modulo by zero is worked out as a
+  double - which is what the variables were before inference, see Variable::setData. Declared ints throw instead*/
 template <typename T>
-void JumpOnComparisonCommand<T>::execute()
+void IntEvaluateExprCommand<T>::execute()
 {
-    T data = (T)var->getData();
+    if (!holdsInt(term1) || !holdsInt(term2))
+    {
+        var->setData(evaluateDouble(term1->getNumber(), type, numberValue(term2)));
+        return;
+    }
 
-    setChangeState(evaluateComparisonOp<T>(data, cop, compareTo));
+    long long one = term1->getData().i;
+    long long two = intValue(term2);
+    long long result;
+    bool overflowed = false;
+    switch(type)
+    {
+        case MUL:
+            overflowed = __builtin_mul_overflow(one, two, &result);
+            break;
+        case PLUS:
+            overflowed = __builtin_add_overflow(one, two, &result);
+            break;
+        case MINUS:
+            overflowed = __builtin_sub_overflow(one, two, &result);
+            break;
+        case MOD:
+            if (two == 0 && !var->isInferred()) throw FSMException(FSMError::ARITHMETIC, "Integer modulo by zero");
+            overflowed = two == 0 || two == -1; //LLONG_MIN % -1 traps
+            if (!overflowed) result = one % two;
+            break;
+        case AND:
+            result = one & two;
+            break;
+        case OR:
+            result = one | two;
+            break;
+        default:
+            throw FSMException(FSMError::INTERNAL, "Expression has no integer version");
+    }
+    if (overflowed) var->setData(evaluateDouble((double) one, type, (double) two));
+    else var->setData(result);
+}
+
+/*IntJumpOnComparisonCommand*/
+template <typename T>
+IntJumpOnComparisonCommand<T>::IntJumpOnComparisonCommand(Variable* varPtr, T compare, int jstate, ComparisonOp type,
+                                                          SharedStack* stack, ExecutionTrace* stackTrace):
+        var(varPtr),
+        compareTo(compare),
+        cop(type),
+        popFrom(stack),
+        trace(stackTrace)
+        {setState(jstate);}
+
+template <typename T>
+void IntJumpOnComparisonCommand<T>::execute()
+{
+    if (holdsInt(var) && holdsInt(compareTo))
+    {
+        setChangeState(evaluateComparisonOp<long long>(var->getData().i, cop, intValue(compareTo)));
+    }
+    else setChangeState(evaluateComparisonOp<double>(var->getNumber(), cop, numberValue(compareTo)));
 
     if (changesState() && getNextState() == -1)
     {
-        setState((int)popFrom->top().contents);
+        setState((int) popFrom->top().asNumber());
         popFrom->pop();
+        if (trace->isEnabled()) trace->record(RETURN, popFrom->size());
     }
 }
 
@@ -297,3 +778,10 @@ template class PrintCommand<Variable*>;
 template class PushCommand<double>;
 template class PushCommand<string>;
 template class PushCommand<Variable*>;
+template class SendCommand<double>;
+template class SendCommand<string>;
+template class SendCommand<Variable*>;
+template class IntEvaluateExprCommand<Variable*>;
+template class IntEvaluateExprCommand<long long>;
+template class IntJumpOnComparisonCommand<Variable*>;
+template class IntJumpOnComparisonCommand<long long>;
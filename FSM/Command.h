@@ -1,11 +1,26 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
-#include <stack>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <unordered_set>
 
 #include "Variable.h"
+#include "SharedStack.h"
 #include "State.h"
 #include "Enums.h"
+#include "Channel.h"
+#include "Trace.h"
+#include "Errors.h"
+#include "FSMIO.h"
+#include "Metrics.h"
+#include "Random.h"
+
+//for commands templated on what they use - only a Variable* is something read
+inline void addIfVariable(std::vector<Variable*>& vars, Variable* var) {vars.push_back(var);}
+template <typename T>
+inline void addIfVariable(std::vector<Variable*>& vars, const T&) {}
 
 class AbstractCommand
 {
@@ -13,7 +28,31 @@ public:
     int getNextState() const;
     bool changesState() const;
 
+    virtual ~AbstractCommand() {}
     virtual void execute() = 0;
+    //prints, reads or talks to another machine
+    virtual bool performsIO() const {return false;}
+
+    //for integer inference - the variable written, and whether what's written is always integral given that the
+    //variables in (integral) are
+    virtual Variable* writes() const {return nullptr;}
+    virtual bool writesIntegral(const std::unordered_set<Variable*>&) const {return false;}
+    //a replacement using integer instructions once its variables have been made INT, or nullptr
+    virtual std::unique_ptr<AbstractCommand> integerVersion() const {return nullptr;}
+
+    //for laying out states - the states it can go to other than through a return, and whether it always jumps (so
+    //nothing after it in the state runs)
+    virtual void jumpTargets(std::vector<int>& targets) const {}
+    virtual bool alwaysJumps() const {return false;}
+    //moves each of those targets (t) to newNumber[t], when the states are laid out
+    virtual void renumberStates(const std::vector<int>& newNumber);
+
+    //for dead code elimination - what it does with the stack (RETURNS is any jump to a popped state), the variables
+    //whose values it uses, and whether writing writes() is all it does, so it can go if that is never read
+    enum StackUse {NO_STACK, PUSHES_VALUE, POPS_VALUE, PUSHES_STATE, RETURNS};
+    virtual StackUse stackUse() const {return NO_STACK;}
+    virtual void reads(std::vector<Variable*>& vars) const {}
+    virtual bool onlyWrites() const {return false;}
 
 private:
     int nextState = -1;
@@ -28,11 +67,16 @@ template <typename T>
 class PrintCommand: public AbstractCommand
 {
 public:
-    PrintCommand(T);
+    PrintCommand(T, FSM& ioOwner);
     void execute() override;
+    bool performsIO() const override {return true;}
+    void reads(std::vector<Variable*>& vars) const override {addIfVariable(vars, toPrint);}
 private:
     static std::string unescape(const std::string&);
+    void print(const std::string& text);
     T toPrint;
+    const FSMIO* io;
+    MachineMetrics* metrics;
 };
 
 class JumpCommand: public AbstractCommand
@@ -40,6 +84,8 @@ class JumpCommand: public AbstractCommand
 public:
     JumpCommand(int);
     void execute() override;
+    void jumpTargets(std::vector<int>& targets) const override {targets.push_back(getNextState());}
+    bool alwaysJumps() const override {return true;}
 };
 
 class ReturnCommand: public AbstractCommand
@@ -47,17 +93,38 @@ class ReturnCommand: public AbstractCommand
 public:
     ReturnCommand(FSM& stackOwner);
     void execute() override;
+    StackUse stackUse() const override {return RETURNS;}
 private:
-    std::stack<Variable::TaggedDataUnion>* popFrom;
+    SharedStack* popFrom;
+    ExecutionTrace* trace;
 };
 
 class InputVarCommand: public AbstractCommand
 {
 public:
-    InputVarCommand(Variable* varPtr);
+    InputVarCommand(Variable* varPtr, FSM& ioOwner);
+    void execute() override;
+    bool performsIO() const override {return true;}
+    Variable* writes() const override {return var;}
+    bool writesIntegral(const std::unordered_set<Variable*>&) const override {return true;} //reads ints
+private:
+    void read();
+    Variable* var;
+    const FSMIO* io;
+    MachineMetrics* metrics;
+};
+
+//a value from the machine's RandomStream, anything the variable's type holds - see RandomStream::nextDouble
+class NondetCommand: public AbstractCommand
+{
+public:
+    NondetCommand(Variable* varPtr, FSM& owner);
     void execute() override;
+    bool performsIO() const override {return true;} //the stream is state the watchdog can't see
+    Variable* writes() const override {return var;}
 private:
     Variable* var;
+    RandomStream* random;
 };
 
 template <typename T>
@@ -66,9 +133,27 @@ class PushCommand: public AbstractCommand
 public:
     PushCommand(T in, FSM& stackOwner);
     void execute() override;
+    StackUse stackUse() const override {return PUSHES_VALUE;}
+    void reads(std::vector<Variable*>& vars) const override {addIfVariable(vars, var);}
 private:
     T var;
-    std::stack<Variable::TaggedDataUnion>* pushTo;
+    SharedStack* pushTo;
+    ExecutionTrace* trace;
+};
+
+//pushes a state to return to - kept apart from PushCommand<double> so the stack knows it's a state
+class PushStateCommand: public AbstractCommand
+{
+public:
+    PushStateCommand(int state, FSM& stackOwner);
+    void execute() override;
+    void jumpTargets(std::vector<int>& targets) const override {targets.push_back(state);}
+    void renumberStates(const std::vector<int>& newNumber) override;
+    StackUse stackUse() const override {return PUSHES_STATE;}
+private:
+    int state;
+    SharedStack* pushTo;
+    ExecutionTrace* trace;
 };
 
 class PopCommand: public AbstractCommand
@@ -76,9 +161,12 @@ class PopCommand: public AbstractCommand
 public:
     PopCommand(Variable* varPtr, FSM& stackOwner);
     void execute() override;
+    Variable* writes() const override {return var;}
+    StackUse stackUse() const override {return POPS_VALUE;}
 private:
     Variable* var;
-    std::stack<Variable::TaggedDataUnion>* popFrom;
+    SharedStack* popFrom;
+    ExecutionTrace* trace;
 };
 
 template <typename T>
@@ -87,6 +175,10 @@ class AssignVarCommand: public AbstractCommand
 public:
     AssignVarCommand(Variable* varPtr, T value);
     void execute() override;
+    Variable* writes() const override {return var;}
+    bool writesIntegral(const std::unordered_set<Variable*>& integral) const override;
+    void reads(std::vector<Variable*>& vars) const override {addIfVariable(vars, val);}
+    bool onlyWrites() const override {return true;}
 private:
     Variable* var;
     T val;
@@ -98,6 +190,15 @@ class EvaluateExprCommand: public AbstractCommand
 public:
     EvaluateExprCommand(Variable* varPtr, Variable* RHSVar, T b, ExpressionType t);
     void execute() override;
+    Variable* writes() const override {return var;}
+    bool writesIntegral(const std::unordered_set<Variable*>& integral) const override;
+    std::unique_ptr<AbstractCommand> integerVersion() const override;
+    void reads(std::vector<Variable*>& vars) const override
+    {
+        vars.push_back(term1);
+        addIfVariable(vars, term2);
+    }
+    bool onlyWrites() const override {return true;}
 private:
     void evaluate(double one, double two);
     Variable* var;
@@ -113,11 +214,124 @@ public:
     JumpOnComparisonCommand(Variable* varPtr, T compareTo, int state, ComparisonOp type);
     JumpOnComparisonCommand(Variable* varPtr, T compareTo, FSM& stackOwner, ComparisonOp type);
     void execute() override;
+    std::unique_ptr<AbstractCommand> integerVersion() const override;
+    //only meaningful before it first runs - a jump to the top of the stack then overwrites the state
+    void jumpTargets(std::vector<int>& targets) const override
+    {
+        if (getNextState() != -1) targets.push_back(getNextState());
+    }
+    StackUse stackUse() const override {return popFrom != nullptr && getNextState() == -1 ? RETURNS : NO_STACK;}
+    void reads(std::vector<Variable*>& vars) const override
+    {
+        vars.push_back(var);
+        addIfVariable(vars, compareTo);
+    }
+private:
+    Variable* var;
+    T compareTo;
+    ComparisonOp cop;
+    SharedStack* popFrom;
+    ExecutionTrace* trace;
+};
+
+template <typename T>
+class SendCommand: public AbstractCommand
+{
+public:
+    SendCommand(Channel* sendTo, T value);
+    void execute() override;
+    bool performsIO() const override {return true;}
+    void reads(std::vector<Variable*>& vars) const override {addIfVariable(vars, val);}
+private:
+    Channel* channel;
+    T val;
+};
+
+class ReceiveCommand: public AbstractCommand
+{
+public:
+    ReceiveCommand(Channel* receiveFrom, Variable* varPtr, FSM& metricsOwner);
+    void execute() override;
+    bool performsIO() const override {return true;}
+    Variable* writes() const override {return var;}
+private:
+    Channel* channel;
+    Variable* var;
+    MachineMetrics* metrics;
+};
+
+/*Multiway jump on a numeric variable. Integral keys that are dense enough index a table directly, other integral keys
+  go through a collision free multiplicative hash, anything else is a binary search. Without a default the command
+  falls through to the rest of the state*/
+class SwitchCommand: public AbstractCommand
+{
+public:
+    SwitchCommand(Variable* varPtr, std::vector<std::pair<double, int>> cases, int defaultState = -1);
+    void execute() override;
+    void jumpTargets(std::vector<int>& targets) const override;
+    void renumberStates(const std::vector<int>& newNumber) override;
+    bool alwaysJumps() const override {return defaultState != -1;}
+    void reads(std::vector<Variable*>& vars) const override {vars.push_back(var);}
+private:
+    enum Lookup {DENSE, HASH, SEARCH};
+    bool findPerfectHash(const std::vector<std::pair<double, int>>& cases);
+    int find(double key) const;
+
+    Variable* var;
+    int defaultState;
+    Lookup lookup;
+    long long base = 0; //DENSE - the smallest key
+    uint64_t multiplier = 0; //HASH
+    unsigned int shift = 0; //HASH
+    std::vector<int> table; //DENSE and HASH - the state for each slot, -1 when empty
+    std::vector<long long> slotKeys; //HASH
+    std::vector<std::pair<double, int>> sorted; //SEARCH
+};
+
+/*Integer fast paths - made by integerVersion once every variable involved is INT. T is Variable* or long long*/
+template <typename T>
+class IntEvaluateExprCommand: public AbstractCommand
+{
+public:
+    IntEvaluateExprCommand(Variable* varPtr, Variable* LHSVar, T b, ExpressionType t);
+    void execute() override;
+    Variable* writes() const override {return var;}
+    void reads(std::vector<Variable*>& vars) const override
+    {
+        vars.push_back(term1);
+        addIfVariable(vars, term2);
+    }
+    bool onlyWrites() const override {return type != MOD || var->isInferred();} //declared int modulo by zero throws
+private:
+    Variable* var;
+    ExpressionType type;
+    Variable* term1;
+    T term2;
+};
+
+template <typename T>
+class IntJumpOnComparisonCommand: public AbstractCommand
+{
+public:
+    IntJumpOnComparisonCommand(Variable* varPtr, T compareTo, int state, ComparisonOp type,
+                               SharedStack* stack, ExecutionTrace* stackTrace);
+    void execute() override;
+    void jumpTargets(std::vector<int>& targets) const override
+    {
+        if (getNextState() != -1) targets.push_back(getNextState());
+    }
+    StackUse stackUse() const override {return getNextState() == -1 ? RETURNS : NO_STACK;}
+    void reads(std::vector<Variable*>& vars) const override
+    {
+        vars.push_back(var);
+        addIfVariable(vars, compareTo);
+    }
 private:
     Variable* var;
     T compareTo;
     ComparisonOp cop;
-    std::stack<Variable::TaggedDataUnion>* popFrom;
+    SharedStack* popFrom;
+    ExecutionTrace* trace;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+#include "FSM.h"
+
+using namespace std;
+
+namespace
+{
+    //one bit per variable
+    class VarSet
+    {
+    public:
+        explicit VarSet(size_t numVars = 0): words((numVars + 63) / 64, 0) {}
+        void insert(size_t i) {words[i / 64] |= 1ULL << (i % 64);}
+        void erase(size_t i) {words[i / 64] &= ~(1ULL << (i % 64));}
+        bool contains(size_t i) const {return (words[i / 64] >> (i % 64)) & 1;}
+        void clear() {fill(words.begin(), words.end(), 0);}
+        void unite(const VarSet& other)
+        {
+            for (size_t i = 0; i < words.size(); ++i) words[i] |= other.words[i];
+        }
+        bool operator==(const VarSet& other) const {return words == other.words;}
+        bool operator!=(const VarSet& other) const {return words != other.words;}
+
+    private:
+        vector<uint64_t> words;
+    };
+}
+
+unsigned int FSM::eliminateDeadCode()
+{
+    if (lazyParser) return 0;
+    eliminatingDeadCode = true;
+
+    unordered_map<Variable*, size_t> varNums;
+    for (auto& p : variableMap) varNums.emplace(p.second.get(), varNums.size());
+    size_t numStates = states.size();
+
+    unsigned int removed = 0;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        vector<int> returnTargets, targets;
+        for (auto& state : states)
+        {
+            for (auto& command : state->getInstructions())
+            {
+                if (command->stackUse() == AbstractCommand::PUSHES_STATE) command->jumpTargets(returnTargets);
+            }
+        }
+
+        /*Walks a state backwards from the live variables at its end (none - falling off the end stops the machine).
+          With dead given, marks what can go: assignments to variables that aren't live, and push/pop pairs with
+          no other stack use or way out of the state between them whose popped value isn't live*/
+        vector<VarSet> liveIn(numStates, VarSet(varNums.size()));
+        VarSet returnLive(varNums.size());
+        vector<Variable*> read;
+        auto walk = [&] (size_t stateNum, vector<bool>* dead) -> VarSet
+        {
+            auto& commands = states[stateNum]->getInstructions();
+            vector<int> pairedPush(commands.size(), -1);
+            if (dead != nullptr)
+            {
+                vector<size_t> pushes;
+                for (size_t i = 0; i < commands.size(); ++i)
+                {
+                    targets.clear();
+                    commands[i]->jumpTargets(targets);
+                    AbstractCommand::StackUse use = commands[i]->stackUse();
+                    if (use == AbstractCommand::PUSHES_VALUE) pushes.push_back(i);
+                    else if (use == AbstractCommand::POPS_VALUE && !pushes.empty())
+                    {
+                        pairedPush[i] = pushes.back();
+                        pushes.pop_back();
+                    }
+                    else if (use != AbstractCommand::NO_STACK || !targets.empty()) pushes.clear();
+                }
+            }
+
+            VarSet live(varNums.size());
+            for (size_t i = commands.size(); i-- > 0;)
+            {
+                AbstractCommand& command = *commands[i];
+                if (dead != nullptr && (*dead)[i]) continue;
+
+                if (command.alwaysJumps()) live.clear();
+                targets.clear();
+                command.jumpTargets(targets);
+                if (command.stackUse() != AbstractCommand::PUSHES_STATE)
+                {
+                    for (int target : targets) live.unite(liveIn[target]);
+                }
+                if (command.stackUse() == AbstractCommand::RETURNS) live.unite(returnLive);
+
+                Variable* written = command.writes();
+                if (dead != nullptr)
+                {
+                    bool unused = written == nullptr || !live.contains(varNums.at(written));
+                    if (unused && command.onlyWrites())
+                    {
+                        (*dead)[i] = true;
+                        continue;
+                    }
+                    if (unused && pairedPush[i] != -1)
+                    {
+                        (*dead)[i] = true;
+                        (*dead)[pairedPush[i]] = true;
+                        continue;
+                    }
+                }
+
+                if (written != nullptr) live.erase(varNums.at(written));
+                read.clear();
+                command.reads(read);
+                for (Variable* var : read) live.insert(varNums.at(var));
+            }
+            return live;
+        };
+
+        bool growing = true;
+        while (growing)
+        {
+            growing = false;
+            returnLive.clear();
+            for (int target : returnTargets) returnLive.unite(liveIn[target]);
+            for (size_t i = numStates; i-- > 0;)
+            {
+                VarSet in = walk(i, nullptr);
+                if (in != liveIn[i])
+                {
+                    liveIn[i] = in;
+                    growing = true;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < numStates; ++i)
+        {
+            vector<bool> dead(states[i]->getInstructions().size(), false);
+            walk(i, &dead);
+            unsigned int count = 0;
+            for (bool d : dead) count += d;
+            if (count == 0) continue;
+            states[i]->eraseInstructions(dead);
+            removed += count;
+            changed = true;
+        }
+    }
+    return removed;
+}
@@ -1,6 +1,8 @@
 #ifndef ENUMS_H
 #define ENUMS_H
 
+#include "Errors.h"
+
 enum ComparisonOp{GT, GE, LT, LE, EQ, NEQ};
 
 template <typename T>
@@ -19,10 +21,22 @@ bool evaluateComparisonOp(T LHS, ComparisonOp op, T RHS)
         case EQ:
             return LHS == RHS;
         case NEQ:
-            return LHS == RHS;
+            return LHS != RHS;
     }
+    throw FSMException(FSMError::INTERNAL, "Unknown comparison");
 }
 enum ExpressionType{PLUS, MINUS, MUL, DIV, MOD, POW, AND, OR};
-enum Type {DOUBLE, STRING};
+enum Type {DOUBLE, STRING, INT};
+
+inline const char* typeName(Type t)
+{
+    switch(t)
+    {
+        case DOUBLE: return "double";
+        case STRING: return "string";
+        case INT: return "int";
+    }
+    return "unknown";
+}
 
 #endif
\ No newline at end of file
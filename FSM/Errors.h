@@ -0,0 +1,40 @@
+#ifndef ERRORS_H
+#define ERRORS_H
+
+#include <stdexcept>
+#include <string>
+
+enum class FSMError {NONE, IO, SYNTAX, UNKNOWN_STATE, UNKNOWN_VARIABLE, UNKNOWN_CHANNEL, TYPE_MISMATCH, EMPTY_STACK,
+                     NO_STATES, INFINITE_LOOP, QUOTA_EXCEEDED, ARITHMETIC, INTERNAL};
+
+inline const char* errorName(FSMError error)
+{
+    switch(error)
+    {
+        case FSMError::NONE: return "none";
+        case FSMError::IO: return "io";
+        case FSMError::SYNTAX: return "syntax";
+        case FSMError::UNKNOWN_STATE: return "unknown state";
+        case FSMError::UNKNOWN_VARIABLE: return "unknown variable";
+        case FSMError::UNKNOWN_CHANNEL: return "unknown channel";
+        case FSMError::TYPE_MISMATCH: return "type mismatch";
+        case FSMError::EMPTY_STACK: return "empty stack";
+        case FSMError::NO_STATES: return "no states";
+        case FSMError::INFINITE_LOOP: return "infinite loop";
+        case FSMError::QUOTA_EXCEEDED: return "quota exceeded";
+        case FSMError::ARITHMETIC: return "arithmetic";
+        case FSMError::INTERNAL: return "internal";
+    }
+    return "unknown";
+}
+
+class FSMException: public std::runtime_error
+{
+public:
+    FSMException(FSMError error, const std::string& what): std::runtime_error(what), code(error) {}
+    FSMError getCode() const {return code;}
+private:
+    FSMError code;
+};
+
+#endif
@@ -1,24 +1,474 @@
 #include <iostream>
+#include <sstream>
 #include <memory>
+#include <limits>
+#include <unordered_set>
+#include <cmath>
 
 #include "FSM.h"
 #include "State.h"
 
 using namespace std;
 
-FSM::FSM(string& filename)
+FSM::FSM(string& filename, ChannelBindings bindings, bool lazy):
+    channels(move(bindings))
 {
-    FSMParser(filename, *this).readFSM();
+    if (lazy)
+    {
+        lazyParser = make_unique<FSMParser>(filename, *this);
+        lazyParser->readFSM(true);
+    }
+    else
+    {
+        FSMParser(filename, *this).readFSM();
+        inferIntegers();
+    }
+}
+
+FSM::FSM(unique_ptr<istream> source, ChannelBindings bindings, bool lazy):
+    channels(move(bindings))
+{
+    if (lazy)
+    {
+        lazyParser = make_unique<FSMParser>(move(source), *this);
+        lazyParser->readFSM(true);
+    }
+    else
+    {
+        FSMParser(move(source), *this).readFSM();
+        inferIntegers();
+    }
+}
+
+namespace
+{
+    template <typename F>
+    FSMError reportErrors(F attempt, string* message)
+    {
+        try
+        {
+            attempt();
+            return FSMError::NONE;
+        }
+        catch (FSMException& e)
+        {
+            if (message != nullptr) *message = e.what();
+            return e.getCode();
+        }
+        catch (exception& e)
+        {
+            if (message != nullptr) *message = e.what();
+            return FSMError::INTERNAL;
+        }
+    }
+}
+
+FSMError FSM::load(string_view source, unique_ptr<FSM>& loaded, string* message, bool lazy)
+{
+    return reportErrors([&] ()
+    {
+        loaded = make_unique<FSM>(make_unique<istringstream>(string(source)), ChannelBindings(), lazy);
+    }, message);
+}
+
+FSMError FSM::loadFile(const string& fileName, unique_ptr<FSM>& loaded, string* message, bool lazy)
+{
+    return reportErrors([&] ()
+    {
+        string name = fileName;
+        loaded = make_unique<FSM>(name, ChannelBindings(), lazy);
+    }, message);
+}
+
+FSMError FSM::tryRun(string* message)
+{
+    return reportErrors([this] () {run();}, message);
+}
+
+void FSM::setIO(FSMIO hooks)
+{
+    io = move(hooks);
+}
+
+void FSM::seedRandom(uint64_t masterSeed, uint64_t instance)
+{
+    random.reseed(masterSeed, instance);
+}
+
+void FSM::fuzzInput()
+{
+    static const size_t batch = 64;
+    io.input = [this] (string& word)
+    {
+        if (fuzzValues.empty())
+        {
+            fuzzValues.resize(batch);
+            random.fill(fuzzValues.data(), batch);
+        }
+        word = to_string(fuzzValues.back());
+        fuzzValues.pop_back();
+        return true;
+    };
+}
+
+void FSM::setLimits(const ExecutionLimits& limits)
+{
+    auto orMax = [] (unsigned long long limit) {return limit == 0 ? numeric_limits<unsigned long long>::max() : limit;};
+    maxStackDepth = orMax(limits.maxStackDepth);
+    maxStringBytes = orMax(limits.maxStringBytes);
+    maxSteps = orMax(limits.maxSteps);
+    maxWallTime = limits.maxWallTime.count() == 0 ? chrono::milliseconds::max() : limits.maxWallTime;
+    limited = limits.maxStackDepth != 0 || limits.maxStringBytes != 0 || limits.maxSteps != 0
+              || limits.maxWallTime.count() != 0;
+}
+
+//the cheap checks are made every step, string bytes and time every 1024
+void FSM::checkLimits(int stateNum, unsigned long long steps)
+{
+    auto violation = [&, this] (Quota quota, unsigned long long limit, unsigned long long reached)
+    {
+        return QuotaExceeded({quota, limit, reached, getStateNames().at(stateNum), steps});
+    };
+
+    if (steps > maxSteps) throw violation(Quota::STEPS, maxSteps, steps);
+    if (sharedStack.size() > maxStackDepth) throw violation(Quota::STACK_DEPTH, maxStackDepth, sharedStack.size());
+
+    unsigned long long stringBytes = sharedStack.stringBytes();
+    for (auto& p : variableMap)
+    {
+        if (p.second->getType() == STRING) stringBytes += ((string*) p.second->getData())->length();
+    }
+    if (stringBytes > maxStringBytes) throw violation(Quota::STRING_BYTES, maxStringBytes, stringBytes);
+
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started);
+    if (elapsed > maxWallTime) throw violation(Quota::WALL_TIME, maxWallTime.count(), elapsed.count());
+}
+
+//needs every command, so lazily loaded machines only get their declared ints
+void FSM::inferIntegers()
+{
+    //after a reload a variable can already hold a fraction carried over from the old program
+    unordered_set<Variable*> integral;
+    for (auto& p : variableMap)
+    {
+        Variable* var = p.second.get();
+        if (var->getType() != STRING && var->getNumber() == trunc(var->getNumber())) integral.insert(var);
+    }
+
+    //optimistic - start with every number integral and throw out any written something that mightn't be
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto& state : states)
+        {
+            for (auto& command : state->getInstructions())
+            {
+                Variable* written = command->writes();
+                if (written == nullptr || written->getType() == INT || integral.find(written) == integral.end()) continue;
+                if (!command->writesIntegral(integral))
+                {
+                    integral.erase(written);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    for (Variable* var : integral) var->makeInteger();
+    for (auto& state : states) state->useIntegerVersions();
+}
+
+//a state's closing jump is weighted as its fall through, above its conditional jumps and the returns it sets up
+vector<int> FSM::layoutOrder() const
+{
+    vector<vector<LayoutEdge>> successors(states.size());
+    vector<int> targets;
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        for (auto& command : states[i]->getInstructions())
+        {
+            targets.clear();
+            command->jumpTargets(targets);
+            unsigned int weight = command->alwaysJumps() && targets.size() == 1 ? 4 : 2;
+            for (int target : targets) successors[i].push_back({target, weight});
+            if (command->alwaysJumps()) break;
+        }
+    }
+    return layoutStates(successors, getStateNames());
+}
+
+unsigned int FSM::layOutStates()
+{
+    if (lazyParser) return 0;
+    layingOut = true;
+
+    vector<int> order = layoutOrder();
+    vector<int> newNumber(order.size());
+    unsigned int moved = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        newNumber[order[i]] = i;
+        if (order[i] != (int) i) ++moved;
+    }
+    if (moved == 0) return 0;
+
+    vector<unique_ptr<State>> laidOut(order.size());
+    for (size_t i = 0; i < order.size(); ++i) laidOut[i] = move(states[order[i]]);
+    states = move(laidOut);
+    for (auto& state : states)
+    {
+        for (auto& command : state->getInstructions()) command->renumberStates(newNumber);
+    }
+    return moved;
+}
+
+State& FSM::getState(int stateNum)
+{
+    auto& state = states.at(stateNum);
+    if (!state)
+    {
+        if (!lazyParser) throw FSMException(FSMError::UNKNOWN_STATE, "State " + to_string(stateNum) + " was never read");
+        state = lazyParser->readStateAt(stateNum);
+    }
+    return *state;
+}
+
+vector<string> FSM::getStateNames() const
+{
+    if (lazyParser) return lazyParser->getStateNames();
+    vector<string> stateNames;
+    for (auto& state : states) stateNames.push_back(state->getName());
+    return stateNames;
 }
 
 void FSM::run()
 {
-    if (states.empty()) throw "need at least one state";
+    if (states.empty()) throw FSMException(FSMError::NO_STATES, "need at least one state");
     int currentStateNum = 0;
+    unsigned long long steps = 0;
+    if (limited) started = chrono::steady_clock::now();
+    struct RunningFlag
+    {
+        MachineMetrics& metrics;
+        RunningFlag(MachineMetrics& m): metrics(m) {metrics.setRunning(true);}
+        ~RunningFlag() {metrics.setRunning(false);}
+    } runningFlag(metrics);
     while (currentStateNum != -1)
     {
-        auto& currentState = states.at(currentStateNum);
-        currentState->run();
+        if (reloadRequested.load(memory_order_relaxed))
+        {
+            reloadRequested.store(false, memory_order_relaxed);
+            string report;
+            FSMError error = reloadAt(reloadSource, currentStateNum, &report);
+            if (reloadReported) reloadReported(error, report);
+        }
+        if (limited)
+        {
+            ++steps;
+            if (steps > maxSteps || sharedStack.size() > maxStackDepth || (steps & 1023) == 0)
+            {
+                checkLimits(currentStateNum, steps);
+            }
+        }
+        State* currentState = &getState(currentStateNum);
+        if (watchdog.isEnabled())
+        {
+            if (currentState->performsIO()) watchdog.progress();
+            if (watchdog.tick() && watchdog.check(currentStateNum, sharedStack)) reportCycle(currentStateNum);
+        }
+        if (metrics.isEnabled()) metrics.transition(sharedStack.size());
+        if (trace.isEnabled())
+        {
+            trace.setState(currentStateNum);
+            trace.record(ENTER, sharedStack.size());
+        }
+        if (perf.isEnabled() && perf.shouldSample())
+        {
+            perf.start();
+            currentState->run();
+            perf.stop(currentStateNum);
+        }
+        else currentState->run();
         currentStateNum = currentState->nextState();
     }
-}
\ No newline at end of file
+}
+
+void FSM::enableTrace(unsigned int capacity, string dumpFile)
+{
+    trace.enable(capacity, move(dumpFile), getStateNames());
+}
+
+bool FSM::dumpTrace() const
+{
+    return trace.dump();
+}
+
+bool FSM::enablePerfCounters(unsigned int sampleInterval, string& error)
+{
+    bool enabled = perf.enable(states.size(), sampleInterval);
+    error = perf.getError();
+    return enabled;
+}
+
+void FSM::reportPerfCounters(ostream& out) const
+{
+    perf.report(out, getStateNames());
+}
+
+void FSM::enableWatchdog(unsigned long checkInterval)
+{
+    vector<Variable*> vars;
+    for (auto& p : variableMap) vars.push_back(p.second.get());
+    watchdog.enable(checkInterval, move(vars));
+}
+
+void FSM::reportCycle(int stateNum)
+{
+    //the loop is deterministic, so going round it once more shows which states are involved and how long it is -
+    //the snapshots the watchdog matched were a whole number of trips apart, so it's back within that many
+    unsigned long bound = watchdog.sampledCycle();
+    unsigned long length = bound;
+    set<int> seen;
+    string path;
+    for (unsigned long i = 0; i < bound && stateNum != -1; ++i)
+    {
+        State& state = getState(stateNum);
+        if (seen.insert(stateNum).second) path += (path.empty() ? "" : " -> ") + state.getName();
+        state.run();
+        stateNum = state.nextState();
+        if (watchdog.backAtDetection(stateNum, sharedStack))
+        {
+            length = i + 1;
+            break;
+        }
+    }
+
+    throw FSMException(FSMError::INFINITE_LOOP, "Machine is in an infinite loop without input or output: it repeats "
+                       "every " + to_string(length) + " transitions, through states " + path + " (entered within the "
+                       "first " + to_string(watchdog.enteredBy()) + " transitions)");
+}
+
+void FSM::enableMetrics()
+{
+    metrics.enable();
+}
+
+FSMError FSM::reload(const string& fileName, string* report)
+{
+    int notRunning = -1;
+    return reloadAt(fileName, notRunning, report);
+}
+
+void FSM::setReloadSource(string fileName, function<void(FSMError, const string&)> reported)
+{
+    reloadSource = move(fileName);
+    reloadReported = move(reported);
+}
+
+void FSM::requestReload()
+{
+    reloadRequested.store(true, memory_order_relaxed);
+}
+
+//the new program is parsed into this machine so its commands use this stack, trace and io - the old one is kept
+//aside until everything that has to carry over is known to
+FSMError FSM::reloadAt(const string& fileName, int& stateNum, string* report)
+{
+    vector<string> oldNames = getStateNames();
+    vector<unique_ptr<State>> oldStates = move(states);
+    unordered_map<string, unique_ptr<Variable>> oldVariables = move(variableMap);
+    unique_ptr<FSMParser> oldParser = move(lazyParser);
+    states.clear();
+    variableMap.clear();
+
+    vector<string> unmapped;
+    vector<int> newNumber(oldNames.size(), -1);
+    FSMError error = reportErrors([&, this] ()
+    {
+        unique_ptr<FSMParser> parser = make_unique<FSMParser>(fileName, *this);
+        parser->readFSM(oldParser != nullptr);
+        if (oldParser != nullptr) lazyParser = move(parser);
+        if (states.empty()) throw FSMException(FSMError::NO_STATES, "need at least one state");
+        if (layingOut) layOutStates();
+
+        vector<string> newNames = getStateNames();
+        unordered_map<string, int> numbers;
+        for (size_t i = 0; i < newNames.size(); ++i) numbers[newNames[i]] = i;
+        for (size_t i = 0; i < oldNames.size(); ++i)
+        {
+            auto it = numbers.find(oldNames[i]);
+            if (it != numbers.end()) newNumber[i] = it->second;
+            else unmapped.push_back("state '" + oldNames[i] + "' is not in the new program");
+        }
+
+        if (stateNum != -1 && newNumber.at(stateNum) == -1)
+        {
+            throw FSMException(FSMError::UNKNOWN_STATE, "Current state '" + oldNames[stateNum]
+                                                         + "' is not in the new program");
+        }
+        for (size_t i = 0; i < sharedStack.size(); ++i)
+        {
+            if (!sharedStack.isReturnTarget(i)) continue;
+            int target = (int) sharedStack.getContents()[i].asNumber();
+            if (target < 0 || target >= (int) newNumber.size() || newNumber[target] == -1)
+            {
+                throw FSMException(FSMError::UNKNOWN_STATE, "Return target '"
+                                   + (target >= 0 && target < (int) oldNames.size() ? oldNames[target] : to_string(target))
+                                   + "' on the stack is not in the new program");
+            }
+        }
+
+        for (auto& p : oldVariables)
+        {
+            auto it = variableMap.find(p.first);
+            if (it == variableMap.end()) unmapped.push_back("variable '" + p.first + "' is not in the new program");
+            else if ((it->second->getType() == STRING) != (p.second->getType() == STRING))
+            {
+                unmapped.push_back("variable '" + p.first + "' changed from " + typeName(p.second->getType()) + " to "
+                                   + typeName(it->second->getType()) + ", so starts again");
+            }
+            else it->second->setData(p.second->getTaggedDataUnion());
+        }
+        for (auto& p : variableMap)
+        {
+            if (oldVariables.find(p.first) == oldVariables.end()) unmapped.push_back("variable '" + p.first + "' is new");
+        }
+
+        if (lazyParser == nullptr) inferIntegers();
+        if (eliminatingDeadCode) eliminateDeadCode();
+    }, report);
+
+    if (error != FSMError::NONE)
+    {
+        states = move(oldStates);
+        variableMap = move(oldVariables);
+        lazyParser = move(oldParser);
+        return error;
+    }
+
+    for (size_t i = 0; i < sharedStack.size(); ++i)
+    {
+        if (sharedStack.isReturnTarget(i))
+        {
+            sharedStack.setReturnTarget(i, newNumber[(int) sharedStack.getContents()[i].asNumber()]);
+        }
+    }
+    if (stateNum != -1) stateNum = newNumber[stateNum];
+
+    if (watchdog.isEnabled())
+    {
+        vector<Variable*> vars;
+        for (auto& p : variableMap) vars.push_back(p.second.get());
+        watchdog.rewatch(move(vars));
+    }
+    if (trace.isEnabled()) trace.renameStates(getStateNames());
+    if (perf.isEnabled()) perf.renumber(newNumber, states.size());
+
+    if (report != nullptr)
+    {
+        report->clear();
+        for (const string& line : unmapped) *report += (report->empty() ? "" : "\n") + line;
+    }
+    return FSMError::NONE;
+}
@@ -3,45 +3,87 @@
 
 #include <vector>
 #include <string>
-#include <stack>
 #include <map>
 #include <set>
 #include <fstream>
+#include <istream>
+#include <string_view>
+#include <atomic>
+#include <functional>
 
 #include "Variable.h"
 #include "State.h"
 #include "Command.h"
+#include "Channel.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "Watchdog.h"
+#include "Errors.h"
+#include "FSMIO.h"
+#include "Limits.h"
+#include "SharedStack.h"
+#include "Metrics.h"
+#include "StateLayout.h"
+#include "Random.h"
 
 
 class FSM
 {
     friend class State;
+    template<class T> friend class PrintCommand;
+    friend class InputVarCommand;
+    friend class NondetCommand;
     template<class T> friend class PushCommand;
+    friend class PushStateCommand;
     friend class PopCommand;
+    friend class ReceiveCommand;
     friend class ReturnCommand;
     template<class T> friend class JumpOnComparisonCommand;
 
 private:
     std::vector<std::unique_ptr<State>> states;
-    std::stack<Variable::TaggedDataUnion> sharedStack;
+    SharedStack sharedStack;
     std::unordered_map<std::string, std::unique_ptr<Variable>> variableMap;
+    ChannelBindings channels;
+    ExecutionTrace trace;
+    PerfCounters perf;
+    Watchdog watchdog;
+    MachineMetrics metrics;
+    FSMIO io;
+    RandomStream random;
+    std::vector<long long> fuzzValues;
+
+    //limits with unlimited stored as the maximum, so checking them is just comparisons
+    bool limited = false;
+    unsigned long long maxStackDepth;
+    unsigned long long maxStringBytes;
+    unsigned long long maxSteps;
+    std::chrono::milliseconds maxWallTime;
+    std::chrono::steady_clock::time_point started;
+    void checkLimits(int stateNum, unsigned long long steps);
 
     class FSMParser
     {
     public:
         FSMParser(std::string filename, FSM& parsedFSM);
-        void readFSM();
+        FSMParser(std::unique_ptr<std::istream> source, FSM& parsedFSM);
+        //lazily, only variables and the offset of each state are read - states are parsed by readStateAt
+        void readFSM(bool lazy = false);
+        std::unique_ptr<State> readStateAt(int stateNum);
+        std::vector<std::string> getStateNames() const;
 
     private:
         std::unordered_map<std::string, int> stateNameMap;
-        std::map<int, std::unique_ptr<State>> stateMap;
-        std::ifstream infile;
+        std::vector<std::streampos> stateOffsets;
+        std::unique_ptr<std::istream> source;
+        std::istream& infile;
         FSM& parsedFSM;
 
         static std::set<std::string> resWords;
         bool isReserved(const std::string&);
 
         Variable* getVar(std::string varN);
+        Channel* getChannel(const std::string& channelN, bool sending);
 
         std::string nextString();
         std::string nextCommand(bool expecting = true);
@@ -50,13 +92,83 @@ private:
         ComparisonOp readComparisonOp();
         int checkState(std::string);
         char nextRealChar(std::string);
+        std::unique_ptr<State> readState();
     };
 
+    std::unique_ptr<FSMParser> lazyParser;
+    std::vector<std::string> getStateNames() const;
+    //makes variables that only ever hold integers INT and switches their commands to integer versions
+    void inferIntegers();
+    //see layoutStates - the order states should be in, from the jumps between them
+    std::vector<int> layoutOrder() const;
+    bool layingOut = false;
+    bool eliminatingDeadCode = false;
+    State& getState(int stateNum);
+    [[noreturn]] void reportCycle(int stateNum);
+
+    std::atomic<bool> reloadRequested{false};
+    std::string reloadSource;
+    std::function<void(FSMError, const std::string&)> reloadReported;
+    //stateNum is the state about to run (or -1), and is moved to its counterpart in the new program
+    FSMError reloadAt(const std::string& fileName, int& stateNum, std::string* report);
 
 public:
-    FSM(std::string& fileName);
+    //lazily loaded machines parse each state the first time it's entered
+    FSM(std::string& fileName, ChannelBindings bindings = ChannelBindings(), bool lazy = false);
+    FSM(std::unique_ptr<std::istream> source, ChannelBindings bindings = ChannelBindings(), bool lazy = false);
 
     void run();
+
+    //for embedding - these never throw, the error code is returned and the details put in message if given
+    static FSMError load(std::string_view source, std::unique_ptr<FSM>& loaded, std::string* message = nullptr,
+                         bool lazy = false);
+    static FSMError loadFile(const std::string& fileName, std::unique_ptr<FSM>& loaded,
+                             std::string* message = nullptr, bool lazy = false);
+    FSMError tryRun(std::string* message = nullptr);
+    void setIO(FSMIO hooks);
+    //nondet draws from a stream decided by these alone - machines sharing a master seed get different instances
+    void seedRandom(uint64_t masterSeed, uint64_t instance = 0);
+    //replaces input with words from the random stream, so a run (bounded by setLimits) explores arbitrary inputs -
+    //whole numbers (RandomStream::nextInteger), since that's what input reads for a number
+    void fuzzInput();
+    /*run throws QuotaExceeded (FSMError::QUOTA_EXCEEDED from tryRun) when a limit is passed. Steps and stack depth are
+      checked every transition, string bytes and wall time every 1024 - so those can be overshot until the next check*/
+    void setLimits(const ExecutionLimits& limits);
+
+    //records the last (capacity) transitions and stack operations, written to dumpFile by dumpTrace or on a crash
+    void enableTrace(unsigned int capacity, std::string dumpFile);
+    bool dumpTrace() const;
+
+    //reads hardware counters around every (sampleInterval)th state execution, false if the kernel won't allow it
+    bool enablePerfCounters(unsigned int sampleInterval, std::string& error);
+    void reportPerfCounters(std::ostream& out) const;
+
+    //checks for a pure infinite loop every (checkInterval) transitions, run throws if one is found
+    void enableWatchdog(unsigned long checkInterval);
+
+    //counts transitions, stack depth, output and time blocked on input for MetricsServer
+    void enableMetrics();
+
+    /*Removes assignments whose value is never read and push/pop pairs within a state whose popped value is never read,
+      using liveness over the jumps between states (a return can go to any state that is pushed). Variables aren't
+      read once the machine ends, so their final values can differ. Needs every state, so does nothing to a lazily
+      loaded machine. Applied again after a reload. Returns how many commands went*/
+    unsigned int eliminateDeadCode();
+
+    /*Reorders the states so ones that usually run one after another are adjacent (see layoutStates), renumbering the
+      jumps to them - the start state stays first. Before enabling a trace, perf counters or the watchdog, which know
+      states by number. Does nothing to a lazily loaded machine. Applied again after a reload. Returns how many states
+      moved*/
+    unsigned int layOutStates();
+
+    /*Replaces the program with a new version, carrying over variables by name along with the current state and the
+      return targets on the stack by state name. If the current state or a return target isn't in the new program
+      the old one is kept and an error returned. Variables that couldn't be carried over are listed in report*/
+    FSMError reload(const std::string& fileName, std::string* report = nullptr);
+    //for a running machine - reloadSource is loaded before the next state runs. requestReload is async-signal-safe
+    void setReloadSource(std::string fileName,
+                         std::function<void(FSMError, const std::string&)> reported = nullptr);
+    void requestReload();
 };
 
 
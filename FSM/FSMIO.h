@@ -0,0 +1,15 @@
+#ifndef FSMIO_H
+#define FSMIO_H
+
+#include <string>
+#include <functional>
+
+//where a machine's output goes and its input comes from - unset hooks fall back to cout/cin
+struct FSMIO
+{
+    std::function<void(const std::string&)> print;
+    //reads one whitespace separated word, false at the end of input
+    std::function<bool(std::string&)> input;
+};
+
+#endif
@@ -2,15 +2,19 @@
 
 using namespace std;
 
-FSM::FSMParser::FSMParser(string filename, FSM& pfsm): parsedFSM(pfsm)
+FSM::FSMParser::FSMParser(string filename, FSM& pfsm): FSMParser(make_unique<ifstream>(filename), pfsm)
 {
-    infile.open(filename);
-    if (!infile) throw runtime_error("Could not open file '" + filename + "'");
+    if (!infile) throw FSMException(FSMError::IO, "Could not open file '" + filename + "'");
 }
 
+FSM::FSMParser::FSMParser(unique_ptr<istream> in, FSM& pfsm):
+        source(move(in)),
+        infile(*source),
+        parsedFSM(pfsm) {}
+
 string FSM::FSMParser::peelQuotes(string in)
 {
-    if (in[0] != '"' || in[in.length() - 1] != '"') throw runtime_error("Badly quoted string");
+    if (in[0] != '"' || in[in.length() - 1] != '"') throw FSMException(FSMError::SYNTAX, "Badly quoted string");
     in.erase(0,1); in.erase(in.length()-1, 1);
     return in;
 }
@@ -18,7 +22,7 @@ string FSM::FSMParser::peelQuotes(string in)
 int FSM::FSMParser::checkState(string str)
 {
     unordered_map<string, int>::const_iterator it = stateNameMap.find(str);
-    if (it == stateNameMap.cend()) throw runtime_error("State '" + str + "' not defined");
+    if (it == stateNameMap.cend()) throw FSMException(FSMError::UNKNOWN_STATE, "State '" + str + "' not defined");
     return it->second;
 }
 
@@ -61,7 +65,7 @@ ComparisonOp FSM::FSMParser::readComparisonOp()
             }
 
         default:
-            throw runtime_error("Strange comparison detected");
+            throw FSMException(FSMError::SYNTAX, "Strange comparison detected");
     }
     return opType;
 }
@@ -71,7 +75,7 @@ string FSM::FSMParser::nextString()
     char c;
     infile.get(c);
     while (isspace(c) && infile.get(c));
-    if (!infile) throw runtime_error("command not finished");
+    if (!infile) throw FSMException(FSMError::SYNTAX, "command not finished");
 
     string ident;
     if (c == '"')
@@ -81,7 +85,7 @@ string FSM::FSMParser::nextString()
         {
             ident += c;
             if (c == '"') break;
-            else if (!infile) throw runtime_error("identifier not finished");
+            else if (!infile) throw FSMException(FSMError::SYNTAX, "identifier not finished");
         }
     }
 
@@ -91,7 +95,7 @@ string FSM::FSMParser::nextString()
         {
             ident += c;
             infile.get(c);
-            if (!infile) throw runtime_error("identifier not finished");
+            if (!infile) throw FSMException(FSMError::SYNTAX, "identifier not finished");
         }
         infile.unget();
     }
@@ -123,7 +127,7 @@ char FSM::FSMParser::nextRealChar(string error = "")
         infile.get(c);
         if (!infile)
         {
-            if (!error.empty()) throw runtime_error(error);
+            if (!error.empty()) throw FSMException(FSMError::SYNTAX, error);
             else return -1;
         }
     }
@@ -134,7 +138,7 @@ string FSM::FSMParser::getVarName()
 {
     string varN;
     char c = nextRealChar("Unexpected end when reading variable");
-    if (isdigit(c)) throw runtime_error("Variables cannot begin with a digit");
+    if (isdigit(c)) throw FSMException(FSMError::SYNTAX, "Variables cannot begin with a digit");
     while (c != ';' && !isspace(c))
     {
         varN += c;
@@ -142,12 +146,13 @@ string FSM::FSMParser::getVarName()
     }
     infile.unget();
 
-    if (varN.empty()) throw runtime_error("Expected variable name");
-    if (isReserved(varN)) throw runtime_error("'" + varN + "' is reserved");
+    if (varN.empty()) throw FSMException(FSMError::SYNTAX, "Expected variable name");
+    if (isReserved(varN)) throw FSMException(FSMError::SYNTAX, "'" + varN + "' is reserved");
     return varN;
 }
 
-set<string> FSM::FSMParser::resWords = {"end", "double", "string", "print", "jump", "jumpif", "push", "pop", "state", "return"};
+set<string> FSM::FSMParser::resWords = {"end", "double", "int", "string", "print", "jump", "jumpif", "push", "pop",
+                                        "state", "return", "send", "recv", "switch", "nondet"};
 bool FSM::FSMParser::isReserved(const string& s)
 {
     return (resWords.find(s) != resWords.end());
@@ -156,17 +161,32 @@ bool FSM::FSMParser::isReserved(const string& s)
 Variable* FSM::FSMParser::getVar(string varN)
 {
     unordered_map<string, unique_ptr<Variable>>::const_iterator it = parsedFSM.variableMap.find(varN);
-    if (it == parsedFSM.variableMap.cend()) throw runtime_error("Unknown variable '" + varN + "'");
+    if (it == parsedFSM.variableMap.cend())
+    {
+        throw FSMException(FSMError::UNKNOWN_VARIABLE, "Unknown variable '" + varN + "'");
+    }
     return it->second.get();
 }
 
-void FSM::FSMParser::readFSM()
+Channel* FSM::FSMParser::getChannel(const string& channelN, bool sending)
+{
+    auto& bound = sending ? parsedFSM.channels.sendsTo : parsedFSM.channels.receivesFrom;
+    auto it = bound.find(channelN);
+    if (it == bound.cend()) throw FSMException(FSMError::UNKNOWN_CHANNEL, "Machine cannot "
+                                                 + string(sending ? "send to" : "receive from")
+                                                 + " channel '" + channelN + "'");
+    return it->second;
+}
+
+void FSM::FSMParser::readFSM(bool lazy)
 {
     char c;
 
-    //first scan - get variables and states
-    string str = nextCommand();
+    //first scan - get variables, states and where each state starts
+    string str = nextCommand(false);
+    if (str.empty()) throw FSMException(FSMError::NO_STATES, "need at least one state");
     stateNameMap[str] = 0;
+    stateOffsets.push_back(0);
     int nextUnusedState = 1;
     while (infile && !str.empty())
     {
@@ -175,22 +195,33 @@ void FSM::FSMParser::readFSM()
             string varN = getVarName();
             parsedFSM.variableMap[varN] = make_unique<Variable>(varN, 0.0);
             c = nextRealChar("Expected semicolon after variable declaration");
-            if (c != ';') throw runtime_error("Expected semicolon after variable declaration");
+            if (c != ';') throw FSMException(FSMError::SYNTAX, "Expected semicolon after variable declaration");
+        }
+        else if (str == "int")
+        {
+            string varN = getVarName();
+            parsedFSM.variableMap[varN] = make_unique<Variable>(varN, 0LL);
+            c = nextRealChar("Expected semicolon after variable declaration");
+            if (c != ';') throw FSMException(FSMError::SYNTAX, "Expected semicolon after variable declaration");
         }
         else if (str == "string")
         {
             string varN = getVarName();
             parsedFSM.variableMap[varN] = make_unique<Variable>(varN, "");
             c = nextRealChar("Expected semicolon after variable declaration");
-            if (c != ';') throw runtime_error("Expected semicolon after variable declaration");
+            if (c != ';') throw FSMException(FSMError::SYNTAX, "Expected semicolon after variable declaration");
         }
         else if (str == "end")
         {
             if (infile >> str && !str.empty())
             {
                 unordered_map<string, int>::const_iterator it = stateNameMap.find(str);
-                if (it == stateNameMap.cend()) stateNameMap[str] = nextUnusedState++;
-                else throw runtime_error("State '" + str + "' defined multiple times");
+                if (it == stateNameMap.cend())
+                {
+                    stateNameMap[str] = nextUnusedState++;
+                    stateOffsets.push_back(infile.tellg() - (streamoff) str.length());
+                }
+                else throw FSMException(FSMError::SYNTAX, "State '" + str + "' defined multiple times");
             }
             else break;
         }
@@ -198,460 +229,586 @@ void FSM::FSMParser::readFSM()
         str = nextCommand();
     }
 
+    if (lazy)
+    {
+        parsedFSM.states.resize(stateOffsets.size());
+        return;
+    }
+
     infile.clear();
     infile.seekg(0, ios::beg);
 
-    while (infile)
+    parsedFSM.states.clear();
+    parsedFSM.states.resize(stateOffsets.size());
+    unique_ptr<State> newState;
+    while ((newState = readState()) != nullptr)
     {
-        //get state name
-        while (infile.get(c) && isspace(c));
-        if (!infile) break;
+        int stateNum = checkState(newState->getName());
+        parsedFSM.states[stateNum] = move(newState);
+    }
+}
 
-        str = "";
-        while (!isspace(c))
-        {
-            if (!infile) throw "Reached EOF while parsing state name";
-            str += c;
-            infile.get(c);
-        }
+unique_ptr<State> FSM::FSMParser::readStateAt(int stateNum)
+{
+    infile.clear();
+    infile.seekg(stateOffsets.at(stateNum));
+    return readState();
+}
 
-        int currentStateNum = checkState(str);
+vector<string> FSM::FSMParser::getStateNames() const
+{
+    vector<string> names(stateNameMap.size());
+    for (auto& p : stateNameMap) names[p.second] = p.first;
+    return names;
+}
 
-        unique_ptr<State> newState = make_unique<State>(str, parsedFSM);
-        vector<unique_ptr<AbstractCommand>> commands;
+unique_ptr<State> FSM::FSMParser::readState()
+{
+    char c;
+    string str;
+    //get state name
+    while (infile.get(c) && isspace(c));
+    if (!infile) return nullptr;
 
-        str = nextCommand();
-        while(str != "end")
+    str = "";
+    while (!isspace(c))
+    {
+        if (!infile) throw FSMException(FSMError::SYNTAX, "Reached EOF while parsing state name");
+        str += c;
+        infile.get(c);
+    }
+
+    checkState(str);
+
+    unique_ptr<State> newState = make_unique<State>(str, parsedFSM);
+    vector<unique_ptr<AbstractCommand>> commands;
+
+    str = nextCommand();
+    while(str != "end")
+    {
+        if (!infile)
         {
-            if (!infile) throw runtime_error("Unexpected end while parsing state '" + newState->getName() + "'");
+            throw FSMException(FSMError::SYNTAX, "Unexpected end while parsing state '" + newState->getName() + "'");
+        }
 
-            if (str == "print")
+        if (str == "print")
+        {
+            infile.get(c);
+
+            while (isspace(c))
             {
                 infile.get(c);
+                if (!infile) throw FSMException(FSMError::SYNTAX, "Unexpected end during print command");
+            }
 
-                while (isspace(c))
+            if (c == '"')
+            {
+                infile.get(c);
+                string strToPrint;
+                while (c != '"')
                 {
+                    if (c == '\\')
+                    {
+                        infile.get(c);
+                        if (c == 'n') c = '\n';
+                        else if (c == '\\') c = '\\';
+                    }
+                    strToPrint += c;
                     infile.get(c);
-                    if (!infile) throw "Unexpected end during print command";
+                    if (!infile) throw FSMException(FSMError::SYNTAX, "Unexpected end when reading print string");
                 }
-
-                if (c == '"')
+                commands.push_back(make_unique<PrintCommand<string>>(strToPrint, parsedFSM));
+            }
+            else
+            {
+                string printed;
+                while (!isspace(c))
                 {
-                    infile.get(c);
-                    string strToPrint;
-                    while (c != '"')
+                    if (c == ';')
                     {
-                        if (c == '\\')
-                        {
-                            infile.get(c);
-                            if (c == 'n') c = '\n';
-                            else if (c == '\\') c = '\\';
-                        }
-                        strToPrint += c;
-                        infile.get(c);
-                        if (!infile) throw "Unexpected end when reading print string";
+                        infile.unget();
+                        break;
                     }
-                    commands.push_back(make_unique<PrintCommand<string>>(strToPrint));
+                    printed += c;
+                    infile.get(c);
+                    if (!infile) throw FSMException(FSMError::SYNTAX, "print command not finished");
                 }
-                else
+                if (isdigit(printed[0]))
                 {
-                    string printed;
-                    while (!isspace(c))
+                    try
                     {
-                        if (c == ';')
-                        {
-                            infile.unget();
-                            break;
-                        }
-                        printed += c;
-                        infile.get(c);
-                        if (!infile) throw runtime_error("print command not finished");
+                        stod(printed);
+                        commands.push_back(make_unique<PrintCommand<string>>(printed, parsedFSM));
                     }
-                    if (isdigit(printed[0]))
+                    catch (invalid_argument&)
                     {
-                        try
-                        {
-                            stod(printed);
-                            commands.push_back(make_unique<PrintCommand<string>>(printed));
-                        }
-                        catch (invalid_argument&)
-                        {
-                            throw runtime_error("Bad print statement 'print " + printed + "'");
-                        }
+                        throw FSMException(FSMError::SYNTAX, "Bad print statement 'print " + printed + "'");
                     }
-                    else commands.push_back(make_unique<PrintCommand<Variable*>>(getVar(printed)));
                 }
+                else commands.push_back(make_unique<PrintCommand<Variable*>>(getVar(printed), parsedFSM));
             }
+        }
 
-            else if (str == "input")
-            {
-                string varN = nextString();
-                commands.push_back(make_unique<InputVarCommand>(getVar(varN)));
-            }
+        else if (str == "input")
+        {
+            string varN = nextString();
+            commands.push_back(make_unique<InputVarCommand>(getVar(varN), parsedFSM));
+        }
 
-            else if (str == "return")
-            {
-                commands.push_back(make_unique<ReturnCommand>(parsedFSM));
-            }
+        else if (str == "nondet")
+        {
+            Variable* var = getVar(nextString());
+            if (var->getType() == STRING) throw FSMException(FSMError::TYPE_MISMATCH, "nondet of a string");
+            commands.push_back(make_unique<NondetCommand>(var, parsedFSM));
+        }
 
-            else if (str == "jump")
-            {
-                string stateName = nextString();
-                if (stateName == "pop") throw "depreciated";
-                int state = checkState(stateName);
-                commands.push_back(make_unique<JumpCommand>(state));
-            }
+        else if (str == "return")
+        {
+            commands.push_back(make_unique<ReturnCommand>(parsedFSM));
+        }
+
+        else if (str == "jump")
+        {
+            string stateName = nextString();
+            if (stateName == "pop") throw FSMException(FSMError::SYNTAX, "depreciated");
+            int state = checkState(stateName);
+            commands.push_back(make_unique<JumpCommand>(state));
+        }
+
+        else if (str == "jumpif")
+        {
+            c = nextRealChar("Unfinished jumpif command");
 
-            else if (str == "jumpif")
+            //a literal on the left is compared the other way round - 3 < x is x > 3
+            auto swapSides = [] (ComparisonOp op) -> ComparisonOp
             {
-                c = nextRealChar("Unfinished jumpif command");
+                switch(op)
+                {
+                    case GT:
+                        return LT;
+                    case GE:
+                        return LE;
+                    case LT:
+                        return GT;
+                    case LE:
+                        return GE;
+                    case EQ:
+                        return EQ;
+                    case NEQ:
+                        return NEQ;
+                }
+                throw FSMException(FSMError::INTERNAL, "Unknown comparison");
+            };
 
-                auto negateRelop = [] (ComparisonOp op) -> ComparisonOp
+            if (isdigit(c)) ///LHS is double literal
+            {
+                auto readNumber = [&, this](char first) -> double
                 {
-                    switch(op)
+                    double LHS;
+                    string readString;
+                    while (!isspace(first))
                     {
-                        case GT:
-                            return LE;
-                        case GE:
-                            return LT;
-                        case LT:
-                            return GE;
-                        case LE:
-                            return GT;
-                        case EQ:
-                            return NEQ;
-                        case NEQ:
-                            return EQ;
+                        readString += first;
+                        infile.get(first);
+                        if (!infile) throw FSMException(FSMError::SYNTAX, "bad number");
                     }
-                };
 
-                if (isdigit(c)) ///LHS is double literal
-                {
-                    auto readNumber = [&, this](char first) -> double
+                    try
                     {
-                        double LHS;
-                        string readString;
-                        while (!isspace(first))
-                        {
-                            readString += first;
-                            infile.get(first);
-                            if (!infile) throw "bad number";
-                        }
-
-                        try
-                        {
-                            LHS = stod(readString);
-                        }
-                        catch(invalid_argument&)
-                        {
-                            throw "bad number";
-                        }
-                        return LHS;
-                    };
-                    double LHS = readNumber(c);
+                        LHS = stod(readString);
+                    }
+                    catch(invalid_argument&)
+                    {
+                        throw FSMException(FSMError::SYNTAX, "bad number");
+                    }
+                    return LHS;
+                };
+                double LHS = readNumber(c);
 
-                    ComparisonOp op = readComparisonOp();
+                ComparisonOp op = readComparisonOp();
 
-                    //read RHS variable
-                    c = nextRealChar("unexpected end during jumpif");
+                //read RHS variable
+                c = nextRealChar("unexpected end during jumpif");
 
-                    if (isdigit(c)) //both numbers
+                if (isdigit(c)) //both numbers
+                {
+                    double RHS = readNumber(c);
+                    int state = checkState(nextString());
+                    if (evaluateComparisonOp<double>(LHS, op, RHS)) commands.push_back(make_unique<JumpCommand>(state));
+                }
+                else
+                {
+                    string varN;
+                    while (infile && !isspace(c))
                     {
-                        double RHS = readNumber(c);
-                        int state = checkState(nextString());
-                        if (evaluateComparisonOp<double>(LHS, op, RHS)) commands.push_back(make_unique<JumpCommand>(state));
+                        varN += c;
+                        infile.get(c);
                     }
-                    else
+                    if (varN.empty() || varN[0] =='"')
                     {
-                        string varN;
-                        while (infile && !isspace(c))
-                        {
-                            varN += c;
-                            infile.get(c);
-                        }
-                        if (varN.empty() || varN[0] =='"') throw runtime_error("invalid RHS '" + varN + "'");
-                        Variable* RHS = getVar(varN);
-                        if (RHS->getType() != DOUBLE) throw runtime_error("comparing double to non double");
+                        throw FSMException(FSMError::SYNTAX, "invalid RHS '" + varN + "'");
+                    }
+                    Variable* RHS = getVar(varN);
+                    if (RHS->getType() == STRING)
+                    {
+                        throw FSMException(FSMError::TYPE_MISMATCH, "comparing double to non double");
+                    }
 
-                        int state = checkState(nextString());
+                    int state = checkState(nextString());
 
-                        ComparisonOp negatedRelop = negateRelop(op);
+                    commands.push_back(make_unique<JumpOnComparisonCommand<double>>(RHS, LHS, state, swapSides(op)));
+                }
+            }
 
-                        commands.push_back(make_unique<JumpOnComparisonCommand<double>>(RHS, LHS, state, negatedRelop));
-                    }
+            else if (c == '"') //string
+            {
+                string LHS;
+                c = nextRealChar("Unfinished string");
+                while (c != '"')
+                {
+                    if (!infile) throw FSMException(FSMError::SYNTAX, "unexpected end whilst parsing string");
+                    LHS += c;
+                    infile.get(c);
                 }
 
-                else if (c == '"') //string
+                ComparisonOp op = readComparisonOp();
+
+                c = nextRealChar("Unfinished jump on comparison");
+                if (!infile) throw FSMException(FSMError::SYNTAX, "unexpected end whilst parsing comparison");
+                if (c == '"') //another string
                 {
-                    string LHS;
-                    c = nextRealChar("Unfinished string");
+                    string RHS;
+                    infile.get(c);
                     while (c != '"')
                     {
-                        if (!infile) throw "unexpected end whilst parsing string";
-                        LHS += c;
+                        RHS += c;
                         infile.get(c);
+                        if (!infile) throw FSMException(FSMError::SYNTAX, "unexpected end whilst parsing string");
                     }
 
-                    ComparisonOp op = readComparisonOp();
-
-                    c = nextRealChar("Unfinished jump on comparison");
-                    if (!infile) throw "unexpected end whilst parsing comparison";
-                    if (c == '"') //another string
-                    {
-                        string RHS;
-                        infile.get(c);
-                        while (c != '"')
-                        {
-                            RHS += c;
-                            infile.get(c);
-                            if (!infile) throw "unexpected end whilst parsing string";
-                        }
-
-                        int state = checkState(nextString());
-                        if (evaluateComparisonOp<string>(LHS, op, RHS)) commands.push_back(make_unique<JumpCommand>(state));
-                    }
-                    else
-                    {
-                        string varN;
-                        while (isalnum(c))
-                        {
-                            varN += c;
-                            infile.get(c);
-                            if (!infile) throw "unfinished RHS";
-                        }
-                        
-                        Variable* var = getVar(varN);
-                        int state = checkState(nextString());
-                        commands.push_back(make_unique<JumpOnComparisonCommand<string>>(var, LHS, state, negateRelop(op)));
-                    }
+                    int state = checkState(nextString());
+                    if (evaluateComparisonOp<string>(LHS, op, RHS)) commands.push_back(make_unique<JumpCommand>(state));
                 }
-
                 else
                 {
-                    //read LHS variable
                     string varN;
-                    while (infile && !isspace(c))
+                    while (isalnum(c))
                     {
                         varN += c;
                         infile.get(c);
+                        if (!infile) throw FSMException(FSMError::SYNTAX, "unfinished RHS");
                     }
+                    
+                    Variable* var = getVar(varN);
+                    int state = checkState(nextString());
+                    commands.push_back(make_unique<JumpOnComparisonCommand<string>>(var, LHS, state, swapSides(op)));
+                }
+            }
 
-                    Variable* LHS = getVar(varN);
+            else
+            {
+                //read LHS variable
+                string varN;
+                while (infile && !isspace(c))
+                {
+                    varN += c;
+                    infile.get(c);
+                }
 
-                    ComparisonOp opType = readComparisonOp();
+                Variable* LHS = getVar(varN);
 
-                    //get RHS
-                    string comparitor = nextString();
+                ComparisonOp opType = readComparisonOp();
 
-                    string stateName = nextString();
+                //get RHS
+                string comparitor = nextString();
 
-                    try
+                string stateName = nextString();
+
+                try
+                {
+                    double d = stod(comparitor);
+                    if (stateName == "pop")
+                    {
+                        commands.push_back(make_unique<JumpOnComparisonCommand<double>>(LHS, d, parsedFSM, opType));
+                    }
+                    else
+                    {
+                        int state = checkState(stateName);
+                        commands.push_back(make_unique<JumpOnComparisonCommand<double>>(LHS, d, state, opType));
+                    }
+
+                }
+                catch (invalid_argument&)
+                {
+                    if (stateName == "pop")
                     {
-                        double d = stod(comparitor);
-                        if (stateName == "pop")
+                        if (comparitor[0] == '"') //string
                         {
-                            commands.push_back(make_unique<JumpOnComparisonCommand<double>>(LHS, d, parsedFSM, opType));
+                            comparitor = peelQuotes(comparitor);
+                            commands.push_back(make_unique<JumpOnComparisonCommand<string>>(LHS, comparitor, parsedFSM, opType));
+
                         }
-                        else
+
+                        else //identifier
                         {
-                            int state = checkState(stateName);
-                            commands.push_back(make_unique<JumpOnComparisonCommand<double>>(LHS, d, state, opType));
+                            commands.push_back(make_unique<JumpOnComparisonCommand<Variable*>>
+                                                       (LHS, getVar(comparitor), parsedFSM, opType));
                         }
-
                     }
-                    catch (invalid_argument&)
+                    else
                     {
-                        if (stateName == "pop")
+                        int state = checkState(stateName);
+                        if (comparitor[0] == '"') //string
                         {
-                            if (comparitor[0] == '"') //string
-                            {
-                                comparitor = peelQuotes(comparitor);
-                                commands.push_back(make_unique<JumpOnComparisonCommand<string>>(LHS, comparitor, parsedFSM, opType));
-
-                            }
-
-                            else //identifier
-                            {
-                                commands.push_back(make_unique<JumpOnComparisonCommand<Variable*>>
-                                                           (LHS, getVar(comparitor), parsedFSM, opType));
-                            }
+                            comparitor = peelQuotes(comparitor);
+                            commands.push_back(make_unique<JumpOnComparisonCommand<string>>(LHS, comparitor, state, opType));
+
                         }
-                        else
+
+                        else //identifier
                         {
-                            int state = checkState(stateName);
-                            if (comparitor[0] == '"') //string
-                            {
-                                comparitor = peelQuotes(comparitor);
-                                commands.push_back(make_unique<JumpOnComparisonCommand<string>>(LHS, comparitor, state, opType));
-
-                            }
-
-                            else //identifier
-                            {
-                                commands.push_back(make_unique<JumpOnComparisonCommand<Variable*>>(LHS, getVar(comparitor),
-                                                                                                  state, opType));
-                            }
+                            commands.push_back(make_unique<JumpOnComparisonCommand<Variable*>>(LHS, getVar(comparitor),
+                                                                                              state, opType));
                         }
                     }
                 }
             }
+        }
 
-            else if (str == "push")
+        else if (str == "push")
+        {
+            str = nextString();
+
+            if (str == "state")
             {
                 str = nextString();
+                int point = checkState(str);
+                commands.push_back(make_unique<PushStateCommand>(point, parsedFSM));
+            }
 
-                if (str == "state")
+            else
+            {
+                try
                 {
-                    str = nextString();
-                    int point = checkState(str);
-                    commands.push_back(make_unique<PushCommand<double>>(point, parsedFSM));
+                    double d = stod(str);
+                    commands.push_back(make_unique<PushCommand<double>>(d, parsedFSM));
                 }
-
-                else
+                catch (invalid_argument&)
                 {
-                    try
-                    {
-                        double d = stod(str);
-                        commands.push_back(make_unique<PushCommand<double>>(d, parsedFSM));
-                    }
-                    catch (invalid_argument&)
+                    if (str[0] == '"') //string
                     {
-                        if (str[0] == '"') //string
-                        {
-                            str = peelQuotes(str);
-                            commands.push_back(make_unique<PushCommand<string>>(str, parsedFSM));
-                        }
-                        else commands.push_back(make_unique<PushCommand<Variable*>>(getVar(str), parsedFSM));
+                        str = peelQuotes(str);
+                        commands.push_back(make_unique<PushCommand<string>>(str, parsedFSM));
                     }
+                    else commands.push_back(make_unique<PushCommand<Variable*>>(getVar(str), parsedFSM));
                 }
             }
+        }
 
-            else if (str == "pop")
+        else if (str == "pop")
+        {
+            c = nextRealChar("Unexpected end when reading pop command");
+            infile.unget();
+            if (c == ';')
             {
-                c = nextRealChar("Unexpected end when reading pop command");
-                infile.unget();
-                if (c == ';')
+                str = nextString();
+                commands.push_back(make_unique<PopCommand>(nullptr, parsedFSM));
+            }
+            else
+            {
+                str = nextString();
+                commands.push_back(make_unique<PopCommand>(getVar(str), parsedFSM));
+            }
+        }
+
+        else if (str == "send")
+        {
+            Channel* channel = getChannel(nextString(), true);
+            str = nextString();
+            try
+            {
+                double d = stod(str);
+                commands.push_back(make_unique<SendCommand<double>>(channel, d));
+            }
+            catch (invalid_argument&)
+            {
+                if (str[0] == '"') commands.push_back(make_unique<SendCommand<string>>(channel, peelQuotes(str)));
+                else commands.push_back(make_unique<SendCommand<Variable*>>(channel, getVar(str)));
+            }
+        }
+
+        else if (str == "recv")
+        {
+            Channel* channel = getChannel(nextString(), false);
+            commands.push_back(make_unique<ReceiveCommand>(channel, getVar(nextString()), parsedFSM));
+        }
+
+        else if (str == "switch") //switch x { 1: A; 2: B; default: C };
+        {
+            string varN;
+            c = nextRealChar("Unfinished switch command");
+            while (infile && !isspace(c) && c != '{')
+            {
+                varN += c;
+                infile.get(c);
+            }
+            Variable* var = getVar(varN);
+            if (isspace(c)) c = nextRealChar("Unfinished switch command");
+            if (c != '{') throw FSMException(FSMError::SYNTAX, "Expected '{' after switch variable");
+
+            vector<pair<double, int>> cases;
+            int defaultState = -1;
+            c = nextRealChar("Unfinished switch command");
+            while (c != '}')
+            {
+                string key;
+                while (c != ':')
                 {
-                    str = nextString();
-                    commands.push_back(make_unique<PopCommand>(nullptr, parsedFSM));
+                    if (!infile || c == ';' || c == '}') throw FSMException(FSMError::SYNTAX, "Expected ':' in switch case");
+                    if (!isspace(c)) key += c;
+                    infile.get(c);
+                }
+
+                string stateName;
+                c = nextRealChar("Unfinished switch case");
+                while (infile && !isspace(c) && c != ';' && c != '}')
+                {
+                    stateName += c;
+                    infile.get(c);
+                }
+                if (isspace(c)) c = nextRealChar("Unfinished switch case");
+                int state = checkState(stateName);
+
+                if (key == "default")
+                {
+                    if (defaultState != -1) throw FSMException(FSMError::SYNTAX, "Switch has multiple defaults");
+                    defaultState = state;
                 }
                 else
                 {
-                    str = nextString();
-                    commands.push_back(make_unique<PopCommand>(getVar(str), parsedFSM));
+                    try
+                    {
+                        cases.emplace_back(stod(key), state);
+                    }
+                    catch (invalid_argument&)
+                    {
+                        throw FSMException(FSMError::SYNTAX, "Bad switch case '" + key + "'");
+                    }
                 }
+
+                if (c == ';') c = nextRealChar("Unfinished switch command");
+                else if (c != '}') throw FSMException(FSMError::SYNTAX, "Expected ';' between switch cases");
             }
+            commands.push_back(make_unique<SwitchCommand>(var, move(cases), defaultState));
+        }
 
-            else if (str == "string" || str == "double") getVarName();
+        else if (str == "string" || str == "double" || str == "int") getVarName();
 
-            else //assigning to an identifier
-            {
-                Variable* LHS = getVar(str);
+        else //assigning to an identifier
+        {
+            Variable* LHS = getVar(str);
 
-                c = nextRealChar("Unfinished assignment command");
-                if (c != '=') throw runtime_error("Expected assignment");
-                string RHS = nextString();
+            c = nextRealChar("Unfinished assignment command");
+            if (c != '=') throw FSMException(FSMError::SYNTAX, "Expected assignment");
+            string RHS = nextString();
 
-                try
+            try
+            {
+                double d = stod(RHS);
+                if (LHS->getType() == STRING) throw FSMException(FSMError::TYPE_MISMATCH,
+                                                                  string("Assigning double to ") + typeName(LHS->getType()));
+                commands.push_back(make_unique<AssignVarCommand<double>>(LHS, d)); //just a constant
+            }
+            catch (invalid_argument&)
+            {
+                if (RHS[0] == '"') //assigning string
                 {
-                    double d = stod(RHS);
-                    if (LHS->getType() != DOUBLE) throw runtime_error("Assigning double to " + LHS->getType());
-                    commands.push_back(make_unique<AssignVarCommand<double>>(LHS, d)); //just a constant
+                    if (LHS->getType() != STRING) throw FSMException(FSMError::TYPE_MISMATCH,
+                                                                      string("Assigning string to ") + typeName(LHS->getType()));
+                    RHS = peelQuotes(RHS);
+                    commands.push_back(make_unique<AssignVarCommand<string>>(LHS, RHS));
                 }
-                catch (invalid_argument&)
+
+                else
                 {
-                    if (RHS[0] == '"') //assigning string
+                    Variable* RHSVar = getVar(RHS);
+
+                    c = nextRealChar("Unfinished assignment command");
+                    if (c == ';')
                     {
-                        if (LHS->getType() != STRING) throw runtime_error("Assigning string to " +  LHS->getType());
-                        RHS = peelQuotes(RHS);
-                        commands.push_back(make_unique<AssignVarCommand<string>>(LHS, RHS));
+                        infile.unget();
+                        commands.push_back(make_unique<AssignVarCommand<Variable*>>(LHS, RHSVar));
                     }
 
-                    else
+                    else //some expression
                     {
-                        Variable* RHSVar = getVar(RHS);
+                        ExpressionType expType;
 
-                        c = nextRealChar("Unfinished assignment command");
-                        if (c == ';')
+                        switch(c)
                         {
-                            infile.unget();
-                            commands.push_back(make_unique<AssignVarCommand<Variable*>>(LHS, RHSVar));
+                            case '+':
+                                expType = PLUS;
+                                break;
+
+                            case '-':
+                                expType = MINUS;
+                                break;
+
+                            case '/':
+                                expType = DIV;
+                                break;
+
+                            case '*':
+                                expType = MUL;
+                                break;
+
+                            case '%':
+                                expType = MOD;
+                                break;
+
+                            case '^':
+                                expType = POW;
+                                break;
+
+                            case '&':
+                                expType = AND;
+                                break;
+
+                            case '|':
+                                expType = OR;
+                                break;
+
+                            default:
+                                throw FSMException(FSMError::SYNTAX, "Strange expression type detected");
                         }
 
-                        else //some expression
+                        string term2 = nextString();
+                        try
                         {
-                            ExpressionType expType;
-
-                            switch(c)
-                            {
-                                case '+':
-                                    expType = PLUS;
-                                    break;
-
-                                case '-':
-                                    expType = MINUS;
-                                    break;
-
-                                case '/':
-                                    expType = DIV;
-                                    break;
-
-                                case '*':
-                                    expType = MUL;
-                                    break;
-
-                                case '%':
-                                    expType = MOD;
-                                    break;
-
-                                case '^':
-                                    expType = POW;
-                                    break;
-
-                                case '&':
-                                    expType = AND;
-                                    break;
-
-                                case '|':
-                                    expType = OR;
-                                    break;
-
-                                default:
-                                    throw runtime_error("Strange expression type detected");
-                            }
-
-                            string term2 = nextString();
-                            try
-                            {
-                                double d = stod(term2);
-                                commands.push_back(make_unique<EvaluateExprCommand<double>>(LHS, RHSVar, d, expType));
-                            }
-                            catch (invalid_argument&) //two vars
-                            {
-                                commands.push_back(make_unique<EvaluateExprCommand<Variable*>>
-                                                           (LHS, RHSVar, getVar(term2), expType));
-                            }
+                            double d = stod(term2);
+                            commands.push_back(make_unique<EvaluateExprCommand<double>>(LHS, RHSVar, d, expType));
+                        }
+                        catch (invalid_argument&) //two vars
+                        {
+                            commands.push_back(make_unique<EvaluateExprCommand<Variable*>>
+                                                       (LHS, RHSVar, getVar(term2), expType));
                         }
                     }
                 }
             }
+        }
 
+        infile.get(c);
+        while (isspace(c))
+        {
+            if (!infile) throw FSMException(FSMError::SYNTAX, "State '" + newState->getName() + "' not ended");
             infile.get(c);
-            while (isspace(c))
-            {
-                if (!infile) throw runtime_error("State '" + newState->getName() + "' not ended");
-                infile.get(c);
-            }
-            if (c != ';') throw "Expected semicolon";
-
-            str = nextCommand();
         }
+        if (c != ';') throw FSMException(FSMError::SYNTAX, "Expected semicolon");
 
-        newState->setInstructions(move(commands));
-        stateMap[currentStateNum] = move(newState);
+        str = nextCommand();
     }
 
-    parsedFSM.states.clear();
-    //works in order
-    for (auto& p : stateMap) parsedFSM.states.push_back(move(p.second));
+    newState->setInstructions(move(commands));
+    return newState;
 }
@@ -0,0 +1,563 @@
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "IOBackend.h"
+#include "Errors.h"
+
+using namespace std;
+
+namespace
+{
+    const ssize_t readSize = 64 * 1024;
+
+    //a word is only complete once the whitespace after it (or the end of input) has been read
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+}
+
+/*The smallest io_uring wrapper that does the job: the rings are mapped once and driven with io_uring_enter directly.
+  Submissions are only made from the I/O thread, so the only ordering that matters is with the kernel's side of the
+  rings (acquire on the heads and tails it writes, release on the ones we write)*/
+class IOBackend::Uring
+{
+public:
+    enum Op : uint64_t {WRITE, READ_INPUT, READ_WAKE, TICK, CANCEL};
+
+    Uring()
+    {
+        io_uring_params params = {};
+        fd = (int) syscall(__NR_io_uring_setup, 16, &params);
+        if (fd < 0) return;
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) sqSize = cqSize = max(sqSize, cqSize);
+
+        sq = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        cq = (params.features & IORING_FEAT_SINGLE_MMAP) ? sq
+             : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe*) mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                    IORING_OFF_SQES);
+        if (sq == MAP_FAILED || cq == MAP_FAILED || sqes == MAP_FAILED)
+        {
+            unmap();
+            close(fd);
+            fd = -1;
+            return;
+        }
+
+        char* sqBase = (char*) sq;
+        sqTail = (unsigned int*) (sqBase + params.sq_off.tail);
+        sqMask = *(unsigned int*) (sqBase + params.sq_off.ring_mask);
+        sqArray = (unsigned int*) (sqBase + params.sq_off.array);
+        char* cqBase = (char*) cq;
+        cqHead = (unsigned int*) (cqBase + params.cq_off.head);
+        cqTail = (unsigned int*) (cqBase + params.cq_off.tail);
+        cqMask = *(unsigned int*) (cqBase + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe*) (cqBase + params.cq_off.cqes);
+    }
+
+    ~Uring()
+    {
+        if (fd < 0) return;
+        unmap();
+        close(fd);
+    }
+
+    bool isOpen() const {return fd >= 0;}
+
+    //at most four operations are ever in flight, so the 16 entry queues can't fill up
+    io_uring_sqe& prepare(uint8_t opcode, int target, const void* address, unsigned int length, uint64_t offset,
+                          Op op)
+    {
+        unsigned int tail = *sqTail + unsubmitted;
+        unsigned int index = tail & sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = opcode;
+        sqe.fd = target;
+        sqe.addr = (uint64_t) address;
+        sqe.len = length;
+        sqe.off = offset;
+        sqe.user_data = op;
+        sqArray[index] = index;
+        unsubmitted++;
+        return sqe;
+    }
+
+    //submits everything prepared and waits for at least one completion
+    int enter()
+    {
+        __atomic_store_n(sqTail, *sqTail + unsubmitted, __ATOMIC_RELEASE);
+        unsigned int toSubmit = unsubmitted;
+        unsubmitted = 0;
+        int result;
+        do
+        {
+            result = (int) syscall(__NR_io_uring_enter, fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result > 0) toSubmit -= result;
+        } while (result < 0 && errno == EINTR);
+        return result;
+    }
+
+    bool nextCompletion(io_uring_cqe& completion)
+    {
+        unsigned int head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) return false;
+        completion = cqes[head & cqMask];
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    //the kernel may write these until the operation using them completes, so they live as long as the ring
+    char input[readSize];
+    uint64_t wakeCount = 0;
+    __kernel_timespec tick = {0, flushIntervalMicros * 1000L};
+
+private:
+    void unmap()
+    {
+        if (sqes != MAP_FAILED && sqes != nullptr) munmap(sqes, sqesSize);
+        if (cq != sq && cq != MAP_FAILED && cq != nullptr) munmap(cq, cqSize);
+        if (sq != MAP_FAILED && sq != nullptr) munmap(sq, sqSize);
+    }
+
+    int fd = -1;
+    void* sq = nullptr;
+    void* cq = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqSize = 0, cqSize = 0, sqesSize = 0;
+    unsigned int* sqTail = nullptr;
+    unsigned int* sqArray = nullptr;
+    unsigned int sqMask = 0;
+    unsigned int* cqHead = nullptr;
+    unsigned int* cqTail = nullptr;
+    unsigned int cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned int unsubmitted = 0;
+};
+
+IOBackend::IOBackend(bool allowUring, int outFd, int inFd):
+        outFd(outFd),
+        inFd(inFd)
+{
+    wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd < 0) throw FSMException(FSMError::IO, string("Could not create eventfd: ") + strerror(errno));
+    if (allowUring)
+    {
+        ring = make_unique<Uring>();
+        if (ring->isOpen()) kind = IO_URING;
+        else ring.reset();
+    }
+    worker = thread(&IOBackend::work, this);
+}
+
+IOBackend::~IOBackend()
+{
+    join(); //a failure has gone to the machines already, or to whoever called stop
+    close(wakeFd);
+}
+
+void IOBackend::stop()
+{
+    join();
+    rethrowFailure();
+}
+
+void IOBackend::join()
+{
+    if (!worker.joinable()) return;
+    stopping.store(true);
+    wake();
+    worker.join();
+    ring.reset();
+}
+
+void IOBackend::work()
+{
+    try
+    {
+        if (kind == IO_URING) runUring();
+        else runEpoll();
+    }
+    catch (...)
+    {
+        failure = current_exception();
+        failed.store(true);
+        //nothing more will be written or read, so let anything waiting on the I/O thread find that out
+        {
+            lock_guard<mutex> guard(inputLock);
+            inputEnded = true;
+        }
+        inputArrived.notify_all();
+        lock_guard<mutex> guard(portsLock);
+        for (unique_ptr<Port>& port : ports)
+        {
+            //under the port's lock so a machine between checking and waiting doesn't miss it
+            lock_guard<mutex> portGuard(port->lock);
+            port->drained.notify_all();
+        }
+    }
+}
+
+void IOBackend::rethrowFailure() const
+{
+    if (failed.load()) rethrow_exception(failure);
+}
+
+FSMIO IOBackend::attach()
+{
+    Port* port;
+    {
+        lock_guard<mutex> guard(portsLock);
+        ports.push_back(make_unique<Port>());
+        port = ports.back().get();
+    }
+    FSMIO hooks;
+    hooks.print = [this, port] (const string& text) {print(*port, text);};
+    hooks.input = [this] (string& word) {return input(word);};
+    return hooks;
+}
+
+IOBackend::Stats IOBackend::getStats() const
+{
+    Stats stats;
+    stats.syscalls = syscalls.load() + machineSyscalls.load();
+    stats.flushes = flushes.load();
+    stats.bytesWritten = bytesWritten.load();
+    return stats;
+}
+
+void IOBackend::print(Port& port, const string& text)
+{
+    rethrowFailure();
+    bool wasEmpty, crossedHighWater;
+    {
+        unique_lock<mutex> lock(port.lock);
+        //a machine outrunning its output waits rather than buffering without limit
+        port.drained.wait(lock, [&] () {return port.pending.size() < maxPending || failed.load();});
+        if (failed.load())
+        {
+            lock.unlock();
+            rethrowFailure();
+        }
+        wasEmpty = port.pending.empty();
+        crossedHighWater = port.pending.size() < highWater && port.pending.size() + text.size() >= highWater;
+        port.pending += text;
+    }
+    //the I/O thread only needs telling if it might be asleep with nothing to do, or this can't wait for the next tick
+    if ((wasEmpty && sleeping.load()) || crossedHighWater) wake();
+}
+
+bool IOBackend::input(string& word)
+{
+    unique_lock<mutex> lock(inputLock);
+    if (takeWord(word)) return true;
+
+    waitingForInput++;
+    bool got = false;
+    while (!inputEnded)
+    {
+        lock.unlock();
+        wake();
+        lock.lock();
+        //checked again under the lock so a read finishing while we were waking the I/O thread isn't missed
+        if ((got = takeWord(word)) || inputEnded) break;
+        inputArrived.wait(lock);
+        if ((got = takeWord(word))) break;
+    }
+    if (!got) got = takeWord(word);
+    waitingForInput--;
+    if (!got) rethrowFailure(); //the input didn't end, the I/O thread did
+    return got;
+}
+
+bool IOBackend::takeWord(string& word)
+{
+    size_t start = 0;
+    while (start < readAhead.size() && isSpace(readAhead[start])) start++;
+    size_t end = start;
+    while (end < readAhead.size() && !isSpace(readAhead[end])) end++;
+
+    if (start == end || (end == readAhead.size() && !inputEnded))
+    {
+        readAhead.erase(0, start);
+        return false;
+    }
+    word = readAhead.substr(start, end - start);
+    readAhead.erase(0, end);
+    return true;
+}
+
+void IOBackend::wake()
+{
+    uint64_t one = 1;
+    machineSyscalls.fetch_add(1, memory_order_relaxed);
+    while (write(wakeFd, &one, sizeof(one)) < 0 && errno == EINTR);
+}
+
+bool IOBackend::gather(vector<string>& batch)
+{
+    lock_guard<mutex> guard(portsLock);
+    for (unique_ptr<Port>& port : ports)
+    {
+        bool wasFull;
+        {
+            lock_guard<mutex> portGuard(port->lock);
+            if (port->pending.empty()) continue;
+            wasFull = port->pending.size() >= maxPending;
+            batch.push_back(move(port->pending));
+            port->pending = string();
+        }
+        if (wasFull) port->drained.notify_all();
+    }
+    return !batch.empty();
+}
+
+void IOBackend::received(const char* data, ssize_t length)
+{
+    {
+        lock_guard<mutex> guard(inputLock);
+        if (length <= 0) inputEnded = true;
+        else readAhead.append(data, length);
+    }
+    inputArrived.notify_all();
+}
+
+void IOBackend::runUring()
+{
+    vector<string> batch;
+    vector<iovec> vectors;
+    size_t firstVector = 0;
+    bool writing = false, reading = false, wakeArmed = false, ticking = false, cancelling = false, woken = false;
+
+    auto submitWrite = [&] ()
+    {
+        unsigned int count = (unsigned int) min<size_t>(vectors.size() - firstVector, IOV_MAX);
+        ring->prepare(IORING_OP_WRITEV, outFd, &vectors[firstVector], count, (uint64_t) -1, Uring::WRITE);
+    };
+
+    while (true)
+    {
+        bool stop = stopping.load();
+        bool busy = writing;
+        //after a flush the next one waits for the tick, unless a machine passing highWater woke us
+        if (!writing && (!ticking || woken || stop))
+        {
+            //set before looking, so a machine printing after the look wakes us
+            sleeping.store(true);
+            batch.clear();
+            if (gather(batch))
+            {
+                sleeping.store(false);
+                vectors.clear();
+                for (string& text : batch) vectors.push_back({(void*) text.data(), text.size()});
+                firstVector = 0;
+                submitWrite();
+                writing = busy = true;
+            }
+        }
+
+        bool wantInput;
+        {
+            lock_guard<mutex> guard(inputLock);
+            wantInput = waitingForInput > 0 && !inputEnded;
+        }
+        if (stop && !writing)
+        {
+            if (!reading) break;
+            //the read would otherwise go on filling ring->input after we stop
+            if (!cancelling) ring->prepare(IORING_OP_ASYNC_CANCEL, -1, (void*) (uint64_t) Uring::READ_INPUT, 0, 0,
+                                           Uring::CANCEL);
+            cancelling = true;
+        }
+        else if (wantInput && !reading)
+        {
+            ring->prepare(IORING_OP_READ, inFd, ring->input, readSize, (uint64_t) -1, Uring::READ_INPUT);
+            reading = true;
+        }
+        if (!wakeArmed)
+        {
+            ring->prepare(IORING_OP_READ, wakeFd, &ring->wakeCount, sizeof(ring->wakeCount), 0, Uring::READ_WAKE);
+            wakeArmed = true;
+        }
+        //while output is flowing come back every flush interval for more, otherwise sleep until woken
+        if (busy && !ticking)
+        {
+            ring->prepare(IORING_OP_TIMEOUT, -1, &ring->tick, 1, 0, Uring::TICK);
+            ticking = true;
+        }
+
+        syscalls.fetch_add(1, memory_order_relaxed);
+        if (ring->enter() < 0) throw FSMException(FSMError::IO, string("io_uring_enter failed: ") + strerror(errno));
+        sleeping.store(false);
+        woken = false;
+
+        io_uring_cqe completion;
+        while (ring->nextCompletion(completion))
+        {
+            switch (completion.user_data)
+            {
+                case Uring::WRITE:
+                {
+                    if (completion.res == -EINTR || completion.res == -EAGAIN)
+                    {
+                        submitWrite();
+                        break;
+                    }
+                    if (completion.res < 0)
+                    {
+                        //nowhere left to report it - drop the output like a closed cout would
+                        writing = false;
+                        break;
+                    }
+                    size_t written = completion.res;
+                    bytesWritten.fetch_add(written, memory_order_relaxed);
+                    while (firstVector < vectors.size() && written >= vectors[firstVector].iov_len)
+                    {
+                        written -= vectors[firstVector].iov_len;
+                        firstVector++;
+                    }
+                    if (firstVector < vectors.size())
+                    {
+                        vectors[firstVector].iov_base = (char*) vectors[firstVector].iov_base + written;
+                        vectors[firstVector].iov_len -= written;
+                        submitWrite();
+                    }
+                    else
+                    {
+                        flushes.fetch_add(1, memory_order_relaxed);
+                        writing = false;
+                    }
+                    break;
+                }
+                case Uring::READ_INPUT:
+                    reading = false;
+                    if (completion.res == -EINTR || completion.res == -EAGAIN) break;
+                    if (completion.res == -ECANCELED) break;
+                    received(ring->input, completion.res);
+                    break;
+                case Uring::READ_WAKE:
+                    wakeArmed = false;
+                    woken = true;
+                    break;
+                case Uring::TICK:
+                    ticking = false;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+void IOBackend::runEpoll()
+{
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) throw FSMException(FSMError::IO, string("Could not create epoll: ") + strerror(errno));
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, wakeFd, &event);
+    //registered with no events and only armed while a machine waits; regular files can't be polled at all
+    event.events = 0;
+    event.data.fd = inFd;
+    bool inputPollable = epoll_ctl(epoll, EPOLL_CTL_ADD, inFd, &event) == 0;
+    bool inputArmed = false;
+    char buffer[readSize];
+
+    vector<string> batch;
+    vector<iovec> vectors;
+    auto readInput = [&] ()
+    {
+        ssize_t got;
+        do
+        {
+            syscalls.fetch_add(1, memory_order_relaxed);
+            got = read(inFd, buffer, sizeof(buffer));
+        } while (got < 0 && errno == EINTR);
+        if (got < 0 && errno == EAGAIN) return;
+        received(buffer, got);
+    };
+
+    while (true)
+    {
+        sleeping.store(true);
+        batch.clear();
+        bool busy = gather(batch);
+        if (busy)
+        {
+            sleeping.store(false);
+            vectors.clear();
+            for (string& text : batch) vectors.push_back({(void*) text.data(), text.size()});
+            size_t first = 0;
+            while (first < vectors.size())
+            {
+                syscalls.fetch_add(1, memory_order_relaxed);
+                ssize_t written = writev(outFd, &vectors[first], (int) min<size_t>(vectors.size() - first, IOV_MAX));
+                if (written < 0 && errno == EINTR) continue;
+                if (written < 0) break;
+                bytesWritten.fetch_add(written, memory_order_relaxed);
+                while (first < vectors.size() && (size_t) written >= vectors[first].iov_len)
+                {
+                    written -= vectors[first].iov_len;
+                    first++;
+                }
+                if (first < vectors.size())
+                {
+                    vectors[first].iov_base = (char*) vectors[first].iov_base + written;
+                    vectors[first].iov_len -= written;
+                }
+            }
+            flushes.fetch_add(1, memory_order_relaxed);
+        }
+        else if (stopping.load()) break;
+
+        bool wantInput;
+        {
+            lock_guard<mutex> guard(inputLock);
+            wantInput = waitingForInput > 0 && !inputEnded;
+        }
+        if (wantInput && !inputPollable)
+        {
+            readInput();
+            continue;
+        }
+        if (wantInput != inputArmed && inputPollable)
+        {
+            event.events = wantInput ? (uint32_t) EPOLLIN : 0;
+            event.data.fd = inFd;
+            syscalls.fetch_add(1, memory_order_relaxed);
+            epoll_ctl(epoll, EPOLL_CTL_MOD, inFd, &event);
+            inputArmed = wantInput;
+        }
+
+        epoll_event ready[2];
+        syscalls.fetch_add(1, memory_order_relaxed);
+        int count = epoll_wait(epoll, ready, 2, busy ? max(1, flushIntervalMicros / 1000) : -1);
+        sleeping.store(false);
+        for (int i = 0; i < count; ++i)
+        {
+            if (ready[i].data.fd == wakeFd)
+            {
+                uint64_t wakeCount;
+                syscalls.fetch_add(1, memory_order_relaxed);
+                if (read(wakeFd, &wakeCount, sizeof(wakeCount)) < 0) continue;
+            }
+            else if (inputArmed) readInput();
+        }
+    }
+    close(epoll);
+}
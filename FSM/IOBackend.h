@@ -0,0 +1,102 @@
+#ifndef IOBACKEND_H
+#define IOBACKEND_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <string>
+#include <memory>
+#include <exception>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "FSMIO.h"
+
+/*Output and input for many machines without them making system calls. Each machine prints into its own buffer; one
+  I/O thread gathers every buffer with something in it into a single writev, at most every flushInterval (sooner if a
+  buffer passes highWater). Input is read ahead by the same thread and handed out a word at a time, a machine waiting
+  for a word sleeping until the read that completes it. The I/O thread drives io_uring (raw syscalls, so no liburing)
+  and falls back to epoll with plain writev and read where io_uring isn't allowed. If the I/O thread fails, what it
+  threw is rethrown to the machines on their next print or input, and by stop*/
+class IOBackend
+{
+public:
+    enum Kind {IO_URING, EPOLL};
+
+    struct Stats
+    {
+        uint64_t syscalls = 0; //made by the I/O thread plus wake ups from machines
+        uint64_t flushes = 0;
+        uint64_t bytesWritten = 0;
+    };
+
+    explicit IOBackend(bool allowUring = true, int outFd = 1, int inFd = 0);
+    //see stop
+    ~IOBackend();
+
+    Kind getKind() const {return kind;}
+    //hooks for one machine - the backend must outlive it
+    FSMIO attach();
+    Stats getStats() const;
+    //flushes everything printed so far and ends the I/O thread - every attached machine must have finished. Throws
+    //what the I/O thread did, if it failed
+    void stop();
+
+    static const size_t highWater = 64 * 1024;
+    static const size_t maxPending = 16 * highWater; //a machine printing past this waits for the I/O thread
+    static const int flushIntervalMicros = 1000;
+
+private:
+    struct Port
+    {
+        std::mutex lock;
+        std::condition_variable drained;
+        std::string pending;
+    };
+    class Uring;
+
+    void print(Port& port, const std::string& text);
+    bool input(std::string& word);
+    bool takeWord(std::string& word);
+    void wake();
+
+    //runs the I/O thread, keeping anything it throws for the machines
+    void work();
+    void runUring();
+    void runEpoll();
+    void rethrowFailure() const;
+    void join();
+    //moves every port's pending output into batch, returns false if there was none
+    bool gather(std::vector<std::string>& batch);
+    void received(const char* data, ssize_t length);
+
+    Kind kind = EPOLL;
+    int outFd;
+    int inFd;
+    int wakeFd = -1;
+    std::unique_ptr<Uring> ring;
+
+    std::mutex portsLock;
+    std::vector<std::unique_ptr<Port>> ports;
+
+    std::mutex inputLock;
+    std::condition_variable inputArrived;
+    std::string readAhead;
+    bool inputEnded = false;
+    unsigned int waitingForInput = 0;
+
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> failed{false};
+    std::exception_ptr failure; //written before failed is set
+    //counts are only written by one thread each, read by getStats
+    std::atomic<uint64_t> machineSyscalls{0};
+    std::atomic<uint64_t> syscalls{0};
+    std::atomic<uint64_t> flushes{0};
+    std::atomic<uint64_t> bytesWritten{0};
+    std::thread worker;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "FSM.h"
+#include "IOBackend.h"
+
+using namespace std;
+
+namespace
+{
+    //each machine prints the numbers below lines, one per transition
+    string writeMachine(unsigned long lines)
+    {
+        char path[] = "/tmp/FSMIOBenchXXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0) throw runtime_error("Could not create machine file");
+        close(fd);
+        ofstream out(path);
+        out << "start\nint i;\nint n;\nn = " << lines << ";\njump loop;\nend\n\n"
+            << "loop\nprint i;\nprint \"\\n\";\ni = i + 1;\njumpif i < n loop;\nreturn;\nend\n";
+        return path;
+    }
+
+    struct Result
+    {
+        double seconds;
+        uint64_t syscalls;
+    };
+
+    Result runMachines(string file, unsigned int machines, int outFd, IOBackend* backend)
+    {
+        atomic<uint64_t> directWrites{0};
+        vector<unique_ptr<FSM>> fsms;
+        for (unsigned int i = 0; i < machines; ++i)
+        {
+            fsms.push_back(make_unique<FSM>(file));
+            if (backend != nullptr) fsms.back()->setIO(backend->attach());
+            else
+            {
+                //what PrintCommand costs without a backend once cout can't buffer it: a write per print
+                FSMIO direct;
+                direct.print = [outFd, &directWrites] (const string& text)
+                {
+                    directWrites.fetch_add(1, memory_order_relaxed);
+                    if (write(outFd, text.data(), text.size()) < 0) throw runtime_error("write failed");
+                };
+                fsms.back()->setIO(direct);
+            }
+        }
+
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (unique_ptr<FSM>& fsm : fsms) threads.emplace_back([&fsm] () {fsm->run();});
+        for (thread& t : threads) t.join();
+        return {chrono::duration<double>(chrono::steady_clock::now() - start).count(), directWrites.load()};
+    }
+
+    void report(const string& mode, const Result& result, uint64_t prints)
+    {
+        cerr << left << setw(8) << mode << right << fixed << setprecision(3)
+             << setw(10) << result.seconds << " s"
+             << setw(14) << (uint64_t) (prints / result.seconds) << " prints/s"
+             << setw(12) << result.syscalls << " syscalls"
+             << setw(10) << setprecision(4) << (double) result.syscalls / prints << " per print\n";
+    }
+}
+
+//compares printing from many machines with a write per print against IOBackend over epoll and io_uring
+int main(int argc, char** argv)
+{
+    unsigned int machines = argc > 1 ? stoul(argv[1]) : 8;
+    unsigned long lines = argc > 2 ? stoul(argv[2]) : 20000;
+    const char* target = argc > 3 ? argv[3] : "/dev/null";
+    if (argc > 4 || machines == 0) throw runtime_error("Usage: FSMIOBench [machines] [lines each] [output file]");
+
+    int outFd = open(target, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (outFd < 0) throw runtime_error("Could not open '" + string(target) + "': " + strerror(errno));
+    string file = writeMachine(lines);
+    uint64_t prints = (uint64_t) machines * lines * 2;
+    cerr << machines << " machines, " << prints << " prints to " << target << "\n";
+
+    report("direct", runMachines(file, machines, outFd, nullptr), prints);
+    for (bool uring : {false, true})
+    {
+        auto backend = make_unique<IOBackend>(uring, outFd);
+        if (uring && backend->getKind() != IOBackend::IO_URING)
+        {
+            cerr << "io_uring unavailable here\n";
+            break;
+        }
+        string mode = backend->getKind() == IOBackend::IO_URING ? "io_uring" : "epoll";
+        auto start = chrono::steady_clock::now();
+        runMachines(file, machines, outFd, backend.get());
+        backend->stop(); //not done until the last flush
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        report(mode, {seconds, backend->getStats().syscalls}, prints);
+    }
+
+    close(outFd);
+    unlink(file.c_str());
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef LIMITS_H
+#define LIMITS_H
+
+#include <string>
+#include <chrono>
+
+#include "Errors.h"
+
+//per instance resource limits, zero means unlimited
+struct ExecutionLimits
+{
+    unsigned long long maxStackDepth = 0;
+    unsigned long long maxStringBytes = 0;
+    unsigned long long maxSteps = 0;
+    std::chrono::milliseconds maxWallTime{0};
+};
+
+enum class Quota {STACK_DEPTH, STRING_BYTES, STEPS, WALL_TIME};
+
+inline const char* quotaName(Quota quota)
+{
+    switch(quota)
+    {
+        case Quota::STACK_DEPTH: return "stack depth";
+        case Quota::STRING_BYTES: return "string bytes";
+        case Quota::STEPS: return "steps";
+        case Quota::WALL_TIME: return "wall time (ms)";
+    }
+    return "unknown";
+}
+
+struct QuotaViolation
+{
+    Quota quota;
+    unsigned long long limit;
+    unsigned long long reached;
+    std::string state; //the state about to run when the limit was noticed
+    unsigned long long steps;
+};
+
+class QuotaExceeded: public FSMException
+{
+public:
+    QuotaExceeded(QuotaViolation v):
+            FSMException(FSMError::QUOTA_EXCEEDED, std::string("Exceeded ") + quotaName(v.quota) + " limit of "
+                                                   + std::to_string(v.limit) + " (reached " + std::to_string(v.reached)
+                                                   + " in state '" + v.state + "' after " + std::to_string(v.steps)
+                                                   + " steps)"),
+            violation(std::move(v)) {}
+
+    const QuotaViolation& getViolation() const {return violation;}
+
+private:
+    QuotaViolation violation;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "Metrics.h"
+#include "Errors.h"
+
+using namespace std;
+
+namespace
+{
+    //registration and scraping are rare, so they share a lock - updates never touch it
+    mutex registryLock;
+    vector<const MachineMetrics*> registered;
+
+    //whether something is accepting connections on address
+    bool inUse(const sockaddr_un& address)
+    {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0) return false;
+        bool connected = connect(probe, (const sockaddr*) &address, sizeof(address)) == 0;
+        close(probe);
+        return connected;
+    }
+}
+
+MachineMetrics::Totals MachineMetrics::retired;
+
+MachineMetrics::~MachineMetrics()
+{
+    if (!enabled) return;
+    lock_guard<mutex> guard(registryLock);
+    addTo(retired);
+    registered.erase(remove(registered.begin(), registered.end(), this), registered.end());
+}
+
+void MachineMetrics::enable()
+{
+    if (enabled) return;
+    lock_guard<mutex> guard(registryLock);
+    registered.push_back(this);
+    enabled = true;
+}
+
+void MachineMetrics::addTo(Totals& totals) const
+{
+    totals.transitions += transitions.load(memory_order_relaxed);
+    totals.outputBytes += outputBytes.load(memory_order_relaxed);
+    totals.inputWaitNanos += inputWaitNanos.load(memory_order_relaxed);
+    totals.depthSum += depthSum.load(memory_order_relaxed);
+    for (unsigned int i = 0; i < depthBuckets; ++i) totals.depthCounts[i] += depthCounts[i].load(memory_order_relaxed);
+}
+
+string MachineMetrics::render()
+{
+    Totals totals;
+    unsigned int instances = 0, runningInstances = 0;
+    {
+        lock_guard<mutex> guard(registryLock);
+        totals = retired;
+        for (const MachineMetrics* m : registered)
+        {
+            m->addTo(totals);
+            instances++;
+            if (m->running.load(memory_order_relaxed)) runningInstances++;
+        }
+    }
+
+    ostringstream out;
+    out << "# HELP fsm_transitions_total State transitions made by all machines.\n"
+        << "# TYPE fsm_transitions_total counter\n"
+        << "fsm_transitions_total " << totals.transitions << "\n"
+        << "# HELP fsm_instances Machines loaded in this process.\n"
+        << "# TYPE fsm_instances gauge\n"
+        << "fsm_instances " << instances << "\n"
+        << "# HELP fsm_instances_running Machines currently running.\n"
+        << "# TYPE fsm_instances_running gauge\n"
+        << "fsm_instances_running " << runningInstances << "\n"
+        << "# HELP fsm_output_bytes_total Bytes printed by all machines.\n"
+        << "# TYPE fsm_output_bytes_total counter\n"
+        << "fsm_output_bytes_total " << totals.outputBytes << "\n"
+        << "# HELP fsm_input_wait_seconds_total Time machines spent blocked on input or channels.\n"
+        << "# TYPE fsm_input_wait_seconds_total counter\n"
+        << "fsm_input_wait_seconds_total " << totals.inputWaitNanos / 1e9 << "\n"
+        << "# HELP fsm_stack_depth Stack depth seen at each transition.\n"
+        << "# TYPE fsm_stack_depth histogram\n";
+
+    uint64_t cumulative = 0;
+    for (unsigned int i = 0; i < depthBuckets - 1; ++i)
+    {
+        cumulative += totals.depthCounts[i];
+        out << "fsm_stack_depth_bucket{le=\"" << ((1ULL << i) - 1) << "\"} " << cumulative << "\n";
+    }
+    cumulative += totals.depthCounts[depthBuckets - 1];
+    out << "fsm_stack_depth_bucket{le=\"+Inf\"} " << cumulative << "\n"
+        << "fsm_stack_depth_sum " << totals.depthSum << "\n"
+        << "fsm_stack_depth_count " << cumulative << "\n";
+    return out.str();
+}
+
+MetricsServer::MetricsServer(string socketPath):
+        path(move(socketPath))
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        throw FSMException(FSMError::IO, "Metrics socket path '" + path + "' is too long");
+    }
+    strcpy(address.sun_path, path.c_str());
+    //another process's, still serving - taking it over would leave that one's scrapers talking to this one
+    if (inUse(address)) throw FSMException(FSMError::IO, "Metrics socket '" + path + "' is already being served on");
+
+    listening = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listening < 0) throw FSMException(FSMError::IO, string("Could not create metrics socket: ") + strerror(errno));
+    unlink(path.c_str()); //left behind by an earlier run that was killed
+    if (bind(listening, (sockaddr*) &address, sizeof(address)) != 0 || listen(listening, 16) != 0)
+    {
+        string reason = strerror(errno);
+        close(listening);
+        throw FSMException(FSMError::IO, "Could not listen on metrics socket '" + path + "': " + reason);
+    }
+    server = thread(&MetricsServer::serve, this);
+}
+
+MetricsServer::~MetricsServer()
+{
+    stopping.store(true);
+    server.join();
+    close(listening);
+    unlink(path.c_str());
+}
+
+void MetricsServer::serve()
+{
+    pollfd waiting = {listening, POLLIN, 0};
+    while (!stopping.load())
+    {
+        if (poll(&waiting, 1, 200) <= 0) continue; //wakes up now and then to check for shutdown
+        int client = accept4(listening, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;
+        answer(client);
+        close(client);
+    }
+}
+
+void MetricsServer::answer(int client)
+{
+    //give an HTTP client a moment to send its request, a plain one needn't send anything
+    char request[1024];
+    ssize_t got = 0;
+    pollfd readable = {client, POLLIN, 0};
+    if (poll(&readable, 1, 100) > 0) got = recv(client, request, sizeof(request), 0);
+    bool http = got >= 3 && memcmp(request, "GET", 3) == 0;
+
+    string body = MachineMetrics::render();
+    string response = http ? "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+                             + to_string(body.size()) + "\r\n\r\n" + body
+                           : body;
+
+    const char* bytes = response.data();
+    size_t remaining = response.size();
+    while (remaining > 0)
+    {
+        ssize_t sent = send(client, bytes, remaining, MSG_NOSIGNAL);
+        if (sent <= 0) return;
+        bytes += sent;
+        remaining -= sent;
+    }
+}
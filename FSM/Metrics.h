@@ -0,0 +1,86 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <thread>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*Live counters for one machine. Only the thread running the machine writes them, so an update is a relaxed load and
+  store with no locked instruction. Enabled machines are registered for MetricsServer, which sums them when scraped;
+  a machine that goes away adds its counts to a retired total first so they aren't lost*/
+class MachineMetrics
+{
+public:
+    //stack depth at each transition - bucket i counts depths up to 2^i - 1, the last is everything deeper
+    static const unsigned int depthBuckets = 17;
+
+    ~MachineMetrics();
+
+    void enable();
+    bool isEnabled() const {return enabled;}
+
+    inline void transition(size_t depth)
+    {
+        bump(transitions, 1);
+        bump(depthSum, depth);
+        bump(depthCounts[depth == 0 ? 0 : depthBucket(depth)], 1);
+    }
+    void output(size_t bytes) {bump(outputBytes, bytes);}
+    void blockedOnInput(uint64_t nanoseconds) {bump(inputWaitNanos, nanoseconds);}
+    void setRunning(bool isRunning) {running.store(isRunning, std::memory_order_relaxed);}
+
+    //Prometheus text exposition of every enabled machine
+    static std::string render();
+
+private:
+    struct Totals
+    {
+        uint64_t transitions = 0;
+        uint64_t outputBytes = 0;
+        uint64_t inputWaitNanos = 0;
+        uint64_t depthSum = 0;
+        uint64_t depthCounts[depthBuckets] = {};
+    };
+
+    static inline void bump(std::atomic<uint64_t>& counter, uint64_t by)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+    static inline unsigned int depthBucket(size_t depth)
+    {
+        unsigned int bits = 64 - __builtin_clzll((unsigned long long) depth);
+        return bits < depthBuckets - 1 ? bits : depthBuckets - 1;
+    }
+    void addTo(Totals& totals) const;
+    static Totals retired;
+
+    bool enabled = false;
+    alignas(64) std::atomic<uint64_t> transitions{0};
+    std::atomic<uint64_t> outputBytes{0};
+    std::atomic<uint64_t> inputWaitNanos{0};
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> depthSum{0};
+    std::atomic<uint64_t> depthCounts[depthBuckets] = {};
+};
+
+/*Serves MachineMetrics::render on a Unix socket from its own thread. A client sending an HTTP GET gets an HTTP
+  response (so Prometheus or curl --unix-socket can scrape it), anything else just gets the text*/
+class MetricsServer
+{
+public:
+    explicit MetricsServer(std::string socketPath);
+    ~MetricsServer();
+
+private:
+    void serve();
+    void answer(int client);
+
+    std::string path;
+    int listening = -1;
+    std::atomic<bool> stopping{false};
+    std::thread server;
+};
+
+#endif
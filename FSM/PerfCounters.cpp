@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "PerfCounters.h"
+
+using namespace std;
+
+namespace
+{
+    int openCounter(uint32_t type, uint64_t config, int groupFd)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = groupFd == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+    }
+
+    const char* counterNames[] = {"instructions", "cycles", "branch-misses", "L1d-misses"};
+}
+
+PerfCounters::~PerfCounters()
+{
+    closeAll();
+}
+
+void PerfCounters::closeAll()
+{
+    for (int& fd : fds)
+    {
+        if (fd != -1) close(fd);
+        fd = -1;
+    }
+    for (int& slot : slots) slot = -1;
+    leader = -1;
+    opened = 0;
+}
+
+bool PerfCounters::enable(unsigned int numStates, unsigned int sampleInterval)
+{
+    const pair<uint32_t, uint64_t> events[NUM_COUNTERS] =
+    {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                             | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}
+    };
+
+    for (int i = 0; i < NUM_COUNTERS; ++i)
+    {
+        fds[i] = openCounter(events[i].first, events[i].second, leader);
+        if (fds[i] == -1)
+        {
+            if (error.empty()) error = string(counterNames[i]) + ": " + strerror(errno);
+            continue;
+        }
+        if (leader == -1) leader = fds[i];
+        slots[i] = opened++;
+    }
+
+    if (leader == -1) return false;
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    if (!readGroup(before))
+    {
+        error = string("reading the counter group failed: ") + strerror(errno);
+        closeAll();
+        return false;
+    }
+
+    interval = sampleInterval == 0 ? 1 : sampleInterval;
+    untilNextSample = interval;
+    totals.assign(numStates, {});
+    samples.assign(numStates, 0);
+    enabled = true;
+    return true;
+}
+
+bool PerfCounters::readGroup(array<uint64_t, NUM_COUNTERS>& into)
+{
+    uint64_t buffer[1 + NUM_COUNTERS];
+    ssize_t got = read(leader, buffer, sizeof(buffer));
+    if (got < (ssize_t) ((1 + opened) * sizeof(uint64_t)))
+    {
+        if (got >= 0) errno = EIO; //short
+        return false;
+    }
+    for (int i = 0; i < NUM_COUNTERS; ++i) into[i] = slots[i] == -1 ? 0 : buffer[1 + slots[i]];
+    return true;
+}
+
+void PerfCounters::start()
+{
+    started = readGroup(before);
+    if (!started) ++failedReads;
+}
+
+void PerfCounters::stop(int state)
+{
+    if (!started) return;
+    started = false;
+    array<uint64_t, NUM_COUNTERS> after;
+    if (!readGroup(after))
+    {
+        ++failedReads;
+        return;
+    }
+    for (int i = 0; i < NUM_COUNTERS; ++i) totals[state][i] += after[i] - before[i];
+    ++samples[state];
+}
+
+void PerfCounters::renumber(const vector<int>& newNumber, unsigned int numStates)
+{
+    vector<array<uint64_t, NUM_COUNTERS>> newTotals(numStates, array<uint64_t, NUM_COUNTERS>{});
+    vector<uint64_t> newSamples(numStates, 0);
+    for (size_t i = 0; i < newNumber.size() && i < totals.size(); ++i)
+    {
+        if (newNumber[i] == -1) continue;
+        newTotals[newNumber[i]] = totals[i];
+        newSamples[newNumber[i]] = samples[i];
+    }
+    totals = move(newTotals);
+    samples = move(newSamples);
+}
+
+void PerfCounters::report(ostream& out, const vector<string>& stateNames) const
+{
+    if (!enabled) return;
+
+    vector<unsigned int> order;
+    for (unsigned int i = 0; i < samples.size(); ++i) if (samples[i] != 0) order.push_back(i);
+    sort(order.begin(), order.end(), [this] (unsigned int a, unsigned int b)
+    {
+        return totals[a][CYCLES] > totals[b][CYCLES];
+    });
+
+    out << "Hardware counters per state execution (sampled every " << interval << " executions)\n";
+    if (!error.empty()) out << "Some counters unavailable (" << error << ")\n";
+    if (failedReads != 0) out << "Counters unavailable for " << failedReads << " reads, their samples were dropped\n";
+    out << left << setw(24) << "state" << right << setw(10) << "samples";
+    for (const char* name : counterNames) out << setw(16) << name;
+    out << setw(8) << "IPC" << "\n";
+
+    for (unsigned int state : order)
+    {
+        out << left << setw(24) << stateNames[state] << right << setw(10) << samples[state];
+        for (int i = 0; i < NUM_COUNTERS; ++i)
+        {
+            if (slots[i] == -1) out << setw(16) << "n/a";
+            else out << setw(16) << fixed << setprecision(1) << (double) totals[state][i] / samples[state];
+        }
+        if (slots[INSTRUCTIONS] == -1 || slots[CYCLES] == -1 || totals[state][CYCLES] == 0) out << setw(8) << "n/a";
+        else out << setw(8) << setprecision(2) << (double) totals[state][INSTRUCTIONS] / totals[state][CYCLES];
+        out << "\n";
+    }
+}
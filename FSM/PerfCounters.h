@@ -0,0 +1,58 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <vector>
+#include <string>
+#include <array>
+#include <ostream>
+#include <cstdint>
+
+/*Per state hardware counters read through perf_event_open. Counters are user space only and read as one group
+  around every (sampleInterval)th state execution. If the kernel refuses a counter (e.g. perf_event_paranoid or
+  running in a container) it is reported as unavailable; if it refuses all of them, or the group can't be read,
+  profiling is switched off. A sample whose reads fail is dropped and counted in the report*/
+class PerfCounters
+{
+public:
+    enum Counter {INSTRUCTIONS, CYCLES, BRANCH_MISSES, L1D_MISSES, NUM_COUNTERS};
+
+    ~PerfCounters();
+
+    //returns false (with the reason in getError) if no counters could be opened
+    bool enable(unsigned int numStates, unsigned int sampleInterval);
+    bool isEnabled() const {return enabled;}
+    //after a reload - newNumber[old state] is the state's number in the new program, or -1 if it's gone
+    void renumber(const std::vector<int>& newNumber, unsigned int numStates);
+    const std::string& getError() const {return error;}
+
+    inline bool shouldSample()
+    {
+        if (--untilNextSample != 0) return false;
+        untilNextSample = interval;
+        return true;
+    }
+    void start();
+    void stop(int state);
+
+    void report(std::ostream& out, const std::vector<std::string>& stateNames) const;
+
+private:
+    bool readGroup(std::array<uint64_t, NUM_COUNTERS>& into);
+    void closeAll();
+
+    bool enabled = false;
+    bool started = false; //before holds a good read
+    uint64_t failedReads = 0;
+    std::string error;
+    int fds[NUM_COUNTERS] = {-1, -1, -1, -1};
+    int leader = -1;
+    unsigned int opened = 0;
+    int slots[NUM_COUNTERS] = {-1, -1, -1, -1}; //position of each counter in a group read
+    unsigned int interval = 1;
+    unsigned int untilNextSample = 1;
+    std::array<uint64_t, NUM_COUNTERS> before;
+    std::vector<std::array<uint64_t, NUM_COUNTERS>> totals;
+    std::vector<uint64_t> samples;
+};
+
+#endif
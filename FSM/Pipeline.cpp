@@ -0,0 +1,212 @@
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <exception>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+namespace
+{
+    const size_t maxCapacity = 1 << 24; //values buffered in one channel
+}
+
+Pipeline::Pipeline(const string& configFile, bool lazy)
+{
+    ifstream config(configFile);
+    if (!config) throw runtime_error("Could not open pipeline config '" + configFile + "'");
+
+    string directory;
+    size_t slash = configFile.find_last_of('/');
+    if (slash != string::npos) directory = configFile.substr(0, slash + 1);
+
+    string line;
+    int lineNum = 0;
+    while (getline(config, line))
+    {
+        ++lineNum;
+        istringstream words(line);
+        string keyword;
+        if (!(words >> keyword) || keyword[0] == '#') continue;
+
+        if (keyword == "machine")
+        {
+            MachineInfo info;
+            if (!(words >> info.name >> info.fileName))
+            {
+                throw runtime_error("Line " + to_string(lineNum) + ": expected 'machine <name> <file>'");
+            }
+            for (MachineInfo& other : machines)
+            {
+                if (other.name == info.name) throw runtime_error("Machine '" + info.name + "' defined multiple times");
+            }
+            if (info.fileName[0] != '/') info.fileName = directory + info.fileName;
+            machines.push_back(move(info));
+        }
+        else if (keyword == "channel")
+        {
+            string channelName, producerList, arrow, consumerName;
+            if (!(words >> channelName >> producerList >> arrow >> consumerName) || arrow != "->")
+            {
+                throw runtime_error("Line " + to_string(lineNum)
+                                    + ": expected 'channel <name> <producer>[,<producer>...] -> <consumer> [capacity]'");
+            }
+            if (channels.find(channelName) != channels.end())
+            {
+                throw runtime_error("Channel '" + channelName + "' defined multiple times");
+            }
+
+            size_t capacity = 1024;
+            string capacityWord, extra;
+            if (words >> capacityWord)
+            {
+                size_t parsed = 0;
+                bool digits = capacityWord.find_first_not_of("0123456789") == string::npos;
+                try
+                {
+                    if (digits) capacity = stoull(capacityWord, &parsed);
+                }
+                catch (out_of_range&) {}
+                bool valid = digits && parsed == capacityWord.size() && capacity != 0 && capacity <= maxCapacity;
+                if (!valid || words >> extra)
+                {
+                    throw runtime_error("Line " + to_string(lineNum) + ": bad capacity '" + capacityWord
+                                        + (extra.empty() ? "" : " " + extra) + "' for channel '" + channelName + "'");
+                }
+            }
+
+            vector<string> producers;
+            istringstream producerStream(producerList);
+            string producer;
+            while (getline(producerStream, producer, ',')) if (!producer.empty()) producers.push_back(producer);
+
+            unique_ptr<Channel> channel = make_unique<Channel>(channelName, capacity, producers.size());
+            for (const string& p : producers) getMachine(p).bindings.sendsTo[channelName] = channel.get();
+            getMachine(consumerName).bindings.receivesFrom[channelName] = channel.get();
+            channels[channelName] = move(channel);
+        }
+        else throw runtime_error("Line " + to_string(lineNum) + ": unknown keyword '" + keyword + "'");
+    }
+
+    if (machines.empty()) throw runtime_error("Pipeline has no machines");
+    for (MachineInfo& info : machines) info.fsm = make_unique<FSM>(info.fileName, info.bindings, lazy);
+}
+
+Pipeline::MachineInfo& Pipeline::getMachine(const string& name)
+{
+    for (MachineInfo& info : machines) if (info.name == name) return info;
+    throw runtime_error("Unknown machine '" + name + "' (machines must be defined before their channels)");
+}
+
+void Pipeline::enableTrace(unsigned int capacity, const string& prefix)
+{
+    for (MachineInfo& info : machines) info.fsm->enableTrace(capacity, prefix + "." + info.name);
+}
+
+void Pipeline::setLimits(const ExecutionLimits& limits)
+{
+    for (MachineInfo& info : machines) info.fsm->setLimits(limits);
+}
+
+void Pipeline::enableMetrics()
+{
+    for (MachineInfo& info : machines) info.fsm->enableMetrics();
+}
+
+void Pipeline::enableWatchdog(unsigned long checkInterval)
+{
+    for (MachineInfo& info : machines) info.fsm->enableWatchdog(checkInterval);
+}
+
+void Pipeline::enablePerfCounters(unsigned int sampleInterval)
+{
+    perfInterval = sampleInterval;
+}
+
+void Pipeline::reportPerfCounters(ostream& out) const
+{
+    if (perfInterval == 0) return;
+    for (const MachineInfo& info : machines)
+    {
+        out << "Machine '" << info.name << "': ";
+        if (!info.perfEnabled) out << "hardware counters unavailable (" << info.perfError << ")\n";
+        else
+        {
+            out << "\n";
+            info.fsm->reportPerfCounters(out);
+        }
+    }
+}
+
+void Pipeline::eliminateDeadCode()
+{
+    for (MachineInfo& info : machines) info.fsm->eliminateDeadCode();
+}
+
+void Pipeline::layOutStates()
+{
+    for (MachineInfo& info : machines) info.fsm->layOutStates();
+}
+
+void Pipeline::setIO(IOBackend& backend)
+{
+    for (MachineInfo& info : machines) info.fsm->setIO(backend.attach());
+}
+
+void Pipeline::seedRandom(uint64_t masterSeed)
+{
+    for (size_t i = 0; i < machines.size(); ++i) machines[i].fsm->seedRandom(masterSeed, i);
+}
+
+void Pipeline::fuzzInput()
+{
+    for (MachineInfo& info : machines) info.fsm->fuzzInput();
+}
+
+void Pipeline::enableReload(function<void(const string&, FSMError, const string&)> reported)
+{
+    for (MachineInfo& info : machines)
+    {
+        const string& name = info.name;
+        info.fsm->setReloadSource(info.fileName, [name, reported] (FSMError error, const string& report)
+        {
+            if (reported) reported(name, error, report);
+        });
+    }
+}
+
+void Pipeline::requestReload()
+{
+    for (MachineInfo& info : machines) info.fsm->requestReload();
+}
+
+void Pipeline::run()
+{
+    vector<exception_ptr> errors(machines.size());
+    vector<thread> threads;
+
+    for (unsigned int i = 0; i < machines.size(); ++i)
+    {
+        threads.emplace_back([this, i, &errors] ()
+        {
+            MachineInfo& info = machines[i];
+            try
+            {
+                if (perfInterval != 0) info.perfEnabled = info.fsm->enablePerfCounters(perfInterval, info.perfError);
+                info.fsm->run();
+            }
+            catch (...)
+            {
+                errors[i] = current_exception();
+                info.fsm->dumpTrace();
+            }
+            //let neighbours finish rather than spin forever
+            for (auto& p : info.bindings.sendsTo) p.second->producerFinished();
+            for (auto& p : info.bindings.receivesFrom) p.second->consumerFinished();
+        });
+    }
+
+    for (thread& t : threads) t.join();
+    for (exception_ptr& error : errors) if (error) rethrow_exception(error);
+}
@@ -0,0 +1,68 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <string>
+#include <ostream>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+
+#include "FSM.h"
+#include "Channel.h"
+#include "IOBackend.h"
+
+/*Several machines connected by channels, each running on its own thread. Described by a config file:
+    machine <name> <file>
+    channel <name> <producer>[,<producer>...] -> <consumer> [capacity]
+  Machine files are relative to the config file. Lines starting with # are ignored*/
+class Pipeline
+{
+public:
+    //lazy loads every machine lazily, see FSM's constructor
+    Pipeline(const std::string& configFile, bool lazy = false);
+    void run();
+    //each machine's trace is dumped to <prefix>.<machine name>
+    void enableTrace(unsigned int capacity, const std::string& prefix);
+    //applied to each machine separately - one going over its limits doesn't stop the others
+    void setLimits(const ExecutionLimits& limits);
+    void enableMetrics();
+    //see FSM::enableWatchdog - each machine is watched on its own, sending and receiving counting as I/O
+    void enableWatchdog(unsigned long checkInterval);
+    /*see FSM::enablePerfCounters - each machine's counters are opened on its thread when the pipeline runs, so they
+      count that machine. One the kernel won't give counters to runs without them, which its report says*/
+    void enablePerfCounters(unsigned int sampleInterval);
+    void reportPerfCounters(std::ostream& out) const;
+    //see FSM::eliminateDeadCode
+    void eliminateDeadCode();
+    //see FSM::layOutStates
+    void layOutStates();
+    //every machine prints and reads through its own port on backend, which must outlive the pipeline's run
+    void setIO(IOBackend& backend);
+    //the nth machine in the config file gets instance n of masterSeed, see FSM::seedRandom
+    void seedRandom(uint64_t masterSeed);
+    //see FSM::fuzzInput - after setIO, which would replace it
+    void fuzzInput();
+    //on requestReload (async-signal-safe) every machine reloads its file, see FSM::reload
+    void enableReload(std::function<void(const std::string& machine, FSMError, const std::string& report)> reported);
+    void requestReload();
+
+private:
+    struct MachineInfo
+    {
+        std::string name;
+        std::string fileName;
+        ChannelBindings bindings;
+        std::unique_ptr<FSM> fsm;
+        bool perfEnabled = false;
+        std::string perfError;
+    };
+
+    MachineInfo& getMachine(const std::string& name);
+
+    std::vector<MachineInfo> machines;
+    unsigned int perfInterval = 0;
+    std::unordered_map<std::string, std::unique_ptr<Channel>> channels;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include <cstring>
+#include <limits>
+
+#include "Random.h"
+
+using namespace std;
+
+namespace
+{
+    const double doubleEdges[] = {0.0, -0.0, 1.0, -1.0, 0.5, -0.5, numeric_limits<double>::epsilon(),
+                                  numeric_limits<double>::min(), -numeric_limits<double>::min(),
+                                  numeric_limits<double>::denorm_min(), numeric_limits<double>::max(),
+                                  -numeric_limits<double>::max(), 2147483647.0, -2147483648.0, 2147483648.0,
+                                  9007199254740992.0, -9007199254740992.0, 9223372036854775808.0,
+                                  -9223372036854775808.0, numeric_limits<double>::infinity(),
+                                  -numeric_limits<double>::infinity(), numeric_limits<double>::quiet_NaN()};
+    const long long integerEdges[] = {0, 1, -1, 2, 2147483647LL, -2147483648LL, 2147483648LL, 9007199254740992LL,
+                                      -9007199254740992LL, 9007199254740993LL, numeric_limits<long long>::max(),
+                                      numeric_limits<long long>::min(), numeric_limits<long long>::max() - 1,
+                                      numeric_limits<long long>::min() + 1};
+
+    uint64_t splitMix(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+}
+
+RandomStream::RandomStream(uint64_t masterSeed, uint64_t instance)
+{
+    reseed(masterSeed, instance);
+}
+
+void RandomStream::reseed(uint64_t masterSeed, uint64_t instance)
+{
+    uint64_t state = masterSeed;
+    for (uint64_t& word : s) word = splitMix(state);
+    for (uint64_t i = 0; i < instance; ++i) jump();
+}
+
+//equivalent to 2^128 calls to next
+void RandomStream::jump()
+{
+    static const uint64_t polynomial[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
+                                          0x39abdc4529b1661cULL};
+    uint64_t jumped[4] = {0, 0, 0, 0};
+    for (uint64_t word : polynomial)
+    {
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            if (word & (1ULL << bit)) for (int i = 0; i < 4; ++i) jumped[i] ^= s[i];
+            next();
+        }
+    }
+    for (int i = 0; i < 4; ++i) s[i] = jumped[i];
+}
+
+double RandomStream::nextDouble()
+{
+    switch (next() >> 62)
+    {
+        case 0:
+            return doubleEdges[below(sizeof(doubleEdges) / sizeof(doubleEdges[0]))];
+        case 1:
+            return (double) nextSmall();
+        default:
+        {
+            uint64_t bits = next();
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+    }
+}
+
+long long RandomStream::nextInteger()
+{
+    switch (next() >> 62)
+    {
+        case 0:
+            return integerEdges[below(sizeof(integerEdges) / sizeof(integerEdges[0]))];
+        case 1:
+            return nextSmall();
+        default:
+            return (long long) next();
+    }
+}
+
+void RandomStream::fill(long long* values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) values[i] = nextInteger();
+}
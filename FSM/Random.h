@@ -0,0 +1,52 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+
+/*xoshiro256** (Blackman and Vigna) - a machine's own random numbers, for nondet and fuzzed input. The master seed is
+  spread over the state with splitmix64 and the stream is then jumped 2^128 steps for each instance number, so every
+  machine in a process gets a stream that never overlaps another's and shares nothing with it. The same master seed
+  and instance always give the same numbers*/
+class RandomStream
+{
+public:
+    explicit RandomStream(uint64_t masterSeed = 0, uint64_t instance = 0);
+    void reseed(uint64_t masterSeed, uint64_t instance);
+
+    inline uint64_t next()
+    {
+        uint64_t result = rotate(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotate(s[3], 45);
+        return result;
+    }
+
+    /*Values for nondet and fuzzed input, over every value the type holds but weighted towards the ones that break
+      things: a quarter of the time an edge case (zeros, ones, the limits of 32 bit, 64 bit and exactly held
+      integers and, for doubles, the smallest, largest and non-finite ones), a quarter a small whole number from
+      -smallRange to smallRange, and otherwise 64 random bits - for a double, a random bit pattern, so every
+      exponent is as likely as any other*/
+    double nextDouble();
+    long long nextInteger();
+    //nextInteger for each
+    void fill(long long* values, size_t count);
+
+    static const long long smallRange = 1000;
+
+private:
+    static inline uint64_t rotate(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+    //below n
+    inline uint64_t below(uint64_t n) {return (uint64_t) (((unsigned __int128) next() * n) >> 64);}
+    inline long long nextSmall() {return (long long) below(2 * smallRange + 1) - smallRange;}
+    void jump();
+
+    uint64_t s[4];
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+//stand-in for a Prometheus scrape of FSM -metrics - prints the body of one GET
+int main(int argc, char** argv)
+{
+    if (argc != 2) throw runtime_error("Exactly one argument reqiured (metrics socket path)");
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (strlen(argv[1]) >= sizeof(address.sun_path)) throw runtime_error("Socket path too long");
+    strcpy(address.sun_path, argv[1]);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (sockaddr*) &address, sizeof(address)) != 0)
+    {
+        throw runtime_error("Could not connect to '" + string(argv[1]) + "': " + strerror(errno));
+    }
+
+    const string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    if (write(fd, request.data(), request.size()) != (ssize_t) request.size()) throw runtime_error("Request failed");
+
+    string response;
+    char buffer[4096];
+    ssize_t got;
+    while ((got = read(fd, buffer, sizeof(buffer))) > 0) response.append(buffer, got);
+    close(fd);
+
+    size_t bodyStart = response.find("\r\n\r\n");
+    if (response.compare(0, 12, "HTTP/1.0 200") != 0 || bodyStart == string::npos)
+    {
+        throw runtime_error("Unexpected response from metrics server");
+    }
+    cout << response.substr(bodyStart + 4);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#ifndef SHAREDSTACK_H
+#define SHAREDSTACK_H
+
+#include <deque>
+#include <vector>
+#include <cstddef>
+
+#include "Variable.h"
+
+/*the machine's stack - keeps count of the string bytes it holds so quotas can be checked without walking it, and
+  which values are return targets (pushed by "push state") so a reload can renumber them*/
+class SharedStack
+{
+public:
+    void push(const Variable::TaggedDataUnion& tdu)
+    {
+        contents.push_back(tdu);
+        returnTargets.push_back(false);
+        if (tdu.type == STRING) strings += tdu.contents.str->length();
+    }
+
+    void pushState(int state)
+    {
+        push(Variable::TaggedDataUnion((double) state));
+        returnTargets.back() = true;
+    }
+
+    void pop()
+    {
+        const Variable::TaggedDataUnion& back = contents.back();
+        if (back.type == STRING) strings -= back.contents.str->length();
+        contents.pop_back();
+        returnTargets.pop_back();
+    }
+
+    const Variable::TaggedDataUnion& top() const {return contents.back();}
+    bool empty() const {return contents.empty();}
+    size_t size() const {return contents.size();}
+    size_t stringBytes() const {return strings;}
+    //bottom first
+    const std::deque<Variable::TaggedDataUnion>& getContents() const {return contents;}
+    bool isReturnTarget(size_t i) const {return returnTargets[i];}
+    void setReturnTarget(size_t i, int state) {contents[i].contents.d = state;}
+
+private:
+    std::deque<Variable::TaggedDataUnion> contents;
+    std::vector<bool> returnTargets;
+    size_t strings = 0;
+};
+
+#endif
@@ -44,4 +44,27 @@ const vector<unique_ptr<AbstractCommand>>& State::getInstructions() const
 void State::setInstructions(vector<unique_ptr<AbstractCommand>> in)
 {
     instructions = move(in);
+    io = false;
+    for (unique_ptr<AbstractCommand>& command : instructions) io = io || command->performsIO();
+}
+
+void State::eraseInstructions(const vector<bool>& erased)
+{
+    vector<unique_ptr<AbstractCommand>> kept;
+    for (size_t i = 0; i < instructions.size(); ++i) if (!erased[i]) kept.push_back(move(instructions[i]));
+    setInstructions(move(kept));
+}
+
+void State::useIntegerVersions()
+{
+    for (unique_ptr<AbstractCommand>& command : instructions)
+    {
+        unique_ptr<AbstractCommand> intVersion = command->integerVersion();
+        if (intVersion != nullptr) command = move(intVersion);
+    }
+}
+
+bool State::performsIO() const
+{
+    return io;
 }
@@ -11,6 +11,7 @@ class State
 {
 private:
     int mnextState;
+    bool io = false;
     std::string name;
     std::vector<std::unique_ptr<AbstractCommand>> instructions;
     FSM& parent;
@@ -19,10 +20,15 @@ public:
     const std::vector<std::unique_ptr<AbstractCommand>>& getInstructions() const;
     const std::string& getName() const;
     void setInstructions(std::vector<std::unique_ptr<AbstractCommand>> instructions);
+    //removes the instructions marked in erased
+    void eraseInstructions(const std::vector<bool>& erased);
+    //swaps in AbstractCommand::integerVersion where there is one
+    void useIntegerVersions();
 
     State(std::string, FSM&);
     void run();
     int nextState() const;
+    bool performsIO() const;
 };
 
 
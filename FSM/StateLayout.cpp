@@ -0,0 +1,142 @@
+#include <algorithm>
+
+#include "StateLayout.h"
+
+using namespace std;
+
+namespace
+{
+    const unsigned int loopWeight = 16;
+
+    //Tarjan's algorithm without recursion, since generated machines can have very long chains of states
+    vector<int> findComponents(const vector<vector<LayoutEdge>>& successors)
+    {
+        int n = successors.size();
+        vector<int> component(n, -1), index(n, -1), low(n, 0);
+        vector<int> stack, path;
+        vector<size_t> nextEdge(n, 0);
+        int nextIndex = 0, components = 0;
+
+        for (int root = 0; root < n; ++root)
+        {
+            if (index[root] != -1) continue;
+            path.push_back(root);
+            while (!path.empty())
+            {
+                int v = path.back();
+                if (index[v] == -1)
+                {
+                    index[v] = low[v] = nextIndex++;
+                    stack.push_back(v);
+                }
+                if (nextEdge[v] < successors[v].size())
+                {
+                    int w = successors[v][nextEdge[v]++].to;
+                    if (index[w] == -1) path.push_back(w);
+                    else if (component[w] == -1) low[v] = min(low[v], index[w]);
+                    continue;
+                }
+
+                path.pop_back();
+                if (!path.empty()) low[path.back()] = min(low[path.back()], low[v]);
+                if (low[v] == index[v])
+                {
+                    int w;
+                    do
+                    {
+                        w = stack.back();
+                        stack.pop_back();
+                        component[w] = components;
+                    } while (w != v);
+                    components++;
+                }
+            }
+        }
+        return component;
+    }
+}
+
+vector<int> layoutStates(const vector<vector<LayoutEdge>>& successors, const vector<string>& names)
+{
+    int n = successors.size();
+    vector<int> component = findComponents(successors);
+    vector<int> byName(n);
+    for (int v = 0; v < n; ++v) byName[v] = v;
+    sort(byName.begin() + (n > 0 ? 1 : 0), byName.end(), [&] (int a, int b) {return names[a] < names[b];});
+
+    struct WeightedEdge
+    {
+        int from, to;
+        unsigned int weight;
+    };
+    vector<WeightedEdge> edges;
+    for (int v = 0; v < n; ++v)
+    {
+        for (const LayoutEdge& e : successors[v])
+        {
+            if (e.to == v) continue;
+            edges.push_back({v, e.to, component[v] == component[e.to] ? e.weight * loopWeight : e.weight});
+        }
+    }
+    stable_sort(edges.begin(), edges.end(), [&] (const WeightedEdge& a, const WeightedEdge& b)
+    {
+        if (a.weight != b.weight) return a.weight > b.weight;
+        if (a.from != b.from) return names[a.from] < names[b.from];
+        return names[a.to] < names[b.to];
+    });
+
+    //each state starts as a chain of its own - an edge joins two chains if it runs from the end of one to the start
+    //of another. Nothing is put in front of the start state
+    vector<vector<int>> chains(n);
+    vector<int> chainOf(n);
+    for (int v = 0; v < n; ++v)
+    {
+        chains[v].push_back(v);
+        chainOf[v] = v;
+    }
+    for (const WeightedEdge& e : edges)
+    {
+        int from = chainOf[e.from], to = chainOf[e.to];
+        if (from == to || e.to == 0 || chains[from].back() != e.from || chains[to].front() != e.to) continue;
+        for (int v : chains[to]) chainOf[v] = from;
+        chains[from].insert(chains[from].end(), chains[to].begin(), chains[to].end());
+        chains[to].clear();
+    }
+
+    //chains go in the order their first state is reached depth first from the start, heaviest edges first
+    vector<int> reached(n, n);
+    int order = 0;
+    vector<int> path;
+    for (int root : byName)
+    {
+        if (reached[root] != n) continue;
+        path.push_back(root);
+        while (!path.empty())
+        {
+            int v = path.back();
+            path.pop_back();
+            if (reached[v] != n) continue;
+            reached[v] = order++;
+            vector<LayoutEdge> next = successors[v];
+            stable_sort(next.begin(), next.end(), [] (const LayoutEdge& a, const LayoutEdge& b)
+            {
+                return a.weight < b.weight; //popped last to first
+            });
+            for (const LayoutEdge& e : next) if (reached[e.to] == n) path.push_back(e.to);
+        }
+    }
+
+    vector<int> chainIds;
+    vector<int> chainReached(n, n);
+    for (int v = 0; v < n; ++v)
+    {
+        chainReached[chainOf[v]] = min(chainReached[chainOf[v]], reached[v]);
+        if (chainOf[v] == v) chainIds.push_back(v);
+    }
+    stable_sort(chainIds.begin(), chainIds.end(), [&] (int a, int b) {return chainReached[a] < chainReached[b];});
+
+    vector<int> layout;
+    layout.reserve(n);
+    for (int id : chainIds) layout.insert(layout.end(), chains[id].begin(), chains[id].end());
+    return layout;
+}
@@ -0,0 +1,21 @@
+#ifndef STATELAYOUT_H
+#define STATELAYOUT_H
+
+#include <vector>
+#include <string>
+
+struct LayoutEdge
+{
+    int to;
+    unsigned int weight;
+};
+
+/*Orders states so ones that usually run one after another sit next to each other. Edges inside a loop (a strongly
+  connected set of states) are weighted up, then chains are built greedily from the heaviest edges (Pettis-Hansen) and
+  laid out in depth first order from the start state, which stays first. Ties go by state name rather than number, so
+  a machine that is already laid out (the compiler lays out its output the same way) comes back unchanged. Returns the
+  old number of each state in its new position*/
+std::vector<int> layoutStates(const std::vector<std::vector<LayoutEdge>>& successors,
+                              const std::vector<std::string>& names);
+
+#endif
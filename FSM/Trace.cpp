@@ -0,0 +1,124 @@
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Trace.h"
+
+using namespace std;
+
+namespace
+{
+    const int maxTraces = 64;
+    atomic<ExecutionTrace*> traces[maxTraces];
+
+    bool writeAll(int fd, const void* data, size_t length)
+    {
+        const char* bytes = (const char*) data;
+        while (length > 0)
+        {
+            ssize_t written = write(fd, bytes, length);
+            if (written <= 0) return false;
+            bytes += written;
+            length -= written;
+        }
+        return true;
+    }
+
+    void appendBytes(vector<char>& to, const void* data, size_t length)
+    {
+        const char* bytes = (const char*) data;
+        to.insert(to.end(), bytes, bytes + length);
+    }
+
+    void crashHandler(int sig)
+    {
+        for (atomic<ExecutionTrace*>& trace : traces)
+        {
+            ExecutionTrace* t = trace.load();
+            if (t != nullptr) t->dump();
+        }
+        signal(sig, SIG_DFL);
+        raise(sig);
+    }
+}
+
+const uint32_t ExecutionTrace::version;
+
+ExecutionTrace::~ExecutionTrace()
+{
+    for (atomic<ExecutionTrace*>& trace : traces)
+    {
+        ExecutionTrace* expected = this;
+        if (trace.compare_exchange_strong(expected, nullptr)) break;
+    }
+}
+
+void ExecutionTrace::writeHeader(const vector<string>& stateNames)
+{
+    header.clear();
+    appendBytes(header, "FSMTRACE", 8);
+    appendBytes(header, &version, sizeof(version));
+    uint32_t numStates = stateNames.size();
+    appendBytes(header, &numStates, sizeof(numStates));
+    for (const string& name : stateNames)
+    {
+        uint32_t length = name.length();
+        appendBytes(header, &length, sizeof(length));
+        appendBytes(header, name.data(), length);
+    }
+}
+
+void ExecutionTrace::renameStates(const vector<string>& stateNames)
+{
+    recorded.store(0, memory_order_relaxed);
+    writeHeader(stateNames);
+}
+
+void ExecutionTrace::enable(unsigned int capacity, string file, const vector<string>& stateNames)
+{
+    unsigned int size = 1;
+    while (size < capacity) size <<= 1;
+    records = make_unique<TraceRecord[]>(size);
+    mask = size - 1;
+    recorded.store(0);
+    dumpFile = move(file);
+    writeHeader(stateNames);
+
+    if (!enabled)
+    {
+        for (atomic<ExecutionTrace*>& trace : traces)
+        {
+            ExecutionTrace* expected = nullptr;
+            if (trace.compare_exchange_strong(expected, this)) break;
+        }
+    }
+    enabled = true;
+}
+
+bool ExecutionTrace::dump() const
+{
+    if (!enabled) return false;
+    int fd = open(dumpFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    uint64_t total = recorded.load(memory_order_relaxed);
+    uint64_t capacity = mask + 1;
+    uint32_t count = total < capacity ? total : capacity;
+    uint64_t oldest = total - count;
+    uint64_t start = oldest & mask;
+    uint64_t firstRun = capacity - start < count ? capacity - start : count;
+
+    bool ok = writeAll(fd, header.data(), header.size())
+              && writeAll(fd, &total, sizeof(total))
+              && writeAll(fd, &count, sizeof(count))
+              && writeAll(fd, &records[start], firstRun * sizeof(TraceRecord))
+              && writeAll(fd, &records[0], (count - firstRun) * sizeof(TraceRecord));
+    close(fd);
+    return ok;
+}
+
+void ExecutionTrace::installCrashHandlers()
+{
+    for (int sig : {SIGSEGV, SIGABRT, SIGFPE, SIGBUS, SIGILL}) signal(sig, crashHandler);
+}
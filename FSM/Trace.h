@@ -0,0 +1,63 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+enum TraceEvent: uint32_t {ENTER, PUSH, POP, RETURN};
+
+//8 bytes: the state executing and the stack depth after the event
+struct TraceRecord
+{
+    uint32_t state;
+    uint32_t eventAndDepth; //event in the top 4 bits, depth saturates at 2^28 - 1
+};
+
+/*Fixed size ring of the most recent transitions and stack operations of one machine. Only the machine's own thread
+  writes to it, so recording is a store and a relaxed increment. Dumps only use write(2) so they can be made from a
+  fatal signal handler. Dump layout (native endianness):
+    "FSMTRACE" | uint32 version | uint32 number of states | (uint32 length, name bytes) per state
+    | uint64 events recorded | uint32 records in dump | records, oldest first*/
+class ExecutionTrace
+{
+public:
+    static const uint32_t version = 1;
+
+    ~ExecutionTrace();
+
+    bool isEnabled() const {return enabled;}
+    void enable(unsigned int capacity, std::string dumpFile, const std::vector<std::string>& stateNames);
+    //after a reload - records so far are dropped, their state numbers belong to the old program
+    void renameStates(const std::vector<std::string>& stateNames);
+
+    void setState(uint32_t state) {currentState = state;}
+    inline void record(TraceEvent event, size_t depth)
+    {
+        uint64_t n = recorded.load(std::memory_order_relaxed);
+        uint32_t d = depth > 0x0FFFFFFF ? 0x0FFFFFFF : (uint32_t) depth;
+        records[n & mask] = {currentState, ((uint32_t) event << 28) | d};
+        recorded.store(n + 1, std::memory_order_relaxed);
+    }
+
+    //async-signal-safe; returns false if the file couldn't be written
+    bool dump() const;
+
+    //dumps every enabled trace, then re-raises with the default handler
+    static void installCrashHandlers();
+
+private:
+    void writeHeader(const std::vector<std::string>& stateNames);
+
+    bool enabled = false;
+    uint32_t currentState = 0;
+    std::unique_ptr<TraceRecord[]> records;
+    uint64_t mask = 0;
+    std::atomic<uint64_t> recorded{0};
+    std::vector<char> header; //serialised up to and including the state names
+    std::string dumpFile;
+};
+
+#endif
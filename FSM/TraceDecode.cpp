@@ -0,0 +1,59 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdexcept>
+
+#include "Trace.h"
+
+using namespace std;
+
+//offline decoder for dumps written by ExecutionTrace
+template <typename T>
+T readValue(ifstream& in)
+{
+    T value;
+    if (!in.read((char*) &value, sizeof(T))) throw runtime_error("Trace dump is truncated");
+    return value;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) throw runtime_error("Exactly one argument reqiured (trace dump filename)");
+
+    ifstream in(argv[1], ios::binary);
+    if (!in) throw runtime_error("Could not open file '" + string(argv[1]) + "'");
+
+    char magic[8];
+    if (!in.read(magic, 8) || memcmp(magic, "FSMTRACE", 8) != 0) throw runtime_error("Not a trace dump");
+    uint32_t version = readValue<uint32_t>(in);
+    if (version != ExecutionTrace::version) throw runtime_error("Unsupported trace version " + to_string(version));
+
+    uint32_t numStates = readValue<uint32_t>(in);
+    vector<string> stateNames;
+    for (uint32_t i = 0; i < numStates; ++i)
+    {
+        uint32_t length = readValue<uint32_t>(in);
+        string name(length, '\0');
+        if (!in.read(&name[0], length)) throw runtime_error("Trace dump is truncated");
+        stateNames.push_back(move(name));
+    }
+
+    uint64_t total = readValue<uint64_t>(in);
+    uint32_t count = readValue<uint32_t>(in);
+    cout << total << " events recorded, showing the last " << count << "\n";
+
+    const char* eventNames[] = {"enter", "push", "pop", "return"};
+    for (uint64_t i = total - count; i < total; ++i)
+    {
+        TraceRecord record = readValue<TraceRecord>(in);
+        uint32_t event = record.eventAndDepth >> 28;
+        uint32_t depth = record.eventAndDepth & 0x0FFFFFFF;
+        string state = record.state < stateNames.size() ? stateNames[record.state]
+                                                          : "<unknown state " + to_string(record.state) + ">";
+        cout << "#" << i << "\t" << (event < 4 ? eventNames[event] : "?") << "\t" << state << "\t(stack depth "
+             << depth << ")\n";
+    }
+    return 0;
+}
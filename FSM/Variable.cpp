@@ -1,20 +1,29 @@
+#include <cmath>
+
 #include "Variable.h"
+#include "Errors.h"
 
 using namespace std;
 
+namespace
+{
+    //the integers a double holds exactly
+    const double exactLimit = 9007199254740992.0; //2^53
+    const double int64Limit = 9223372036854775808.0; //2^63
+}
+
 Variable::Variable(string vname, double vd):
         name(move(vname)),
         data(vd) {}
 
+Variable::Variable(string vname, long long vi):
+        name(move(vname)),
+        data(vi) {}
+
 Variable::Variable(string vname, string str):
         name(move(vname)),
         data(move(str)) {}
 
-Variable::~Variable()
-{
-    if (data.type == STRING) delete data.contents.str;
-}
-
 const string &Variable::getName() const
 {
     return name;
@@ -37,15 +46,47 @@ const Variable::TaggedDataUnion &Variable::getTaggedDataUnion() const
 
 void Variable::setData(string str)
 {
-    if (data.type != STRING) throw runtime_error("Cannot assign STRING to type " + data.type);
-    delete getData();
-    data.contents = new string(str);
+    if (data.type != STRING)
+    {
+        throw FSMException(FSMError::TYPE_MISMATCH, string("Cannot assign string to ") + typeName(data.type));
+    }
+    *data.contents.str = move(str);
 }
 
 void Variable::setData(double d)
 {
-    if (data.type != DOUBLE) throw runtime_error("Cannot assign DOUBLE to type " + data.type);
-    data.contents = d;
+    if (data.type == INT)
+    {
+        if (inferred && (d != trunc(d) || fabs(d) > exactLimit))
+        {
+            data.type = DOUBLE;
+            data.contents = d;
+        }
+        else if (!inferred && !(trunc(d) >= -int64Limit && trunc(d) < int64Limit))
+        {
+            throw FSMException(FSMError::ARITHMETIC, "int '" + name + "' can't hold " + to_string(d));
+        }
+        else data.contents = (long long) d;
+    }
+    else if (data.type != DOUBLE)
+    {
+        throw FSMException(FSMError::TYPE_MISMATCH, string("Cannot assign double to ") + typeName(data.type));
+    }
+    else data.contents = d;
+}
+
+void Variable::setData(long long i)
+{
+    if (data.type == DOUBLE || (inferred && (i > (long long) exactLimit || i < -(long long) exactLimit)))
+    {
+        data.type = DOUBLE;
+        data.contents = (double) i;
+    }
+    else if (data.type != INT)
+    {
+        throw FSMException(FSMError::TYPE_MISMATCH, string("Cannot assign int to ") + typeName(data.type));
+    }
+    else data.contents = i;
 }
 
 void Variable::setData(Variable* var)
@@ -55,6 +96,23 @@ void Variable::setData(Variable* var)
 
 void Variable::setData(Variable::TaggedDataUnion tdu)
 {
-    if (data.type != tdu.type) throw runtime_error("Invalid assignment to type " + data.type);
-    data = tdu;
+    //numbers convert between DOUBLE and INT
+    if (data.type != STRING && tdu.type != STRING && data.type != tdu.type)
+    {
+        if (tdu.type == INT) setData(tdu.contents.i);
+        else setData(tdu.contents.d);
+        return;
+    }
+    if (data.type != tdu.type) throw FSMException(FSMError::TYPE_MISMATCH, string("Cannot assign ") + typeName(tdu.type)
+                                                                             + " to " + typeName(data.type));
+    data = move(tdu);
+}
+
+void Variable::makeInteger()
+{
+    if (data.type == INT) return;
+    if (data.type != DOUBLE) throw FSMException(FSMError::TYPE_MISMATCH, "Only doubles can become integers");
+    data.type = INT;
+    data.contents = (long long) data.contents.d;
+    inferred = true;
 }
\ No newline at end of file
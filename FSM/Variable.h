@@ -14,9 +14,11 @@ public:
     typedef union DU
     {
         double d;
+        long long i;
         std::string* str;
 
         DU(double doub): d(doub) {};
+        DU(long long in): i(in) {};
         DU(std::string* st): str(st) {};
 
         operator double() const {return d;}
@@ -24,47 +26,100 @@ public:
         operator std::string() const {return *str;}
     } DataUnion;
 
+    //owns its string - copies copy it, and a moved from value is left holding 0.0
     typedef struct TaggedDataUnion
     {
         DataUnion contents;
         Type type;
 
         TaggedDataUnion(double doub):
-                type(DOUBLE),
-                contents(doub) {}
+                contents(doub),
+                type(DOUBLE) {}
+
+        TaggedDataUnion(long long in):
+                contents(in),
+                type(INT) {}
 
         TaggedDataUnion(const std::string& st):
-                type(STRING),
-                contents(new std::string(st)) {}
+                contents(new std::string(st)),
+                type(STRING) {}
+
+        TaggedDataUnion(const TaggedDataUnion& o):
+                contents(o.type == STRING ? DataUnion(new std::string(*o.contents.str)) : o.contents),
+                type(o.type) {}
+
+        TaggedDataUnion(TaggedDataUnion&& o) noexcept:
+                contents(o.contents),
+                type(o.type)
+        {
+            o.type = DOUBLE;
+            o.contents.d = 0.0;
+        }
 
-        TaggedDataUnion(const TaggedDataUnion& o): contents(0.0)
+        TaggedDataUnion& operator=(const TaggedDataUnion& o)
         {
-            type = o.type;
-            if (type != STRING) contents = o.contents;
-            else
+            if (type == STRING && o.type == STRING) *contents.str = *o.contents.str; //reuses the buffer
+            else if (this != &o)
             {
-                std::string* ref = o.contents;
-                contents = new std::string(*ref);
+                DataUnion copied = o.type == STRING ? DataUnion(new std::string(*o.contents.str)) : o.contents;
+                release();
+                contents = copied;
+                type = o.type;
             }
+            return *this;
+        }
+
+        TaggedDataUnion& operator=(TaggedDataUnion&& o) noexcept
+        {
+            if (this != &o)
+            {
+                release();
+                contents = o.contents;
+                type = o.type;
+                o.type = DOUBLE;
+                o.contents.d = 0.0;
+            }
+            return *this;
+        }
+
+        ~TaggedDataUnion() {release();}
+
+        double asNumber() const {return type == INT ? (double) contents.i : contents.d;}
+
+    private:
+        void release()
+        {
+            if (type == STRING) delete contents.str;
         }
     } Data;
 
     Variable(std::string vname, double vd);
+    Variable(std::string vname, long long vi);
     Variable(std::string vname, std::string str);
-    ~Variable();
 
     const std::string &getName() const;
     Type getType() const;
     const DataUnion &getData() const;
     const TaggedDataUnion &getTaggedDataUnion() const;
+    //value of a DOUBLE or INT variable
+    double getNumber() const {return data.type == INT ? (double) data.contents.i : data.contents.d;}
     void setData(std::string str);
+    /*Assigning a double to a declared INT truncates it, and throws if the result is out of range. An inferred INT
+      only ever holds what the double it was would have, so it goes back to being a DOUBLE for a value that isn't
+      whole or is past 2^53*/
     void setData(double d);
+    void setData(long long i);
     void setData(Variable* var);
     void setData(Variable::TaggedDataUnion tdu);
+    //used once the variable is known to only ever hold integers
+    void makeInteger();
+    //made an INT by makeInteger rather than declared one
+    bool isInferred() const {return inferred;}
 
 protected:
     std::string name;
     Data data;
+    bool inferred = false;
 };
 
 #endif
@@ -0,0 +1,117 @@
+#include <cstring>
+#include <functional>
+
+#include "Watchdog.h"
+
+using namespace std;
+
+namespace
+{
+    inline uint64_t mix(uint64_t hash, uint64_t value)
+    {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    uint64_t hashValue(const Variable::TaggedDataUnion& tdu)
+    {
+        if (tdu.type == STRING) return hash<string>()(*tdu.contents.str);
+        uint64_t bits;
+        memcpy(&bits, &tdu.contents.d, sizeof(bits));
+        return bits;
+    }
+}
+
+void Watchdog::Snapshot::clear()
+{
+    values.clear();
+}
+
+void Watchdog::enable(unsigned long checkInterval, vector<Variable*> watchedVars)
+{
+    interval = checkInterval == 0 ? 1 : checkInterval;
+    untilCheck = interval;
+    vars = move(watchedVars);
+    haveSaved = false;
+    checks = 0;
+    enabled = true;
+}
+
+void Watchdog::rewatch(vector<Variable*> watchedVars)
+{
+    vars = move(watchedVars);
+    haveSaved = false;
+}
+
+void Watchdog::take(int state, const SharedStack& stack, Snapshot& into) const
+{
+    into.clear();
+    into.values.reserve(vars.size() + stack.size());
+    into.state = state;
+    uint64_t hash = state;
+    for (Variable* var : vars)
+    {
+        into.values.push_back(var->getTaggedDataUnion());
+        hash = mix(hash, hashValue(into.values.back()));
+    }
+    for (const Variable::TaggedDataUnion& tdu : stack.getContents())
+    {
+        into.values.push_back(tdu);
+        hash = mix(hash, hashValue(tdu));
+    }
+    into.hash = hash;
+}
+
+bool Watchdog::same(const Snapshot& a, const Snapshot& b)
+{
+    if (a.hash != b.hash || a.state != b.state || a.values.size() != b.values.size()) return false;
+    for (unsigned int i = 0; i < a.values.size(); ++i)
+    {
+        const Variable::TaggedDataUnion& x = a.values[i];
+        const Variable::TaggedDataUnion& y = b.values[i];
+        if (x.type != y.type) return false;
+        if (x.type == STRING)
+        {
+            if (*x.contents.str != *y.contents.str) return false;
+        }
+        else if (memcmp(&x.contents.d, &y.contents.d, sizeof(double)) != 0) return false;
+    }
+    return true;
+}
+
+bool Watchdog::backAtDetection(int state, const SharedStack& stack) const
+{
+    if (state != current.state) return false;
+    Snapshot now;
+    take(state, stack, now);
+    return same(now, current);
+}
+
+bool Watchdog::check(int state, const SharedStack& stack)
+{
+    ++checks;
+    if (!haveSaved)
+    {
+        take(state, stack, saved);
+        savedAt = checks;
+        haveSaved = true;
+        power = 1;
+        lambda = 0;
+        return false;
+    }
+
+    take(state, stack, current);
+    ++lambda;
+    if (same(saved, current)) return true;
+
+    if (lambda == power)
+    {
+        swap(saved.values, current.values);
+        saved.hash = current.hash;
+        saved.state = current.state;
+        savedAt = checks;
+        power *= 2;
+        lambda = 0;
+    }
+    return false;
+}
@@ -0,0 +1,66 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Variable.h"
+#include "SharedStack.h"
+
+/*Detects machines stuck in a pure loop - one that does no input or output and keeps revisiting the exact same
+  (state, variables, stack). Every (interval) transitions the machine is snapshotted and Brent's algorithm compares it
+  against a saved snapshot, moving the saved one forward at powers of two. Hashes are compared first, then the full
+  snapshots, so a reported cycle is proven rather than likely*/
+class Watchdog
+{
+public:
+    void enable(unsigned long checkInterval, std::vector<Variable*> watchedVars);
+    bool isEnabled() const {return enabled;}
+    //after a reload - the old variables are gone, and snapshots of them can't match anything new
+    void rewatch(std::vector<Variable*> watchedVars);
+
+    inline bool tick()
+    {
+        if (--untilCheck != 0) return false;
+        untilCheck = interval;
+        return true;
+    }
+    //input or output happened, so anything seen so far isn't a pure loop
+    void progress() {haveSaved = false;}
+    //true if the machine is now provably looping
+    bool check(int state, const SharedStack& stack);
+    /*Once check returns true - the two matching snapshots were this many transitions apart, which is a whole number
+      of trips round the loop (lambda, in checks, times the interval between them)*/
+    unsigned long sampledCycle() const {return lambda * interval;}
+    //and the earlier one was taken this many transitions after enabling, so the loop had been entered by then
+    unsigned long long enteredBy() const {return savedAt * interval;}
+    //whether the machine is back where it was when check returned true - for finding the loop's exact length
+    bool backAtDetection(int state, const SharedStack& stack) const;
+
+private:
+    struct Snapshot
+    {
+        uint64_t hash = 0;
+        int state = -1;
+        std::vector<Variable::TaggedDataUnion> values;
+        void clear();
+    };
+
+    void take(int state, const SharedStack& stack, Snapshot& into) const;
+    static bool same(const Snapshot& a, const Snapshot& b);
+
+    bool enabled = false;
+    unsigned long interval = 1;
+    unsigned long untilCheck = 1;
+    std::vector<Variable*> vars;
+
+    bool haveSaved = false;
+    unsigned long long checks = 0;
+    unsigned long long savedAt = 0; //the check saved was taken at
+    unsigned long power = 1;
+    unsigned long lambda = 0;
+    Snapshot saved;
+    Snapshot current;
+};
+
+#endif
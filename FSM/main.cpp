@@ -1,14 +1,247 @@
 #include <iostream>
+#include <cstring>
+#include <cctype>
+#include <csignal>
 
 #include "FSM.h"
+#include "Pipeline.h"
 
 using namespace std;
 
-int main(int argc, char** argv)
+namespace
 {
-    if (argc != 2) throw runtime_error("Exactly one argument reqiured (filename)");
-    string filename = argv[1];
-    FSM test(filename);
-    test.run();
+    //exit status for errors that aren't FSMExceptions - those exit with their FSMError
+    const int otherError = (int) FSMError::INTERNAL + 1;
+
+    FSM* reloadingMachine = nullptr;
+    Pipeline* reloadingPipeline = nullptr;
+
+    void reloadOnHangup(int)
+    {
+        if (reloadingMachine != nullptr) reloadingMachine->requestReload();
+        if (reloadingPipeline != nullptr) reloadingPipeline->requestReload();
+    }
+
+    void reportReload(const string& machine, FSMError error, const string& report)
+    {
+        string name = machine.empty() ? "machine" : "'" + machine + "'";
+        if (error != FSMError::NONE) cerr << "Reload of " << name << " failed (" << errorName(error) << "): " << report << "\n";
+        else cerr << "Reloaded " << name << (report.empty() ? "" : ":\n" + report) << "\n";
+    }
+}
+
+void doHelp()
+{
+    cout << "Usage: FSM [options] <file> | FSM [options] -p <pipeline config>\n";
+    cout << "Optional parameters:\n";
+    cout << "-trace <file> : keep a trace of recent transitions, dumped to <file> on an error or crash\n";
+    cout << "-tracesize <n> : number of trace records kept (default 4096)\n";
+    cout << "-lazy : parse each state the first time it is entered\n";
+    cout << "-watchdog <n> : every n transitions, check whether the machine is stuck in an infinite loop\n";
+    cout << "-maxstack <n> : stop the machine if its stack grows past n values\n";
+    cout << "-maxstrings <n> : stop the machine if it holds more than n bytes of strings\n"
+         << "                  (checked every 1024 transitions)\n";
+    cout << "-maxsteps <n> : stop the machine after n transitions\n";
+    cout << "-maxtime <ms> : stop the machine after ms milliseconds (checked every 1024 transitions)\n";
+    cout << "-perf <n> : report hardware counters per state, measuring every nth state execution\n";
+    cout << "-metrics <socket> : serve live metrics (Prometheus text format) on a Unix socket\n";
+    cout << "-layout : reorder states so ones that run one after another are adjacent (not with -lazy)\n";
+    cout << "-dce : remove assignments and stack pushes whose values are never used (not with -lazy)\n";
+    cout << "-aio : batch output and input through one I/O thread (io_uring, or epoll where unavailable)\n";
+    cout << "-seed <n> : master seed for nondet (default 0) - each pipeline machine gets its own stream of it\n";
+    cout << "-fuzz : input comes from the random stream instead of stdin (bound the run with -maxsteps)\n";
+    cout << "-reload : on SIGHUP, load the machine file(s) again, carrying over variables, state and stack\n";
+    cout << "Exit status: 0 once the machine(s) finish, otherwise the error stopped with -";
+    for (int e = (int) FSMError::IO; e <= (int) FSMError::INTERNAL; ++e) cout << " " << e << " " << errorName((FSMError) e);
+    cout << ", " << otherError << " for bad options or pipeline configs\n";
+}
+
+int runMachines(int argc, char** argv)
+{
+    int counter = 1;
+    string filename;
+    string pipelineConfig;
+    string traceFile;
+    string metricsSocket;
+    unsigned int traceSize = 4096;
+    unsigned int perfInterval = 0;
+    bool lazy = false;
+    bool reload = false;
+    bool asyncIO = false;
+    bool layout = false;
+    bool deadCode = false;
+    bool fuzz = false;
+    uint64_t seed = 0;
+    unsigned long watchdogInterval = 0;
+    ExecutionLimits limits;
+
+    auto readLimit = [&] () -> unsigned long long
+    {
+        ++counter;
+        size_t parsed = 0;
+        unsigned long long limit = 0;
+        try
+        {
+            if (counter < argc && isdigit((unsigned char) argv[counter][0])) limit = stoull(argv[counter], &parsed);
+        }
+        catch (out_of_range&) {}
+        if (counter == argc || parsed == 0 || argv[counter][parsed] != '\0')
+        {
+            throw runtime_error("Expected number after " + string(argv[counter - 1]) + " (-h for help)");
+        }
+        return limit;
+    };
+
+    while (counter < argc)
+    {
+        if (strcmp(argv[counter], "-h") == 0)
+        {
+            doHelp();
+            return 0;
+        }
+        else if (strcmp(argv[counter], "-p") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected config filename after -p (-h for help)");
+            pipelineConfig = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-trace") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected filename after -trace (-h for help)");
+            traceFile = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-tracesize") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected number after -tracesize (-h for help)");
+            traceSize = stoul(argv[counter]);
+        }
+        else if (strcmp(argv[counter], "-lazy") == 0) lazy = true;
+        else if (strcmp(argv[counter], "-reload") == 0) reload = true;
+        else if (strcmp(argv[counter], "-aio") == 0) asyncIO = true;
+        else if (strcmp(argv[counter], "-layout") == 0) layout = true;
+        else if (strcmp(argv[counter], "-dce") == 0) deadCode = true;
+        else if (strcmp(argv[counter], "-fuzz") == 0) fuzz = true;
+        else if (strcmp(argv[counter], "-seed") == 0) seed = readLimit();
+        else if (strcmp(argv[counter], "-metrics") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected socket path after -metrics (-h for help)");
+            metricsSocket = argv[counter];
+        }
+        else if (strcmp(argv[counter], "-watchdog") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected check interval after -watchdog (-h for help)");
+            watchdogInterval = stoul(argv[counter]);
+            if (watchdogInterval == 0) throw runtime_error("-watchdog interval must be at least 1");
+        }
+        else if (strcmp(argv[counter], "-maxstack") == 0) limits.maxStackDepth = readLimit();
+        else if (strcmp(argv[counter], "-maxstrings") == 0) limits.maxStringBytes = readLimit();
+        else if (strcmp(argv[counter], "-maxsteps") == 0) limits.maxSteps = readLimit();
+        else if (strcmp(argv[counter], "-maxtime") == 0) limits.maxWallTime = chrono::milliseconds(readLimit());
+        else if (strcmp(argv[counter], "-perf") == 0)
+        {
+            ++counter;
+            if (counter == argc) throw runtime_error("Expected sample interval after -perf (-h for help)");
+            perfInterval = stoul(argv[counter]);
+            if (perfInterval == 0) throw runtime_error("-perf interval must be at least 1");
+        }
+        else if (!filename.empty()) throw runtime_error("Exactly one machine file expected (-h for help)");
+        else filename = argv[counter];
+        ++counter;
+    }
+
+    if (!traceFile.empty()) ExecutionTrace::installCrashHandlers();
+    unique_ptr<MetricsServer> metricsServer;
+    if (!metricsSocket.empty()) metricsServer = make_unique<MetricsServer>(metricsSocket);
+    //declared before the machines so it outlives them and flushes after they finish
+    unique_ptr<IOBackend> ioBackend;
+    if (asyncIO) ioBackend = make_unique<IOBackend>();
+
+    if (!pipelineConfig.empty())
+    {
+        if (!filename.empty()) throw runtime_error("Give either a machine file or -p, not both (-h for help)");
+        Pipeline pipeline(pipelineConfig, lazy);
+        if (layout) pipeline.layOutStates();
+        if (deadCode) pipeline.eliminateDeadCode();
+        if (perfInterval != 0) pipeline.enablePerfCounters(perfInterval);
+        if (!traceFile.empty()) pipeline.enableTrace(traceSize, traceFile);
+        if (watchdogInterval != 0) pipeline.enableWatchdog(watchdogInterval);
+        pipeline.setLimits(limits);
+        if (metricsServer) pipeline.enableMetrics();
+        if (ioBackend) pipeline.setIO(*ioBackend);
+        pipeline.seedRandom(seed);
+        if (fuzz) pipeline.fuzzInput();
+        if (reload)
+        {
+            pipeline.enableReload(reportReload);
+            reloadingPipeline = &pipeline;
+            signal(SIGHUP, reloadOnHangup);
+        }
+        pipeline.run();
+        if (ioBackend) ioBackend->stop();
+        pipeline.reportPerfCounters(cerr);
+        return 0;
+    }
+
+    if (filename.empty()) throw runtime_error("Exactly one argument reqiured (filename, -h for help)");
+    FSM test(filename, ChannelBindings(), lazy);
+    if (layout) test.layOutStates();
+    if (deadCode) test.eliminateDeadCode();
+    if (perfInterval != 0)
+    {
+        string error;
+        if (!test.enablePerfCounters(perfInterval, error))
+        {
+            cerr << "Hardware counters unavailable (" << error << "), running without them\n";
+            perfInterval = 0;
+        }
+    }
+    if (!traceFile.empty()) test.enableTrace(traceSize, traceFile);
+    if (watchdogInterval != 0) test.enableWatchdog(watchdogInterval);
+    test.setLimits(limits);
+    if (metricsServer) test.enableMetrics();
+    if (ioBackend) test.setIO(ioBackend->attach());
+    test.seedRandom(seed);
+    if (fuzz) test.fuzzInput();
+    if (reload)
+    {
+        test.setReloadSource(filename, [] (FSMError error, const string& report) {reportReload("", error, report);});
+        reloadingMachine = &test;
+        signal(SIGHUP, reloadOnHangup);
+    }
+
+    try
+    {
+        test.run();
+    }
+    catch (...)
+    {
+        if (!traceFile.empty() && test.dumpTrace()) cerr << "Trace written to '" << traceFile << "'\n";
+        throw;
+    }
+
+    if (ioBackend) ioBackend->stop();
+    if (perfInterval != 0) test.reportPerfCounters(cerr);
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        return runMachines(argc, argv);
+    }
+    catch (FSMException& e)
+    {
+        cerr << "Error (" << errorName(e.getCode()) << "): " << e.what() << "\n";
+        return (int) e.getCode();
+    }
+    catch (exception& e)
+    {
+        cerr << "Error: " << e.what() << "\n";
+        return otherError;
+    }
+}
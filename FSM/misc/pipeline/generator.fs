@@ -0,0 +1,6 @@
+start
+double i;
+i = i + 1;
+send numbers i;
+jumpif i < 10 start;
+end
@@ -0,0 +1,7 @@
+start
+double sq;
+recv squares sq;
+print sq;
+print "\n";
+jump start;
+end
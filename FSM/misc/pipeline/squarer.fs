@@ -0,0 +1,8 @@
+start
+double n;
+double sq;
+recv numbers n;
+sq = n * n;
+send squares sq;
+jump start;
+end
@@ -0,0 +1,180 @@
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <ctime>
+#include <unistd.h>
+
+#include "Testing.h"
+#include "Channel.h"
+#include "Pipeline.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    typedef Variable::TaggedDataUnion Value;
+
+    void values()
+    {
+        Value a(string("first"));
+        Value b(a);
+        check(*b.contents.str == "first" && b.contents.str != a.contents.str, "a copy has a string of its own");
+
+        Value c(2.0);
+        c = a;
+        *a.contents.str = "changed";
+        check(c.type == STRING && *c.contents.str == "first", "assigning copies the string");
+
+        c = c;
+        check(*c.contents.str == "first", "assigning a value to itself keeps it");
+
+        Value d(move(c));
+        check(d.type == STRING && *d.contents.str == "first", "moving hands the string over");
+        check(c.type == DOUBLE, "a moved from value holds a number");
+
+        d = Value(3LL);
+        check(d.type == INT && d.contents.i == 3, "assigning a number over a string frees it");
+    }
+
+    void strings()
+    {
+        Channel channel("c", 4, 1);
+        Value sent(string("hello"));
+        check(channel.send(sent), "sending");
+        check(sent.type == STRING && *sent.contents.str == "hello", "the sender keeps its value");
+
+        Value received(0.0);
+        check(channel.receive(received), "receiving");
+        check(received.type == STRING && *received.contents.str == "hello", "the string arrives");
+        check(received.contents.str != sent.contents.str, "the receiver has a string of its own");
+
+        //left in the buffer, freed with the channel
+        for (int i = 0; i < 3; ++i) channel.send(Value(string(100, 'x')));
+        channel.consumerFinished();
+        Value overflow(string("nobody reads this"));
+        check(channel.send(overflow) && !channel.send(overflow), "a full channel with no consumer refuses sends");
+    }
+
+    void producers()
+    {
+        const int perProducer = 2000;
+        Channel channel("c", 16, 3);
+        vector<thread> threads;
+        for (int p = 0; p < 3; ++p)
+        {
+            threads.emplace_back([&channel, p] ()
+            {
+                for (int i = 0; i < perProducer; ++i) channel.send(Value(to_string(p) + ":" + to_string(i)));
+                channel.producerFinished();
+            });
+        }
+
+        vector<int> next(3, 0);
+        bool ordered = true;
+        Value received(0.0);
+        while (channel.receive(received))
+        {
+            const string& s = *received.contents.str;
+            int p = s[0] - '0';
+            ordered = ordered && s == to_string(p) + ":" + to_string(next[p]);
+            ++next[p];
+        }
+        for (thread& t : threads) t.join();
+        check(ordered, "each producer's strings arrive intact and in order");
+        check(next == vector<int>(3, perProducer), "every string arrives");
+    }
+
+    double threadCpuSeconds()
+    {
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return now.tv_sec + now.tv_nsec / 1e9;
+    }
+
+    //an end blocked for a while - on an empty channel, then a full one - sleeps rather than spinning
+    void blocking()
+    {
+        const auto wait = chrono::milliseconds(300);
+        Channel channel("c", 1, 1);
+        double receiverCpu = 0;
+        Value received(0.0);
+        thread receiver([&] ()
+        {
+            double start = threadCpuSeconds();
+            channel.receive(received);
+            receiverCpu = threadCpuSeconds() - start;
+        });
+        this_thread::sleep_for(wait);
+        channel.send(Value(1.0));
+        receiver.join();
+        check(received.type == DOUBLE && received.contents.d == 1.0, "a receiver that waited gets the value");
+        check(receiverCpu < 0.1, "a receiver waiting on an empty channel sleeps (" + to_string(receiverCpu) + "s)");
+
+        channel.send(Value(2.0));
+        channel.send(Value(3.0)); //a channel of 1 rounds up to 2
+        double senderCpu = 0;
+        thread sender([&] ()
+        {
+            double start = threadCpuSeconds();
+            channel.send(Value(4.0));
+            senderCpu = threadCpuSeconds() - start;
+            channel.producerFinished();
+        });
+        this_thread::sleep_for(wait);
+        vector<double> got;
+        while (channel.receive(received)) got.push_back(received.contents.d);
+        sender.join();
+        check(got == vector<double>({2.0, 3.0, 4.0}), "a sender that waited for room sends");
+        check(senderCpu < 0.1, "a sender waiting on a full channel sleeps (" + to_string(senderCpu) + "s)");
+    }
+
+    void capacities()
+    {
+        const string config = "/tmp/channeltest" + to_string(getpid()) + ".pipeline";
+        const string machine = "/tmp/channeltest" + to_string(getpid()) + ".fs";
+        ofstream(machine) << "S_0\nend\n";
+        for (const string& capacity : {"lots", "12x", "-4", "0", "99999999999", "99999999999999999999999", "8 9"})
+        {
+            ofstream(config) << "machine a " << machine << "\nmachine b " << machine << "\nchannel c a -> b "
+                             << capacity << "\n";
+            //a bad config like any other, not an error in a machine
+            bool badConfig = false;
+            try
+            {
+                Pipeline pipeline(config);
+            }
+            catch (FSMException&) {}
+            catch (runtime_error&)
+            {
+                badConfig = true;
+            }
+            check(badConfig, "channel capacity '" + capacity + "' is a bad config");
+        }
+
+        ofstream(config) << "machine a " << machine << "\nmachine b " << machine << "\nchannel c a -> b 8\n";
+        bool loaded = true;
+        try
+        {
+            Pipeline pipeline(config);
+        }
+        catch (exception&)
+        {
+            loaded = false;
+        }
+        check(loaded, "a channel capacity of 8 is fine");
+        unlink(config.c_str());
+        unlink(machine.c_str());
+    }
+}
+
+int main()
+{
+    values();
+    strings();
+    producers();
+    blocking();
+    capacities();
+    return finish();
+}
@@ -0,0 +1,151 @@
+#include <fstream>
+#include <sstream>
+#include <deque>
+#include <unistd.h>
+
+#include "Testing.h"
+#include "Pipeline.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    //runs source with and without dead code removed, checking the output's the same - how many commands went
+    unsigned int removedFrom(const string& source, const string& expected, const string& what)
+    {
+        unsigned int removed = 0;
+        Run plain = run(source);
+        Run eliminated = run(source, 100000, [&removed] (FSM& machine) {removed = machine.eliminateDeadCode();});
+        check(plain.error == FSMError::NONE && plain.output == expected, what + " runs: " + plain.output
+                                                                         + plain.message);
+        check(eliminated.error == FSMError::NONE && eliminated.output == expected,
+              what + " runs the same with dead code removed: " + eliminated.output + eliminated.message);
+        return removed;
+    }
+
+    void assignments()
+    {
+        unsigned int removed = removedFrom("S_0\n"
+                                           "double x;\n"
+                                           "double y;\n"
+                                           "x = 1;\n"
+                                           "x = 5;\n"
+                                           "y = 7;\n"
+                                           "print x;\n"
+                                           "end\n", "5", "overwritten and unread assignments");
+        check(removed == 2, "an assignment overwritten before it's read, and one never read, go ("
+                            + to_string(removed) + ")");
+    }
+
+    void stack()
+    {
+        unsigned int removed = removedFrom("S_0\n"
+                                           "double x;\n"
+                                           "double y;\n"
+                                           "x = 5;\n"
+                                           "push x;\n"
+                                           "pop y;\n"
+                                           "print x;\n"
+                                           "end\n", "5", "a push and pop of an unread value");
+        check(removed == 2, "a push and pop of a value that's never read go (" + to_string(removed) + ")");
+
+        removed = removedFrom("S_0\n"
+                              "double x;\n"
+                              "double y;\n"
+                              "x = 5;\n"
+                              "push x;\n"
+                              "pop y;\n"
+                              "print y;\n"
+                              "end\n", "5", "a push and pop of a read value");
+        check(removed == 0, "a pop whose value is read stays, with its push (" + to_string(removed) + ")");
+    }
+
+    //x is read after a return to a pushed state, so its assignments before the call and in the callee are live
+    void returns()
+    {
+        unsigned int removed = removedFrom("S_0\n"
+                                           "double x;\n"
+                                           "double y;\n"
+                                           "x = 3;\n"
+                                           "y = x;\n"
+                                           "push state S_back;\n"
+                                           "jump S_call;\n"
+                                           "end\n\n"
+                                           "S_call\n"
+                                           "x = x + y;\n"
+                                           "return;\n"
+                                           "end\n\n"
+                                           "S_back\n"
+                                           "print x;\n"
+                                           "end\n", "6", "values live across a return");
+        check(removed == 0, "values read after a return stay (" + to_string(removed) + ")");
+    }
+
+    //writing nondet, input or recv into a variable that's never read still draws from the stream, input or channel
+    void sideEffects()
+    {
+        const string nondet = "S_0\n"
+                              "int d;\n"
+                              "int x;\n"
+                              "nondet d;\n"
+                              "nondet x;\n"
+                              "print x;\n"
+                              "end\n";
+        unsigned int removed = 1;
+        Run plain = run(nondet, 100000, [] (FSM& machine) {machine.seedRandom(7, 0);});
+        Run eliminated = run(nondet, 100000, [&removed] (FSM& machine)
+        {
+            machine.seedRandom(7, 0);
+            removed = machine.eliminateDeadCode();
+        });
+        check(removed == 0 && eliminated.output == plain.output, "a nondet into an unread variable stays ("
+                                                                 + to_string(removed) + ")");
+
+        unique_ptr<FSM> machine;
+        string message;
+        FSM::load("S_0\n"
+                  "double d;\n"
+                  "double x;\n"
+                  "input d;\n"
+                  "input x;\n"
+                  "print x;\n"
+                  "end\n", machine, &message);
+        removed = machine->eliminateDeadCode();
+        string output;
+        deque<string> words = {"1", "2"};
+        machine->setIO({[&output] (const string& text) {output += text;}, [&words] (string& word)
+        {
+            if (words.empty()) return false;
+            word = words.front();
+            words.pop_front();
+            return true;
+        }});
+        FSMError error = machine->tryRun(&message);
+        check(removed == 0 && error == FSMError::NONE && output == "2", "an input into an unread variable stays ("
+                                                                        + to_string(removed) + "): " + output + message);
+
+        const string base = "/tmp/deadcodetest" + to_string(getpid());
+        ofstream(base + ".producer.fs") << "S_0\nsend c 1;\nsend c 2;\nend\n";
+        ofstream(base + ".consumer.fs") << "S_0\ndouble d;\ndouble x;\nrecv c d;\nrecv c x;\nprint x;\nend\n";
+        ofstream(base + ".pipeline") << "machine p " << base << ".producer.fs\nmachine q " << base << ".consumer.fs\n"
+                                     << "channel c p -> q\n";
+        Pipeline pipeline(base + ".pipeline");
+        pipeline.eliminateDeadCode();
+        ostringstream captured;
+        streambuf* old = cout.rdbuf(captured.rdbuf());
+        pipeline.run();
+        cout.rdbuf(old);
+        check(captured.str() == "2", "a recv into an unread variable stays: " + captured.str());
+        for (const string& suffix : {".producer.fs", ".consumer.fs", ".pipeline"}) unlink((base + suffix).c_str());
+    }
+}
+
+int main()
+{
+    assignments();
+    stack();
+    returns();
+    sideEffects();
+    return finish();
+}
@@ -0,0 +1,78 @@
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "Testing.h"
+#include "IOBackend.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    //an I/O thread that can't start up hands its error to the machines instead of ending the process
+    void failedThread()
+    {
+        //leaves one descriptor free - the backend's eventfd gets it, so the I/O thread's epoll can't be made
+        rlimit original;
+        getrlimit(RLIMIT_NOFILE, &original);
+        rlimit lowered = original;
+        lowered.rlim_cur = 64;
+        setrlimit(RLIMIT_NOFILE, &lowered);
+        vector<int> filler;
+        int fd;
+        while ((fd = open("/dev/null", O_RDONLY | O_CLOEXEC)) >= 0) filler.push_back(fd);
+        close(filler.back());
+        filler.pop_back();
+
+        unique_ptr<IOBackend> backend = make_unique<IOBackend>(false);
+        FSMError stopped = FSMError::NONE;
+        try
+        {
+            backend->stop();
+        }
+        catch (FSMException& e)
+        {
+            stopped = e.getCode();
+        }
+        for (int f : filler) close(f);
+        setrlimit(RLIMIT_NOFILE, &original);
+        check(stopped == FSMError::IO, "stop throws what the I/O thread did");
+
+        unique_ptr<FSM> machine;
+        string message;
+        FSM::load("S_0\nprint \"hello\";\nend\n", machine, &message);
+        machine->setIO(backend->attach());
+        FSMError error = machine->tryRun(&message);
+        check(error == FSMError::IO, "a machine printing through the failed thread gets its error: " + message);
+
+        FSM::load("S_0\ndouble x;\ninput x;\nend\n", machine, &message);
+        machine->setIO(backend->attach());
+        error = machine->tryRun(&message);
+        check(error == FSMError::IO, "a machine reading through the failed thread gets its error: " + message);
+    }
+
+    void working()
+    {
+        int out[2];
+        check(pipe(out) == 0, "making a pipe");
+        IOBackend backend(false, out[1]);
+        unique_ptr<FSM> machine;
+        FSM::load("S_0\nprint \"hello\";\nend\n", machine);
+        machine->setIO(backend.attach());
+        check(machine->tryRun() == FSMError::NONE, "a machine prints through the I/O thread");
+        backend.stop();
+        char got[16] = {};
+        check(read(out[0], got, sizeof(got)) == 5 && string(got) == "hello", "what it printed is written");
+        close(out[0]);
+        close(out[1]);
+    }
+}
+
+int main()
+{
+    working();
+    failedThread();
+    return finish();
+}
@@ -0,0 +1,162 @@
+#include <sstream>
+#include <vector>
+#include <functional>
+
+#include "Testing.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    string printed(double d)
+    {
+        ostringstream out;
+        out << d;
+        return out.str();
+    }
+
+    //doubles inferred to be integral print what they would have as doubles, past 2^63 too
+    void overflow()
+    {
+        Run r = run("S_0\n"
+                    "double x;\n"
+                    "double y;\n"
+                    "x = 3;\n"
+                    "jump S_1;\n"
+                    "end\n\n"
+                    "S_1\n"
+                    "x = x * x;\n"
+                    "y = x + x;\n"
+                    "print y;\n"
+                    "print \"\\n\";\n"
+                    "jumpif x < 1e40 S_1;\n"
+                    "end\n");
+        string expected;
+        for (double x = 3; x < 1e40; ) expected += printed((x *= x) + x) + "\n";
+        check(r.error == FSMError::NONE, "squaring past 2^63 runs: " + r.message);
+        check(r.output == expected, "squaring past 2^63 prints the doubles:\n" + r.output.substr(0, 200)
+                                    + "...instead of\n" + expected);
+
+        r = run("S_0\n"
+                "double x;\n"
+                "x = 4611686018427387904;\n"
+                "x = x + x;\n"
+                "x = x - 1;\n"
+                "print x;\n"
+                "end\n");
+        check(r.output == printed(4611686018427387904.0 * 2 - 1), "adding past 2^63 gives the double: " + r.output);
+    }
+
+    void zeroDivisor()
+    {
+        Run r = run("S_0\n"
+                    "double x;\n"
+                    "double zero;\n"
+                    "x = 7;\n"
+                    "zero = 0;\n"
+                    "x = x % zero;\n"
+                    "print x;\n"
+                    "end\n");
+        check(r.error == FSMError::NONE, "an inferred integer modulo zero runs: " + r.message);
+        check(r.output.find("nan") != string::npos, "an inferred integer modulo zero is NaN: " + r.output);
+
+        r = run("S_0\n"
+                "int x;\n"
+                "int zero;\n"
+                "x = 7;\n"
+                "x = x % zero;\n"
+                "end\n");
+        check(r.error == FSMError::ARITHMETIC, "a declared int modulo zero is an arithmetic error");
+    }
+
+    void declared()
+    {
+        Run r = run("S_0\n"
+                    "int x;\n"
+                    "x = 4611686018427387904;\n"
+                    "x = x + x;\n"
+                    "end\n");
+        check(r.error == FSMError::ARITHMETIC, "a declared int overflowing is an arithmetic error: " + r.message);
+
+        r = run("S_0\n"
+                "int x;\n"
+                "x = 9007199254740993;\n"
+                "x = x + 1;\n"
+                "print x;\n"
+                "end\n");
+        check(r.error == FSMError::NONE && r.output == "9.0072e+15", "a declared int holds past 2^53: " + r.output);
+    }
+
+    //past 32 bits, which the old (int) casts cut off
+    void bitwise()
+    {
+        Run r = run("S_0\n"
+                    "double x;\n"
+                    "double y;\n"
+                    "x = 4294967296;\n"
+                    "y = x | 5;\n"
+                    "y = y & 4294967300;\n"
+                    "jumpif y = 4294967300 S_1;\n"
+                    "print \"wrong\";\n"
+                    "end\n\n"
+                    "S_1\n"
+                    "print \"right\";\n"
+                    "end\n");
+        check(r.output == "right", "AND and OR work on 64 bits: " + r.output + r.message);
+    }
+
+    //every comparison, with the variable on either side, for an int, an inferred integer, a double and a string
+    void comparisons()
+    {
+        struct Op
+        {
+            string text;
+            function<bool(int, int)> holds;
+        };
+        const vector<Op> ops = {{"<", less<int>()}, {"<=", less_equal<int>()}, {">", greater<int>()},
+                                {">=", greater_equal<int>()}, {"=", equal_to<int>()}, {"!=", not_equal_to<int>()}};
+        const vector<pair<string, string>> kinds = {{"int", ""}, {"double", ""}, {"double", ".5"}, {"string", ""}};
+        for (const auto& kind : kinds)
+        {
+            for (const Op& op : ops)
+            {
+                for (int value : {2, 3, 4})
+                {
+                    for (bool variableFirst : {true, false})
+                    {
+                        //x holds value, compared with 3 - as numbers, or as one letter strings
+                        auto literal = [&] (int n)
+                        {
+                            return kind.first == "string" ? "\"" + string(1, 'a' + n) + "\"" : to_string(n) + kind.second;
+                        };
+                        string comparison = variableFirst ? "x " + op.text + " " + literal(3)
+                                                          : literal(3) + " " + op.text + " x";
+                        Run r = run("S_0\n" + kind.first + " x;\n"
+                                    "x = " + literal(value) + ";\n"
+                                    "jumpif " + comparison + " S_1;\n"
+                                    "print \"no\";\n"
+                                    "end\n\n"
+                                    "S_1\n"
+                                    "print \"yes\";\n"
+                                    "end\n");
+                        bool holds = variableFirst ? op.holds(value, 3) : op.holds(3, value);
+                        check(r.error == FSMError::NONE && r.output == (holds ? "yes" : "no"),
+                              kind.first + " x = " + literal(value) + ": jumpif " + comparison + " gives "
+                              + r.output + r.message);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    overflow();
+    zeroDivisor();
+    declared();
+    bitwise();
+    comparisons();
+    return finish();
+}
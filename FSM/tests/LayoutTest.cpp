@@ -0,0 +1,79 @@
+#include "Testing.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    //states out of the order they run in, reached by every kind of jump - a plain one, a conditional one, a switch
+    //(through a case and its default) and a return to a pushed state
+    const string program = "S_0\n"
+                           "double i;\n"
+                           "double k;\n"
+                           "i = 0;\n"
+                           "jump S_loop;\n"
+                           "end\n\n"
+                           "S_done\n"
+                           "print \"done\\n\";\n"
+                           "end\n\n"
+                           "S_odd\n"
+                           "print \"odd \";\n"
+                           "push state S_next;\n"
+                           "jump S_call;\n"
+                           "end\n\n"
+                           "S_call\n"
+                           "print \"call \";\n"
+                           "return;\n"
+                           "end\n\n"
+                           "S_next\n"
+                           "i = i + 1;\n"
+                           "jumpif i < 6 S_loop;\n"
+                           "jump S_done;\n"
+                           "end\n\n"
+                           "S_even\n"
+                           "print \"even \";\n"
+                           "jump S_next;\n"
+                           "end\n\n"
+                           "S_loop\n"
+                           "k = i % 2;\n"
+                           "print i;\n"
+                           "print \" \";\n"
+                           "switch k { 0: S_even; default: S_odd };\n"
+                           "end\n";
+
+    void sameBehaviour()
+    {
+        Run plain = run(program);
+        check(plain.error == FSMError::NONE, "the machine runs: " + plain.message);
+        check(plain.output.find("done") != string::npos, "the machine finishes: " + plain.output);
+
+        unsigned int moved = 0, movedAgain = 0;
+        Run laidOut = run(program, 100000, [&] (FSM& machine)
+        {
+            moved = machine.layOutStates();
+            movedAgain = machine.layOutStates();
+        });
+        check(moved != 0, "states out of order are moved");
+        check(movedAgain == 0, "states laid out already are left alone");
+        check(laidOut.error == FSMError::NONE, "the laid out machine runs: " + laidOut.message);
+        check(laidOut.output == plain.output, "the laid out machine prints the same:\n" + laidOut.output
+                                              + "\ninstead of\n" + plain.output);
+    }
+
+    void afterDeadCode()
+    {
+        Run r = run(program, 100000, [] (FSM& machine)
+        {
+            machine.layOutStates();
+            machine.eliminateDeadCode();
+        });
+        check(r.output == run(program).output, "laying out then removing dead code prints the same: " + r.output);
+    }
+}
+
+int main()
+{
+    sameBehaviour();
+    afterDeadCode();
+    return finish();
+}
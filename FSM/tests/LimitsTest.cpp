@@ -0,0 +1,102 @@
+#include "Testing.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    //the violation a machine stops with under limits - any other ending fails the check
+    QuotaViolation violated(const string& source, const ExecutionLimits& limits, const string& what)
+    {
+        unique_ptr<FSM> machine;
+        string message;
+        FSMError error = FSM::load(source, machine, &message);
+        check(error == FSMError::NONE, what + " loads: " + message);
+        if (error != FSMError::NONE) return {};
+        machine->setLimits(limits);
+        try
+        {
+            machine->run();
+        }
+        catch (QuotaExceeded& e)
+        {
+            check(e.getCode() == FSMError::QUOTA_EXCEEDED, what + " is QUOTA_EXCEEDED");
+            return e.getViolation();
+        }
+        catch (exception& e)
+        {
+            check(false, what + " stops with a quota violation, not: " + e.what());
+            return {};
+        }
+        check(false, what + " stops with a quota violation, not by finishing");
+        return {};
+    }
+
+    //goes round S_loop for ever, doing body each time
+    string looping(const string& declarations, const string& body)
+    {
+        return "S_0\n" + declarations + "jump S_loop;\nend\n\nS_loop\n" + body + "jump S_loop;\nend\n";
+    }
+
+    void steps()
+    {
+        ExecutionLimits limits;
+        limits.maxSteps = 50;
+        QuotaViolation v = violated(looping("", ""), limits, "a step limit");
+        check(v.quota == Quota::STEPS && v.limit == 50 && v.reached == 51 && v.steps == 51,
+              "the step limit stops the 51st step (" + to_string(v.reached) + ", " + to_string(v.steps) + ")");
+        check(v.state == "S_loop", "the step limit reports the state about to run: " + v.state);
+
+        Run r = run(looping("", ""), 50);
+        check(r.error == FSMError::QUOTA_EXCEEDED, "tryRun gives QUOTA_EXCEEDED: " + r.message);
+        check(r.message.find("steps limit of 50") != string::npos && r.message.find("'S_loop'") != string::npos,
+              "the message gives the limit and the state: " + r.message);
+    }
+
+    void stackDepth()
+    {
+        ExecutionLimits limits;
+        limits.maxStackDepth = 10;
+        QuotaViolation v = violated(looping("", "push 1;\n"), limits, "a stack limit");
+        check(v.quota == Quota::STACK_DEPTH && v.limit == 10 && v.reached == 11,
+              "the stack limit stops at 11 values (" + to_string(v.reached) + ")");
+        //S_0, then eleven trips round S_loop pushing one each, noticed as the next step starts
+        check(v.state == "S_loop" && v.steps == 13, "the stack limit is noticed at once: '" + v.state + "' after "
+                                                    + to_string(v.steps));
+    }
+
+    //ten bytes a trip round S_loop, the first being step 2, but only counted every 1024 steps
+    void stringBytes()
+    {
+        ExecutionLimits limits;
+        limits.maxStringBytes = 1000;
+        QuotaViolation v = violated(looping("string s;\n", "push \"abcdefghij\";\n"), limits, "a string limit");
+        check(v.quota == Quota::STRING_BYTES && v.limit == 1000, "the string limit is what stops the machine");
+        check(v.steps == 1024 && v.reached == 1022 * 10, "string bytes are checked at step 1024 ("
+                                                         + to_string(v.reached) + " after " + to_string(v.steps) + ")");
+
+        limits.maxStringBytes = 1022 * 10;
+        v = violated(looping("", "push \"abcdefghij\";\n"), limits, "a string limit exactly reached");
+        check(v.quota == Quota::STRING_BYTES && v.steps == 2048, "reaching the string limit isn't passing it ("
+                                                                 + to_string(v.steps) + ")");
+    }
+
+    void wallTime()
+    {
+        ExecutionLimits limits;
+        limits.maxWallTime = chrono::milliseconds(50);
+        QuotaViolation v = violated(looping("", ""), limits, "a time limit");
+        check(v.quota == Quota::WALL_TIME && v.limit == 50 && v.reached > 50,
+              "the time limit stops the machine after 50ms (" + to_string(v.reached) + ")");
+        check(v.steps % 1024 == 0, "time is checked every 1024 steps (" + to_string(v.steps) + ")");
+    }
+}
+
+int main()
+{
+    steps();
+    stackDepth();
+    stringBytes();
+    wallTime();
+    return finish();
+}
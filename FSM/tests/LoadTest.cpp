@@ -0,0 +1,64 @@
+#include "Testing.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    //reaches its states out of file order, so loading lazily reads them as it gets to them rather than in turn
+    const string program = "S_0\n"
+                           "double i;\n"
+                           "double j;\n"
+                           "i = 0;\n"
+                           "j = 0;\n"
+                           "jump S_loop;\n"
+                           "end\n\n"
+                           "S_done\n"
+                           "print j;\n"
+                           "print \"\\n\";\n"
+                           "end\n\n"
+                           "S_loop\n"
+                           "print i;\n"
+                           "print \" \";\n"
+                           "i = i + 1;\n"
+                           "push state S_loop;\n"
+                           "jumpif i < 4 S_grow;\n"
+                           "jump S_done;\n"
+                           "end\n\n"
+                           "S_grow\n"
+                           "j = j + 10;\n"
+                           "return;\n"
+                           "end\n";
+
+    void lazyMatchesEager()
+    {
+        Run eager = run(program);
+        check(eager.error == FSMError::NONE, "the machine runs: " + eager.message);
+        check(eager.output == "0 1 2 3 30\n", "the machine prints what it should: " + eager.output);
+        Run lazy = run(program, 100000, nullptr, true);
+        check(lazy.error == FSMError::NONE, "the machine runs loaded lazily: " + lazy.message);
+        check(lazy.output == eager.output, "loaded lazily it prints the same: " + lazy.output);
+    }
+
+    void empty()
+    {
+        for (bool lazy : {false, true})
+        {
+            for (const string source : {"", "  \n\t\n"})
+            {
+                unique_ptr<FSM> machine;
+                string message;
+                FSMError error = FSM::load(source, machine, &message, lazy);
+                check(error == FSMError::NO_STATES, string("an empty source is rejected") + (lazy ? " lazily" : "")
+                                                    + ": " + message);
+            }
+        }
+    }
+}
+
+int main()
+{
+    lazyMatchesEager();
+    empty();
+    return finish();
+}
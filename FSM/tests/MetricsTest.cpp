@@ -0,0 +1,144 @@
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "Testing.h"
+#include "Metrics.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    const string socketPath = "/tmp/metricstest" + to_string(getpid()) + ".sock";
+
+    sockaddr_un address()
+    {
+        sockaddr_un a = {};
+        a.sun_family = AF_UNIX;
+        strcpy(a.sun_path, socketPath.c_str());
+        return a;
+    }
+
+    //the body of one GET, as Prometheus would scrape it - empty if nothing answered
+    string scrape()
+    {
+        sockaddr_un a = address();
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (connect(fd, (sockaddr*) &a, sizeof(a)) != 0)
+        {
+            close(fd);
+            return "";
+        }
+        const string request = "GET /metrics HTTP/1.0\r\n\r\n";
+        string response;
+        if (write(fd, request.data(), request.size()) == (ssize_t) request.size())
+        {
+            char buffer[4096];
+            ssize_t got;
+            while ((got = read(fd, buffer, sizeof(buffer))) > 0) response.append(buffer, got);
+        }
+        close(fd);
+        size_t body = response.find("\r\n\r\n");
+        if (response.compare(0, 12, "HTTP/1.0 200") != 0 || body == string::npos) return "";
+        return response.substr(body + 4);
+    }
+
+    bool has(const string& body, const string& line)
+    {
+        return body.find("\n" + line + "\n") != string::npos;
+    }
+
+    //three transitions, at stack depths 0, 3 and 0, printing one byte
+    const string program = "S_0\n"
+                           "push 1;\n"
+                           "push 2;\n"
+                           "push 3;\n"
+                           "jump S_1;\n"
+                           "end\n\n"
+                           "S_1\n"
+                           "pop;\n"
+                           "pop;\n"
+                           "pop;\n"
+                           "jump S_2;\n"
+                           "end\n\n"
+                           "S_2\n"
+                           "print \"x\";\n"
+                           "end\n";
+
+    void scraped()
+    {
+        MetricsServer server(socketPath);
+        {
+            unique_ptr<FSM> machine;
+            string message;
+            check(FSM::load(program, machine, &message) == FSMError::NONE, "the machine loads: " + message);
+            machine->enableMetrics();
+            machine->setIO({[] (const string&) {}, nullptr});
+            check(machine->tryRun(&message) == FSMError::NONE, "the machine runs: " + message);
+
+            string body = scrape();
+            check(has(body, "fsm_transitions_total 3"), "the transitions are counted:\n" + body);
+            check(has(body, "fsm_instances 1") && has(body, "fsm_instances_running 0"),
+                  "the machine is loaded, and not running once it's finished:\n" + body);
+            check(has(body, "fsm_output_bytes_total 1"), "what it printed is counted:\n" + body);
+            bool buckets = true;
+            for (const string& bucket : {"le=\"0\"} 2", "le=\"1\"} 2", "le=\"3\"} 3", "le=\"7\"} 3", "le=\"+Inf\"} 3"})
+            {
+                buckets = buckets && has(body, "fsm_stack_depth_bucket{" + bucket);
+            }
+            check(buckets, "the stack depths go in their buckets, cumulatively:\n" + body);
+            check(has(body, "fsm_stack_depth_sum 3") && has(body, "fsm_stack_depth_count 3"),
+                  "the depth histogram's sum and count:\n" + body);
+        }
+
+        string body = scrape();
+        check(has(body, "fsm_transitions_total 3") && has(body, "fsm_instances 0"),
+              "a machine that's gone keeps its counts in the totals:\n" + body);
+    }
+
+    //a socket something's serving on is left alone, one left behind is taken over
+    void socketInUse()
+    {
+        {
+            MetricsServer server(socketPath);
+            bool refused = false;
+            try
+            {
+                MetricsServer second(socketPath);
+            }
+            catch (FSMException& e)
+            {
+                refused = e.getCode() == FSMError::IO;
+            }
+            check(refused, "a second server on a socket in use is refused");
+            check(!scrape().empty(), "the first server still answers");
+        }
+
+        //bound but never listened on, as a killed process would leave it
+        sockaddr_un a = address();
+        int stale = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        check(bind(stale, (sockaddr*) &a, sizeof(a)) == 0, "leaving a socket behind");
+        close(stale);
+        bool served = true;
+        try
+        {
+            MetricsServer server(socketPath);
+            served = !scrape().empty();
+        }
+        catch (FSMException&)
+        {
+            served = false;
+        }
+        check(served, "a socket left behind is taken over");
+    }
+}
+
+int main()
+{
+    scraped();
+    socketInUse();
+    unlink(socketPath.c_str());
+    return finish();
+}
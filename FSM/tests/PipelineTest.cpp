@@ -0,0 +1,134 @@
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "Testing.h"
+#include "Pipeline.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    const string base = "/tmp/pipelinetest" + to_string(getpid());
+
+    //a producer sending 1 to 5 then its sum, and a consumer printing what it gets - the consumer goes through its
+    //states out of file order, so loaded lazily it reads them as it reaches them
+    const string producer = "S_0\n"
+                            "double i;\n"
+                            "double sum;\n"
+                            "i = 0;\n"
+                            "sum = 0;\n"
+                            "jump S_send;\n"
+                            "end\n\n"
+                            "S_send\n"
+                            "i = i + 1;\n"
+                            "sum = sum + i;\n"
+                            "send out i;\n"
+                            "jumpif i < 5 S_send;\n"
+                            "send out sum;\n"
+                            "end\n";
+    const string consumer = "S_0\n"
+                            "double v;\n"
+                            "double n;\n"
+                            "n = 0;\n"
+                            "jump S_receive;\n"
+                            "end\n\n"
+                            "S_print\n"
+                            "print v;\n"
+                            "print \" \";\n"
+                            "jumpif n < 6 S_receive;\n"
+                            "end\n\n"
+                            "S_receive\n"
+                            "recv out v;\n"
+                            "n = n + 1;\n"
+                            "jump S_print;\n"
+                            "end\n";
+    //goes round for ever without sending
+    const string looping = "S_0\n"
+                           "double k;\n"
+                           "k = 0;\n"
+                           "jump S_spin;\n"
+                           "end\n\n"
+                           "S_spin\n"
+                           "k = k * -1;\n"
+                           "jump S_spin;\n"
+                           "end\n";
+
+    string writeConfig(const string& producerSource, const string& consumerSource)
+    {
+        ofstream(base + ".producer.fs") << producerSource;
+        ofstream(base + ".consumer.fs") << consumerSource;
+        ofstream(base + ".pipeline") << "machine p " << base << ".producer.fs\nmachine c " << base << ".consumer.fs\n"
+                                     << "channel out p -> c 2\n";
+        return base + ".pipeline";
+    }
+
+    //what the pipeline printed, and the error it stopped with
+    Run runPipeline(Pipeline& pipeline)
+    {
+        Run result;
+        ostringstream captured;
+        streambuf* old = cout.rdbuf(captured.rdbuf());
+        try
+        {
+            pipeline.run();
+        }
+        catch (FSMException& e)
+        {
+            result.error = e.getCode();
+            result.message = e.what();
+        }
+        cout.rdbuf(old);
+        result.output = captured.str();
+        return result;
+    }
+
+    void lazy()
+    {
+        string config = writeConfig(producer, consumer);
+        Pipeline eager(config);
+        Run expected = runPipeline(eager);
+        check(expected.error == FSMError::NONE, "the pipeline runs: " + expected.message);
+        check(expected.output == "1 2 3 4 5 15 ", "the pipeline prints what it should: " + expected.output);
+
+        Pipeline lazily(config, true);
+        Run r = runPipeline(lazily);
+        check(r.error == FSMError::NONE, "the pipeline runs loaded lazily: " + r.message);
+        check(r.output == expected.output, "loaded lazily it prints the same: " + r.output);
+    }
+
+    void watchdog()
+    {
+        Pipeline pipeline(writeConfig(producer, looping));
+        pipeline.enableWatchdog(16);
+        Run r = runPipeline(pipeline);
+        check(r.error == FSMError::INFINITE_LOOP, "a looping machine in a pipeline is caught: " + r.message);
+        check(r.message.find("S_spin") != string::npos, "its loop is reported: " + r.message);
+    }
+
+    void perf()
+    {
+        Pipeline pipeline(writeConfig(producer, consumer));
+        pipeline.enablePerfCounters(1);
+        Run r = runPipeline(pipeline);
+        check(r.error == FSMError::NONE, "the pipeline runs with counters: " + r.message);
+        ostringstream report;
+        pipeline.reportPerfCounters(report);
+        //what the counters say depends on the kernel, but every machine is reported on, one way or the other
+        check(report.str().find("Machine 'p': ") != string::npos && report.str().find("Machine 'c': ") != string::npos,
+              "each machine's counters are reported: " + report.str());
+        bool measured = report.str().find("S_send") != string::npos && report.str().find("S_receive") != string::npos;
+        check(measured || report.str().find("unavailable") != string::npos,
+              "each machine's states are measured on its thread: " + report.str());
+    }
+}
+
+int main()
+{
+    lazy();
+    watchdog();
+    perf();
+    for (const string& suffix : {".producer.fs", ".consumer.fs", ".pipeline"}) unlink((base + suffix).c_str());
+    return finish();
+}
@@ -0,0 +1,92 @@
+#include <cmath>
+#include <limits>
+#include <set>
+
+#include "Testing.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    const int draws = 100000;
+
+    void doubles()
+    {
+        RandomStream random(7);
+        int fractions = 0, huge = 0, tiny = 0, small = 0, nans = 0, infinities = 0, negativeZeros = 0;
+        for (int i = 0; i < draws; ++i)
+        {
+            double d = random.nextDouble();
+            if (isnan(d)) ++nans;
+            else if (isinf(d)) ++infinities;
+            else if (d == 0 && signbit(d)) ++negativeZeros;
+            else if (d != trunc(d)) ++fractions;
+            if (fabs(d) > 1e100 && !isinf(d)) ++huge;
+            if (d != 0 && fabs(d) < 1e-100) ++tiny;
+            if (d == trunc(d) && fabs(d) <= RandomStream::smallRange) ++small;
+        }
+        check(fractions > draws / 10, "doubles aren't all whole (" + to_string(fractions) + ")");
+        check(huge > draws / 20 && tiny > draws / 20, "doubles span the exponents (" + to_string(huge) + " huge, "
+                                                      + to_string(tiny) + " tiny)");
+        check(small > draws / 5, "small whole numbers stay common (" + to_string(small) + ")");
+        check(nans > 0 && infinities > 0 && negativeZeros > 0, "the non-finite values and -0 come up");
+    }
+
+    void integers()
+    {
+        RandomStream random(7);
+        set<long long> seen;
+        int outside32 = 0;
+        for (int i = 0; i < draws; ++i)
+        {
+            long long v = random.nextInteger();
+            seen.insert(v);
+            if (v > 2147483647LL || v < -2147483648LL) ++outside32;
+        }
+        check(seen.count(numeric_limits<long long>::max()) && seen.count(numeric_limits<long long>::min())
+              && seen.count(0) && seen.count(-1), "the integer limits come up");
+        check(outside32 > draws / 3, "integers span 64 bits (" + to_string(outside32) + ")");
+    }
+
+    void reproducible()
+    {
+        RandomStream a(42, 3), b(42, 3), c(42, 4);
+        bool same = true, different = false;
+        for (int i = 0; i < 1000; ++i)
+        {
+            double x = a.nextDouble(), y = b.nextDouble(), z = c.nextDouble();
+            same = same && (x == y || (isnan(x) && isnan(y)));
+            different = different || !(x == z || (isnan(x) && isnan(z)));
+        }
+        check(same, "the same seed and instance give the same doubles");
+        check(different, "another instance gives other doubles");
+    }
+
+    //nondet into a double gives fractions rather than only whole numbers, and the variable stays a double
+    void nondet()
+    {
+        string source = "S_0\ndouble x;\ndouble i;\ni = 0;\njump S_1;\nend\n\n"
+                        "S_1\nnondet x;\nprint x;\nprint \"\\n\";\ni = i + 1;\njumpif i < 200 S_1;\nend\n";
+        Run r = run(source);
+        check(r.error == FSMError::NONE, "nondet runs: " + r.message);
+        bool fraction = false;
+        size_t start = 0, end;
+        while ((end = r.output.find('\n', start)) != string::npos)
+        {
+            double d = strtod(r.output.substr(start, end - start).c_str(), nullptr);
+            fraction = fraction || (isfinite(d) && d != trunc(d));
+            start = end + 1;
+        }
+        check(fraction, "nondet into a double gives fractions:\n" + r.output.substr(0, 200));
+    }
+}
+
+int main()
+{
+    doubles();
+    integers();
+    reproducible();
+    nondet();
+    return finish();
+}
@@ -0,0 +1,63 @@
+#ifndef TESTING_H
+#define TESTING_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <functional>
+
+#include "FSM.h"
+
+//what the tests share - a check that counts failures, and running a machine from source with its output captured
+namespace Testing
+{
+    inline int failures = 0;
+
+    inline void check(bool ok, const std::string& what)
+    {
+        if (!ok)
+        {
+            std::cerr << "FAILED: " << what << "\n";
+            ++failures;
+        }
+    }
+
+    //what the machine printed, and the error it stopped with
+    struct Run
+    {
+        FSMError error = FSMError::NONE;
+        std::string message;
+        std::string output;
+    };
+
+    //bounded, so a machine that goes wrong by looping fails rather than hangs. prepare is given the machine first
+    inline Run run(std::string_view source, unsigned long long maxSteps = 100000,
+                   const std::function<void(FSM&)>& prepare = nullptr, bool lazy = false)
+    {
+        Run result;
+        std::unique_ptr<FSM> machine;
+        result.error = FSM::load(source, machine, &result.message, lazy);
+        if (result.error != FSMError::NONE) return result;
+        if (prepare) prepare(*machine);
+        machine->setIO({[&result] (const std::string& text) {result.output += text;}, nullptr});
+        ExecutionLimits limits;
+        limits.maxSteps = maxSteps;
+        machine->setLimits(limits);
+        result.error = machine->tryRun(&result.message);
+        return result;
+    }
+
+    inline int finish()
+    {
+        if (failures != 0)
+        {
+            std::cerr << failures << " checks failed\n";
+            return 1;
+        }
+        std::cout << "All passed\n";
+        return 0;
+    }
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include "Testing.h"
+
+using namespace std;
+using namespace Testing;
+
+namespace
+{
+    //counts to 50 then goes round S_a, S_b, S_c for ever, flipping the sign of k each time - so the same state and
+    //values come round every 6 transitions, which isn't a multiple of the interval the watchdog checks at
+    const string program = "S_0\n"
+                           "double i;\n"
+                           "double k;\n"
+                           "i = 0;\n"
+                           "k = 1;\n"
+                           "jump S_count;\n"
+                           "end\n\n"
+                           "S_count\n"
+                           "i = i + 1;\n"
+                           "jumpif i < 50 S_count;\n"
+                           "jump S_a;\n"
+                           "end\n\n"
+                           "S_a\n"
+                           "k = k * -1;\n"
+                           "jump S_b;\n"
+                           "end\n\n"
+                           "S_b\n"
+                           "jump S_c;\n"
+                           "end\n\n"
+                           "S_c\n"
+                           "jump S_a;\n"
+                           "end\n";
+
+    //the number in message just after what
+    unsigned long long numberAfter(const string& message, const string& what)
+    {
+        size_t at = message.find(what);
+        return at == string::npos ? 0 : stoull(message.substr(at + what.size()));
+    }
+
+    void reportsTheLoop()
+    {
+        Run r = run(program, 100000, [] (FSM& machine) {machine.enableWatchdog(7);});
+        check(r.error == FSMError::INFINITE_LOOP, "the loop is caught: " + r.message);
+        check(numberAfter(r.message, "repeats every ") == 6, "the loop's exact length is given: " + r.message);
+        check(r.message.find("S_a -> S_b -> S_c") != string::npos || r.message.find("S_b -> S_c -> S_a") != string::npos
+              || r.message.find("S_c -> S_a -> S_b") != string::npos, "the loop's states are given: " + r.message);
+        check(r.message.find("S_count") == string::npos, "states before the loop aren't: " + r.message);
+        unsigned long long entered = numberAfter(r.message, "within the first ");
+        check(entered >= 51 && entered < 100000, "when the loop was entered by is given: " + r.message);
+    }
+}
+
+int main()
+{
+    reportsTheLoop();
+    return finish();
+}